@@ -324,7 +324,8 @@ enum class SnapshotSyncState : uint8
 	Location		= (uint8)0x02,
 	Motion			= (uint8)0x04,
 	Skill			= (uint8)0x08,
-	Controller		= (uint8)0x10
+	Controller		= (uint8)0x10,
+	DeltaLocation	= (uint8)0x20
 };
 
 #define SNAPSHOT_SYNC_ROTATION		(uint8)SnapshotSyncState::Rotation
@@ -332,6 +333,7 @@ enum class SnapshotSyncState : uint8
 #define SNAPSHOT_SYNC_MOTION		(uint8)SnapshotSyncState::Motion
 #define SNAPSHOT_SYNC_SKILL			(uint8)SnapshotSyncState::Skill
 #define SNAPSHOT_SYNC_CONTROLLER	(uint8)SnapshotSyncState::Controller
+#define SNAPSHOT_SYNC_DELTA_LOCATION	(uint8)SnapshotSyncState::DeltaLocation
 #define SNAPSHOT_SYNC_MOBILE		SNAPSHOT_SYNC_ROTATION | SNAPSHOT_SYNC_LOCATION
 #define SNAPSHOT_SYNC_CHARACTER		SNAPSHOT_SYNC_MOBILE | SNAPSHOT_SYNC_MOTION | SNAPSHOT_SYNC_SKILL | SNAPSHOT_SYNC_CONTROLLER
 #define SNAPSHOT_SYNC_FF			(uint8)0xFF
@@ -356,6 +358,17 @@ SNAPSHOT_DATA_SINGLE_UNIT(SNAPSHOT_SYNC_MOTION, MotionState Motion);
 SNAPSHOT_DATA_SINGLE_UNIT(SNAPSHOT_SYNC_SKILL, uint32 SkillGUID);
 SNAPSHOT_DATA_SINGLE_UNIT(SNAPSHOT_SYNC_CONTROLLER, uint8 ControllerEnabled);
 
+// location and yaw quantized against the baseline the receiver holds, see anu_snapshot_delta.h.
+// sent in place of SNAPSHOT_SYNC_LOCATION | SNAPSHOT_SYNC_ROTATION, a record never carries both forms.
+template<> struct SnapshotData<SNAPSHOT_SYNC_DELTA_LOCATION>
+{
+	int16 Delta[3];		// steps of 1 / SNAPSHOT_DELTA_STEPS_PER_UNIT
+	uint16 Yaw;			// SNAPSHOT_DELTA_YAW_BITS of a full turn
+};
+
+#define SNAPSHOT_DELTA_STEPS_PER_UNIT	8.0f
+#define SNAPSHOT_DELTA_YAW_BITS			10
+
 // Add implement structure for that contains multiple units.
 // Like this:
 // template<> struct SnapshotData<SNAPSHOT_SYNC_X>
@@ -396,6 +409,37 @@ struct ArrangedSnapshotData : public AmbiguousSnapshotDataArrangedTypedef<_ImplF
 {
 };
 
+// where the units of one SyncState mask sit behind the SyncState byte
+struct SnapshotDataLayout
+{
+	uint8 Size;			// all arranged units
+	uint8 Offsets[8];	// per unit bit, only meaningful for the bits of the mask
+};
+
+inline constexpr uint8 SnapshotDataUnitSizes[8] = {
+	sizeof(SnapshotData<0x01>), sizeof(SnapshotData<0x02>), sizeof(SnapshotData<0x04>), sizeof(SnapshotData<0x08>),
+	sizeof(SnapshotData<0x10>), sizeof(SnapshotData<0x20>), sizeof(SnapshotData<0x40>), sizeof(SnapshotData<0x80>),
+};
+
+constexpr std::array<SnapshotDataLayout, 256> MakeSnapshotDataLayouts()
+{
+	std::array<SnapshotDataLayout, 256> layouts = {};
+	for (size_t state = 0; state < layouts.size(); ++state) {
+		uint8 offset = 0;
+		for (size_t bit = 0; bit < 8; ++bit) {
+			layouts[state].Offsets[bit] = offset;
+			if ((state & ((size_t)1 << bit)) != 0) {
+				offset += SnapshotDataUnitSizes[bit];
+			}
+		}
+		layouts[state].Size = offset;
+	}
+	return layouts;
+}
+
+// indexed by SyncState, replaces walking the eight bits on every access
+inline constexpr std::array<SnapshotDataLayout, 256> SnapshotDataLayouts = MakeSnapshotDataLayouts();
+
 struct AmbiguousSnapshotData
 {
 
@@ -420,7 +464,7 @@ struct AmbiguousSnapshotData
 	{
 		static_assert(CountBits<_ImplClass>() == 1, "The count of bits of _ImplClass template parameter of GetImplClass() function must be 1.");
 		check1(_ImplClass & SyncState);
-		return reinterpret_cast<SnapshotData<_ImplClass>*>(GetArrangedStart() + CalcArrangedGetImplClassHead<0, _ImplClass>(SyncState));
+		return reinterpret_cast<SnapshotData<_ImplClass>*>(GetArrangedStart() + GetImplClassOffset<_ImplClass>(SyncState));
 	}
 
 	template<uint8 _ImplClass>
@@ -428,17 +472,23 @@ struct AmbiguousSnapshotData
 	{
 		static_assert(CountBits<_ImplClass>() == 1, "The count of bits of _ImplClass template parameter of GetImplClass() function must be 1.");
 		check1(_ImplClass & SyncState);
-		return reinterpret_cast<const SnapshotData<_ImplClass>*>(GetArrangedStart() + CalcArrangedGetImplClassHead<0, _ImplClass>(SyncState));
+		return reinterpret_cast<const SnapshotData<_ImplClass>*>(GetArrangedStart() + GetImplClassOffset<_ImplClass>(SyncState));
 	}
 
 	size_t CompressedSz() const
 	{
-		return sizeof(SyncState) + CompressedSzImpl<0>(SyncState);
+		return CompressedSz(SyncState);
 	}
 
-	static size_t CompressedSz(uint8 state)
+	static constexpr size_t CompressedSz(uint8 state)
 	{
-		return sizeof(SyncState) + CompressedSzImpl<0>(state);
+		return sizeof(SyncState) + SnapshotDataLayouts[state].Size;
+	}
+
+	template<uint8 _ImplClass>
+	static constexpr size_t GetImplClassOffset(uint8 state)
+	{
+		return SnapshotDataLayouts[state].Offsets[GetImplClassIndex<0, _ImplClass>()];
 	}
 
 private:
@@ -472,35 +522,6 @@ private:
 		}
 	}
 
-	template<size_t _Idx>
-	static inline size_t CompressedSzImpl(uint8 state)
-	{
-		constexpr uint8 _Flag = ((uint8)1) << ((uint8)_Idx);
-		size_t _Sizeof = ((state & _Flag) != 0) ? sizeof(SnapshotData<_Flag>) : 0;
-
-		if constexpr (_Idx + 1 < 8) {
-			return _Sizeof + CompressedSzImpl<_Idx + 1>(state);
-		}
-		else {
-			return _Sizeof;
-		}
-	}
-
-	template<uint8 _Idx, uint8 _ImplClass>
-	static inline auto CalcArrangedGetImplClassHead(uint8 sync)
-	{
-		constexpr bool _This = (1 << _Idx) == _ImplClass;
-		const bool impls = sync & (1 << _Idx);
-		size_t size = impls ? sizeof(SnapshotData<(1 << _Idx)>) : 0;
-
-		if constexpr (_This) {
-			return 0;
-		}
-		else {
-			return CalcArrangedGetImplClassHead<_Idx + 1, _ImplClass>(sync) + size;
-		}
-	}
-
 	inline uint8* GetArrangedStart() { return reinterpret_cast<uint8*>(this) + sizeof(SyncState); }
 	inline const uint8* GetArrangedStart() const { return reinterpret_cast<const uint8*>(this) + sizeof(SyncState); }
 };
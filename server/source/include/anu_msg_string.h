@@ -1,3 +1,5 @@
+// generated by server/source/tools/msggen.py from anu_msg_define.h and framework_msg_define.h, do not edit
+
 #pragma once
 
 #include <string>
@@ -10,499 +12,613 @@ namespace MsgHelper
 	using msgid_t = unsigned short;
 	using errid_t = unsigned char;
 
-	static std::map<msgid_t, std::wstring> ProtocolMap
+	struct ProtocolName
+	{
+		msgid_t msgID;
+		const wchar_t* name;
+	};
+
+	// sorted by msgID, the first definition wins when two protocols share an id
+	inline constexpr ProtocolName ProtocolNames[] =
 	{
-		{28673, L"DUMMY_ACTION_REQ"},
-		{45057, L"DUMMY_ACTION_ACK"},
 		{12289, L"DUMMY_ACTION_NFY"},
-		{28676, L"DUMMY_REDIRECT_REQ"},
-		{45060, L"DUMMY_REDIRECT_ACK"},
 		{12290, L"CLIENT_ACCOUNT_INFO_NFY"},
-		{28675, L"GLOBAL_TIMESYSTEM_SYNC_REQ"},
-		{45059, L"GLOBAL_TIMESYSTEM_SYNC_ACK"},
-		{28688, L"ENTER_WORLD_FRONT_END_LOBBY_REQ"},
-		{45072, L"ENTER_WORLD_FRONT_END_LOBBY_ACK"},
-		{28689, L"LIST_CHARACTER_REQ"},
-		{45073, L"LIST_CHARACTER_ACK"},
-		{28690, L"CREATE_CHARACTER_REQ"},
-		{45074, L"CREATE_CHARACTER_ACK"},
-		{28691, L"CHARACTER_AMENITY_REQ"},
-		{45075, L"CHARACTER_AMENITY_ACK"},
-		{28693, L"CHANGE_CHARACTER_NICKNAME_REQ"},
-		{45077, L"CHANGE_CHARACTER_NICKNAME_ACK"},
 		{12309, L"CHANGE_CHARACTER_NICKNAME_NFY"},
 		{12310, L"DISCONTINUE_SESSION"},
-		{28695, L"ACCOUNT_WITHDRAW_REQ"},
-		{45079, L"ACCOUNT_WITHDRAW_ACK"},
 		{12312, L"EXECUTE_CLIENT_RPC_NFY"},
-		{28698, L"IMAGE_UPLOAD_AUTH_REQ"},
-		{45082, L"IMAGE_UPLOAD_AUTH_ACK"},
-		{45083, L"TRANSLATE_AUTH_NFY"},
-		{28700, L"CHANGE_WORLD_INSTANCE_REQ"},
-		{45084, L"CHANGE_WORLD_INSTANCE_ACK"},
-		{28704, L"ENTER_GAME_REQ"},
-		{45088, L"ENTER_GAME_ACK"},
-		{28705, L"READY_TO_PLAY_REQ"},
-		{45089, L"READY_TO_PLAY_ACK"},
 		{12322, L"WORLD_OBJ_ADD_NFY"},
 		{12323, L"WORLD_OBJ_DEL_NFY"},
 		{12324, L"WORLD_MIGRATION_STARTED_NFY"},
-		{28709, L"WORLD_OBJ_STAT_REQ"},
-		{45093, L"WORLD_OBJ_STAT_ACK"},
 		{12325, L"WORLD_OBJ_STAT_NFY"},
 		{12326, L"WORLD_OBJ_STATE_NFY"},
 		{12327, L"WORLD_OBJ_VITAL_INFO_UPDATED_NFY"},
 		{12328, L"WORLD_OBJ_MOBILE_INFO_UPDATED_NFY"},
 		{12329, L"WORLD_OBJ_STANCE_UPDATED_NFY"},
 		{12330, L"WORLD_OBJ_SHIELD_INFO_UPDATED_NFY"},
-		{12330, L"WORLD_TIME_DAY_TYPE_NFY"},
 		{12331, L"WORLD_TIME_DAY_TYPE_CHANGED_NFY"},
 		{12332, L"WORLD_OBJ_BEHAVIOR_NFY"},
-		{28719, L"USE_PORTAL_REQ"},
-		{45103, L"USE_PORTAL_ACK"},
-		{28720, L"USER_SOCIAL_MOTION_REQ"},
-		{45104, L"USER_SOCIAL_MOTION_ACK"},
 		{12337, L"USER_SOCIAL_MOTION_NFY"},
-		{28722, L"USER_BUSY_STATE_REQ"},
 		{12339, L"USER_BLOCK_STATE_NFY"},
 		{12340, L"USER_SOCIAL_MOTION_UPDATE_NFY"},
 		{12352, L"CURRENCY_UPDATE_NFY"},
-		{28737, L"CURRENCY_EXCHANGE_REQ"},
-		{45121, L"CURRENCY_EXCHANGE_ACK"},
 		{12354, L"FAVOR_UPDATE_NFY"},
 		{12362, L"REWARD_PERIOD_UPDATE_NFY"},
-		{28747, L"USE_PERIODIC_ITEM_REQ"},
-		{45131, L"USE_PERIODIC_ITEM_ACK"},
-		{45136, L"MOVE_ACK"},
-		{45137, L"MOVE_TO_ACK"},
 		{12369, L"MOVE_TO_NFY"},
-		{28754, L"JUMP_REQ"},
-		{45138, L"JUMP_ACK"},
 		{12371, L"MOVE_LOCATION_NFY"},
 		{12372, L"MOVE_WITH_CONSTANT_VELOCITY_NFY"},
-		{28757, L"DASH_REQ"},
-		{45141, L"DASH_ACK"},
 		{12373, L"DASH_NFY"},
-		{28758, L"RESET_LOCATION_REQ"},
-		{45142, L"RESET_LOCATION_ACK"},
-		{28760, L"MOVE_SNAPSHOT_INIT_REQ"},
-		{45144, L"MOVE_SNAPSHOT_INIT_ACK"},
 		{12376, L"MOVE_SNAPSHOT_INIT_NFY"},
 		{12379, L"MOVE_HISTORY_NFY"},
 		{12380, L"NAVMESH_FINDING_SURFACE_FAILED_NFY"},
 		{12381, L"NAVMESH_RESOLVE_NEXT_LOCATION_NFY"},
 		{12382, L"IMPULSE_NFY"},
 		{12383, L"FALLING_NFY"},
-		{28768, L"CHAT_REQ"},
-		{45152, L"CHAT_ACK"},
 		{12384, L"CHAT_NFY"},
 		{12385, L"CHAT_CHANNEL_NFY"},
-		{28770, L"CHAT_HISTORY_REQ"},
-		{45154, L"CHAT_HISTORY_ACK"},
 		{12387, L"CHAT_STICKER_GROUP_UPDATE_NFY"},
 		{12389, L"CHAT_TOAST_NFY"},
 		{12400, L"PERMISSION_NFY"},
 		{12401, L"SERVER_SCHEDULE_NFY"},
-		{28789, L"PALETTE_LIST_REQ"},
-		{45173, L"PALETTE_LIST_ACK"},
 		{12416, L"LIFEOBJ_UPDATED_NFY"},
-		{28802, L"LIFEOBJ_INTERACTION_REQ"},
-		{45186, L"LIFEOBJ_INTERACTION_ACK"},
 		{12419, L"LIFEOBJ_INTERACTION_START_NFY"},
 		{12420, L"LIFEOBJ_INTERACTION_END_NFY"},
 		{12421, L"LIFEOBJ_CHANGE_AMOUNT_NFY"},
-		{28806, L"LIFEOBJ_MINIGAME_END_REQ"},
-		{45190, L"LIFEOBJ_MINIGAME_END_ACK"},
 		{12423, L"SCHEDULE_ACTOR_NFY"},
-		{28816, L"SKILL_USE_REQ"},
-		{45200, L"SKILL_USE_ACK"},
 		{12433, L"SKILL_STATE_NFY"},
 		{12434, L"SKILL_EFFECT_NFY"},
 		{12435, L"SKILL_COOLTIME_NFY"},
 		{12436, L"SKILL_INDICATOR_NFY"},
-		{28821, L"SKILL_CHARGE_START_REQ"},
-		{45205, L"SKILL_CHARGE_START_ACK"},
 		{12437, L"SKILL_CHARGE_NFY"},
-		{28822, L"SKILL_CHARGE_END_REQ"},
-		{45206, L"SKILL_CHARGE_END_ACK"},
 		{12439, L"SKILL_CANCEL_NFY"},
-		{28824, L"CHANGE_TO_PLAYABLE_STATE_REQ"},
-		{45208, L"CHANGE_TO_PLAYABLE_STATE_ACK"},
 		{12447, L"SKILL_DBG_DRAW_RANGE_NFY"},
+		{12450, L"TITLE_ADD_NFY"},
+		{12451, L"TITLE_OWNERSHIP_NFY"},
+		{12464, L"MATCH_MAKE_NFY"},
+		{12482, L"GALLERY_FEEDBACK_NFY"},
+		{12549, L"SHOP_ITEM_LIST_NFY"},
+		{12551, L"EMBLEM_EQUIP_NFY"},
+		{12552, L"REWARD_NFY"},
+		{12560, L"CLASS_UPDATE_NFY"},
+		{12562, L"CLASS_SKILL_UPDATE_NFY"},
+		{12563, L"CLASS_LICENSE_MASTERY_NFY"},
+		{12564, L"CLASS_LICENSE_GAIN_NFY"},
+		{12576, L"FASHION_CONTENTS_NFY"},
+		{12578, L"FASHION_SHOW_CMD_NFY"},
+		{12580, L"FASHION_AUDITION_NFY"},
+		{12581, L"FASHION_AUDITION_SEASON_NFY"},
+		{12582, L"FASHION_AUDITION_BATTLE_START_NFY"},
+		{12594, L"CREW_MASTER_MANAGE_NFY"},
+		{12596, L"CREW_MEMBER_NFY"},
+		{12597, L"CREW_INFO_NFY"},
+		{12598, L"CREW_INTERACTION_LIST_NFY"},
+		{12608, L"QUEST_CLIENT_TASK_NFY"},
+		{12609, L"QUEST_ADD_NFY"},
+		{12612, L"QUEST_COMPLETE_NFY"},
+		{12615, L"QUEST_LIST_NFY"},
+		{12623, L"LOAD_QUEST_SEQUENCE_REWARD_NFY"},
+		{12626, L"STAGE_STATE_NFY"},
+		{12628, L"STAGE_REVIVAL_WAIT_NFY"},
+		{12629, L"STAGE_PLAYER_CONTENTS_NFY"},
+		{12630, L"STAGE_TEAM_INFO_NFY"},
+		{12631, L"LEVELDESIGN_START_NFY"},
+		{12632, L"LEVELDESIGN_END_NFY"},
+		{12633, L"STAGE_EVENT_NFY"},
+		{12634, L"STAGE_DATA_UPDATE_NFY"},
+		{12635, L"NPC_SKIN_NFY"},
+		{12641, L"EQUIP_ITEM_NFY"},
+		{12647, L"COSTUME_EQUIP_NFY"},
+		{12648, L"COSTUME_SNAP_NFY"},
+		{12650, L"MAGICSHOP_CONFIRM_NFY"},
+		{12657, L"QUEST_CHALLENGE_RANK_NFY"},
+		{12658, L"QUEST_CHALLENGE_SUBMIT_NFY"},
+		{12662, L"QUEST_CHALLENGE_SPOT_NFY"},
+		{12673, L"USER_PROFILE_NFY"},
+		{12674, L"USER_INTERACTION_DATA_NFY"},
+		{12675, L"USER_INTERACTION_NFY"},
+		{12677, L"USER_FRIEND_LIST_NFY"},
+		{12683, L"USER_GUESTBOOK_READ_NFY"},
+		{12684, L"USER_PROFILE_BLOCK_NFY"},
+		{12688, L"POSTMSG_LIST_NFY"},
+		{12689, L"POSTMSG_OPENED_LIST_NFY"},
+		{12690, L"POSTMSG_NEW_UNREAD_MSG_NFY"},
+		{12691, L"POSTMSG_NEW_READ_MSG_NFY"},
+		{12692, L"POSTMSG_RUNTIME_EXPIRED_NFY"},
+		{12784, L"ITEM_UPDATED_NFY"},
+		{12803, L"NPC_BODY_EQUIP_NFY"},
+		{12825, L"HANDOVER_STARTED"},
+		{12848, L"PROXY_ADD_NFY"},
+		{12849, L"PROXY_DEL_NFY"},
+		{12850, L"PROXY_UPDATE_NFY"},
+		{12883, L"CREW_SEND_TO_MASTER_CANCEL_JOIN_NFY"},
+		{12884, L"CREW_SEND_TO_USER_INVITE_NFY"},
+		{12885, L"CREW_SEND_TO_USER_CANCEL_INVITE_NFY"},
+		{12932, L"RANKING_PERSISTENT_TOP_RANKER_NFY"},
+		{12934, L"RANKING_SCORE_UPDATED_NFY"},
+		{13056, L"GM_COMMAND"},
+		{13057, L"GAME_MANAGEMENT_SERVICE_NFY"},
+		{13077, L"SPECTATING_STAGE_FINISHED_NFY"},
+		{13078, L"SPECTATING_DONATION_NFY"},
+		{13080, L"SPECTATING_STAGE_INFO_NFY"},
+		{13107, L"SHAREDQUEST_CONNECTED_NFY"},
+		{13108, L"SHAREDQUEST_DISCONNECTED_NFY"},
+		{13109, L"SHAREDQUEST_MEMBER_UPDATED_NFY"},
+		{13111, L"SHAREDQUEST_GOT_REWARDS_NFY"},
+		{13112, L"SHAREDQUEST_QUERY_MASSIVE_ARBEIT_NFY"},
+		{13115, L"SHAREDQUEST_SUPPORT_CONTRIBUTION_NFY"},
+		{13116, L"SHAREDQUEST_QUERY_USERDATA_NFY"},
+		{13117, L"SHAREDQUEST_MASSIVE_STAGE_START_NFY"},
+		{13118, L"SHAREDQUEST_MASSIVE_ARBEIT_CATEGORY_NFY"},
+		{13121, L"GLOBALNOTICE_UPDATE_NOTICES_NFY"},
+		{13137, L"USER_SAVE_NFY"},
+		{13152, L"TAG_COMPONENT_SYNCHRONIZE_NFY"},
+		{13153, L"CHAR_EVENT_MESSAGE_RECVED_NFY"},
+		{13154, L"ONEOFFPASS_LEVELUP_NFY"},
+		{28673, L"DUMMY_ACTION_REQ"},
+		{28675, L"GLOBAL_TIMESYSTEM_SYNC_REQ"},
+		{28676, L"DUMMY_REDIRECT_REQ"},
+		{28688, L"ENTER_WORLD_FRONT_END_LOBBY_REQ"},
+		{28689, L"LIST_CHARACTER_REQ"},
+		{28690, L"CREATE_CHARACTER_REQ"},
+		{28691, L"CHARACTER_AMENITY_REQ"},
+		{28693, L"CHANGE_CHARACTER_NICKNAME_REQ"},
+		{28695, L"ACCOUNT_WITHDRAW_REQ"},
+		{28698, L"IMAGE_UPLOAD_AUTH_REQ"},
+		{28700, L"CHANGE_WORLD_INSTANCE_REQ"},
+		{28704, L"ENTER_GAME_REQ"},
+		{28705, L"READY_TO_PLAY_REQ"},
+		{28709, L"WORLD_OBJ_STAT_REQ"},
+		{28719, L"USE_PORTAL_REQ"},
+		{28720, L"USER_SOCIAL_MOTION_REQ"},
+		{28722, L"USER_BUSY_STATE_REQ"},
+		{28737, L"CURRENCY_EXCHANGE_REQ"},
+		{28747, L"USE_PERIODIC_ITEM_REQ"},
+		{28754, L"JUMP_REQ"},
+		{28757, L"DASH_REQ"},
+		{28758, L"RESET_LOCATION_REQ"},
+		{28760, L"MOVE_SNAPSHOT_INIT_REQ"},
+		{28768, L"CHAT_REQ"},
+		{28770, L"CHAT_HISTORY_REQ"},
+		{28789, L"PALETTE_LIST_REQ"},
+		{28802, L"LIFEOBJ_INTERACTION_REQ"},
+		{28806, L"LIFEOBJ_MINIGAME_END_REQ"},
+		{28816, L"SKILL_USE_REQ"},
+		{28821, L"SKILL_CHARGE_START_REQ"},
+		{28822, L"SKILL_CHARGE_END_REQ"},
+		{28824, L"CHANGE_TO_PLAYABLE_STATE_REQ"},
 		{28832, L"TITLE_LIST_REQ"},
-		{45216, L"TITLE_LIST_ACK"},
 		{28833, L"TITLE_EQUIP_REQ"},
+		{28848, L"MATCH_MAKE_REQ"},
+		{28864, L"GALLERY_UPLOAD_REQ"},
+		{28865, L"GALLERY_LIST_REQ"},
+		{28866, L"GALLERY_FEEDBACK_REQ"},
+		{28867, L"GALLERY_USER_BLIND_REQ"},
+		{28868, L"GALLERY_GUESTBOOK_REQ"},
+		{28869, L"GALLERY_CMD_REQ"},
+		{28870, L"GALLERY_OWNER_CMD_REQ"},
+		{28931, L"USE_ITEM_REQ"},
+		{28932, L"CRAFT_EQUIP_ITEM_REQ"},
+		{28933, L"SHOP_ITEM_LIST_REQ"},
+		{28934, L"SHOP_ITEM_BUY_REQ"},
+		{28935, L"EMBLEM_EQUIP_REQ"},
+		{28937, L"SHOP_PAYMENT_RETRY_REQ"},
+		{28938, L"EQUIP_COLLECTION_REQ"},
+		{28939, L"SHOP_PAYMENT_PRECHECK_REQ"},
+		{28940, L"EXTRACT_SKIN_ITEM_REQ"},
+		{28941, L"EMBLEM_UNEQUIP_REQ"},
+		{28945, L"CLASS_CHANGE_REQ"},
+		{28960, L"FASHION_SHOW_INFO_REQ"},
+		{28961, L"FASHION_SHOW_JOIN_REQ"},
+		{28962, L"FASHION_SHOW_CMD_REQ"},
+		{28964, L"FASHION_AUDITION_REQ"},
+		{28966, L"FASHION_AUDITION_BATTLE_START_REQ"},
+		{28967, L"FASHION_AUDITION_BATTLE_END_REQ"},
+		{28968, L"FASHION_AUDITION_RANK_REQ"},
+		{28969, L"FASHION_AUDITION_RANKER_REQ"},
+		{28970, L"FASHION_SHOW_RANKING_REQ"},
+		{28976, L"CREW_CMD_REQ"},
+		{28977, L"CREW_MASTER_CONTENTS_CMD_REQ"},
+		{28978, L"CREW_MASTER_MANAGE_CMD_REQ"},
+		{28979, L"CREW_MEMBER_CMD_REQ"},
+		{28982, L"CREW_INTERACTION_LIST_REQ"},
+		{28994, L"QUEST_ACCEPT_REQ"},
+		{28995, L"QUEST_REWARD_REQ"},
+		{28997, L"QUEST_GIVEUP_REQ"},
+		{28998, L"QUEST_RUNTIME_ADD_REQ"},
+		{29000, L"QUEST_CLIENT_TASK_COMPLETE_REQ"},
+		{29001, L"QUEST_RUNTIME_LIST_REQ"},
+		{29004, L"QUEST_REWARD_SELECTABLE_REQ"},
+		{29006, L"QUEST_MANUAL_RETRY_REQ"},
+		{29009, L"STAGE_START_REQ"},
+		{29011, L"STAGE_LEAVE_REQ"},
+		{29024, L"EQUIP_ITEM_REQ"},
+		{29026, L"CARVE_ITEM_REQ"},
+		{29027, L"COSTUME_EQUIP_ITEM_REQ"},
+		{29028, L"COSTUME_CUSTOMIZE_REQ"},
+		{29029, L"COSTUME_PRESET_SET_REQ"},
+		{29030, L"COSTUME_PRESET_QUICK_CHANGE_REQ"},
+		{29032, L"COSTUME_SNAP_REQ"},
+		{29033, L"COSTUME_LIST_REQ"},
+		{29034, L"MAGICSHOP_CONFIRM_REQ"},
+		{29035, L"PIGMENT_CRAFT_REQ"},
+		{29036, L"COSTUME_PRESET_PURCHASE_REQ"},
+		{29040, L"QUEST_CHALLENGE_EXCHANGE_REQ"},
+		{29041, L"QUEST_CHALLENGE_RANK_REQ"},
+		{29042, L"QUEST_CHALLENGE_SUBMIT_REQ"},
+		{29043, L"QUEST_CHALLENGE_MYINFO_REQ"},
+		{29044, L"QUEST_CHALLENGE_CEREMONY_REQ"},
+		{29045, L"QUEST_CHALLENGE_RANKER_REQ"},
+		{29056, L"USER_GROUP_REQ"},
+		{29057, L"USER_PROFILE_REQ"},
+		{29059, L"USER_INTERACTION_REQ"},
+		{29060, L"USER_FRIEND_ADD_REQ"},
+		{29064, L"USER_PROFILE_EDIT_REQ"},
+		{29065, L"USER_FRIEND_CONTENTS_REQ"},
+		{29066, L"USER_GUESTBOOK_REQ"},
+		{29067, L"USER_GUESTBOOK_READ_REQ"},
+		{29068, L"USER_PROFILE_BLOCK_REQ"},
+		{29069, L"USER_PROFILE_BLOCK_LIST_REQ"},
+		{29070, L"USER_PROFILE_REPORT_REQ"},
+		{29072, L"POSTMSG_LIST_REQ"},
+		{29073, L"POSTMSG_OPENED_LIST_REQ"},
+		{29077, L"POSTMSG_ACTION_REQ"},
+		{29169, L"UPGRADE_ITEM_REQ"},
+		{29171, L"UPGRADE_TRANSCENDENCE_ITEM_REQ"},
+		{29172, L"UPGRADE_EMBLEM_REQ"},
+		{29173, L"UPGRADE_EMBLEM_TRANSCENDENCE_REQ"},
+		{29174, L"ASSEMBLE_EMBLEM_PIECE_REQ"},
+		{29175, L"UPDATE_ITEM_ATTRIBUTE_REQ"},
+		{29184, L"NPC_INTERACTION_REQ"},
+		{29185, L"NPC_PROFILE_UPDATE_REQ"},
+		{29186, L"MONSTER_INTERACTION_REQ"},
+		{29187, L"NPC_BODY_EQUIP_REQ"},
+		{29209, L"HANDOVER_REQ"},
+		{29216, L"DEBUG_LOCATION_REQ"},
+		{29217, L"DEBUG_VOXEL_REQ"},
+		{29220, L"DEBUG_USER_LOG_REQ"},
+		{29234, L"PROXY_UPDATE_REQ"},
+		{29235, L"PROXY_COMPLETE_REQ"},
+		{29248, L"CREW_CMD_LIST_REQ"},
+		{29249, L"CREW_CMD_CREATE_REQ"},
+		{29250, L"CREW_CMD_SIGN_UP_REQ"},
+		{29251, L"CREW_CMD_SIGN_OUT_REQ"},
+		{29252, L"CREW_CMD_SEARCH_REQ"},
+		{29253, L"CREW_CMD_INVITE_CANCEL_REQ"},
+		{29254, L"CREW_CMD_APPLY_CANCEL_REQ"},
+		{29255, L"CREW_MASTER_CMD_NOTICE_REQ"},
+		{29256, L"CREW_MASTER_CMD_DESC_REQ"},
+		{29257, L"CREW_MASTER_CMD_APPROVAL_REQ"},
+		{29258, L"CREW_MASTER_CMD_IMAGE_REQ"},
+		{29259, L"CREW_MASTER_MANAGE_CMD_EXPEL_REQ"},
+		{29260, L"CREW_MASTER_MANAGE_CMD_APPLY_REQ"},
+		{29261, L"CREW_MASTER_MANAGE_CMD_APPLY_CANCEL_REQ"},
+		{29262, L"CREW_MASTER_MANAGE_CMD_INVITE_REQ"},
+		{29263, L"CREW_MASTER_MANAGE_CMD_INVITE_CANCEL_REQ"},
+		{29264, L"CREW_MEMBER_CMD_INFO_REQ"},
+		{29265, L"CREW_MEMBER_CMD_WARP_REQ"},
+		{29266, L"CREW_DISPLAY_DATA_REQ"},
+		{29312, L"RANKING_MINE_REQ"},
+		{29313, L"RANKING_LIST_REQ"},
+		{29314, L"RANKING_PERSISTENT_MINE_REQ"},
+		{29315, L"RANKING_PERSISTENT_LIST_REQ"},
+		{29317, L"RANKING_QUALIFIER_SCORE_REQ"},
+		{29440, L"GM_COMMAND_REQ"},
+		{29457, L"SPECTATING_STOP_REQ"},
+		{29460, L"SPECTATING_READY_REQ"},
+		{29462, L"SPECTATING_DONATION_REQ"},
+		{29463, L"SPECTATING_ENQUEUE_AS_TYPE_REQ"},
+		{29464, L"SPECTATING_STAGE_INFO_REQ"},
+		{29465, L"SPECTATING_ENQUEUE_RESIGN_REQ"},
+		{29468, L"CHAMPIONSHIP_RANKING_REQ"},
+		{29472, L"SKILLTREE_UPGRADE_REQ"},
+		{29473, L"SKILLTREE_EQUIP_REQ"},
+		{29474, L"SKILLTREE_RESET_REQ"},
+		{29489, L"SHAREDQUEST_REQUEST_HELP_REQ"},
+		{29496, L"SHAREDQUEST_QUERY_MASSIVE_ARBEIT_REQ"},
+		{29497, L"SHAREDQUEST_MASSIVE_JOIN_REQ"},
+		{29498, L"SHAREDQUEST_MASSIVE_LEAVE_REQ"},
+		{29500, L"SHAREDQUEST_QUERY_USERDATA_REQ"},
+		{29502, L"CALLRPC_REQ"},
+		{29504, L"GLOBALNOTICE_INIT_NOTICES_REQ"},
+		{29505, L"GLOBALNOTICE_GET_NOTICE_INFO_REQ"},
+		{29520, L"COUPON_EXCHANGE_REQ"},
+		{29521, L"USER_SAVE_REQ"},
+		{29523, L"OTHERUSER_SCREENSHOT_REQ"},
+		{29537, L"CHAR_EVENT_MESSAGE_RECVED_REQ"},
+		{45057, L"DUMMY_ACTION_ACK"},
+		{45059, L"GLOBAL_TIMESYSTEM_SYNC_ACK"},
+		{45060, L"DUMMY_REDIRECT_ACK"},
+		{45072, L"ENTER_WORLD_FRONT_END_LOBBY_ACK"},
+		{45073, L"LIST_CHARACTER_ACK"},
+		{45074, L"CREATE_CHARACTER_ACK"},
+		{45075, L"CHARACTER_AMENITY_ACK"},
+		{45077, L"CHANGE_CHARACTER_NICKNAME_ACK"},
+		{45079, L"ACCOUNT_WITHDRAW_ACK"},
+		{45082, L"IMAGE_UPLOAD_AUTH_ACK"},
+		{45083, L"TRANSLATE_AUTH_NFY"},
+		{45084, L"CHANGE_WORLD_INSTANCE_ACK"},
+		{45088, L"ENTER_GAME_ACK"},
+		{45089, L"READY_TO_PLAY_ACK"},
+		{45093, L"WORLD_OBJ_STAT_ACK"},
+		{45103, L"USE_PORTAL_ACK"},
+		{45104, L"USER_SOCIAL_MOTION_ACK"},
+		{45121, L"CURRENCY_EXCHANGE_ACK"},
+		{45131, L"USE_PERIODIC_ITEM_ACK"},
+		{45136, L"MOVE_ACK"},
+		{45137, L"MOVE_TO_ACK"},
+		{45138, L"JUMP_ACK"},
+		{45141, L"DASH_ACK"},
+		{45142, L"RESET_LOCATION_ACK"},
+		{45144, L"MOVE_SNAPSHOT_INIT_ACK"},
+		{45152, L"CHAT_ACK"},
+		{45154, L"CHAT_HISTORY_ACK"},
+		{45173, L"PALETTE_LIST_ACK"},
+		{45186, L"LIFEOBJ_INTERACTION_ACK"},
+		{45190, L"LIFEOBJ_MINIGAME_END_ACK"},
+		{45200, L"SKILL_USE_ACK"},
+		{45205, L"SKILL_CHARGE_START_ACK"},
+		{45206, L"SKILL_CHARGE_END_ACK"},
+		{45208, L"CHANGE_TO_PLAYABLE_STATE_ACK"},
+		{45216, L"TITLE_LIST_ACK"},
 		{45217, L"TITLE_EQUIP_ACK"},
-		{12450, L"TITLE_ADD_NFY"},
-		{12451, L"TITLE_OWNERSHIP_NFY"},
-		{28848, L"MATCH_MAKE_REQ"},
 		{45232, L"MATCH_MAKE_ACK"},
-		{12464, L"MATCH_MAKE_NFY"},
-		{28864, L"GALLERY_UPLOAD_REQ"},
 		{45248, L"GALLERY_UPLOAD_ACK"},
-		{28865, L"GALLERY_LIST_REQ"},
 		{45249, L"GALLERY_LIST_ACK"},
-		{28866, L"GALLERY_FEEDBACK_REQ"},
 		{45250, L"GALLERY_FEEDBACK_ACK"},
-		{12482, L"GALLERY_FEEDBACK_NFY"},
-		{28867, L"GALLERY_USER_BLIND_REQ"},
 		{45251, L"GALLERY_USER_BLIND_ACK"},
-		{28868, L"GALLERY_GUESTBOOK_REQ"},
 		{45252, L"GALLERY_GUESTBOOK_ACK"},
-		{28869, L"GALLERY_CMD_REQ"},
 		{45253, L"GALLERY_CMD_ACK"},
-		{28870, L"GALLERY_OWNER_CMD_REQ"},
 		{45254, L"GALLERY_OWNER_CMD_ACK"},
-		{12784, L"ITEM_UPDATED_NFY"},
-		{29169, L"UPGRADE_ITEM_REQ"},
-		{45553, L"UPGRADE_ITEM_ACK"},
-		{29171, L"UPGRADE_TRANSCENDENCE_ITEM_REQ"},
-		{45555, L"UPGRADE_TRANSCENDENCE_ITEM_ACK"},
-		{29172, L"UPGRADE_EMBLEM_REQ"},
-		{45556, L"UPGRADE_EMBLEM_ACK"},
-		{29173, L"UPGRADE_EMBLEM_TRANSCENDENCE_REQ"},
-		{45557, L"UPGRADE_EMBLEM_TRANSCENDENCE_ACK"},
-		{29174, L"ASSEMBLE_EMBLEM_PIECE_REQ"},
-		{45558, L"ASSEMBLE_EMBLEM_PIECE_ACK"},
-		{29175, L"UPDATE_ITEM_ATTRIBUTE_REQ"},
-		{45559, L"UPDATE_ITEM_ATTRIBUTE_ACK"},
-		{28931, L"USE_ITEM_REQ"},
 		{45315, L"USE_ITEM_ACK"},
-		{28932, L"CRAFT_EQUIP_ITEM_REQ"},
 		{45316, L"CRAFT_EQUIP_ITEM_ACK"},
-		{28933, L"SHOP_ITEM_LIST_REQ"},
 		{45317, L"SHOP_ITEM_LIST_ACK"},
-		{12549, L"SHOP_ITEM_LIST_NFY"},
-		{28934, L"SHOP_ITEM_BUY_REQ"},
 		{45318, L"SHOP_ITEM_BUY_ACK"},
-		{28935, L"EMBLEM_EQUIP_REQ"},
 		{45319, L"EMBLEM_EQUIP_ACK"},
-		{12551, L"EMBLEM_EQUIP_NFY"},
-		{12552, L"REWARD_NFY"},
-		{28937, L"SHOP_PAYMENT_RETRY_REQ"},
 		{45321, L"SHOP_PAYMENT_RETRY_ACK"},
-		{28938, L"EQUIP_COLLECTION_REQ"},
-		{28939, L"SHOP_PAYMENT_PRECHECK_REQ"},
+		{45322, L"EQUIP_COLLECTION_ACK"},
 		{45323, L"SHOP_PAYMENT_PRECHECK_ACK"},
-		{28940, L"EXTRACT_SKIN_ITEM_REQ"},
 		{45324, L"EXTRACT_SKIN_ITEM_ACK"},
-		{28941, L"EMBLEM_UNEQUIP_REQ"},
 		{45325, L"EMBLEM_UNEQUIP_ACK"},
-		{28938, L"EQUIP_COLLECTION_REQ"},
-		{45322, L"EQUIP_COLLECTION_ACK"},
-		{28939, L"SHOP_PAYMENT_PRECHECK_REQ"},
-		{12560, L"CLASS_UPDATE_NFY"},
-		{28945, L"CLASS_CHANGE_REQ"},
 		{45329, L"CLASS_CHANGE_ACK"},
-		{12562, L"CLASS_SKILL_UPDATE_NFY"},
-		{12563, L"CLASS_LICENSE_MASTERY_NFY"},
-		{12564, L"CLASS_LICENSE_GAIN_NFY"},
-		{28960, L"FASHION_SHOW_INFO_REQ"},
 		{45344, L"FASHION_SHOW_INFO_ACK"},
-		{12576, L"FASHION_CONTENTS_NFY"},
-		{28961, L"FASHION_SHOW_JOIN_REQ"},
 		{45345, L"FASHION_SHOW_JOIN_ACK"},
-		{28962, L"FASHION_SHOW_CMD_REQ"},
 		{45346, L"FASHION_SHOW_CMD_ACK"},
-		{12578, L"FASHION_SHOW_CMD_NFY"},
-		{28964, L"FASHION_AUDITION_REQ"},
 		{45348, L"FASHION_AUDITION_ACK"},
-		{12580, L"FASHION_AUDITION_NFY"},
-		{12581, L"FASHION_AUDITION_SEASON_NFY"},
-		{28966, L"FASHION_AUDITION_BATTLE_START_REQ"},
 		{45350, L"FASHION_AUDITION_BATTLE_START_ACK"},
-		{12582, L"FASHION_AUDITION_BATTLE_START_NFY"},
-		{28967, L"FASHION_AUDITION_BATTLE_END_REQ"},
 		{45351, L"FASHION_AUDITION_BATTLE_END_ACK"},
-		{28968, L"FASHION_AUDITION_RANK_REQ"},
 		{45352, L"FASHION_AUDITION_RANK_ACK"},
-		{28969, L"FASHION_AUDITION_RANKER_REQ"},
 		{45353, L"FASHION_AUDITION_RANKER_ACK"},
-		{28970, L"FASHION_SHOW_RANKING_REQ"},
 		{45354, L"FASHION_SHOW_RANKING_ACK"},
-		{28976, L"CREW_CMD_REQ"},
 		{45360, L"CREW_CMD_ACK"},
-		{28977, L"CREW_MASTER_CONTENTS_CMD_REQ"},
 		{45361, L"CREW_MASTER_CONTENTS_CMD_ACK"},
-		{28978, L"CREW_MASTER_MANAGE_CMD_REQ"},
 		{45362, L"CREW_MASTER_MANAGE_CMD_ACK"},
-		{12594, L"CREW_MASTER_MANAGE_NFY"},
-		{28979, L"CREW_MEMBER_CMD_REQ"},
 		{45363, L"CREW_MEMBER_CMD_ACK"},
-		{12596, L"CREW_MEMBER_NFY"},
-		{12597, L"CREW_INFO_NFY"},
-		{28982, L"CREW_INTERACTION_LIST_REQ"},
 		{45366, L"CREW_INTERACTION_LIST_ACK"},
-		{12598, L"CREW_INTERACTION_LIST_NFY"},
-		{12608, L"QUEST_CLIENT_TASK_NFY"},
-		{12609, L"QUEST_ADD_NFY"},
-		{28994, L"QUEST_ACCEPT_REQ"},
 		{45378, L"QUEST_ACCEPT_ACK"},
-		{28995, L"QUEST_REWARD_REQ"},
 		{45379, L"QUEST_REWARD_ACK"},
-		{12612, L"QUEST_COMPLETE_NFY"},
-		{28997, L"QUEST_GIVEUP_REQ"},
 		{45381, L"QUEST_GIVEUP_ACK"},
-		{28998, L"QUEST_RUNTIME_ADD_REQ"},
 		{45382, L"QUEST_RUNTIME_ADD_ACK"},
-		{12615, L"QUEST_LIST_NFY"},
-		{29000, L"QUEST_CLIENT_TASK_COMPLETE_REQ"},
 		{45384, L"QUEST_CLIENT_TASK_COMPLETE_ACK"},
-		{29001, L"QUEST_RUNTIME_LIST_REQ"},
 		{45385, L"QUEST_RUNTIME_LIST_ACK"},
 		{45387, L"QUEST_RUNTIME_LIST_NFY"},
-		{29004, L"QUEST_REWARD_SELECTABLE_REQ"},
 		{45388, L"QUEST_REWARD_SELECTABLE_ACK"},
 		{45389, L"QUEST_TEAM_INFO_NFY"},
-		{29006, L"QUEST_MANUAL_RETRY_REQ"},
 		{45390, L"QUEST_MANUAL_RETRY_ACK"},
-		{12623, L"LOAD_QUEST_SEQUENCE_REWARD_NFY"},
-		{29009, L"STAGE_START_REQ"},
 		{45393, L"STAGE_START_ACK"},
-		{12626, L"STAGE_STATE_NFY"},
-		{29011, L"STAGE_LEAVE_REQ"},
 		{45395, L"STAGE_LEAVE_ACK"},
-		{12628, L"STAGE_REVIVAL_WAIT_NFY"},
-		{12629, L"STAGE_PLAYER_CONTENTS_NFY"},
-		{12630, L"STAGE_TEAM_INFO_NFY"},
-		{12631, L"LEVELDESIGN_START_NFY"},
-		{12632, L"LEVELDESIGN_END_NFY"},
-		{12633, L"STAGE_EVENT_NFY"},
-		{12634, L"STAGE_DATA_UPDATE_NFY"},
-		{12635, L"NPC_SKIN_NFY"},
-		{29024, L"EQUIP_ITEM_REQ"},
 		{45408, L"EQUIP_ITEM_ACK"},
-		{12641, L"EQUIP_ITEM_NFY"},
-		{29026, L"CARVE_ITEM_REQ"},
 		{45410, L"CARVE_ITEM_ACK"},
-		{29027, L"COSTUME_EQUIP_ITEM_REQ"},
 		{45411, L"COSTUME_EQUIP_ITEM_ACK"},
-		{29028, L"COSTUME_CUSTOMIZE_REQ"},
 		{45412, L"COSTUME_CUSTOMIZE_ACK"},
-		{29029, L"COSTUME_PRESET_SET_REQ"},
 		{45413, L"COSTUME_PRESET_SET_ACK"},
-		{29030, L"COSTUME_PRESET_QUICK_CHANGE_REQ"},
 		{45414, L"COSTUME_PRESET_QUICK_CHANGE_ACK"},
-		{12647, L"COSTUME_EQUIP_NFY"},
-		{29032, L"COSTUME_SNAP_REQ"},
 		{45416, L"COSTUME_SNAP_ACK"},
-		{12648, L"COSTUME_SNAP_NFY"},
-		{29033, L"COSTUME_LIST_REQ"},
 		{45417, L"COSTUME_LIST_ACK"},
-		{29034, L"MAGICSHOP_CONFIRM_REQ"},
 		{45418, L"MAGICSHOP_CONFIRM_ACK"},
-		{12650, L"MAGICSHOP_CONFIRM_NFY"},
-		{29035, L"PIGMENT_CRAFT_REQ"},
 		{45419, L"PIGMENT_CRAFT_ACK"},
-		{29036, L"COSTUME_PRESET_PURCHASE_REQ"},
 		{45420, L"COSTUME_PRESET_PURCHASE_ACK"},
-		{29040, L"QUEST_CHALLENGE_EXCHANGE_REQ"},
 		{45424, L"QUEST_CHALLENGE_EXCHANGE_ACK"},
-		{29041, L"QUEST_CHALLENGE_RANK_REQ"},
 		{45425, L"QUEST_CHALLENGE_RANK_ACK"},
-		{12657, L"QUEST_CHALLENGE_RANK_NFY"},
-		{29042, L"QUEST_CHALLENGE_SUBMIT_REQ"},
 		{45426, L"QUEST_CHALLENGE_SUBMIT_ACK"},
-		{12658, L"QUEST_CHALLENGE_SUBMIT_NFY"},
-		{29043, L"QUEST_CHALLENGE_MYINFO_REQ"},
 		{45427, L"QUEST_CHALLENGE_MYINFO_ACK"},
-		{29044, L"QUEST_CHALLENGE_CEREMONY_REQ"},
 		{45428, L"QUEST_CHALLENGE_CEREMONY_ACK"},
-		{29045, L"QUEST_CHALLENGE_RANKER_REQ"},
 		{45429, L"QUEST_CHALLENGE_RANKER_ACK"},
-		{12662, L"QUEST_CHALLENGE_SPOT_NFY"},
-		{29056, L"USER_GROUP_REQ"},
 		{45440, L"USER_GROUP_ACK"},
-		{29057, L"USER_PROFILE_REQ"},
 		{45441, L"USER_PROFILE_ACK"},
-		{12673, L"USER_PROFILE_NFY"},
-		{12674, L"USER_INTERACTION_DATA_NFY"},
-		{29059, L"USER_INTERACTION_REQ"},
 		{45443, L"USER_INTERACTION_ACK"},
-		{12675, L"USER_INTERACTION_NFY"},
-		{29060, L"USER_FRIEND_ADD_REQ"},
 		{45444, L"USER_FRIEND_ADD_ACK"},
-		{12677, L"USER_FRIEND_LIST_NFY"},
-		{29064, L"USER_PROFILE_EDIT_REQ"},
 		{45448, L"USER_PROFILE_EDIT_ACK"},
-		{29065, L"USER_FRIEND_CONTENTS_REQ"},
 		{45449, L"USER_FRIEND_CONTENTS_ACK"},
-		{29066, L"USER_GUESTBOOK_REQ"},
 		{45450, L"USER_GUESTBOOK_ACK"},
-		{29067, L"USER_GUESTBOOK_READ_REQ"},
 		{45451, L"USER_GUESTBOOK_READ_ACK"},
-		{12683, L"USER_GUESTBOOK_READ_NFY"},
-		{29068, L"USER_PROFILE_BLOCK_REQ"},
 		{45452, L"USER_PROFILE_BLOCK_ACK"},
-		{12684, L"USER_PROFILE_BLOCK_NFY"},
-		{29069, L"USER_PROFILE_BLOCK_LIST_REQ"},
 		{45453, L"USER_PROFILE_BLOCK_LIST_ACK"},
-		{29070, L"USER_PROFILE_REPORT_REQ"},
 		{45454, L"USER_PROFILE_REPORT_ACK"},
-		{29072, L"POSTMSG_LIST_REQ"},
 		{45456, L"POSTMSG_LIST_ACK"},
-		{12688, L"POSTMSG_LIST_NFY"},
-		{29073, L"POSTMSG_OPENED_LIST_REQ"},
 		{45457, L"POSTMSG_OPENED_LIST_ACK"},
-		{12689, L"POSTMSG_OPENED_LIST_NFY"},
-		{12690, L"POSTMSG_NEW_UNREAD_MSG_NFY"},
-		{12691, L"POSTMSG_NEW_READ_MSG_NFY"},
-		{12692, L"POSTMSG_RUNTIME_EXPIRED_NFY"},
-		{29077, L"POSTMSG_ACTION_REQ"},
 		{45461, L"POSTMSG_ACTION_ACK"},
-		{29184, L"NPC_INTERACTION_REQ"},
+		{45553, L"UPGRADE_ITEM_ACK"},
+		{45555, L"UPGRADE_TRANSCENDENCE_ITEM_ACK"},
+		{45556, L"UPGRADE_EMBLEM_ACK"},
+		{45557, L"UPGRADE_EMBLEM_TRANSCENDENCE_ACK"},
+		{45558, L"ASSEMBLE_EMBLEM_PIECE_ACK"},
+		{45559, L"UPDATE_ITEM_ATTRIBUTE_ACK"},
 		{45568, L"NPC_INTERACTION_ACK"},
-		{29185, L"NPC_PROFILE_UPDATE_REQ"},
 		{45569, L"NPC_PROFILE_UPDATE_ACK"},
-		{29186, L"MONSTER_INTERACTION_REQ"},
 		{45570, L"MONSTER_INTERACTION_ACK"},
-		{29187, L"NPC_BODY_EQUIP_REQ"},
 		{45571, L"NPC_BODY_EQUIP_ACK"},
-		{12803, L"NPC_BODY_EQUIP_NFY"},
-		{29209, L"HANDOVER_REQ"},
 		{45593, L"HANDOVER_ACK"},
-		{12825, L"HANDOVER_STARTED"},
-		{29216, L"DEBUG_LOCATION_REQ"},
 		{45600, L"DEBUG_LOCATION_ACK"},
-		{29217, L"DEBUG_VOXEL_REQ"},
 		{45601, L"DEBUG_VOXEL_ACK"},
-		{29220, L"DEBUG_USER_LOG_REQ"},
 		{45604, L"DEBUG_USER_LOG_ACK"},
-		{12848, L"PROXY_ADD_NFY"},
-		{12849, L"PROXY_DEL_NFY"},
-		{12850, L"PROXY_UPDATE_NFY"},
-		{29234, L"PROXY_UPDATE_REQ"},
 		{45618, L"PROXY_UPDATE_ACK"},
-		{29235, L"PROXY_COMPLETE_REQ"},
 		{45619, L"PROXY_COMPLETE_ACK"},
-		{29248, L"CREW_CMD_LIST_REQ"},
 		{45632, L"CREW_CMD_LIST_ACK"},
-		{29249, L"CREW_CMD_CREATE_REQ"},
 		{45633, L"CREW_CMD_CREATE_ACK"},
-		{29250, L"CREW_CMD_SIGN_UP_REQ"},
 		{45634, L"CREW_CMD_SIGN_UP_ACK"},
-		{29251, L"CREW_CMD_SIGN_OUT_REQ"},
 		{45635, L"CREW_CMD_SIGN_OUT_ACK"},
-		{29252, L"CREW_CMD_SEARCH_REQ"},
 		{45636, L"CREW_CMD_SEARCH_ACK"},
-		{29253, L"CREW_CMD_INVITE_CANCEL_REQ"},
 		{45637, L"CREW_CMD_INVITE_CANCEL_ACK"},
-		{29254, L"CREW_CMD_APPLY_CANCEL_REQ"},
 		{45638, L"CREW_CMD_APPLY_CANCEL_ACK"},
-		{29255, L"CREW_MASTER_CMD_NOTICE_REQ"},
 		{45639, L"CREW_MASTER_CMD_NOTICE_ACK"},
-		{29256, L"CREW_MASTER_CMD_DESC_REQ"},
 		{45640, L"CREW_MASTER_CMD_DESC_ACK"},
-		{29257, L"CREW_MASTER_CMD_APPROVAL_REQ"},
 		{45641, L"CREW_MASTER_CMD_APPROVAL_ACK"},
-		{29258, L"CREW_MASTER_CMD_IMAGE_REQ"},
 		{45642, L"CREW_MASTER_CMD_IMAGE_ACK"},
-		{29259, L"CREW_MASTER_MANAGE_CMD_EXPEL_REQ"},
 		{45643, L"CREW_MASTER_MANAGE_CMD_EXPEL_ACK"},
-		{29260, L"CREW_MASTER_MANAGE_CMD_APPLY_REQ"},
 		{45644, L"CREW_MASTER_MANAGE_CMD_APPLY_ACK"},
-		{29261, L"CREW_MASTER_MANAGE_CMD_APPLY_CANCEL_REQ"},
 		{45645, L"CREW_MASTER_MANAGE_CMD_APPLY_CANCEL_ACK"},
-		{29262, L"CREW_MASTER_MANAGE_CMD_INVITE_REQ"},
 		{45646, L"CREW_MASTER_MANAGE_CMD_INVITE_ACK"},
-		{29263, L"CREW_MASTER_MANAGE_CMD_INVITE_CANCEL_REQ"},
 		{45647, L"CREW_MASTER_MANAGE_CMD_INVITE_CANCEL_ACK"},
-		{29264, L"CREW_MEMBER_CMD_INFO_REQ"},
 		{45648, L"CREW_MEMBER_CMD_INFO_ACK"},
-		{29265, L"CREW_MEMBER_CMD_WARP_REQ"},
 		{45649, L"CREW_MEMBER_CMD_WARP_ACK"},
-		{29266, L"CREW_DISPLAY_DATA_REQ"},
 		{45650, L"CREW_DISPLAY_DATA_ACK"},
-		{12883, L"CREW_SEND_TO_MASTER_CANCEL_JOIN_NFY"},
-		{12884, L"CREW_SEND_TO_USER_INVITE_NFY"},
-		{12885, L"CREW_SEND_TO_USER_CANCEL_INVITE_NFY"},
-		{29312, L"RANKING_MINE_REQ"},
 		{45696, L"RANKING_MINE_ACK"},
-		{29313, L"RANKING_LIST_REQ"},
 		{45697, L"RANKING_LIST_ACK"},
-		{29314, L"RANKING_PERSISTENT_MINE_REQ"},
 		{45698, L"RANKING_PERSISTENT_MINE_ACK"},
-		{29315, L"RANKING_PERSISTENT_LIST_REQ"},
 		{45699, L"RANKING_PERSISTENT_LIST_ACK"},
-		{12932, L"RANKING_PERSISTENT_TOP_RANKER_NFY"},
-		{29317, L"RANKING_QUALIFIER_SCORE_REQ"},
 		{45701, L"RANKING_QUALIFIER_SCORE_ACK"},
-		{12934, L"RANKING_SCORE_UPDATED_NFY"},
-		{29440, L"GM_COMMAND_REQ"},
 		{45824, L"GM_COMMAND_ACK"},
-		{13056, L"GM_COMMAND"},
-		{13057, L"GAME_MANAGEMENT_SERVICE_NFY"},
-		{29457, L"SPECTATING_STOP_REQ"},
 		{45841, L"SPECTATING_STOP_ACK"},
-		{29460, L"SPECTATING_READY_REQ"},
 		{45844, L"SPECTATING_READY_ACK"},
-		{13077, L"SPECTATING_STAGE_FINISHED_NFY"},
-		{29462, L"SPECTATING_DONATION_REQ"},
 		{45846, L"SPECTATING_DONATION_ACK"},
-		{13078, L"SPECTATING_DONATION_NFY"},
-		{29463, L"SPECTATING_ENQUEUE_AS_TYPE_REQ"},
 		{45847, L"SPECTATING_ENQUEUE_AS_TYPE_ACK"},
-		{29464, L"SPECTATING_STAGE_INFO_REQ"},
 		{45848, L"SPECTATING_STAGE_INFO_ACK"},
-		{13080, L"SPECTATING_STAGE_INFO_NFY"},
-		{29465, L"SPECTATING_ENQUEUE_RESIGN_REQ"},
 		{45849, L"SPECTATING_ENQUEUE_RESIGN_ACK"},
-		{29468, L"CHAMPIONSHIP_RANKING_REQ"},
 		{45852, L"CHAMPIONSHIP_RANKING_ACK"},
-		{29472, L"SKILLTREE_UPGRADE_REQ"},
 		{45856, L"SKILLTREE_UPGRADE_ACK"},
-		{29473, L"SKILLTREE_EQUIP_REQ"},
 		{45857, L"SKILLTREE_EQUIP_ACK"},
-		{29474, L"SKILLTREE_RESET_REQ"},
 		{45858, L"SKILLTREE_RESET_ACK"},
-		{29489, L"SHAREDQUEST_REQUEST_HELP_REQ"},
 		{45873, L"SHAREDQUEST_REQUEST_HELP_ACK"},
-		{13107, L"SHAREDQUEST_CONNECTED_NFY"},
-		{13108, L"SHAREDQUEST_DISCONNECTED_NFY"},
-		{13109, L"SHAREDQUEST_MEMBER_UPDATED_NFY"},
-		{13111, L"SHAREDQUEST_GOT_REWARDS_NFY"},
-		{29496, L"SHAREDQUEST_QUERY_MASSIVE_ARBEIT_REQ"},
 		{45880, L"SHAREDQUEST_QUERY_MASSIVE_ARBEIT_ACK"},
-		{13112, L"SHAREDQUEST_QUERY_MASSIVE_ARBEIT_NFY"},
-		{29497, L"SHAREDQUEST_MASSIVE_JOIN_REQ"},
 		{45881, L"SHAREDQUEST_MASSIVE_JOIN_ACK"},
-		{29498, L"SHAREDQUEST_MASSIVE_LEAVE_REQ"},
 		{45882, L"SHAREDQUEST_MASSIVE_LEAVE_ACK"},
-		{13115, L"SHAREDQUEST_SUPPORT_CONTRIBUTION_NFY"},
-		{29500, L"SHAREDQUEST_QUERY_USERDATA_REQ"},
 		{45884, L"SHAREDQUEST_QUERY_USERDATA_ACK"},
-		{13116, L"SHAREDQUEST_QUERY_USERDATA_NFY"},
-		{13117, L"SHAREDQUEST_MASSIVE_STAGE_START_NFY"},
-		{13118, L"SHAREDQUEST_MASSIVE_ARBEIT_CATEGORY_NFY"},
-		{29502, L"CALLRPC_REQ"},
 		{45886, L"CALLRPC_ACK"},
-		{29504, L"GLOBALNOTICE_INIT_NOTICES_REQ"},
 		{45888, L"GLOBALNOTICE_INIT_NOTICES_ACK"},
-		{29505, L"GLOBALNOTICE_GET_NOTICE_INFO_REQ"},
 		{45889, L"GLOBALNOTICE_GET_NOTICE_INFO_ACK"},
-		{13121, L"GLOBALNOTICE_UPDATE_NOTICES_NFY"},
-		{29520, L"COUPON_EXCHANGE_REQ"},
 		{45904, L"COUPON_EXCHANGE_ACK"},
-		{29521, L"USER_SAVE_REQ"},
 		{45905, L"USER_SAVE_ACK"},
-		{13137, L"USER_SAVE_NFY"},
-		{29523, L"OTHERUSER_SCREENSHOT_REQ"},
 		{45907, L"OTHERUSER_SCREENSHOT_ACK"},
-		{13152, L"TAG_COMPONENT_SYNCHRONIZE_NFY"},
-		{29537, L"CHAR_EVENT_MESSAGE_RECVED_REQ"},
 		{45921, L"CHAR_EVENT_MESSAGE_RECVED_ACK"},
-		{13153, L"CHAR_EVENT_MESSAGE_RECVED_NFY"},
-		{13154, L"ONEOFFPASS_LEVELUP_NFY"},
 	};
 
-	inline std::wstring& GetProtocolName(msgid_t msgID)
+	// framework messages, kept apart so content indices stay dense
+	inline constexpr ProtocolName FrameworkProtocolNames[] =
+	{
+		{8193, L"FRAMEWORKMSG_SETUP_CORD"},
+		{8197, L"FRAMEWORKMSG_DISCONTINUE_SESSION"},
+		{8200, L"FRAMEWORKMSG_IMMIGRATION_WORLD"},
+		{8201, L"FRAMEWORKMSG_IMMIGRATION_COMPLETED"},
+		{8204, L"FRAMEWORKMSG_SYNC_ADDITIONALDATA_NFY"},
+		{8210, L"FRAMEWORKMSG_SECURITY_ERROR"},
+		{8449, L"FRAMEWORKMSG_RELAY_CLIENT_SINGLE"},
+		{8450, L"FRAMEWORKMSG_RELAY_CLIENT_MULTI"},
+		{8454, L"FRAMEWORKMSG_DISCONNECTED"},
+		{8464, L"FRAMEWORKMSG_ENTER_GROUP"},
+		{8465, L"FRAMEWORKMSG_LEAVE_GROUP"},
+		{8466, L"FRAMEWORKMSG_MIGRATE_GROUP"},
+		{8467, L"FRAMEWORKMSG_BROADCAST_GROUP"},
+		{8468, L"FRAMEWORKMSG_REMOVE_GROUP"},
+		{8480, L"FRAMEWORKMSG_READY_TO_LOGOUT"},
+		{8481, L"FRAMEWORKMSG_CONTENT_SERVICE_SHUTDOWN"},
+		{8496, L"FRAMEWORKMSG_COMPRESSED"},
+		{8497, L"FRAMEWORKMSG_FRAGMENT"},
+		{8498, L"FRAMEWORKMSG_SEQUENCE_ACK"},
+		{24578, L"FRAMEWORKMSG_HEART_BEAT_REQ"},
+		{24580, L"FRAMEWORKMSG_SIGN_IN_REQ"},
+		{24582, L"FRAMEWORKMSG_WORLD_LIST_REQ"},
+		{24583, L"FRAMEWORKMSG_QUEUE_UP_IMMIGRATION_WORLD_REQ"},
+		{24586, L"FRAMEWORKMSG_CONNECT_CERTIFICATION_SERVICE_REQ"},
+		{24587, L"FRAMEWORKMSG_RPC_INVOKE_REQ"},
+		{24592, L"FRAMEWORKMSG_START_ENTER_WORLD_REQ"},
+		{24593, L"FRAMEWORKMSG_SECURITY_EXCHANGE_REQ"},
+		{24608, L"FRAMEWORKMSG_ASYNC_QUERY_REQ"},
+		{24624, L"FRAMEWORKMSG_QUERY_CONTENT_INFO_REQ"},
+		{24625, L"FRAMEWORKMSG_QUERY_ACCOUNT_INFO_REQ"},
+		{24837, L"FRAMEWORKMSG_TIME_SYNC_REQ"},
+		{24839, L"FRAMEWORKMSG_RENEWAL_SESSION_REQ"},
+		{24840, L"FRAMEWORKMSG_REPAIR_SESSION_REQ"},
+		{24841, L"FRAMEWORKMSG_HANDOVER_REQ"},
+		{24883, L"FRAMEWORKMSG_RESUME_SESSION_REQ"},
+		{25088, L"FRAMEWORKMSG_DUMMY_SIGN_IN_REQ"},
+		{25089, L"FRAMEWORKMSG_DUMMY_ENTER_WORLD_REQ"},
+		{40962, L"FRAMEWORKMSG_HEART_BEAT_ACK"},
+		{40964, L"FRAMEWORKMSG_SIGN_IN_ACK"},
+		{40966, L"FRAMEWORKMSG_WORLD_LIST_ACK"},
+		{40967, L"FRAMEWORKMSG_QUEUE_UP_IMMIGRATION_WORLD_ACK"},
+		{40970, L"FRAMEWORKMSG_CONNECT_CERTIFICATION_SERVICE_ACK"},
+		{40971, L"FRAMEWORKMSG_RPC_INVOKE_ACK"},
+		{40976, L"FRAMEWORKMSG_START_ENTER_WORLD_ACK"},
+		{40977, L"FRAMEWORKMSG_SECURITY_EXCHANGE_ACK"},
+		{40992, L"FRAMEWORKMSG_ASYNC_QUERY_ACK"},
+		{41008, L"FRAMEWORKMSG_QUERY_CONTENT_INFO_ACK"},
+		{41009, L"FRAMEWORKMSG_QUERY_ACCOUNT_INFO_ACK"},
+		{41221, L"FRAMEWORKMSG_TIME_SYNC_ACK"},
+		{41223, L"FRAMEWORKMSG_RENEWAL_SESSION_ACK"},
+		{41224, L"FRAMEWORKMSG_REPAIR_SESSION_ACK"},
+		{41225, L"FRAMEWORKMSG_HANDOVER_ACK"},
+		{41267, L"FRAMEWORKMSG_RESUME_SESSION_ACK"},
+		{41472, L"FRAMEWORKMSG_DUMMY_SIGN_IN_ACK"},
+		{41473, L"FRAMEWORKMSG_DUMMY_ENTER_WORLD_ACK"},
+	};
+
+	inline constexpr int ProtocolCount = (int)(sizeof(ProtocolNames) / sizeof(ProtocolNames[0]));
+	inline constexpr int FrameworkProtocolCount = (int)(sizeof(FrameworkProtocolNames) / sizeof(FrameworkProtocolNames[0]));
+
+	constexpr bool IsSortedProtocolNames(const ProtocolName* names, int count)
+	{
+		for (int i = 1; i < count; ++i) {
+			if (names[i - 1].msgID >= names[i].msgID) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static_assert(IsSortedProtocolNames(ProtocolNames, ProtocolCount), "ProtocolNames must be sorted by msgID without duplicates");
+	static_assert(IsSortedProtocolNames(FrameworkProtocolNames, FrameworkProtocolCount), "FrameworkProtocolNames must be sorted by msgID without duplicates");
+
+	constexpr int FindProtocolIndex(const ProtocolName* names, int count, msgid_t msgID)
+	{
+		int lo = 0;
+		int hi = count;
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (names[mid].msgID < msgID) {
+				lo = mid + 1;
+			}
+			else {
+				hi = mid;
+			}
+		}
+		return (lo < count && names[lo].msgID == msgID) ? lo : -1;
+	}
+
+	// dense index of a known content protocol, -1 otherwise
+	constexpr int FindProtocolIndex(msgid_t msgID)
+	{
+		return FindProtocolIndex(ProtocolNames, ProtocolCount, msgID);
+	}
+
+	constexpr const wchar_t* FindProtocolName(msgid_t msgID)
+	{
+		int index = FindProtocolIndex(msgID);
+		if (index >= 0) {
+			return ProtocolNames[index].name;
+		}
+
+		index = FindProtocolIndex(FrameworkProtocolNames, FrameworkProtocolCount, msgID);
+		return index < 0 ? nullptr : FrameworkProtocolNames[index].name;
+	}
+
+	inline std::wstring GetProtocolName(msgid_t msgID)
 	{
-		return ProtocolMap[msgID];
+		const wchar_t* name = FindProtocolName(msgID);
+		return name ? std::wstring(name) : std::wstring();
 	}
 
 	inline bool Contains(msgid_t msgID)
 	{
-		return ProtocolMap.find(msgID) != ProtocolMap.end();
+		return FindProtocolIndex(msgID) >= 0;
 	}
 
 	inline std::wstring GetResultStringW(const std::map<errid_t, std::wstring>& container, errid_t errid)
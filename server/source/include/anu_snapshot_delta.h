@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+
+#include "anu_global_def.h"
+
+using SnapshotDeltaData = SnapshotData<SNAPSHOT_SYNC_DELTA_LOCATION>;
+
+// baselines of SNAPSHOT_SYNC_DELTA_LOCATION, one table per observer on the sending side and one per connection on the receiving side.
+// the snapshot stream is ordered and lossless, a unit counts as acknowledged once it is sent. both tables advance to what the
+// receiver reconstructs, so the quantization error never accumulates. both sides drop their table with the session.
+class SnapshotDeltaBaselines
+{
+public:
+	// the yaw is sent whole, only the location needs a baseline
+	struct Baseline
+	{
+		float Location[3];
+	};
+
+	static constexpr uint32_t YawSteps = 1u << SNAPSHOT_DELTA_YAW_BITS;
+	static_assert(SNAPSHOT_DELTA_YAW_BITS > 0 && SNAPSHOT_DELTA_YAW_BITS <= 16, "the yaw has to fit SnapshotDeltaData::Yaw");
+
+	static uint16 QuantizeYaw(float rotation)
+	{
+		float turn = std::fmod(rotation, 360.0f);
+		if (turn < 0.0f) {
+			turn += 360.0f;
+		}
+		return (uint16)((uint32_t)std::lround(turn * (YawSteps / 360.0f)) & (YawSteps - 1));
+	}
+
+	static float DequantizeYaw(uint16 yaw)
+	{
+		return (float)yaw * (360.0f / YawSteps);
+	}
+
+	// sending side. false when the guid has no baseline or the move is out of range, the absolute units go out then
+	bool Encode(int64 guid, const float location[3], float rotation, SnapshotDeltaData& delta)
+	{
+		auto it = _baselines.find(guid);
+		if (it == _baselines.end()) {
+			return false;
+		}
+
+		Baseline& baseline = it->second;
+		long steps[3];
+		for (int axis = 0; axis < 3; ++axis) {
+			steps[axis] = std::lround((location[axis] - baseline.Location[axis]) * SNAPSHOT_DELTA_STEPS_PER_UNIT);
+			if (steps[axis] < INT16_MIN || steps[axis] > INT16_MAX) {
+				return false;
+			}
+		}
+
+		for (int axis = 0; axis < 3; ++axis) {
+			delta.Delta[axis] = (int16)steps[axis];
+		}
+		delta.Yaw = QuantizeYaw(rotation);
+
+		Apply(baseline, delta);
+		return true;
+	}
+
+	// receiving side, false when the guid has no baseline
+	bool Decode(int64 guid, const SnapshotDeltaData& delta, float location[3], float& rotation)
+	{
+		auto it = _baselines.find(guid);
+		if (it == _baselines.end()) {
+			return false;
+		}
+
+		Baseline& baseline = it->second;
+		Apply(baseline, delta);
+
+		location[0] = baseline.Location[0];
+		location[1] = baseline.Location[1];
+		location[2] = baseline.Location[2];
+		rotation = DequantizeYaw(delta.Yaw);
+		return true;
+	}
+
+	// both sides, whenever SNAPSHOT_SYNC_LOCATION went out or came in. a guid has a baseline from then on
+	void UpdateLocation(int64 guid, const float location[3])
+	{
+		Baseline& baseline = _baselines[guid];
+		baseline.Location[0] = location[0];
+		baseline.Location[1] = location[1];
+		baseline.Location[2] = location[2];
+	}
+
+	void Remove(int64 guid) { _baselines.erase(guid); }
+	void Clear() { _baselines.clear(); }
+	size_t Num() const { return _baselines.size(); }
+
+private:
+	static void Apply(Baseline& baseline, const SnapshotDeltaData& delta)
+	{
+		for (int axis = 0; axis < 3; ++axis) {
+			baseline.Location[axis] += (float)delta.Delta[axis] / SNAPSHOT_DELTA_STEPS_PER_UNIT;
+		}
+	}
+
+private:
+	std::unordered_map<int64, Baseline> _baselines;
+};
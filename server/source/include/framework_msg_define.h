@@ -11,6 +11,10 @@
 #define MAKE_FRAMEWORKMSG(dir, id)          (MSG_FLAG_IDFIELD_FRAMEWORK | (dir) | id)
 #define IS_FRAMEWORK_MSG(id)                ((((id & 0x3000) & MSG_FLAG_IDFIELD_FRAMEWORK)) == (((id & 0x3000)| MSG_FLAG_IDFIELD_FRAMEWORK)) )
 
+// body integers wider than a byte are LEB128 varints, signed ones zigzagged. no message id uses this bit
+#define MSG_FLAG_IDFIELD_COMPACT            (uint16)0x0400
+#define IS_COMPACT_MSG(msgid)               (((msgid) & MSG_FLAG_IDFIELD_COMPACT) == MSG_FLAG_IDFIELD_COMPACT)
+
 //////////////////////////////////////////////////////////////////////////////////////////
 //common error codes
 #define RESULT_SUCCEEDED				(uint8)0x00
@@ -125,6 +129,25 @@
 #define FRAMEWORKMSG_READY_TO_LOGOUT        MAKE_FRAMEWORKMSG(MSG_FLAG_IDFIELD_NO_DIR, 0x0120)
 #define FRAMEWORKMSG_CONTENT_SERVICE_SHUTDOWN       MAKE_FRAMEWORKMSG(MSG_FLAG_IDFIELD_NO_DIR, 0x0121)
 
+// transport envelopes, unwrapped by the receiving session before any handler sees them
+#define FRAMEWORKMSG_COMPRESSED             MAKE_FRAMEWORKMSG(MSG_FLAG_IDFIELD_NO_DIR, 0x0130)
+#define FRAMEWORKMSG_FRAGMENT               MAKE_FRAMEWORKMSG(MSG_FLAG_IDFIELD_NO_DIR, 0x0131)
+
+// session resume, both sides number the content messages they sent since sign in or repair
+#define FRAMEWORKMSG_SEQUENCE_ACK           MAKE_FRAMEWORKMSG(MSG_FLAG_IDFIELD_NO_DIR, 0x0132)
+#define FRAMEWORKMSG_RESUME_SESSION_REQ     MAKE_FRAMEWORKMSG(MSG_FLAG_IDFIELD_REQMSG, 0x0133)
+#define FRAMEWORKMSG_RESUME_SESSION_ACK     MAKE_FRAMEWORKMSG(MSG_FLAG_IDFIELD_ACKMSG, 0x0133)
+
+// bodies up to this size are streamed as FRAMEWORKMSG_FRAGMENT slices
+#define MAX_STREAMED_MSG_SIZE				(uint32)(16 * 1024 * 1024)
+// header size of a body that only fits the cursors, it never goes out as one frame
+#define MSG_BODY_SIZE_STREAMED				(uint16)0xFFFF
+
+// FRAMEWORKMSG_SETUP_CORD capabilities, the server answers with the subset it accepts
+#define FRAMEWORK_CAPABILITY_LZ4			(uint8)0x01
+#define FRAMEWORK_CAPABILITY_FRAGMENT		(uint8)0x02
+#define FRAMEWORK_CAPABILITY_RESUME			(uint8)0x04
+
 
 #define FRAMEWORKMSG_DUMMY_SIGN_IN_REQ      MAKE_FRAMEWORKMSG(MSG_FLAG_IDFIELD_REQMSG, 0x0200)
 #define FRAMEWORKMSG_DUMMY_SIGN_IN_ACK      MAKE_FRAMEWORKMSG(MSG_FLAG_IDFIELD_ACKMSG, 0x0200)
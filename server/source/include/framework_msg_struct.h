@@ -0,0 +1,966 @@
+// generated by server/source/tools/msggen.py from framework_msg.schema, do not edit
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// wire layout matches FNetPacket: little endian, packed, strings and arrays prefixed with a uint16 count
+namespace MsgSchema
+{
+	namespace Detail
+	{
+		inline uint16_t ClampedLength(size_t length)
+		{
+			return length > 0xFFFF ? (uint16_t)0xFFFF : (uint16_t)length;
+		}
+
+		template <typename T>
+		inline uint8_t* Put(uint8_t* out, const T& value)
+		{
+			std::memcpy(out, &value, sizeof(T));
+			return out + sizeof(T);
+		}
+
+		inline uint8_t* PutBytes(uint8_t* out, const void* items, uint16_t count, size_t itemSize)
+		{
+			out = Put(out, count);
+			if (count > 0) {
+				std::memcpy(out, items, count * itemSize);
+			}
+			return out + count * itemSize;
+		}
+
+		template <typename T>
+		inline const uint8_t* Get(const uint8_t* cur, T& value)
+		{
+			std::memcpy(&value, cur, sizeof(T));
+			return cur + sizeof(T);
+		}
+	}
+
+	struct FRAMEWORKMSG_SETUP_CORD_Body
+	{
+		static constexpr uint16_t MsgID = 0x2001;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 3;
+
+		std::string clientName;
+		uint8_t capabilities = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize + Detail::ClampedLength(clientName.size());
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::PutBytes(out, clientName.data(), Detail::ClampedLength(clientName.size()), 1);
+			out = Detail::Put(out, capabilities);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t clientNameCount = 0;
+			cur = Detail::Get(cur, clientNameCount);
+
+			if ((size_t)(end - cur) < (size_t)clientNameCount * sizeof(char)) {
+				return false;
+			}
+			clientName.assign((const char*)cur, clientNameCount);
+			cur += (size_t)clientNameCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 1) {
+				return false;
+			}
+			cur = Detail::Get(cur, capabilities);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(clientName, capabilities); }
+		auto Fields() const { return std::tie(clientName, capabilities); }
+	};
+
+	struct FRAMEWORKMSG_HEART_BEAT_REQ_Body
+	{
+		static constexpr uint16_t MsgID = 0x6002;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 8;
+
+		int64_t clientSent = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize;
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::Put(out, clientSent);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 8) {
+				return false;
+			}
+			cur = Detail::Get(cur, clientSent);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(clientSent); }
+		auto Fields() const { return std::tie(clientSent); }
+	};
+
+	struct FRAMEWORKMSG_HEART_BEAT_ACK_Body
+	{
+		static constexpr uint16_t MsgID = 0xa002;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 24;
+
+		int64_t clientSent = {};
+		int64_t serverReceived = {};
+		int64_t serverSent = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize;
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::Put(out, clientSent);
+			out = Detail::Put(out, serverReceived);
+			out = Detail::Put(out, serverSent);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 24) {
+				return false;
+			}
+			cur = Detail::Get(cur, clientSent);
+			cur = Detail::Get(cur, serverReceived);
+			cur = Detail::Get(cur, serverSent);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(clientSent, serverReceived, serverSent); }
+		auto Fields() const { return std::tie(clientSent, serverReceived, serverSent); }
+	};
+
+	struct FRAMEWORKMSG_COMPRESSED_Body
+	{
+		static constexpr uint16_t MsgID = 0x2130;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 4;
+
+		uint16_t msgID = {};
+		uint16_t bodySize = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize;
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::Put(out, msgID);
+			out = Detail::Put(out, bodySize);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 4) {
+				return false;
+			}
+			cur = Detail::Get(cur, msgID);
+			cur = Detail::Get(cur, bodySize);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(msgID, bodySize); }
+		auto Fields() const { return std::tie(msgID, bodySize); }
+	};
+
+	struct FRAMEWORKMSG_FRAGMENT_Body
+	{
+		static constexpr uint16_t MsgID = 0x2131;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 12;
+
+		uint16_t streamID = {};
+		uint16_t msgID = {};
+		uint32_t totalSize = {};
+		uint32_t offset = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize;
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::Put(out, streamID);
+			out = Detail::Put(out, msgID);
+			out = Detail::Put(out, totalSize);
+			out = Detail::Put(out, offset);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 12) {
+				return false;
+			}
+			cur = Detail::Get(cur, streamID);
+			cur = Detail::Get(cur, msgID);
+			cur = Detail::Get(cur, totalSize);
+			cur = Detail::Get(cur, offset);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(streamID, msgID, totalSize, offset); }
+		auto Fields() const { return std::tie(streamID, msgID, totalSize, offset); }
+	};
+
+	struct FRAMEWORKMSG_SEQUENCE_ACK_Body
+	{
+		static constexpr uint16_t MsgID = 0x2132;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 4;
+
+		uint32_t received = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize;
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::Put(out, received);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 4) {
+				return false;
+			}
+			cur = Detail::Get(cur, received);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(received); }
+		auto Fields() const { return std::tie(received); }
+	};
+
+	struct FRAMEWORKMSG_RESUME_SESSION_REQ_Body
+	{
+		static constexpr uint16_t MsgID = 0x6133;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 16;
+
+		std::string sessionToken;
+		std::string signinToken;
+		uint32_t received = {};
+		uint32_t sent = {};
+		uint32_t oldest = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize + Detail::ClampedLength(sessionToken.size()) + Detail::ClampedLength(signinToken.size());
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::PutBytes(out, sessionToken.data(), Detail::ClampedLength(sessionToken.size()), 1);
+			out = Detail::PutBytes(out, signinToken.data(), Detail::ClampedLength(signinToken.size()), 1);
+			out = Detail::Put(out, received);
+			out = Detail::Put(out, sent);
+			out = Detail::Put(out, oldest);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t sessionTokenCount = 0;
+			cur = Detail::Get(cur, sessionTokenCount);
+
+			if ((size_t)(end - cur) < (size_t)sessionTokenCount * sizeof(char)) {
+				return false;
+			}
+			sessionToken.assign((const char*)cur, sessionTokenCount);
+			cur += (size_t)sessionTokenCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t signinTokenCount = 0;
+			cur = Detail::Get(cur, signinTokenCount);
+
+			if ((size_t)(end - cur) < (size_t)signinTokenCount * sizeof(char)) {
+				return false;
+			}
+			signinToken.assign((const char*)cur, signinTokenCount);
+			cur += (size_t)signinTokenCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 12) {
+				return false;
+			}
+			cur = Detail::Get(cur, received);
+			cur = Detail::Get(cur, sent);
+			cur = Detail::Get(cur, oldest);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(sessionToken, signinToken, received, sent, oldest); }
+		auto Fields() const { return std::tie(sessionToken, signinToken, received, sent, oldest); }
+	};
+
+	struct FRAMEWORKMSG_RESUME_SESSION_ACK_Body
+	{
+		static constexpr uint16_t MsgID = 0xa133;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 5;
+
+		uint8_t result = {};
+		uint32_t received = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize;
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::Put(out, result);
+			out = Detail::Put(out, received);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 5) {
+				return false;
+			}
+			cur = Detail::Get(cur, result);
+			cur = Detail::Get(cur, received);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(result, received); }
+		auto Fields() const { return std::tie(result, received); }
+	};
+
+	struct FRAMEWORKMSG_SIGN_IN_REQ_Body
+	{
+		static constexpr uint16_t MsgID = 0x6004;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 21;
+
+		std::string platformID;
+		uint8_t platformCode = {};
+		std::string market;
+		std::string os;
+		std::string osVersion;
+		std::string deviceModel;
+		std::string country;
+		std::string language;
+		uint32_t timeZone = {};
+		std::string accessToken;
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize + Detail::ClampedLength(platformID.size()) + Detail::ClampedLength(market.size()) + Detail::ClampedLength(os.size()) + Detail::ClampedLength(osVersion.size()) + Detail::ClampedLength(deviceModel.size()) + Detail::ClampedLength(country.size()) + Detail::ClampedLength(language.size()) + Detail::ClampedLength(accessToken.size());
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::PutBytes(out, platformID.data(), Detail::ClampedLength(platformID.size()), 1);
+			out = Detail::Put(out, platformCode);
+			out = Detail::PutBytes(out, market.data(), Detail::ClampedLength(market.size()), 1);
+			out = Detail::PutBytes(out, os.data(), Detail::ClampedLength(os.size()), 1);
+			out = Detail::PutBytes(out, osVersion.data(), Detail::ClampedLength(osVersion.size()), 1);
+			out = Detail::PutBytes(out, deviceModel.data(), Detail::ClampedLength(deviceModel.size()), 1);
+			out = Detail::PutBytes(out, country.data(), Detail::ClampedLength(country.size()), 1);
+			out = Detail::PutBytes(out, language.data(), Detail::ClampedLength(language.size()), 1);
+			out = Detail::Put(out, timeZone);
+			out = Detail::PutBytes(out, accessToken.data(), Detail::ClampedLength(accessToken.size()), 1);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t platformIDCount = 0;
+			cur = Detail::Get(cur, platformIDCount);
+
+			if ((size_t)(end - cur) < (size_t)platformIDCount * sizeof(char)) {
+				return false;
+			}
+			platformID.assign((const char*)cur, platformIDCount);
+			cur += (size_t)platformIDCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 3) {
+				return false;
+			}
+			cur = Detail::Get(cur, platformCode);
+			uint16_t marketCount = 0;
+			cur = Detail::Get(cur, marketCount);
+
+			if ((size_t)(end - cur) < (size_t)marketCount * sizeof(char)) {
+				return false;
+			}
+			market.assign((const char*)cur, marketCount);
+			cur += (size_t)marketCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t osCount = 0;
+			cur = Detail::Get(cur, osCount);
+
+			if ((size_t)(end - cur) < (size_t)osCount * sizeof(char)) {
+				return false;
+			}
+			os.assign((const char*)cur, osCount);
+			cur += (size_t)osCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t osVersionCount = 0;
+			cur = Detail::Get(cur, osVersionCount);
+
+			if ((size_t)(end - cur) < (size_t)osVersionCount * sizeof(char)) {
+				return false;
+			}
+			osVersion.assign((const char*)cur, osVersionCount);
+			cur += (size_t)osVersionCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t deviceModelCount = 0;
+			cur = Detail::Get(cur, deviceModelCount);
+
+			if ((size_t)(end - cur) < (size_t)deviceModelCount * sizeof(char)) {
+				return false;
+			}
+			deviceModel.assign((const char*)cur, deviceModelCount);
+			cur += (size_t)deviceModelCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t countryCount = 0;
+			cur = Detail::Get(cur, countryCount);
+
+			if ((size_t)(end - cur) < (size_t)countryCount * sizeof(char)) {
+				return false;
+			}
+			country.assign((const char*)cur, countryCount);
+			cur += (size_t)countryCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t languageCount = 0;
+			cur = Detail::Get(cur, languageCount);
+
+			if ((size_t)(end - cur) < (size_t)languageCount * sizeof(char)) {
+				return false;
+			}
+			language.assign((const char*)cur, languageCount);
+			cur += (size_t)languageCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 6) {
+				return false;
+			}
+			cur = Detail::Get(cur, timeZone);
+			uint16_t accessTokenCount = 0;
+			cur = Detail::Get(cur, accessTokenCount);
+
+			if ((size_t)(end - cur) < (size_t)accessTokenCount * sizeof(char)) {
+				return false;
+			}
+			accessToken.assign((const char*)cur, accessTokenCount);
+			cur += (size_t)accessTokenCount * sizeof(char);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(platformID, platformCode, market, os, osVersion, deviceModel, country, language, timeZone, accessToken); }
+		auto Fields() const { return std::tie(platformID, platformCode, market, os, osVersion, deviceModel, country, language, timeZone, accessToken); }
+	};
+
+	struct FRAMEWORKMSG_DISCONTINUE_SESSION_Body
+	{
+		static constexpr uint16_t MsgID = 0x2005;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 1;
+
+		uint8_t reason = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize;
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::Put(out, reason);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 1) {
+				return false;
+			}
+			cur = Detail::Get(cur, reason);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(reason); }
+		auto Fields() const { return std::tie(reason); }
+	};
+
+	struct FRAMEWORKMSG_WORLD_LIST_ACK_Body
+	{
+		static constexpr uint16_t MsgID = 0xa006;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 2;
+
+		std::vector<uint32_t> worldIDs;
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize + Detail::ClampedLength(worldIDs.size()) * sizeof(uint32_t);
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::PutBytes(out, worldIDs.data(), Detail::ClampedLength(worldIDs.size()), sizeof(uint32_t));
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t worldIDsCount = 0;
+			cur = Detail::Get(cur, worldIDsCount);
+
+			if ((size_t)(end - cur) < (size_t)worldIDsCount * sizeof(uint32_t)) {
+				return false;
+			}
+			worldIDs.resize(worldIDsCount);
+			if (worldIDsCount > 0) {
+				std::memcpy(worldIDs.data(), cur, (size_t)worldIDsCount * sizeof(uint32_t));
+			}
+			cur += (size_t)worldIDsCount * sizeof(uint32_t);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(worldIDs); }
+		auto Fields() const { return std::tie(worldIDs); }
+	};
+
+	struct FRAMEWORKMSG_QUEUE_UP_IMMIGRATION_WORLD_REQ_Body
+	{
+		static constexpr uint16_t MsgID = 0x6007;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 6;
+
+		std::string signinToken;
+		int32_t worldID = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize + Detail::ClampedLength(signinToken.size());
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::PutBytes(out, signinToken.data(), Detail::ClampedLength(signinToken.size()), 1);
+			out = Detail::Put(out, worldID);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t signinTokenCount = 0;
+			cur = Detail::Get(cur, signinTokenCount);
+
+			if ((size_t)(end - cur) < (size_t)signinTokenCount * sizeof(char)) {
+				return false;
+			}
+			signinToken.assign((const char*)cur, signinTokenCount);
+			cur += (size_t)signinTokenCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 4) {
+				return false;
+			}
+			cur = Detail::Get(cur, worldID);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(signinToken, worldID); }
+		auto Fields() const { return std::tie(signinToken, worldID); }
+	};
+
+	struct FRAMEWORKMSG_IMMIGRATION_WORLD_Body
+	{
+		static constexpr uint16_t MsgID = 0x2008;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 2;
+
+		uint16_t processedNumber = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize;
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::Put(out, processedNumber);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			cur = Detail::Get(cur, processedNumber);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(processedNumber); }
+		auto Fields() const { return std::tie(processedNumber); }
+	};
+
+	struct FRAMEWORKMSG_START_ENTER_WORLD_REQ_Body
+	{
+		static constexpr uint16_t MsgID = 0x6010;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 2;
+
+		uint16_t waitingNumber = {};
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize;
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::Put(out, waitingNumber);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			cur = Detail::Get(cur, waitingNumber);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(waitingNumber); }
+		auto Fields() const { return std::tie(waitingNumber); }
+	};
+
+	struct FRAMEWORKMSG_RENEWAL_SESSION_REQ_Body
+	{
+		static constexpr uint16_t MsgID = 0x6107;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 2;
+
+		std::string sessionToken;
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize + Detail::ClampedLength(sessionToken.size());
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::PutBytes(out, sessionToken.data(), Detail::ClampedLength(sessionToken.size()), 1);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t sessionTokenCount = 0;
+			cur = Detail::Get(cur, sessionTokenCount);
+
+			if ((size_t)(end - cur) < (size_t)sessionTokenCount * sizeof(char)) {
+				return false;
+			}
+			sessionToken.assign((const char*)cur, sessionTokenCount);
+			cur += (size_t)sessionTokenCount * sizeof(char);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(sessionToken); }
+		auto Fields() const { return std::tie(sessionToken); }
+	};
+
+	struct FRAMEWORKMSG_RENEWAL_SESSION_ACK_Body
+	{
+		static constexpr uint16_t MsgID = 0xa107;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 2;
+
+		std::string sessionToken;
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize + Detail::ClampedLength(sessionToken.size());
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::PutBytes(out, sessionToken.data(), Detail::ClampedLength(sessionToken.size()), 1);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t sessionTokenCount = 0;
+			cur = Detail::Get(cur, sessionTokenCount);
+
+			if ((size_t)(end - cur) < (size_t)sessionTokenCount * sizeof(char)) {
+				return false;
+			}
+			sessionToken.assign((const char*)cur, sessionTokenCount);
+			cur += (size_t)sessionTokenCount * sizeof(char);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(sessionToken); }
+		auto Fields() const { return std::tie(sessionToken); }
+	};
+
+	struct FRAMEWORKMSG_REPAIR_SESSION_REQ_Body
+	{
+		static constexpr uint16_t MsgID = 0x6108;
+		// scalars and length prefixes
+		static constexpr size_t FixedSize = 4;
+
+		std::string sessionToken;
+		std::string signinToken;
+
+		size_t GetEncodedSize() const
+		{
+			return FixedSize + Detail::ClampedLength(sessionToken.size()) + Detail::ClampedLength(signinToken.size());
+		}
+
+		// out has to hold GetEncodedSize() bytes, returns the end of the written body
+		uint8_t* Encode(uint8_t* out) const
+		{
+			out = Detail::PutBytes(out, sessionToken.data(), Detail::ClampedLength(sessionToken.size()), 1);
+			out = Detail::PutBytes(out, signinToken.data(), Detail::ClampedLength(signinToken.size()), 1);
+			return out;
+		}
+
+		// false on a short body, consumed is set on success
+		bool Decode(const uint8_t* data, size_t size, size_t& consumed)
+		{
+			const uint8_t* cur = data;
+			const uint8_t* end = data + size;
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t sessionTokenCount = 0;
+			cur = Detail::Get(cur, sessionTokenCount);
+
+			if ((size_t)(end - cur) < (size_t)sessionTokenCount * sizeof(char)) {
+				return false;
+			}
+			sessionToken.assign((const char*)cur, sessionTokenCount);
+			cur += (size_t)sessionTokenCount * sizeof(char);
+
+			if ((size_t)(end - cur) < 2) {
+				return false;
+			}
+			uint16_t signinTokenCount = 0;
+			cur = Detail::Get(cur, signinTokenCount);
+
+			if ((size_t)(end - cur) < (size_t)signinTokenCount * sizeof(char)) {
+				return false;
+			}
+			signinToken.assign((const char*)cur, signinTokenCount);
+			cur += (size_t)signinTokenCount * sizeof(char);
+
+			consumed = (size_t)(cur - data);
+			return true;
+		}
+
+		auto Fields() { return std::tie(sessionToken, signinToken); }
+		auto Fields() const { return std::tie(sessionToken, signinToken); }
+	};
+
+	// every body above, in schema order
+	using Bodies = std::tuple<
+		FRAMEWORKMSG_SETUP_CORD_Body,
+		FRAMEWORKMSG_HEART_BEAT_REQ_Body,
+		FRAMEWORKMSG_HEART_BEAT_ACK_Body,
+		FRAMEWORKMSG_COMPRESSED_Body,
+		FRAMEWORKMSG_FRAGMENT_Body,
+		FRAMEWORKMSG_SEQUENCE_ACK_Body,
+		FRAMEWORKMSG_RESUME_SESSION_REQ_Body,
+		FRAMEWORKMSG_RESUME_SESSION_ACK_Body,
+		FRAMEWORKMSG_SIGN_IN_REQ_Body,
+		FRAMEWORKMSG_DISCONTINUE_SESSION_Body,
+		FRAMEWORKMSG_WORLD_LIST_ACK_Body,
+		FRAMEWORKMSG_QUEUE_UP_IMMIGRATION_WORLD_REQ_Body,
+		FRAMEWORKMSG_IMMIGRATION_WORLD_Body,
+		FRAMEWORKMSG_START_ENTER_WORLD_REQ_Body,
+		FRAMEWORKMSG_RENEWAL_SESSION_REQ_Body,
+		FRAMEWORKMSG_RENEWAL_SESSION_ACK_Body,
+		FRAMEWORKMSG_REPAIR_SESSION_REQ_Body>;
+}
@@ -0,0 +1,1546 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+// microbenchmarks of the protocol core, one case per message type and layer.
+//   netcore_bench [--quick] [--filter <substring>] [--thresholds <file>]
+// every case checks its round trip before it is timed. with --thresholds a case slower than its "name max_ns" line
+// fails the run, the exit code is the number of regressions (ctest runs it that way, see CMakeLists.txt)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "netcore_cipher.h"
+#include "netcore_fragment.h"
+#include "netcore_mpsc.h"
+#include "netcore_poller.h"
+#include "netcore_reader.h"
+#include "netcore_ring.h"
+#include "netcore_snapshot.h"
+#include "netcore_utf8.h"
+#include "netcore_varint.h"
+
+#include "framework_msg_struct.h"
+
+// the AES_* calls are only here to time the code path they replaced
+#define OPENSSL_SUPPRESS_DEPRECATED
+#include <openssl/aes.h>
+
+#ifndef NETCORE_BENCH_LZ4
+#define NETCORE_BENCH_LZ4 0
+#endif
+
+#if NETCORE_BENCH_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#define NETCORE_BENCH_SOCKETS 1
+#else
+#define NETCORE_BENCH_SOCKETS 0
+#endif
+
+// heap allocations of the calling thread, the recv.alloc cases report theirs per received frame
+static thread_local uint64_t g_allocations = 0;
+
+void* operator new(size_t size)
+{
+	++g_allocations;
+	if (void* memory = std::malloc(size > 0 ? size : 1)) {
+		return memory;
+	}
+	throw std::bad_alloc();
+}
+
+// kept out of line, gcc would see a free() of what the new above returned and warn about a mismatch
+#if defined(_MSC_VER)
+	#define NETCORE_BENCH_NOINLINE	__declspec(noinline)
+#else
+	#define NETCORE_BENCH_NOINLINE	__attribute__((noinline))
+#endif
+
+NETCORE_BENCH_NOINLINE void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+}
+
+NETCORE_BENCH_NOINLINE void operator delete(void* memory, size_t) noexcept
+{
+	std::free(memory);
+}
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct BenchResult
+	{
+		double nsPerOp = 0.0;
+		double mbPerSec = 0.0;
+	};
+
+	struct BenchCase
+	{
+		std::string name;
+		size_t bytesPerOp = 0;
+		std::function<bool()> verify;
+		std::function<void()> run;
+		// optional line printed under the timing, from what the verify pass counted
+		std::function<std::string(const BenchResult&)> report = nullptr;
+	};
+
+	volatile uint64_t g_sink = 0;
+
+	void Consume(uint64_t value)
+	{
+		g_sink = g_sink + value;
+	}
+
+	// the best of a few timed slices, noisy neighbours only ever make a slice slower
+	BenchResult Measure(const BenchCase& bench, double sliceSeconds, int slices)
+	{
+		uint64_t iterations = 1;
+		for (;;) {
+			Clock::time_point begin = Clock::now();
+			for (uint64_t i = 0; i < iterations; ++i) {
+				bench.run();
+			}
+			double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+			if (elapsed >= sliceSeconds / 4 || iterations >= (1ull << 30)) {
+				iterations = std::max<uint64_t>(1, (uint64_t)(iterations * sliceSeconds / std::max(elapsed, 1e-9)));
+				break;
+			}
+			iterations *= 4;
+		}
+
+		double best = 0.0;
+		for (int slice = 0; slice < slices; ++slice) {
+			Clock::time_point begin = Clock::now();
+			for (uint64_t i = 0; i < iterations; ++i) {
+				bench.run();
+			}
+			double ns = std::chrono::duration<double, std::nano>(Clock::now() - begin).count() / (double)iterations;
+			if (slice == 0 || ns < best) {
+				best = ns;
+			}
+		}
+
+		BenchResult result;
+		result.nsPerOp = best;
+		result.mbPerSec = bench.bytesPerOp > 0 ? (double)bench.bytesPerOp / best * 1e9 / (1024.0 * 1024.0) : 0.0;
+		return result;
+	}
+
+	std::map<std::string, double> LoadThresholds(const char* path)
+	{
+		std::map<std::string, double> thresholds;
+		std::ifstream file(path);
+		if (file.is_open() == false) {
+			std::fprintf(stderr, "can not open thresholds %s\n", path);
+			std::exit(-1);
+		}
+
+		std::string line;
+		while (std::getline(file, line)) {
+			if (line.empty() || line[0] == '#') {
+				continue;
+			}
+
+			std::istringstream fields(line);
+			std::string name;
+			double maxNs = 0.0;
+			if (fields >> name >> maxNs) {
+				thresholds[name] = maxNs;
+			}
+		}
+		return thresholds;
+	}
+
+	// framing of a generated body the way FNetPacket lays it out
+	template <typename TBody>
+	std::vector<uint8_t> MakeFrame(const TBody& body)
+	{
+		std::vector<uint8_t> frame(MSG_HEADER_SIZE + body.GetEncodedSize());
+		NetCore::WriteFrameHeader(frame.data(), (uint16_t)TBody::MsgID, (uint16_t)body.GetEncodedSize());
+		body.Encode(frame.data() + MSG_HEADER_SIZE);
+		return frame;
+	}
+
+	template <typename TBody>
+	void AddBodyCases(std::vector<BenchCase>& cases, const char* name, const TBody& body, std::function<bool(const TBody&, const TBody&)> equal)
+	{
+		std::shared_ptr<std::vector<uint8_t>> frame = std::make_shared<std::vector<uint8_t>>(MakeFrame(body));
+		std::shared_ptr<std::vector<uint8_t>> out = std::make_shared<std::vector<uint8_t>>(frame->size());
+		size_t bytes = frame->size();
+
+		cases.push_back({ std::string("body.") + name + ".encode", bytes,
+			[=]() {
+				body.Encode(out->data());
+				return std::memcmp(out->data(), frame->data() + MSG_HEADER_SIZE, body.GetEncodedSize()) == 0;
+			},
+			[=]() {
+				NetCore::WriteFrameHeader(out->data(), (uint16_t)TBody::MsgID, (uint16_t)body.GetEncodedSize());
+				Consume((uint64_t)(body.Encode(out->data() + MSG_HEADER_SIZE) - out->data()));
+			} });
+
+		cases.push_back({ std::string("body.") + name + ".decode", bytes,
+			[=]() {
+				NetCore::PacketReader reader(frame->data(), (uint32_t)frame->size());
+				TBody decoded;
+				return reader.ReadBody(decoded) && reader.AllDataRead() && equal(body, decoded);
+			},
+			[=]() {
+				NetCore::PacketReader reader(frame->data(), (uint32_t)frame->size());
+				TBody decoded;
+				reader.ReadBody(decoded);
+				Consume(reader.GetRdPos());
+			} });
+	}
+
+	void AddVarintCases(std::vector<BenchCase>& cases)
+	{
+		// ids and counts, mostly one or two bytes with a long tail
+		std::mt19937 random(7);
+		std::shared_ptr<std::vector<uint32_t>> values = std::make_shared<std::vector<uint32_t>>(1024);
+		for (uint32_t& value : *values) {
+			uint32_t bits = random() % 100 < 80 ? 7 : (random() % 100 < 80 ? 14 : 32);
+			value = bits == 32 ? (uint32_t)random() : (uint32_t)random() & ((1u << bits) - 1);
+		}
+
+		std::shared_ptr<std::vector<uint8_t>> frame = std::make_shared<std::vector<uint8_t>>(MSG_HEADER_SIZE + 3 + values->size() * NETCORE_VARINT_MAX_SIZE);
+		uint8_t* cur = frame->data() + MSG_HEADER_SIZE;
+		cur = NetCore::Varint::Encode(NetCore::Varint::ToWire((uint16_t)values->size()), cur);
+		for (uint32_t value : *values) {
+			cur = NetCore::Varint::Encode(NetCore::Varint::ToWire(value), cur);
+		}
+		frame->resize((size_t)(cur - frame->data()));
+		NetCore::WriteFrameHeader(frame->data(), (uint16_t)(FRAMEWORKMSG_WORLD_LIST_ACK | MSG_FLAG_IDFIELD_COMPACT), (uint16_t)(frame->size() - MSG_HEADER_SIZE));
+
+		std::shared_ptr<std::vector<uint8_t>> out = std::make_shared<std::vector<uint8_t>>(frame->size());
+		size_t bytes = frame->size() - MSG_HEADER_SIZE;
+
+		cases.push_back({ "varint.u32x1k.encode", bytes,
+			[=]() { return true; },
+			[=]() {
+				uint8_t* cur = out->data();
+				for (uint32_t value : *values) {
+					cur = NetCore::Varint::Encode(NetCore::Varint::ToWire(value), cur);
+				}
+				Consume((uint64_t)(cur - out->data()));
+			} });
+
+		cases.push_back({ "varint.u32x1k.decode", bytes,
+			[=]() {
+				NetCore::PacketReader reader(frame->data(), (uint32_t)frame->size());
+				std::vector<uint32_t> decoded;
+				reader >> decoded;
+				return reader.IsValid() && reader.AllDataRead() && decoded == *values;
+			},
+			[=]() {
+				NetCore::PacketReader reader(frame->data(), (uint32_t)frame->size());
+				uint32_t decoded[1024];
+				uint16_t count = 0;
+				reader >> count;
+				reader.ReadArray(decoded, count);
+				Consume(decoded[count - 1]);
+			} });
+	}
+
+	// a 10k element id list like an inventory or a world object sync, read with one copy, element by element the way the
+	// reader did before the bulk path, and as compact varints
+	void AddArrayCases(std::vector<BenchCase>& cases)
+	{
+		constexpr uint16_t Count = 10000;
+
+		std::mt19937 random(13);
+		std::shared_ptr<std::vector<uint32_t>> values = std::make_shared<std::vector<uint32_t>>(Count);
+		for (uint32_t& value : *values) {
+			value = random() % 100 < 90 ? (uint32_t)random() % 20000 : (uint32_t)random();
+		}
+
+		std::shared_ptr<std::vector<uint8_t>> fixed = std::make_shared<std::vector<uint8_t>>(MSG_HEADER_SIZE + sizeof(uint16_t) + Count * sizeof(uint32_t));
+		std::memcpy(fixed->data() + MSG_HEADER_SIZE, &Count, sizeof(uint16_t));
+		std::memcpy(fixed->data() + MSG_HEADER_SIZE + sizeof(uint16_t), values->data(), Count * sizeof(uint32_t));
+		NetCore::WriteFrameHeader(fixed->data(), (uint16_t)FRAMEWORKMSG_WORLD_LIST_ACK, (uint16_t)(fixed->size() - MSG_HEADER_SIZE));
+
+		std::shared_ptr<std::vector<uint8_t>> compact = std::make_shared<std::vector<uint8_t>>(MSG_HEADER_SIZE + 3 + Count * NETCORE_VARINT_MAX_SIZE);
+		uint8_t* cur = compact->data() + MSG_HEADER_SIZE;
+		cur = NetCore::Varint::Encode(NetCore::Varint::ToWire(Count), cur);
+		for (uint32_t value : *values) {
+			cur = NetCore::Varint::Encode(NetCore::Varint::ToWire(value), cur);
+		}
+		compact->resize((size_t)(cur - compact->data()));
+		NetCore::WriteFrameHeader(compact->data(), (uint16_t)(FRAMEWORKMSG_WORLD_LIST_ACK | MSG_FLAG_IDFIELD_COMPACT), (uint16_t)(compact->size() - MSG_HEADER_SIZE));
+
+		std::shared_ptr<std::vector<uint32_t>> decoded = std::make_shared<std::vector<uint32_t>>();
+
+		auto bulk = [decoded](const std::vector<uint8_t>& frame) {
+			NetCore::PacketReader reader(frame.data(), (uint32_t)frame.size());
+			reader >> *decoded;
+			return reader.IsValid() && reader.AllDataRead();
+		};
+
+		auto perElement = [decoded](const std::vector<uint8_t>& frame) {
+			NetCore::PacketReader reader(frame.data(), (uint32_t)frame.size());
+			uint16_t count = 0;
+			reader >> count;
+			decoded->resize(count);
+			for (uint16_t i = 0; i < count; ++i) {
+				uint32_t value = 0;
+				reader >> value;
+				(*decoded)[i] = value;
+			}
+			return reader.IsValid() && reader.AllDataRead();
+		};
+
+		auto add = [&](const char* name, std::shared_ptr<std::vector<uint8_t>> frame, std::function<bool(const std::vector<uint8_t>&)> read) {
+			cases.push_back({ name, frame->size() - MSG_HEADER_SIZE,
+				[=]() {
+					decoded->clear();
+					return read(*frame) && *decoded == *values;
+				},
+				[=]() {
+					read(*frame);
+					Consume((*decoded)[Count - 1]);
+				} });
+		};
+
+		add("array.u32x10k.bulk", fixed, bulk);
+		add("array.u32x10k.perelement", fixed, perElement);
+		add("array.u32x10k.varint", compact, bulk);
+	}
+
+	// a mail or chat history page, [uint16 count] then [uint16 byte length][utf8] per string
+	using Strings = std::vector<std::u16string>;
+
+	std::shared_ptr<Strings> MakeStrings(uint32_t seed, uint32_t hangulPercent)
+	{
+		static const char Ascii[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789 .,!?";
+
+		std::mt19937 random(seed);
+		std::shared_ptr<Strings> strings = std::make_shared<Strings>(64);
+		for (size_t i = 0; i < strings->size(); ++i) {
+			// nicknames and chat lines take turns
+			uint32_t len = (i % 2 == 0) ? 6 + random() % 10 : 24 + random() % 100;
+			std::u16string& str = (*strings)[i];
+			for (uint32_t c = 0; c < len; ++c) {
+				if (random() % 100 < hangulPercent) {
+					str += (char16_t)(0xAC00 + random() % 11172);
+				} else {
+					str += (char16_t)Ascii[random() % (sizeof(Ascii) - 1)];
+				}
+			}
+			if (hangulPercent > 0 && i % 8 == 1) {
+				str += u"\U0001F600";
+			}
+		}
+		return strings;
+	}
+
+	// what TCHAR_TO_UTF8 and UTF8_TO_TCHAR did, one character at a time into a conversion buffer and a temporary string after that
+	uint8_t* WriteStringTemp(const std::u16string& str, uint8_t* cur)
+	{
+		std::vector<uint8_t> converter(str.size() * 3 + 1);
+		uint8_t* end = converter.data();
+		for (uint32_t i = 0; i < (uint32_t)str.size();) {
+			end = NetCore::Utf8::WriteCodePoint(NetCore::Utf8::NextCodePoint(str.data(), (uint32_t)str.size(), i), end);
+		}
+		*end = 0;
+
+		std::string temp{ (const char*)converter.data() };
+		uint16_t size = (uint16_t)std::strlen(temp.c_str());
+		std::memcpy(cur, &size, sizeof(uint16_t));
+		std::memcpy(cur + sizeof(uint16_t), temp.c_str(), size);
+		return cur + sizeof(uint16_t) + size;
+	}
+
+	const uint8_t* ReadStringTemp(const uint8_t* cur, std::u16string& str)
+	{
+		uint16_t size = 0;
+		std::memcpy(&size, cur, sizeof(uint16_t));
+		std::string temp((const char*)cur + sizeof(uint16_t), size);
+
+		const uint8_t* utf8 = (const uint8_t*)temp.c_str();
+		uint32_t bytes = (uint32_t)std::strlen(temp.c_str());
+		std::vector<char16_t> converter(bytes + 1);
+		char16_t* end = converter.data();
+		for (uint32_t i = 0; i < bytes;) {
+			end = NetCore::Utf8::WriteCodePoint(NetCore::Utf8::NextCodePoint(utf8, bytes, i), end);
+		}
+		*end = 0;
+
+		str = std::u16string(converter.data());
+		return cur + sizeof(uint16_t) + size;
+	}
+
+	// the length up front, then the ASCII runs sixteen at a time straight into the frame
+	uint8_t* WriteStringDirect(const std::u16string& str, uint8_t* cur)
+	{
+		uint16_t size = (uint16_t)NetCore::Utf8::EncodedLength(str.data(), (uint32_t)str.size());
+		std::memcpy(cur, &size, sizeof(uint16_t));
+		NetCore::Utf8::Encode(str.data(), (uint32_t)str.size(), cur + sizeof(uint16_t));
+		return cur + sizeof(uint16_t) + size;
+	}
+
+	// into the storage str already has
+	const uint8_t* ReadStringDirect(const uint8_t* cur, std::u16string& str)
+	{
+		uint16_t size = 0;
+		std::memcpy(&size, cur, sizeof(uint16_t));
+		const uint8_t* utf8 = cur + sizeof(uint16_t);
+		str.resize(NetCore::Utf8::DecodedLength<char16_t>(utf8, size));
+		NetCore::Utf8::Decode(utf8, size, str.data());
+		return utf8 + size;
+	}
+
+	void AddStringCases(std::vector<BenchCase>& cases)
+	{
+		using WriteString = uint8_t* (*)(const std::u16string&, uint8_t*);
+		using ReadString = const uint8_t* (*)(const uint8_t*, std::u16string&);
+
+		auto add = [&](const std::string& name, std::shared_ptr<Strings> strings) {
+			size_t capacity = MSG_HEADER_SIZE + sizeof(uint16_t);
+			for (const std::u16string& str : *strings) {
+				capacity += sizeof(uint16_t) + str.size() * 3;
+			}
+
+			std::shared_ptr<std::vector<uint8_t>> frame = std::make_shared<std::vector<uint8_t>>(capacity);
+			std::shared_ptr<std::vector<uint8_t>> out = std::make_shared<std::vector<uint8_t>>(capacity);
+			std::shared_ptr<Strings> decoded = std::make_shared<Strings>(strings->size());
+
+			auto write = [strings](WriteString writeString, std::vector<uint8_t>& buffer) {
+				uint16_t count = (uint16_t)strings->size();
+				uint8_t* cur = buffer.data() + MSG_HEADER_SIZE;
+				std::memcpy(cur, &count, sizeof(uint16_t));
+				cur += sizeof(uint16_t);
+				for (const std::u16string& str : *strings) {
+					cur = writeString(str, cur);
+				}
+				return (size_t)(cur - buffer.data());
+			};
+
+			auto read = [frame, decoded](ReadString readString) {
+				const uint8_t* cur = frame->data() + MSG_HEADER_SIZE + sizeof(uint16_t);
+				for (std::u16string& str : *decoded) {
+					cur = readString(cur, str);
+				}
+			};
+
+			size_t frameSize = write(WriteStringDirect, *frame);
+			frame->resize(frameSize);
+			NetCore::WriteFrameHeader(frame->data(), (uint16_t)FRAMEWORKMSG_WORLD_LIST_ACK, (uint16_t)(frameSize - MSG_HEADER_SIZE));
+
+			for (auto [path, writeString] : { std::pair<const char*, WriteString>{ "temp", WriteStringTemp }, { "direct", WriteStringDirect } }) {
+				cases.push_back({ name + ".encode." + path, frameSize - MSG_HEADER_SIZE,
+					[=]() {
+						return write(writeString, *out) == frameSize && std::memcmp(out->data() + MSG_HEADER_SIZE, frame->data() + MSG_HEADER_SIZE, frameSize - MSG_HEADER_SIZE) == 0;
+					},
+					[=]() {
+						Consume(write(writeString, *out));
+					} });
+			}
+
+			for (auto [path, readString] : { std::pair<const char*, ReadString>{ "temp", ReadStringTemp }, { "direct", ReadStringDirect } }) {
+				cases.push_back({ name + ".decode." + path, frameSize - MSG_HEADER_SIZE,
+					[=]() {
+						for (std::u16string& str : *decoded) {
+							str.clear();
+						}
+						read(readString);
+						return *decoded == *strings;
+					},
+					[=]() {
+						read(readString);
+						Consume(decoded->back().size());
+					} });
+			}
+		};
+
+		add("string.ascii64", MakeStrings(17, 0));
+		add("string.hangul64", MakeStrings(19, 70));
+	}
+
+	void AddBodies(std::vector<BenchCase>& cases)
+	{
+		MsgSchema::FRAMEWORKMSG_SETUP_CORD_Body setup;
+		setup.clientName = "anu-client/windows";
+		setup.capabilities = 0x07;
+		AddBodyCases<MsgSchema::FRAMEWORKMSG_SETUP_CORD_Body>(cases, "SETUP_CORD", setup, [](const auto& a, const auto& b) {
+			return a.clientName == b.clientName && a.capabilities == b.capabilities;
+		});
+
+		MsgSchema::FRAMEWORKMSG_SIGN_IN_REQ_Body signIn;
+		signIn.platformID = "8f0c6b1e-54a2-4f36-9d6a-0f4bfc2e1a77";
+		signIn.platformCode = 2;
+		signIn.market = "google";
+		signIn.os = "android";
+		signIn.osVersion = "14";
+		signIn.deviceModel = "SM-S918N";
+		signIn.country = "KR";
+		signIn.language = "ko";
+		signIn.timeZone = 540;
+		signIn.accessToken = std::string(512, 'x');
+		AddBodyCases<MsgSchema::FRAMEWORKMSG_SIGN_IN_REQ_Body>(cases, "SIGN_IN_REQ", signIn, [](const auto& a, const auto& b) {
+			return a.platformID == b.platformID && a.platformCode == b.platformCode && a.market == b.market && a.os == b.os &&
+				a.osVersion == b.osVersion && a.deviceModel == b.deviceModel && a.country == b.country &&
+				a.language == b.language && a.timeZone == b.timeZone && a.accessToken == b.accessToken;
+		});
+
+		MsgSchema::FRAMEWORKMSG_WORLD_LIST_ACK_Body worldList;
+		for (uint32_t i = 0; i < 64; ++i) {
+			worldList.worldIDs.push_back(1000 + i * 7);
+		}
+		AddBodyCases<MsgSchema::FRAMEWORKMSG_WORLD_LIST_ACK_Body>(cases, "WORLD_LIST_ACK", worldList, [](const auto& a, const auto& b) {
+			return a.worldIDs == b.worldIDs;
+		});
+
+		MsgSchema::FRAMEWORKMSG_FRAGMENT_Body fragment;
+		fragment.streamID = 3;
+		fragment.msgID = 0x2001;
+		fragment.totalSize = 180000;
+		fragment.offset = 64000;
+		AddBodyCases<MsgSchema::FRAMEWORKMSG_FRAGMENT_Body>(cases, "FRAGMENT", fragment, [](const auto& a, const auto& b) {
+			return a.streamID == b.streamID && a.msgID == b.msgID && a.totalSize == b.totalSize && a.offset == b.offset;
+		});
+
+		MsgSchema::FRAMEWORKMSG_COMPRESSED_Body compressed;
+		compressed.msgID = 0x2001;
+		compressed.bodySize = 4096;
+		AddBodyCases<MsgSchema::FRAMEWORKMSG_COMPRESSED_Body>(cases, "COMPRESSED", compressed, [](const auto& a, const auto& b) {
+			return a.msgID == b.msgID && a.bodySize == b.bodySize;
+		});
+	}
+
+	// 64 frames of 64 bytes per op, written through GetWritable/Commit and sliced with PeekFrame/Consume
+	void AddRingCases(std::vector<BenchCase>& cases)
+	{
+		constexpr uint32_t FrameCount = 64;
+		constexpr uint32_t FrameSize = 64;
+
+		std::shared_ptr<std::vector<uint8_t>> stream = std::make_shared<std::vector<uint8_t>>(FrameCount * FrameSize);
+		for (uint32_t i = 0; i < FrameCount; ++i) {
+			uint8_t* frame = stream->data() + i * FrameSize;
+			NetCore::WriteFrameHeader(frame, (uint16_t)FRAMEWORKMSG_FRAGMENT, (uint16_t)(FrameSize - MSG_HEADER_SIZE));
+			std::memset(frame + MSG_HEADER_SIZE, (int)i, FrameSize - MSG_HEADER_SIZE);
+		}
+
+		// capacity not a multiple of the stream, frames wrap around the end every few ops
+		std::shared_ptr<NetCore::RecvRingBuffer> ring = std::make_shared<NetCore::RecvRingBuffer>(6000);
+
+		auto pump = [=]() {
+			uint32_t written = 0;
+			uint32_t frames = 0;
+			while (written < stream->size()) {
+				uint32_t contiguous = 0;
+				uint8_t* dest = ring->GetWritable(contiguous);
+				uint32_t bytes = std::min<uint32_t>(contiguous, (uint32_t)stream->size() - written);
+				std::memcpy(dest, stream->data() + written, bytes);
+				ring->Commit(bytes);
+				written += bytes;
+
+				NetCore::RecvFrame frame;
+				while (ring->PeekFrame(frame) == NetCore::RecvRingBuffer::EFrameResult::Completed) {
+					ring->Consume(frame.GetSize());
+					++frames;
+				}
+			}
+			return frames;
+		};
+
+		cases.push_back({ "ring.frame64x64", stream->size(),
+			[=]() {
+				ring->Reset();
+				for (int round = 0; round < 8; ++round) {
+					if (pump() != FrameCount) {
+						return false;
+					}
+				}
+				return ring->GetReadableBytes() == 0;
+			},
+			[=]() { Consume(pump()); } });
+	}
+
+	// a received packet of the session, its buffer allocated once and reused while the packet is pooled
+	struct RecvPacket
+	{
+		std::vector<uint8_t> buffer;
+		uint32_t size = 0;
+	};
+
+	// packets of the receive path with or without the FNetPacketPool size classes. every handle allocates its
+	// shared_ptr control block like TSharedPacket does, a pooled packet comes back through the deleter
+	template <bool Pooled>
+	struct RecvPackets
+	{
+		using Buffer = std::shared_ptr<RecvPacket>;
+
+		static Buffer Acquire(size_t required)
+		{
+			size_t sizeClass = required <= 256 ? 0 : required <= MAX_MSGBUF_SIZE ? 1 : 2;
+			size_t capacity = std::max(required, sizeClass == 0 ? (size_t)256 : sizeClass == 1 ? (size_t)MAX_MSGBUF_SIZE : (size_t)MAX_MESSIVE_BUF_SIZE);
+
+			RecvPacket* packet = nullptr;
+			std::vector<RecvPacket*>& bucket = Buckets().packets[sizeClass];
+			if (Pooled && bucket.empty() == false) {
+				// a streamed body grows the buffer past its class, FNetPacket::Recycle does the same
+				packet = bucket.back();
+				bucket.pop_back();
+				if (packet->buffer.size() < capacity) {
+					packet->buffer.resize(capacity);
+				}
+			} else {
+				packet = new RecvPacket();
+				packet->buffer.resize(capacity);
+			}
+			packet->size = 0;
+
+			return Buffer(packet, [](RecvPacket* released) {
+				// streamed bodies are not kept, like FNetPacketPool::Release
+				size_t capacity = released->buffer.size();
+				if (Pooled && capacity <= (size_t)MAX_MESSIVE_BUF_SIZE) {
+					Buckets().packets[capacity <= 256 ? 0 : capacity <= MAX_MSGBUF_SIZE ? 1 : 2].push_back(released);
+				} else {
+					delete released;
+				}
+			});
+		}
+
+		// FragmentReassembler policy, the body of a streamed message
+		static Buffer Alloc(uint16_t, uint32_t totalSize)
+		{
+			return Acquire(totalSize);
+		}
+
+		static void Append(Buffer& buffer, const uint8_t* data, uint32_t size)
+		{
+			std::memcpy(buffer->buffer.data() + buffer->size, data, size);
+			buffer->size += size;
+		}
+
+	private:
+		struct PooledPackets
+		{
+			std::vector<RecvPacket*> packets[3];
+
+			~PooledPackets()
+			{
+				for (std::vector<RecvPacket*>& bucket : packets) {
+					for (RecvPacket* packet : bucket) {
+						delete packet;
+					}
+				}
+			}
+		};
+
+		static PooledPackets& Buckets()
+		{
+			static PooledPackets buckets;
+			return buckets;
+		}
+	};
+
+	struct RecvCounts
+	{
+		uint32_t frames = 0;
+		uint32_t delivered = 0;
+		uint64_t deliveredBytes = 0;
+	};
+
+	// FSession::PumpRecv on one op of the stream, read in 4k socket reads. every frame is copied into a packet of its own,
+	// with inPlace unwrapped fragment slices are fed to the reassembler where they lie in the ring instead
+	template <bool Pooled>
+	RecvCounts PumpReceive(const std::vector<uint8_t>& stream, NetCore::RecvRingBuffer& ring,
+		NetCore::FragmentReassembler<RecvPackets<Pooled>>& reassembler, bool inPlace)
+	{
+		RecvCounts counts;
+		auto deliver = [&counts](std::shared_ptr<RecvPacket>&& packet) {
+			++counts.delivered;
+			counts.deliveredBytes += packet->size;
+		};
+
+		uint32_t written = 0;
+		while (written < stream.size()) {
+			uint32_t contiguous = 0;
+			uint8_t* dest = ring.GetWritable(contiguous);
+			uint32_t bytes = std::min<uint32_t>({ contiguous, 4096u, (uint32_t)stream.size() - written });
+			std::memcpy(dest, stream.data() + written, bytes);
+			ring.Commit(bytes);
+			written += bytes;
+
+			NetCore::RecvFrame frame;
+			while (ring.PeekFrame(frame) == NetCore::RecvRingBuffer::EFrameResult::Completed) {
+				uint32_t size = frame.GetSize();
+				++counts.frames;
+
+				uint8_t header[MSG_HEADER_SIZE];
+				std::memcpy(header, frame.head, std::min<uint32_t>(frame.headSize, MSG_HEADER_SIZE));
+				if (frame.headSize < MSG_HEADER_SIZE) {
+					std::memcpy(header + frame.headSize, frame.tail, MSG_HEADER_SIZE - frame.headSize);
+				}
+				uint16_t msgID = 0;
+				std::memcpy(&msgID, header + MSG_OFFSET_ID, sizeof(uint16_t));
+
+				std::shared_ptr<RecvPacket> completed;
+				if (inPlace && frame.IsWrapped() == false && msgID == FRAMEWORKMSG_FRAGMENT) {
+					if (reassembler.Feed(frame.head + MSG_HEADER_SIZE, size - MSG_HEADER_SIZE, completed) == NetCore::FragmentResult::Completed) {
+						deliver(std::move(completed));
+					}
+					ring.Consume(size);
+					continue;
+				}
+
+				std::shared_ptr<RecvPacket> packet = RecvPackets<Pooled>::Acquire(size);
+				frame.CopyTo(packet->buffer.data());
+				packet->size = size;
+				ring.Consume(size);
+
+				if (msgID == FRAMEWORKMSG_FRAGMENT) {
+					if (reassembler.Feed(packet->buffer.data() + MSG_HEADER_SIZE, size - MSG_HEADER_SIZE, completed) == NetCore::FragmentResult::Completed) {
+						deliver(std::move(completed));
+					}
+				} else {
+					deliver(std::move(packet));
+				}
+			}
+		}
+		return counts;
+	}
+
+	// allocations per received frame: 256 small messages and one 80k body in 16k slices between them, through a packet
+	// allocated per frame (recv.alloc.new), the pool (recv.alloc.pool), and the pool with the slices reassembled out of
+	// the ring (recv.alloc.inplace)
+	template <bool Pooled>
+	void AddReceiveAllocCase(std::vector<BenchCase>& cases, const char* name, bool inPlace)
+	{
+		constexpr uint32_t Messages = 256;
+		constexpr uint32_t MessageBody = 48;
+		constexpr uint32_t StreamedBody = 80 * 1024;
+		constexpr uint32_t SliceBytes = 16 * 1024;
+		constexpr uint16_t MessageID = MSG_FLAG_IDFIELD_CONTENT | 0x0101;
+
+		std::shared_ptr<std::vector<uint8_t>> streamed = std::make_shared<std::vector<uint8_t>>(StreamedBody, (uint8_t)0x5A);
+		NetCore::FragmentWriter<int> writer;
+		writer.Push(0, MessageID, streamed->data(), StreamedBody);
+
+		std::shared_ptr<std::vector<uint8_t>> stream = std::make_shared<std::vector<uint8_t>>();
+		for (uint32_t i = 0; i < Messages; ++i) {
+			size_t at = stream->size();
+			stream->resize(at + MSG_HEADER_SIZE + MessageBody, (uint8_t)i);
+			NetCore::WriteFrameHeader(stream->data() + at, MessageID, (uint16_t)MessageBody);
+
+			if (i % 32 == 16 && writer.IsEmpty() == false) {
+				at = stream->size();
+				stream->resize(at + MSG_HEADER_SIZE + MAX_MESSIVE_BUF_SIZE);
+				stream->resize(at + writer.WriteNext(stream->data() + at, MSG_HEADER_SIZE + MAX_MESSIVE_BUF_SIZE, SliceBytes));
+			}
+		}
+
+		std::shared_ptr<NetCore::RecvRingBuffer> ring = std::make_shared<NetCore::RecvRingBuffer>(128 * 1024);
+		std::shared_ptr<NetCore::FragmentReassembler<RecvPackets<Pooled>>> reassembler =
+			std::make_shared<NetCore::FragmentReassembler<RecvPackets<Pooled>>>();
+		std::shared_ptr<RecvCounts> counted = std::make_shared<RecvCounts>();
+		std::shared_ptr<uint64_t> allocations = std::make_shared<uint64_t>(0);
+
+		cases.push_back({ name, stream->size(),
+			[=]() {
+				// the first op fills the pool, the second one is counted
+				PumpReceive<Pooled>(*stream, *ring, *reassembler, inPlace);
+				uint64_t before = g_allocations;
+				*counted = PumpReceive<Pooled>(*stream, *ring, *reassembler, inPlace);
+				*allocations = g_allocations - before;
+				return counted->delivered == Messages + 1 && counted->deliveredBytes == Messages * (MSG_HEADER_SIZE + MessageBody) + StreamedBody
+					&& ring->GetReadableBytes() == 0 && reassembler->NumOpen() == 0;
+			},
+			[=]() { Consume(PumpReceive<Pooled>(*stream, *ring, *reassembler, inPlace).delivered); },
+			[=](const BenchResult&) {
+				char line[160];
+				std::snprintf(line, sizeof(line), "%.2f allocations per received frame, %.2f per delivered message (%u frames, %u messages)",
+					(double)*allocations / counted->frames, (double)*allocations / counted->delivered, counted->frames, counted->delivered);
+				return std::string(line);
+			} });
+	}
+
+	void AddReceiveAllocCases(std::vector<BenchCase>& cases)
+	{
+		AddReceiveAllocCase<false>(cases, "recv.alloc.new", false);
+		AddReceiveAllocCase<true>(cases, "recv.alloc.pool", false);
+		AddReceiveAllocCase<true>(cases, "recv.alloc.inplace", true);
+	}
+
+#if NETCORE_BENCH_SOCKETS
+	// one connected stream pair, the write end blocks and the read end does not like the client socket
+	struct SocketPair
+	{
+		int writer = -1;
+		int reader = -1;
+
+		SocketPair()
+		{
+			int fds[2];
+			if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+				std::fprintf(stderr, "socketpair failed, errno %d\n", errno);
+				std::exit(-1);
+			}
+			writer = fds[0];
+			reader = fds[1];
+
+			// a whole op in flight at once, the reader never waits for the writer
+			int bufferSize = 1 << 20;
+			::setsockopt(writer, SOL_SOCKET, SO_SNDBUF, &bufferSize, sizeof(bufferSize));
+			::setsockopt(reader, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+			::fcntl(reader, F_SETFL, ::fcntl(reader, F_GETFL, 0) | O_NONBLOCK);
+		}
+
+		~SocketPair()
+		{
+			::close(writer);
+			::close(reader);
+		}
+
+		void Write(const std::vector<uint8_t>& stream) const
+		{
+			size_t written = 0;
+			while (written < stream.size()) {
+				ssize_t sent = ::send(writer, stream.data() + written, stream.size() - written, 0);
+				if (sent <= 0) {
+					std::fprintf(stderr, "socketpair send failed, errno %d\n", errno);
+					std::exit(-1);
+				}
+				written += (size_t)sent;
+			}
+		}
+	};
+
+	struct FramerCounts
+	{
+		uint64_t frames = 0;
+		uint64_t recvCalls = 0;
+	};
+
+	// the pre-ring FSession::Receiving: the header into a fresh packet, then exactly the rest of the body,
+	// a MAX_MSGBUF_SIZE packet allocated per frame and one more recv to see the socket drained
+	FramerCounts OldFramerPump(int fd)
+	{
+		FramerCounts counts;
+		std::unique_ptr<std::vector<uint8_t>> building;
+		uint32_t wrPos = 0;
+		for (;;) {
+			if (building == nullptr) {
+				building = std::make_unique<std::vector<uint8_t>>(MAX_MSGBUF_SIZE);
+				wrPos = 0;
+			}
+
+			uint32_t remains = 0;
+			if (wrPos < MSG_HEADER_SIZE) {
+				remains = MSG_HEADER_SIZE - wrPos;
+			} else {
+				uint16_t bodySize = 0;
+				std::memcpy(&bodySize, building->data(), sizeof(uint16_t));
+				uint32_t packetSize = MSG_HEADER_SIZE + bodySize;
+				if (packetSize > building->size()) {
+					building->resize(packetSize);
+				}
+				remains = packetSize - wrPos;
+			}
+
+			ssize_t bytes = ::recv(fd, building->data() + wrPos, remains, 0);
+			++counts.recvCalls;
+			if (bytes <= 0) {
+				break;
+			}
+			wrPos += (uint32_t)bytes;
+
+			uint16_t bodySize = 0;
+			std::memcpy(&bodySize, building->data(), sizeof(uint16_t));
+			if (wrPos >= MSG_HEADER_SIZE && wrPos == (uint32_t)MSG_HEADER_SIZE + bodySize) {
+				Consume((*building)[MSG_HEADER_SIZE]);
+				building.reset();
+				++counts.frames;
+			}
+		}
+		return counts;
+	}
+
+	// FSession::Receiving over the ring, as much as fits per recv and every completed frame sliced out in place
+	FramerCounts RingFramerPump(int fd, NetCore::RecvRingBuffer& ring)
+	{
+		FramerCounts counts;
+		for (;;) {
+			uint32_t contiguous = 0;
+			uint8_t* dest = ring.GetWritable(contiguous);
+			ssize_t bytes = ::recv(fd, dest, contiguous, 0);
+			++counts.recvCalls;
+			if (bytes <= 0) {
+				break;
+			}
+			ring.Commit((uint32_t)bytes);
+
+			NetCore::RecvFrame frame;
+			while (ring.PeekFrame(frame) == NetCore::RecvRingBuffer::EFrameResult::Completed) {
+				Consume(frame.GetSize());
+				ring.Consume(frame.GetSize());
+				++counts.frames;
+			}
+
+			// a short read means the socket is drained, no need to hear it from EAGAIN
+			if ((uint32_t)bytes < contiguous) {
+				break;
+			}
+		}
+		return counts;
+	}
+
+	// the old framer against the ring over a real socket, frames/s and recv calls per frame are what the ring was for.
+	// 256 frames per op, mostly small moves and chat with some item lists and a few large snapshots
+	void AddFramerCases(std::vector<BenchCase>& cases)
+	{
+		constexpr uint32_t FrameCount = 256;
+
+		std::mt19937 random(11);
+		std::shared_ptr<std::vector<uint8_t>> stream = std::make_shared<std::vector<uint8_t>>();
+		for (uint32_t i = 0; i < FrameCount; ++i) {
+			uint32_t roll = random() % 100;
+			uint16_t bodySize = (uint16_t)(roll < 80 ? 8 + random() % 120 : (roll < 98 ? 200 + random() % 800 : 2048 + random() % 6144));
+			size_t offset = stream->size();
+			stream->resize(offset + MSG_HEADER_SIZE + bodySize);
+			NetCore::WriteFrameHeader(stream->data() + offset, (uint16_t)FRAMEWORKMSG_FRAGMENT, bodySize);
+			std::memset(stream->data() + offset + MSG_HEADER_SIZE, (int)i, bodySize);
+		}
+
+		std::shared_ptr<SocketPair> sockets = std::make_shared<SocketPair>();
+		std::shared_ptr<NetCore::RecvRingBuffer> ring = std::make_shared<NetCore::RecvRingBuffer>(0);
+
+		auto report = [](std::shared_ptr<FramerCounts> counts) {
+			return [counts](const BenchResult& result) {
+				char line[128];
+				std::snprintf(line, sizeof(line), "%.2f recv/frame, %.2f M frames/s", (double)counts->recvCalls / (double)counts->frames,
+					(double)counts->frames / result.nsPerOp * 1e3);
+				return std::string(line);
+			};
+		};
+
+		std::shared_ptr<FramerCounts> oldCounts = std::make_shared<FramerCounts>();
+		cases.push_back({ "framer.old.mixed256", stream->size(),
+			[=]() {
+				sockets->Write(*stream);
+				*oldCounts = OldFramerPump(sockets->reader);
+				return oldCounts->frames == FrameCount;
+			},
+			[=]() {
+				sockets->Write(*stream);
+				Consume(OldFramerPump(sockets->reader).frames);
+			},
+			report(oldCounts) });
+
+		std::shared_ptr<FramerCounts> ringCounts = std::make_shared<FramerCounts>();
+		cases.push_back({ "framer.ring.mixed256", stream->size(),
+			[=]() {
+				ring->Reset();
+				sockets->Write(*stream);
+				*ringCounts = RingFramerPump(sockets->reader, *ring);
+				return ringCounts->frames == FrameCount && ring->GetReadableBytes() == 0;
+			},
+			[=]() {
+				sockets->Write(*stream);
+				Consume(RingFramerPump(sockets->reader, *ring).frames);
+			},
+			report(ringCounts) });
+	}
+#endif
+
+	// what the plugin queues went through before MpscQueue, TQueue<T, EQueueMode::Mpsc>: one heap node per item, producers
+	// swap the head and link the old one, the consumer frees the node it moves past. unbounded, Enqueue never fails
+	template <typename T>
+	class NodeMpscQueue
+	{
+	public:
+		NodeMpscQueue()
+		{
+			_tail = new Node();
+			_head.store(_tail, std::memory_order_relaxed);
+		}
+
+		~NodeMpscQueue()
+		{
+			while (_tail) {
+				Node* node = _tail;
+				_tail = node->next.load(std::memory_order_relaxed);
+				delete node;
+			}
+		}
+
+		NodeMpscQueue(const NodeMpscQueue&) = delete;
+		NodeMpscQueue& operator=(const NodeMpscQueue&) = delete;
+
+		bool Enqueue(const T& item)
+		{
+			Node* node = new Node();
+			node->item = item;
+			Node* previous = _head.exchange(node, std::memory_order_acq_rel);
+			previous->next.store(node, std::memory_order_release);
+			return true;
+		}
+
+		// consumer only
+		template <typename TCallback>
+		uint32_t DequeueAll(TCallback&& callback)
+		{
+			uint32_t count = 0;
+			for (Node* next; (next = _tail->next.load(std::memory_order_acquire)) != nullptr; ++count) {
+				callback(std::move(next->item));
+				delete _tail;
+				_tail = next;
+			}
+			return count;
+		}
+
+		bool IsEmpty() const { return _tail->next.load(std::memory_order_acquire) == nullptr; }
+
+	private:
+		struct Node
+		{
+			std::atomic<Node*> next{ nullptr };
+			T item = {};
+		};
+
+		std::atomic<Node*> _head{ nullptr };
+		Node* _tail = nullptr;
+	};
+
+	// producers push their numbered items through a ring smaller than the op while the consumer drains it, like the pump
+	// and the game thread producers against Tick. a producer that finds the ring full yields and tries again.
+	// returns false when an item got lost, duplicated or overtook an earlier one of the same producer
+	template <typename TQueue>
+	bool PumpMpsc(TQueue& queue, uint32_t producers, uint32_t itemsPerProducer)
+	{
+		std::vector<std::thread> threads;
+		for (uint32_t producer = 0; producer < producers; ++producer) {
+			threads.emplace_back([&queue, producer, itemsPerProducer]() {
+				for (uint32_t i = 0; i < itemsPerProducer; ++i) {
+					uint64_t item = ((uint64_t)producer << 32) | i;
+					while (queue.Enqueue(item) == false) {
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		std::vector<uint32_t> next(producers, 0);
+		bool ordered = true;
+		uint64_t received = 0;
+		uint64_t expected = (uint64_t)producers * itemsPerProducer;
+		while (received < expected) {
+			uint32_t drained = queue.DequeueAll([&](uint64_t item) {
+				uint32_t producer = (uint32_t)(item >> 32);
+				if (producer >= producers || (uint32_t)item != next[producer]) {
+					ordered = false;
+				} else {
+					++next[producer];
+				}
+				++received;
+			});
+			if (drained == 0) {
+				std::this_thread::yield();
+			}
+		}
+
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+		return ordered && queue.IsEmpty();
+	}
+
+	// one producer against four contending for the tail, 64k items per op through a 1k ring.
+	// mpsc.tqueue.* runs the same workload through the node queue it replaced
+	void AddMpscCases(std::vector<BenchCase>& cases)
+	{
+		constexpr uint32_t Items = 64 * 1024;
+
+		auto report = [](const BenchResult& result) {
+			char line[128];
+			std::snprintf(line, sizeof(line), "%.1f ns/item, %.2f M items/s", result.nsPerOp / Items, Items / result.nsPerOp * 1e3);
+			return std::string(line);
+		};
+
+		for (uint32_t producers : { 1u, 4u }) {
+			std::shared_ptr<NodeMpscQueue<uint64_t>> nodes = std::make_shared<NodeMpscQueue<uint64_t>>();
+			cases.push_back({ "mpsc.tqueue." + std::to_string(producers) + "p.64k", Items * sizeof(uint64_t),
+				[=]() { return PumpMpsc(*nodes, producers, Items / producers); },
+				[=]() { Consume(PumpMpsc(*nodes, producers, Items / producers)); },
+				report });
+
+			std::shared_ptr<NetCore::MpscQueue<uint64_t>> queue = std::make_shared<NetCore::MpscQueue<uint64_t>>(1024);
+			cases.push_back({ "mpsc." + std::to_string(producers) + "p.64k", Items * sizeof(uint64_t),
+				[=]() { return PumpMpsc(*queue, producers, Items / producers); },
+				[=]() { Consume(PumpMpsc(*queue, producers, Items / producers)); },
+				report });
+		}
+	}
+
+#if NETCORE_EPOLL
+	int64_t NowNanos()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+	}
+
+	// one message at a time from the game thread to the socket: enqueue, wake the pump, wait until the byte arrives.
+	// the pump sleeps in wait() between drains and records enqueue to send() in microseconds
+	template <typename TWait, typename TWakeup>
+	bool PumpEnqueueToWire(uint32_t messages, std::vector<double>& latencies, TWait wait, TWakeup wakeup)
+	{
+		SocketPair pair;
+		::fcntl(pair.reader, F_SETFL, ::fcntl(pair.reader, F_GETFL, 0) & ~O_NONBLOCK);
+
+		NetCore::MpscQueue<int64_t> queue(64);
+		std::atomic<bool> stop{ false };
+		std::vector<double> sent;
+		sent.reserve(messages);
+
+		std::thread pump([&]() {
+			while (stop.load(std::memory_order_acquire) == false) {
+				wait();
+				queue.DequeueAll([&](int64_t enqueued) {
+					uint8_t byte = 1;
+					::send(pair.writer, &byte, 1, 0);
+					sent.push_back((double)(NowNanos() - enqueued) / 1000.0);
+				});
+			}
+		});
+
+		uint32_t received = 0;
+		for (uint32_t i = 0; i < messages; ++i) {
+			queue.Enqueue(NowNanos());
+			wakeup();
+
+			uint8_t byte = 0;
+			ssize_t read = 0;
+			while ((read = ::recv(pair.reader, &byte, 1, 0)) < 0 && errno == EINTR) {
+			}
+			received += (read == 1) ? 1 : 0;
+		}
+
+		stop.store(true, std::memory_order_release);
+		wakeup();
+		pump.join();
+
+		if (latencies.size() < 64 * 1024) {
+			latencies.insert(latencies.end(), sent.begin(), sent.end());
+		}
+		return received == messages && sent.size() == messages;
+	}
+
+	// enqueue to wire of a message the game thread sends into an idle pump. the old pump slept _shutdownEvent->Wait(1)
+	// between drains whatever was queued, now it waits in epoll and the enqueue wakes it through the eventfd
+	void AddWakeupCases(std::vector<BenchCase>& cases)
+	{
+		constexpr uint32_t Messages = 32;
+
+		auto report = [](std::shared_ptr<std::vector<double>> latencies) {
+			return [latencies](const BenchResult&) {
+				std::vector<double> sorted = *latencies;
+				std::sort(sorted.begin(), sorted.end());
+				char line[128];
+				if (sorted.empty() == false) {
+					std::snprintf(line, sizeof(line), "enqueue to wire median %.1f us, p99 %.1f us over %zu messages",
+						sorted[sorted.size() / 2], sorted[sorted.size() * 99 / 100], sorted.size());
+				}
+				return sorted.empty() ? std::string() : std::string(line);
+			};
+		};
+
+		std::shared_ptr<std::vector<double>> polled = std::make_shared<std::vector<double>>();
+		auto sleep = []() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); };
+		auto nothing = []() {};
+		cases.push_back({ "wakeup.sleep1ms.x32", 0,
+			[=]() { return PumpEnqueueToWire(Messages, *polled, sleep, nothing); },
+			[=]() { Consume(PumpEnqueueToWire(Messages, *polled, sleep, nothing)); },
+			report(polled) });
+
+		std::shared_ptr<std::vector<double>> woken = std::make_shared<std::vector<double>>();
+		std::shared_ptr<NetCore::EpollPoller> poller = std::make_shared<NetCore::EpollPoller>();
+		if (poller->Init() == false) {
+			std::fprintf(stderr, "epoll poller failed, errno %d\n", errno);
+			std::exit(-1);
+		}
+		// the same 1 ms cap the pump uses while a socket is stalled, a missed wakeup shows up as the polled latency
+		cases.push_back({ "wakeup.epoll.x32", 0,
+			[=]() { return PumpEnqueueToWire(Messages, *woken, [poller]() { poller->Wait(1); }, [poller]() { poller->Wakeup(); }); },
+			[=]() { Consume(PumpEnqueueToWire(Messages, *woken, [poller]() { poller->Wait(1); }, [poller]() { poller->Wakeup(); })); },
+			report(woken) });
+	}
+#endif
+
+	// MOVE_SNAPSHOT_PATCH_NFY body with 1k characters, absolute units or the delta form against the baselines
+	std::vector<uint8_t> MakeSnapshotBody(uint32_t count, bool delta, SnapshotDeltaBaselines& sender)
+	{
+		std::vector<uint8_t> body;
+		uint16_t records = (uint16_t)count;
+		body.resize(sizeof(uint16_t));
+		std::memcpy(body.data(), &records, sizeof(uint16_t));
+
+		for (uint32_t i = 0; i < count; ++i) {
+			SnapshotPatchGUID guid = 0x10000 + i;
+			float location[3] = { 100.0f + i, 200.0f + i * 0.5f, 10.0f };
+			float rotation = (float)(i % 360);
+
+			uint8_t syncState = SNAPSHOT_SYNC_MOTION | SNAPSHOT_SYNC_SKILL;
+			SnapshotDeltaData deltaData = {};
+			if (delta && sender.Encode(guid, location, rotation, deltaData)) {
+				syncState |= SNAPSHOT_SYNC_DELTA_LOCATION;
+			} else {
+				syncState |= SNAPSHOT_SYNC_LOCATION | SNAPSHOT_SYNC_ROTATION;
+				sender.UpdateLocation(guid, location);
+			}
+
+			const SnapshotDataLayout& layout = SnapshotDataLayouts[syncState];
+			size_t offset = body.size();
+			body.resize(offset + NetCore::Detail::SnapshotRecordHeadSize + layout.Size);
+			std::memcpy(&body[offset], &guid, sizeof(guid));
+			body[offset + sizeof(guid)] = syncState;
+
+			uint8_t* units = &body[offset + NetCore::Detail::SnapshotRecordHeadSize];
+			auto put = [&](uint8_t flag, const void* data, size_t size) {
+				if ((syncState & flag) != 0) {
+					std::memcpy(units + layout.Offsets[NetCore::Detail::SnapshotUnitIndex(flag)], data, size);
+				}
+			};
+			MotionState motion = {};
+			uint32_t skill = 7000 + i;
+			put(SNAPSHOT_SYNC_ROTATION, &rotation, sizeof(rotation));
+			put(SNAPSHOT_SYNC_LOCATION, location, sizeof(location));
+			put(SNAPSHOT_SYNC_MOTION, &motion, sizeof(motion));
+			put(SNAPSHOT_SYNC_SKILL, &skill, sizeof(skill));
+			put(SNAPSHOT_SYNC_DELTA_LOCATION, &deltaData, sizeof(deltaData));
+		}
+		return body;
+	}
+
+	void AddSnapshotCases(std::vector<BenchCase>& cases)
+	{
+		constexpr uint32_t Count = 1024;
+
+		for (bool delta : { false, true }) {
+			// the sender establishes its baselines with one absolute frame, the receiver decodes that frame first
+			SnapshotDeltaBaselines sender;
+			std::vector<uint8_t> first = MakeSnapshotBody(Count, false, sender);
+			std::shared_ptr<std::vector<uint8_t>> body = std::make_shared<std::vector<uint8_t>>(delta ? MakeSnapshotBody(Count, true, sender) : first);
+
+			std::shared_ptr<SnapshotDeltaBaselines> receiver = std::make_shared<SnapshotDeltaBaselines>();
+			std::shared_ptr<NetCore::SnapshotBatch> batch = std::make_shared<NetCore::SnapshotBatch>();
+			batch->Decode(first.data(), (uint32_t)first.size(), receiver.get());
+
+			cases.push_back({ delta ? "snapshot.delta1k.decode" : "snapshot.abs1k.decode", body->size(),
+				[=]() {
+					if (batch->Decode(body->data(), (uint32_t)body->size(), receiver.get()) == false || batch->Num() != Count) {
+						return false;
+					}
+					for (uint32_t i = 0; i < Count; ++i) {
+						if (batch->guids[i] != 0x10000 + i || batch->skillGUIDs[i] != 7000 + i ||
+							std::abs(batch->locations[i * 3] - (100.0f + i)) > 0.125f) {
+							return false;
+						}
+					}
+					return true;
+				},
+				[=]() {
+					batch->Decode(body->data(), (uint32_t)body->size(), receiver.get());
+					Consume(batch->Num());
+				} });
+		}
+	}
+
+#if NETCORE_BENCH_LZ4
+	// the FRAMEWORKMSG_COMPRESSED envelope over bodies above the default threshold: a snapshot patch, a string heavy mail
+	// list and random bytes standing in for ciphertext. the block gets the capacity the plugin gives it, a body that does
+	// not shrink below it is sent as it is, so the random case times how quickly lz4 gives up
+	void AddCompressionCases(std::vector<BenchCase>& cases)
+	{
+		using Envelope = MsgSchema::FRAMEWORKMSG_COMPRESSED_Body;
+
+		SnapshotDeltaBaselines sender;
+		std::vector<uint8_t> snapshot = MakeSnapshotBody(256, false, sender);
+
+		std::mt19937 random(17);
+		std::vector<uint8_t> mails;
+		const char* senders[] = { "System", "GuildMaster", "Arena", "Market" };
+		const char* subjects[] = { "Daily reward", "Season ranking reward", "Item sold", "Guild war result", "Maintenance compensation" };
+		while (mails.size() < 4096) {
+			std::string mail = std::string(senders[random() % 4]) + "|" + subjects[random() % 5] + "|item " + std::to_string(10000 + random() % 500) +
+				" x" + std::to_string(1 + random() % 99) + "|expires 2026-11-" + std::to_string(10 + random() % 20);
+			uint16_t length = (uint16_t)mail.size();
+			mails.insert(mails.end(), (const uint8_t*)&length, (const uint8_t*)&length + sizeof(length));
+			mails.insert(mails.end(), mail.begin(), mail.end());
+		}
+
+		std::vector<uint8_t> noise(4096);
+		for (uint8_t& byte : noise) {
+			byte = (uint8_t)random();
+		}
+
+		const std::pair<const char*, std::vector<uint8_t>*> bodies[] = { { "snapshot", &snapshot }, { "mail", &mails }, { "random", &noise } };
+		for (const auto& [bodyName, source] : bodies) {
+			std::shared_ptr<std::vector<uint8_t>> body = std::make_shared<std::vector<uint8_t>>(*source);
+			int capacity = (int)(body->size() - Envelope::FixedSize - 1);
+			std::shared_ptr<std::vector<uint8_t>> block = std::make_shared<std::vector<uint8_t>>(capacity);
+			std::shared_ptr<std::vector<uint8_t>> restored = std::make_shared<std::vector<uint8_t>>(body->size());
+			std::string name = std::string("lz4.") + bodyName + "." + std::to_string(body->size() / 1024) + "k";
+			bool shrinks = std::strcmp(bodyName, "random") != 0;
+
+			auto report = [body](std::shared_ptr<int> blockSize) {
+				return [body, blockSize](const BenchResult&) {
+					if (*blockSize == 0) {
+						return std::string("does not shrink, sent as it is");
+					}
+					char line[128];
+					std::snprintf(line, sizeof(line), "ratio %.3f, %zu -> %zu bytes with the envelope",
+						(double)(*blockSize + Envelope::FixedSize) / body->size(), body->size(), *blockSize + Envelope::FixedSize);
+					return std::string(line);
+				};
+			};
+
+			// lz4_compress_default and the high compression mode at its lowest level, more cpu for a smaller block
+			const std::pair<const char*, int> levels[] = { { ".compress", 0 }, { ".compress_hc", LZ4HC_CLEVEL_MIN } };
+			for (const auto& [suffix, level] : levels) {
+				std::shared_ptr<int> blockSize = std::make_shared<int>(0);
+				auto compress = [body, block, capacity, level = level]() {
+					return level == 0
+						? LZ4_compress_default((const char*)body->data(), (char*)block->data(), (int)body->size(), capacity)
+						: LZ4_compress_HC((const char*)body->data(), (char*)block->data(), (int)body->size(), capacity, level);
+				};
+
+				cases.push_back({ name + suffix, body->size(),
+					[=]() {
+						*blockSize = compress();
+						if (*blockSize == 0) {
+							return shrinks == false;
+						}
+						int restoredSize = LZ4_decompress_safe((const char*)block->data(), (char*)restored->data(), *blockSize, (int)restored->size());
+						return shrinks && restoredSize == (int)body->size() && *restored == *body;
+					},
+					[=]() { Consume((uint64_t)compress()); },
+					report(blockSize) });
+			}
+
+			if (shrinks == false) {
+				continue;
+			}
+
+			std::shared_ptr<std::vector<uint8_t>> compressed = std::make_shared<std::vector<uint8_t>>(block->size());
+			int compressedSize = LZ4_compress_default((const char*)body->data(), (char*)compressed->data(), (int)body->size(), capacity);
+			compressed->resize((size_t)compressedSize);
+
+			cases.push_back({ name + ".decompress", body->size(),
+				[=]() {
+					int restoredSize = LZ4_decompress_safe((const char*)compressed->data(), (char*)restored->data(), (int)compressed->size(), (int)restored->size());
+					return restoredSize == (int)body->size() && *restored == *body;
+				},
+				[=]() {
+					Consume((uint64_t)LZ4_decompress_safe((const char*)compressed->data(), (char*)restored->data(), (int)compressed->size(), (int)restored->size()));
+				} });
+		}
+	}
+#endif
+
+	// the pre-cache Security::EncryptPacket: the key schedule expanded for every body and the output copied back
+	// from a scratch buffer. same cfb128 stream as StreamCipher, so the two have to produce the same bytes
+	struct RekeyedCipher
+	{
+		std::vector<uint8_t> key;
+		uint8_t iv[AES_BLOCK_SIZE];
+
+		bool Encrypt(uint8_t* data, size_t size)
+		{
+			AES_KEY encKey;
+			if (AES_set_encrypt_key(key.data(), (int)key.size() * 8, &encKey) < 0) {
+				return false;
+			}
+
+			std::vector<uint8_t> buffer(size);
+			int num = 0;
+			AES_cfb128_encrypt(data, buffer.data(), size, &encKey, iv, &num, AES_ENCRYPT);
+			std::memcpy(data, buffer.data(), size);
+			return true;
+		}
+	};
+
+	void AddCipherCases(std::vector<BenchCase>& cases)
+	{
+		// a move or chat body, the bulk of what goes out, and a fragment slice of a large list
+		const std::pair<size_t, const char*> sizes[] = { { 64, "64" }, { 1024, "1k" }, { 16384, "16k" } };
+
+		for (size_t keySize : { (size_t)16, (size_t)32 }) {
+			uint8_t key[32];
+			uint8_t iv[16];
+			for (size_t i = 0; i < sizeof(key); ++i) {
+				key[i] = (uint8_t)(i * 31 + 5);
+			}
+			for (size_t i = 0; i < sizeof(iv); ++i) {
+				iv[i] = (uint8_t)(i * 17 + 3);
+			}
+
+			for (const auto& [size, sizeName] : sizes) {
+				std::shared_ptr<NetCore::StreamCipher> cipher = std::make_shared<NetCore::StreamCipher>();
+				if (cipher->Init(key, keySize, iv, sizeof(iv)) == false) {
+					std::fprintf(stderr, "cipher init failed for a %zu byte key\n", keySize);
+					std::exit(-1);
+				}
+
+				std::shared_ptr<RekeyedCipher> rekeyed = std::make_shared<RekeyedCipher>();
+				rekeyed->key.assign(key, key + keySize);
+				std::memcpy(rekeyed->iv, iv, sizeof(iv));
+
+				std::shared_ptr<std::vector<uint8_t>> plain = std::make_shared<std::vector<uint8_t>>(size);
+				for (size_t i = 0; i < size; ++i) {
+					(*plain)[i] = (uint8_t)(i * 13);
+				}
+				std::shared_ptr<std::vector<uint8_t>> data = std::make_shared<std::vector<uint8_t>>(*plain);
+				std::string name = "cipher.aes" + std::to_string(keySize * 8) + "." + sizeName;
+
+				cases.push_back({ name + ".encrypt", size,
+					[=]() {
+						NetCore::StreamCipher peer;
+						peer.Init(key, keySize, iv, sizeof(iv));
+						std::vector<uint8_t> buffer = *plain;
+						for (int round = 0; round < 4; ++round) {
+							if (peer.Encrypt(buffer.data(), buffer.size()) == false || buffer == *plain) {
+								return false;
+							}
+							if (peer.Decrypt(buffer.data(), buffer.size()) == false || buffer != *plain) {
+								return false;
+							}
+						}
+						return true;
+					},
+					[=]() {
+						cipher->Encrypt(data->data(), data->size());
+						Consume((*data)[0]);
+					} });
+
+				cases.push_back({ name + ".decrypt", size,
+					[=]() { return true; },
+					[=]() {
+						cipher->Decrypt(data->data(), data->size());
+						Consume((*data)[0]);
+					} });
+
+				cases.push_back({ name + ".rekeyed", size,
+					[=]() {
+						NetCore::StreamCipher cached;
+						cached.Init(key, keySize, iv, sizeof(iv));
+						RekeyedCipher old;
+						old.key.assign(key, key + keySize);
+						std::memcpy(old.iv, iv, sizeof(iv));
+
+						std::vector<uint8_t> expected = *plain;
+						std::vector<uint8_t> buffer = *plain;
+						for (int round = 0; round < 4; ++round) {
+							if (cached.Encrypt(expected.data(), expected.size()) == false || old.Encrypt(buffer.data(), buffer.size()) == false ||
+								buffer != expected) {
+								return false;
+							}
+						}
+						return true;
+					},
+					[=]() {
+						rekeyed->Encrypt(data->data(), data->size());
+						Consume((*data)[0]);
+					} });
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool quick = false;
+	const char* filter = nullptr;
+	const char* thresholdsPath = nullptr;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--quick") {
+			quick = true;
+		} else if (arg == "--filter" && i + 1 < argc) {
+			filter = argv[++i];
+		} else if (arg == "--thresholds" && i + 1 < argc) {
+			thresholdsPath = argv[++i];
+		} else {
+			std::fprintf(stderr, "usage: %s [--quick] [--filter <substring>] [--thresholds <file>]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	std::vector<BenchCase> cases;
+	AddVarintCases(cases);
+	AddArrayCases(cases);
+	AddStringCases(cases);
+	AddBodies(cases);
+	AddRingCases(cases);
+	AddReceiveAllocCases(cases);
+	AddMpscCases(cases);
+#if NETCORE_EPOLL
+	AddWakeupCases(cases);
+#endif
+#if NETCORE_BENCH_SOCKETS
+	AddFramerCases(cases);
+#endif
+	AddSnapshotCases(cases);
+#if NETCORE_BENCH_LZ4
+	AddCompressionCases(cases);
+#endif
+	AddCipherCases(cases);
+
+	std::map<std::string, double> thresholds;
+	if (thresholdsPath) {
+		thresholds = LoadThresholds(thresholdsPath);
+	}
+
+	int failures = 0;
+	std::printf("%-32s %12s %12s %12s\n", "case", "ns/op", "MB/s", "max ns");
+	for (const BenchCase& bench : cases) {
+		if (filter && bench.name.find(filter) == std::string::npos) {
+			continue;
+		}
+
+		if (bench.verify() == false) {
+			std::printf("%-32s round trip FAILED\n", bench.name.c_str());
+			++failures;
+			continue;
+		}
+
+		BenchResult result = Measure(bench, quick ? 0.02 : 0.2, quick ? 3 : 5);
+
+		auto threshold = thresholds.find(bench.name);
+		bool regressed = threshold != thresholds.end() && result.nsPerOp > threshold->second;
+		if (regressed) {
+			++failures;
+		}
+
+		char limit[32] = "-";
+		if (threshold != thresholds.end()) {
+			std::snprintf(limit, sizeof(limit), "%.0f", threshold->second);
+		}
+		std::printf("%-32s %12.1f %12.1f %12s%s\n", bench.name.c_str(), result.nsPerOp, result.mbPerSec, limit, regressed ? "  REGRESSED" : "");
+		if (bench.report) {
+			std::printf("    %s\n", bench.report(result).c_str());
+		}
+	}
+
+	return failures;
+}
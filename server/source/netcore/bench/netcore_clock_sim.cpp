@@ -0,0 +1,170 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+// the heartbeat clock estimator over a simulated link, one case per delay / jitter / loss profile.
+//   netcore_clock_sim [--seeds <count>] [--verbose]
+// a case fails when, over any seed, the offset estimate does not stay within its tolerance soon enough or the smoothed
+// round trip ends up too far from the true mean. the exit code is the number of failed cases (ctest runs it, see CMakeLists.txt)
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "netcore_clock.h"
+
+namespace
+{
+	struct LinkProfile
+	{
+		const char* name;
+		// one way, every packet takes at least this long
+		double baseMs;
+		// mean of the exponential queueing delay on top, per direction
+		double jitterMs;
+		double loss;
+
+		// the estimate has to stay this close to the true offset from convergeSeconds on
+		double offsetToleranceMs;
+		double convergeSeconds;
+		// mean distance of the smoothed rtt to the true mean over the second half
+		double rttToleranceMs;
+	};
+
+	// probes go out at the fast rate the client uses while the estimate settles and during combat
+	constexpr double ProbeIntervalSeconds = 1.0;
+	constexpr double RunSeconds = 300.0;
+	constexpr double ServerHoldMaxMs = 2.0;
+	constexpr double ServerDriftPpm = 20.0;
+	constexpr int64_t ServerEpochMicros = 1700000000LL * 1000000LL;
+
+	const LinkProfile Profiles[] = {
+		{ "lan",        1.0,   0.3,  0.00,   1.0,  5.0,  1.0 },
+		{ "wifi",       8.0,   4.0,  0.01,   5.0, 15.0,  4.0 },
+		{ "mobile",    30.0,  15.0,  0.05,  15.0, 30.0, 12.0 },
+		{ "congested", 60.0,  40.0,  0.20,  40.0, 60.0, 35.0 },
+	};
+
+	struct CaseResult
+	{
+		// seconds from which on the offset error stayed within tolerance
+		double convergedAt = 0.0;
+		double offsetErrorMaxMs = 0.0;
+		double offsetErrorMeanMs = 0.0;
+		double rttErrorMeanMs = 0.0;
+		double jitterMs = 0.0;
+		uint32_t answered = 0;
+	};
+
+	CaseResult Simulate(const LinkProfile& link, uint32_t seed)
+	{
+		std::mt19937_64 rng(seed);
+		std::uniform_real_distribution<double> unit(0.0, 1.0);
+		std::exponential_distribution<double> queueing(1.0 / std::max(link.jitterMs, 1e-6));
+
+		auto oneWayMs = [&] { return link.baseMs + (link.jitterMs > 0.0 ? queueing(rng) : 0.0); };
+		auto serverClock = [](double seconds) {
+			return ServerEpochMicros + (int64_t)std::llround(seconds * (1.0 + ServerDriftPpm * 1e-6) * 1e6);
+		};
+
+		NetCore::ClockEstimator estimator;
+		CaseResult result;
+
+		// the delay leaves out the time the server held the probe
+		double trueRttMs = 2.0 * (link.baseMs + link.jitterMs);
+		double lastViolation = 0.0;
+		double errorSum = 0.0;
+		double rttErrorSum = 0.0;
+		uint32_t secondHalf = 0;
+
+		for (double sent = 0.0; sent < RunSeconds; sent += ProbeIntervalSeconds) {
+			// either direction may drop the probe, the client just sends the next one
+			if (unit(rng) < link.loss || unit(rng) < link.loss) {
+				continue;
+			}
+
+			double arrived = sent + oneWayMs() / 1000.0;
+			double answered = arrived + unit(rng) * ServerHoldMaxMs / 1000.0;
+			double received = answered + oneWayMs() / 1000.0;
+
+			NetCore::ClockSample sample;
+			sample.clientSent = (int64_t)std::llround(sent * 1e6);
+			sample.serverReceived = serverClock(arrived);
+			sample.serverSent = serverClock(answered);
+			sample.clientReceived = (int64_t)std::llround(received * 1e6);
+			estimator.AddSample(sample);
+			++result.answered;
+
+			const NetCore::ClockEstimate& estimate = estimator.GetEstimate();
+			int64_t trueOffset = serverClock(received) - sample.clientReceived;
+			double errorMs = std::fabs((double)(estimate.offset - trueOffset)) / 1000.0;
+			if (errorMs > link.offsetToleranceMs) {
+				lastViolation = received;
+			}
+
+			if (sent >= RunSeconds / 2) {
+				result.offsetErrorMaxMs = std::max(result.offsetErrorMaxMs, errorMs);
+				errorSum += errorMs;
+				rttErrorSum += std::fabs(estimate.rtt / 1000.0 - trueRttMs);
+				++secondHalf;
+			}
+		}
+
+		result.convergedAt = lastViolation;
+		if (secondHalf > 0) {
+			result.offsetErrorMeanMs = errorSum / secondHalf;
+			result.rttErrorMeanMs = rttErrorSum / secondHalf;
+		}
+		result.jitterMs = estimator.GetEstimate().jitter / 1000.0;
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t seeds = 16;
+	bool verbose = false;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--seeds" && i + 1 < argc) {
+			seeds = (uint32_t)std::max(1, std::atoi(argv[++i]));
+		} else if (arg == "--verbose") {
+			verbose = true;
+		} else {
+			std::fprintf(stderr, "usage: %s [--seeds <count>] [--verbose]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	int failures = 0;
+	std::printf("%-12s %10s %10s %12s %12s %12s %10s\n", "link", "converged", "limit", "offset max", "offset mean", "rtt error", "jitter");
+	for (const LinkProfile& link : Profiles) {
+		// the worst seed is what counts
+		CaseResult worst;
+		for (uint32_t seed = 1; seed <= seeds; ++seed) {
+			CaseResult result = Simulate(link, seed);
+			if (verbose) {
+				std::printf("  %-10s seed %-4u converged %6.1f s offset max %7.3f ms rtt error %7.3f ms answered %u\n",
+					link.name, seed, result.convergedAt, result.offsetErrorMaxMs, result.rttErrorMeanMs, result.answered);
+			}
+
+			worst.convergedAt = std::max(worst.convergedAt, result.convergedAt);
+			worst.offsetErrorMaxMs = std::max(worst.offsetErrorMaxMs, result.offsetErrorMaxMs);
+			worst.offsetErrorMeanMs = std::max(worst.offsetErrorMeanMs, result.offsetErrorMeanMs);
+			worst.rttErrorMeanMs = std::max(worst.rttErrorMeanMs, result.rttErrorMeanMs);
+			worst.jitterMs = std::max(worst.jitterMs, result.jitterMs);
+		}
+
+		bool failed = worst.convergedAt > link.convergeSeconds || worst.rttErrorMeanMs > link.rttToleranceMs;
+		if (failed) {
+			++failures;
+		}
+
+		std::printf("%-12s %9.1fs %9.1fs %10.3fms %10.3fms %10.3fms %8.3fms%s\n", link.name, worst.convergedAt, link.convergeSeconds,
+			worst.offsetErrorMaxMs, worst.offsetErrorMeanMs, worst.rttErrorMeanMs, worst.jitterMs, failed ? "  FAILED" : "");
+	}
+
+	return failures;
+}
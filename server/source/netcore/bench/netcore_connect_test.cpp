@@ -0,0 +1,840 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+// the connect state machine of the pump thread, NetCore::ConnectDriver and ConnectRace, the same code FNetConnectDriver
+// runs in the plugin. two transports drive it:
+// - a scripted one on a simulated clock, addresses answer, refuse or stay silent at set times and lookups finish late
+//   or never. the pump loop waits what GetWaitMsec allows or until the next scripted event, like the poller would.
+// - loopback sockets watched by the epoll poller: 50 connects to a local listener plus one to a port nobody listens
+//   on, started in the same pump iteration while the game thread keeps waking the pump through the MPSC queue.
+//   netcore_connect_test [--verbose]
+// it fails when the race does not start the next address after the attempt delay or right after a failure, the loser
+// is not closed, a retry does not wait out its backoff or comes off schedule, the tries, the attempt timeout, the lookup
+// timeout or the connect deadline are not kept to the msec, a connect to the listener does not complete, the refused
+// port is not reported as refused before its timeout, or a wakeup waits longer than MaxServiceMs for the pump.
+// the exit code is the number of failed checks (ctest runs it, see CMakeLists.txt)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "netcore_connect.h"
+#include "netcore_mpsc.h"
+#include "netcore_poller.h"
+
+#if NETCORE_EPOLL
+#include <cerrno>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	// a deadline fires on the msec GetWaitMsec rounded up to
+	constexpr double Slack = 0.0011;
+	constexpr double Never = -1.0;
+	constexpr double Forever = std::numeric_limits<double>::infinity();
+
+	int failures = 0;
+	bool verbose = false;
+
+	void Check(bool ok, const char* what)
+	{
+		if (ok == false) {
+			std::printf("  FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	bool Near(double value, double expected)
+	{
+		return value >= expected - 1e-9 && value <= expected + Slack;
+	}
+
+	// what an address does once an attempt on it started, in seconds after the start. Never stays silent
+	struct Script
+	{
+		double connectAfter = Never;
+		double failAfter = Never;
+		// the connect call itself fails
+		bool failAtOnce = false;
+	};
+
+	// a lookup answers resolveAfter seconds after it started, Never leaves it running forever
+	struct Lookup
+	{
+		std::vector<int32_t> addresses;
+		double resolveAfter = 0.0;
+	};
+
+	// sockets, lookups and the clock of one scripted run, every call is recorded with its time
+	class ScriptedTransport
+	{
+	public:
+		// index into the sockets opened so far
+		using Socket = int32_t;
+		// index into the scripts
+		using Address = int32_t;
+		// index into the lookups
+		using Context = int32_t;
+
+		struct Opened
+		{
+			Address address = 0;
+			double at = 0.0;
+			bool closed = false;
+		};
+
+		struct Ended
+		{
+			Address address = 0;
+			NetCore::AttemptState state = NetCore::AttemptState::Pending;
+			double at = 0.0;
+		};
+
+		struct TryFailed
+		{
+			NetCore::TryFailure failure = NetCore::TryFailure::RaceFailed;
+			double retryIn = 0.0;
+			double at = 0.0;
+		};
+
+		struct Completed
+		{
+			Context context = 0;
+			NetCore::ConnectOutcome outcome = NetCore::ConnectOutcome::Retired;
+			Socket socket = -1;
+			Address address = -1;
+			double seconds = 0.0;
+			double at = 0.0;
+		};
+
+		double now = 0.0;
+		NetCore::ConnectSettings settings;
+		std::vector<Script> scripts;
+		std::vector<Lookup> lookups;
+		// handed out in turn by Random()
+		std::vector<double> randoms = { 0.5 };
+
+		std::vector<Opened> opened;
+		std::vector<Ended> ended;
+		std::vector<TryFailed> tryFailures;
+		std::vector<Completed> completed;
+		std::vector<double> resolvesBegun;
+		uint32_t resolvesAbandoned = 0;
+		uint32_t closedTwice = 0;
+
+		NetCore::ConnectSettings GetSettings() { return settings; }
+
+		double Random()
+		{
+			double random = randoms[_nextRandom % randoms.size()];
+			++_nextRandom;
+			return random;
+		}
+
+		bool Open(const Address& address, Socket& socket)
+		{
+			if (scripts[address].failAtOnce) {
+				return false;
+			}
+
+			socket = (Socket)opened.size();
+			opened.push_back(Opened{ address, now, false });
+			return true;
+		}
+
+		NetCore::AttemptState Check(Socket& socket)
+		{
+			const Opened& open = opened[socket];
+			const Script& script = scripts[open.address];
+			if (script.connectAfter >= 0.0 && now >= open.at + script.connectAfter) {
+				return NetCore::AttemptState::Connected;
+			}
+			if (script.failAfter >= 0.0 && now >= open.at + script.failAfter) {
+				return NetCore::AttemptState::Failed;
+			}
+			return NetCore::AttemptState::Pending;
+		}
+
+		void Close(Socket& socket)
+		{
+			closedTwice += opened[socket].closed ? 1 : 0;
+			opened[socket].closed = true;
+		}
+
+		void OnAttempt(const Address& address, double, NetCore::AttemptState state)
+		{
+			ended.push_back(Ended{ address, state, now });
+		}
+
+		void BeginResolve(Context& context)
+		{
+			resolvesBegun.push_back(now);
+			_resolving.resize(lookups.size(), Never);
+			_resolving[context] = now;
+		}
+
+		bool TakeResolved(Context& context, std::vector<Address>& addresses)
+		{
+			const Lookup& lookup = lookups[context];
+			if (lookup.resolveAfter < 0.0 || now < _resolving[context] + lookup.resolveAfter) {
+				return false;
+			}
+
+			_resolving[context] = Never;
+			addresses = lookup.addresses;
+			return true;
+		}
+
+		void AbandonResolve(Context& context)
+		{
+			_resolving[context] = Never;
+			++resolvesAbandoned;
+		}
+
+		void OnTryFailed(Context&, NetCore::TryFailure failure, double retryIn)
+		{
+			tryFailures.push_back(TryFailed{ failure, retryIn, now });
+		}
+
+		void OnCompleted(Context& context, NetCore::ConnectOutcome outcome, Socket* socket, const Address* address, double seconds)
+		{
+			Completed done{ context, outcome, -1, -1, seconds, now };
+			if (socket) {
+				done.socket = *socket;
+				done.address = *address;
+			}
+			completed.push_back(done);
+		}
+
+		// the next handshake or lookup that ends after now, the poller would wake the pump for it
+		double NextEvent() const
+		{
+			double next = Forever;
+			for (const Opened& open : opened) {
+				if (open.closed) {
+					continue;
+				}
+				const Script& script = scripts[open.address];
+				for (double after : { script.connectAfter, script.failAfter }) {
+					if (after >= 0.0 && open.at + after > now) {
+						next = std::min(next, open.at + after);
+					}
+				}
+			}
+			for (size_t i = 0; i < _resolving.size(); ++i) {
+				if (_resolving[i] >= 0.0 && lookups[i].resolveAfter >= 0.0 && _resolving[i] + lookups[i].resolveAfter > now) {
+					next = std::min(next, _resolving[i] + lookups[i].resolveAfter);
+				}
+			}
+			return next;
+		}
+
+		uint32_t OpenSockets() const
+		{
+			uint32_t open = 0;
+			for (const Opened& socket : opened) {
+				open += socket.closed ? 0 : 1;
+			}
+			return open;
+		}
+
+	private:
+		size_t _nextRandom = 0;
+		// start of the running lookup per context, Never when none runs
+		std::vector<double> _resolving;
+	};
+
+	using ScriptedDriver = NetCore::ConnectDriver<ScriptedTransport>;
+
+	// the pump: waits what the driver allows or until a socket or lookup would wake it, then advances. returns the wakeups
+	uint32_t Pump(ScriptedDriver& driver, ScriptedTransport& transport, double until)
+	{
+		uint32_t wakeups = 0;
+		while (driver.IsEmpty() == false && wakeups < 10000) {
+			uint32_t waitMsec = driver.GetWaitMsec(transport.now);
+			double next = waitMsec == NetCore::TimerHeap::NoDeadline ? Forever : transport.now + waitMsec / 1000.0;
+			next = std::min(next, transport.NextEvent());
+			if (next == Forever || next > until) {
+				break;
+			}
+
+			transport.now = std::max(next, transport.now);
+			driver.Advance(transport.now);
+			++wakeups;
+		}
+		return wakeups;
+	}
+
+	// one connect over the given addresses, the lookup answering right away
+	void StartOne(ScriptedDriver& driver, ScriptedTransport& transport, std::vector<int32_t> addresses, double timeout)
+	{
+		transport.lookups.push_back(Lookup{ std::move(addresses), 0.0 });
+		driver.Start((int32_t)transport.lookups.size() - 1, (int32_t)transport.lookups.size() - 1, timeout, transport.now);
+		driver.Advance(transport.now);
+	}
+
+	void Report(const char* name, const ScriptedTransport& transport, uint32_t wakeups)
+	{
+		Check(transport.closedTwice == 0, "socket closed twice");
+		if (verbose == false) {
+			return;
+		}
+
+		std::printf("  %-10s %zu opened, %zu ended, %zu tries failed, %u wakeups", name, transport.opened.size(), transport.ended.size(),
+			transport.tryFailures.size(), wakeups);
+		for (const ScriptedTransport::Completed& done : transport.completed) {
+			std::printf(", completed %d after %.4f sec", (int)done.outcome, done.seconds);
+		}
+		std::printf("\n");
+	}
+
+	// the second address starts attemptDelay after the first, which never answers, wins and the first is closed
+	void RunFallback()
+	{
+		ScriptedTransport transport;
+		transport.scripts = { Script{}, Script{ 0.05 } };
+		ScriptedDriver driver(transport);
+		StartOne(driver, transport, { 0, 1 }, 0.0);
+		uint32_t wakeups = Pump(driver, transport, 60.0);
+		Report("fallback", transport, wakeups);
+
+		double delay = transport.settings.attemptDelay;
+		Check(transport.opened.size() == 2 && transport.opened[0].at == 0.0, "fallback: first address not tried at once");
+		Check(transport.opened.size() == 2 && Near(transport.opened[1].at, delay), "fallback: second address not tried after the attempt delay");
+		Check(transport.completed.size() == 1 && transport.completed[0].outcome == NetCore::ConnectOutcome::Connected, "fallback: race not won");
+		if (transport.completed.size() == 1 && transport.opened.size() == 2) {
+			const ScriptedTransport::Completed& done = transport.completed[0];
+			Check(done.address == 1 && done.socket == 1 && Near(done.seconds, delay + 0.05), "fallback: wrong winner or late");
+			Check(transport.opened[0].closed && transport.opened[1].closed == false, "fallback: loser kept or winner closed");
+		}
+		Check(transport.tryFailures.empty() && driver.IsEmpty(), "fallback: connect retried or left behind");
+		Check(wakeups <= 3, "fallback: pump woke without anything to do");
+	}
+
+	// an address whose connect fails at once or is refused lets the next one start right away
+	void RunFailFast()
+	{
+		ScriptedTransport transport;
+		Script refused;
+		refused.failAfter = 0.01;
+		Script failing;
+		failing.failAtOnce = true;
+		transport.scripts = { failing, refused, Script{ 0.02 } };
+		ScriptedDriver driver(transport);
+		StartOne(driver, transport, { 0, 1, 2 }, 0.0);
+		uint32_t wakeups = Pump(driver, transport, 60.0);
+		Report("failfast", transport, wakeups);
+
+		Check(transport.opened.size() == 2 && transport.opened[0].address == 1 && transport.opened[0].at == 0.0,
+			"failfast: failed connect call held back the next address");
+		Check(transport.opened.size() == 2 && Near(transport.opened[1].at, 0.01), "failfast: refused attempt held back the next address");
+		Check(transport.ended.size() == 3 && transport.ended[0].state == NetCore::AttemptState::Failed && transport.ended[1].state == NetCore::AttemptState::Failed
+			&& transport.ended[2].state == NetCore::AttemptState::Connected, "failfast: attempts not reported");
+		Check(transport.completed.size() == 1 && transport.completed[0].address == 2 && Near(transport.completed[0].seconds, 0.03),
+			"failfast: third address did not win in time");
+	}
+
+	// every try is refused, each retry waits out its backoff and the tries run out
+	void RunBackoff()
+	{
+		ScriptedTransport transport;
+		transport.settings.retries = 5;
+		transport.settings.backoffBase = 0.5;
+		transport.settings.backoffMax = 2.0;
+		transport.randoms = { 0.0, 0.99, 0.25, 0.75 };
+		Script refused;
+		refused.failAfter = 0.01;
+		transport.scripts = { refused };
+		ScriptedDriver driver(transport);
+		StartOne(driver, transport, { 0 }, 0.0);
+		uint32_t wakeups = Pump(driver, transport, 600.0);
+		Report("backoff", transport, wakeups);
+
+		const uint32_t retries = (uint32_t)transport.settings.retries;
+		Check(transport.opened.size() == retries && transport.resolvesBegun.size() == retries, "backoff: tries not used up");
+		Check(transport.tryFailures.size() == retries, "backoff: failed tries not reported");
+		Check(transport.completed.size() == 1 && transport.completed[0].outcome == NetCore::ConnectOutcome::Retired, "backoff: not retired");
+
+		bool spread = true;
+		bool onTime = true;
+		for (size_t i = 0; i < transport.tryFailures.size() && i < transport.opened.size(); ++i) {
+			const ScriptedTransport::TryFailed& failed = transport.tryFailures[i];
+			if (i + 1 == retries) {
+				spread &= failed.retryIn < 0.0;
+				break;
+			}
+
+			// equal jitter below a ceiling doubling from the base up to the max
+			double ceiling = std::min(transport.settings.backoffMax, transport.settings.backoffBase * (double)(1u << i));
+			double random = transport.randoms[i % transport.randoms.size()];
+			spread &= std::abs(failed.retryIn - ceiling * (0.5 + 0.5 * random)) < 1e-9;
+			onTime &= i + 1 < transport.opened.size() && Near(transport.opened[i + 1].at, failed.at + failed.retryIn);
+		}
+		Check(spread, "backoff: delays off the schedule");
+		Check(onTime, "backoff: retry not at the end of its delay");
+		// every wakeup is a handshake that ended or a retry that is due
+		Check(wakeups <= retries * 2, "backoff: pump woke without anything to do");
+		Check(transport.OpenSockets() == 0, "backoff: socket left open");
+	}
+
+	// the attempt timeout closes a silent address, the connect deadline ends everything in between
+	void RunTimeouts()
+	{
+		{
+			ScriptedTransport transport;
+			transport.settings.attemptTimeout = 0.5;
+			transport.settings.retries = 2;
+			transport.scripts = { Script{} };
+			ScriptedDriver driver(transport);
+			StartOne(driver, transport, { 0 }, 0.0);
+			uint32_t wakeups = Pump(driver, transport, 60.0);
+			Report("attempt", transport, wakeups);
+
+			Check(transport.ended.size() == 2 && transport.ended[0].state == NetCore::AttemptState::TimedOut && Near(transport.ended[0].at, 0.5),
+				"attempt timeout: silent address not given up in time");
+			Check(transport.completed.size() == 1 && transport.completed[0].outcome == NetCore::ConnectOutcome::Retired, "attempt timeout: not retired");
+			Check(transport.OpenSockets() == 0, "attempt timeout: socket left open");
+		}
+
+		{
+			ScriptedTransport transport;
+			transport.scripts = { Script{} };
+			ScriptedDriver driver(transport);
+			StartOne(driver, transport, { 0 }, 1.5);
+			uint32_t wakeups = Pump(driver, transport, 60.0);
+			Report("deadline", transport, wakeups);
+
+			Check(transport.completed.size() == 1 && transport.completed[0].outcome == NetCore::ConnectOutcome::TimedOut
+				&& Near(transport.completed[0].seconds, 1.5), "deadline: connect not timed out on its deadline");
+			Check(transport.tryFailures.empty() && transport.OpenSockets() == 0, "deadline: attempt left open or retried");
+		}
+
+		{
+			// the deadline falls into a backoff wait
+			ScriptedTransport transport;
+			transport.settings.backoffBase = 4.0;
+			Script refused;
+			refused.failAfter = 0.01;
+			transport.scripts = { refused };
+			ScriptedDriver driver(transport);
+			StartOne(driver, transport, { 0 }, 1.0);
+			uint32_t wakeups = Pump(driver, transport, 60.0);
+			Report("backoff+dl", transport, wakeups);
+
+			Check(transport.completed.size() == 1 && transport.completed[0].outcome == NetCore::ConnectOutcome::TimedOut
+				&& Near(transport.completed[0].seconds, 1.0), "deadline: backoff wait outlived the deadline");
+		}
+	}
+
+	// a lookup that never answers is abandoned after its timeout, an empty one is a failed try, a late one starts the race late
+	void RunResolve()
+	{
+		{
+			ScriptedTransport transport;
+			transport.settings.resolveTimeout = 0.3;
+			transport.settings.retries = 2;
+			transport.lookups.push_back(Lookup{ { 0 }, Never });
+			transport.scripts = { Script{ 0.01 } };
+			ScriptedDriver driver(transport);
+			driver.Start(0, 0, 0.0, transport.now);
+			driver.Advance(transport.now);
+			uint32_t wakeups = Pump(driver, transport, 60.0);
+			Report("dns hang", transport, wakeups);
+
+			Check(transport.tryFailures.size() == 2 && transport.tryFailures[0].failure == NetCore::TryFailure::ResolveTimedOut
+				&& Near(transport.tryFailures[0].at, 0.3), "resolve timeout: lookup not given up in time");
+			Check(transport.resolvesBegun.size() == 2 && transport.resolvesAbandoned == 2, "resolve timeout: lookups not abandoned");
+			Check(transport.opened.empty() && transport.completed.size() == 1 && transport.completed[0].outcome == NetCore::ConnectOutcome::Retired,
+				"resolve timeout: not retired");
+		}
+
+		{
+			ScriptedTransport transport;
+			transport.settings.retries = 2;
+			transport.lookups.push_back(Lookup{ {}, 0.02 });
+			ScriptedDriver driver(transport);
+			driver.Start(0, 0, 0.0, transport.now);
+			uint32_t wakeups = Pump(driver, transport, 60.0);
+			Report("dns fail", transport, wakeups);
+
+			Check(transport.tryFailures.size() == 2 && transport.tryFailures[0].failure == NetCore::TryFailure::ResolveFailed
+				&& Near(transport.tryFailures[0].at, 0.02), "resolve failure: not reported as a failed try");
+			Check(transport.resolvesAbandoned == 0, "resolve failure: finished lookup abandoned");
+		}
+
+		{
+			ScriptedTransport transport;
+			transport.lookups.push_back(Lookup{ { 0 }, 0.2 });
+			transport.scripts = { Script{ 0.01 } };
+			ScriptedDriver driver(transport);
+			driver.Start(0, 0, 0.0, transport.now);
+			uint32_t wakeups = Pump(driver, transport, 60.0);
+			Report("dns late", transport, wakeups);
+
+			Check(transport.opened.size() == 1 && Near(transport.opened[0].at, 0.2), "late lookup: race not started when it answered");
+			Check(transport.completed.size() == 1 && transport.completed[0].outcome == NetCore::ConnectOutcome::Connected, "late lookup: not connected");
+		}
+	}
+
+	// connects on different keys run side by side, CancelAll closes their sockets and abandons their lookups without a report
+	void RunCancel()
+	{
+		ScriptedTransport transport;
+		transport.scripts = { Script{}, Script{} };
+		transport.lookups = { Lookup{ { 0, 1 }, 0.0 }, Lookup{ { 0 }, Never }, Lookup{ { 1 }, 0.0 } };
+		ScriptedDriver driver(transport);
+		Check(driver.Start(0, 0, 0.0, transport.now) && driver.Start(1, 1, 0.0, transport.now) && driver.Start(2, 2, 0.0, transport.now),
+			"cancel: connects not started");
+		Check(driver.Start(2, 2, 0.0, transport.now) == false, "cancel: key connecting twice");
+		driver.Advance(transport.now);
+		Pump(driver, transport, 0.3);
+
+		Check(driver.Num() == 3 && transport.OpenSockets() == 3, "cancel: connects not running side by side");
+		driver.CancelAll();
+		Check(driver.IsEmpty() && transport.OpenSockets() == 0 && transport.resolvesAbandoned == 1, "cancel: sockets or lookups left behind");
+		Check(transport.completed.empty() && driver.GetWaitMsec(transport.now) == NetCore::TimerHeap::NoDeadline, "cancel: reported or still scheduled");
+	}
+}
+
+#if NETCORE_EPOLL
+namespace
+{
+	constexpr uint32_t Connects = 50;
+	constexpr int Backlog = 64;
+	constexpr double AttemptTimeoutSeconds = 2.0;
+	// the game thread sends that often while the storm runs
+	constexpr auto ProbeInterval = std::chrono::microseconds(500);
+	constexpr uint32_t IdleProbes = 200;
+	constexpr double MaxServiceMs = 20.0;
+
+	double Now()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	sockaddr_in Loopback(uint16_t port)
+	{
+		sockaddr_in addr = {};
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+		addr.sin_port = htons(port);
+		return addr;
+	}
+
+	uint16_t BoundPort(int fd)
+	{
+		sockaddr_in addr = {};
+		socklen_t size = sizeof(addr);
+		::getsockname(fd, (sockaddr*)&addr, &size);
+		return ntohs(addr.sin_port);
+	}
+
+	int Listen(uint16_t& port)
+	{
+		int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+		sockaddr_in addr = Loopback(0);
+		if (fd < 0 || ::bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(fd, Backlog) != 0) {
+			std::fprintf(stderr, "listener failed, errno %d\n", errno);
+			std::exit(-1);
+		}
+		port = BoundPort(fd);
+		return fd;
+	}
+
+	// a port that was free a moment ago, connects to it are refused
+	uint16_t ClosedPort()
+	{
+		int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+		sockaddr_in addr = Loopback(0);
+		::bind(fd, (sockaddr*)&addr, sizeof(addr));
+		uint16_t port = BoundPort(fd);
+		::close(fd);
+		return port;
+	}
+
+	// what the plugin does with FSocket, on native descriptors: a non blocking connect watched by the poller,
+	// writable means the handshake ended
+	class SocketTransport
+	{
+	public:
+		using Socket = int;
+		// loopback port
+		using Address = uint16_t;
+		// index into the results
+		using Context = uint32_t;
+
+		struct Result
+		{
+			uint16_t port = 0;
+			NetCore::ConnectOutcome outcome = NetCore::ConnectOutcome::Retired;
+			bool completed = false;
+			int fd = -1;
+			// of the attempt that failed last
+			int error = 0;
+			double seconds = 0.0;
+		};
+
+		SocketTransport(NetCore::EpollPoller& poller, std::vector<Result>& results)
+			: _poller(poller), _results(results)
+		{
+			// one try, a refused port is retired right away
+			_settings.attemptTimeout = AttemptTimeoutSeconds;
+			_settings.retries = 1;
+		}
+
+		NetCore::ConnectSettings GetSettings() { return _settings; }
+		double Random() { return 0.5; }
+
+		bool Open(const Address& address, Socket& socket)
+		{
+			socket = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+			sockaddr_in addr = Loopback(address);
+			if (::connect(socket, (sockaddr*)&addr, sizeof(addr)) != 0 && errno != EINPROGRESS) {
+				_lastError = errno;
+				::close(socket);
+				socket = -1;
+				return false;
+			}
+
+			_poller.RegisterConnect(socket);
+			return true;
+		}
+
+		NetCore::AttemptState Check(Socket& socket)
+		{
+			pollfd writable = { socket, POLLOUT, 0 };
+			if (::poll(&writable, 1, 0) != 1) {
+				return NetCore::AttemptState::Pending;
+			}
+
+			int error = 0;
+			socklen_t size = sizeof(error);
+			::getsockopt(socket, SOL_SOCKET, SO_ERROR, &error, &size);
+			if (error != 0) {
+				_lastError = error;
+				return NetCore::AttemptState::Failed;
+			}
+			return NetCore::AttemptState::Connected;
+		}
+
+		void Close(Socket& socket)
+		{
+			_poller.Unregister(socket);
+			::close(socket);
+			socket = -1;
+		}
+
+		void OnAttempt(const Address&, double, NetCore::AttemptState) {}
+
+		// the loopback port needs no lookup
+		void BeginResolve(Context&) {}
+
+		bool TakeResolved(Context& context, std::vector<Address>& addresses)
+		{
+			addresses.push_back(_results[context].port);
+			return true;
+		}
+
+		void AbandonResolve(Context&) {}
+
+		void OnTryFailed(Context& context, NetCore::TryFailure, double) { _results[context].error = _lastError; }
+
+		void OnCompleted(Context& context, NetCore::ConnectOutcome outcome, Socket* socket, const Address*, double seconds)
+		{
+			Result& result = _results[context];
+			result.completed = true;
+			result.outcome = outcome;
+			result.seconds = seconds;
+			if (socket) {
+				// handed over, the session registers it for readability
+				_poller.Unregister(*socket);
+				result.fd = *socket;
+			}
+		}
+
+	private:
+		NetCore::EpollPoller& _poller;
+		std::vector<Result>& _results;
+		NetCore::ConnectSettings _settings;
+		int _lastError = 0;
+	};
+
+	double Percentile(std::vector<double> values, double percentile)
+	{
+		if (values.empty()) {
+			return 0.0;
+		}
+		std::sort(values.begin(), values.end());
+		return values[std::min(values.size() - 1, (size_t)(values.size() * percentile))];
+	}
+
+	void RunStorm()
+	{
+		uint16_t port = 0;
+		int listener = Listen(port);
+
+		std::vector<SocketTransport::Result> results(Connects + 1);
+		for (uint32_t i = 0; i < Connects; ++i) {
+			results[i].port = port;
+		}
+		SocketTransport::Result& refused = results[Connects];
+		refused.port = ClosedPort();
+
+		NetCore::EpollPoller poller;
+		if (poller.Init() == false) {
+			std::fprintf(stderr, "epoll poller failed, errno %d\n", errno);
+			std::exit(-1);
+		}
+
+		NetCore::MpscQueue<double> probes(1024);
+		std::vector<double> stormService;
+		std::vector<double> idleService;
+		std::atomic<bool> go{ false };
+		std::atomic<bool> settled{ false };
+		std::atomic<bool> stop{ false };
+		double stormStarted = 0.0;
+		double stormEnded = 0.0;
+
+		std::thread pump([&]() {
+			SocketTransport transport(poller, results);
+			NetCore::ConnectDriver<SocketTransport> driver(transport);
+			bool started = false;
+			while (stop.load(std::memory_order_acquire) == false) {
+				poller.Wait(std::min<uint32_t>(driver.GetWaitMsec(Now()), 100));
+
+				// wakeups that waited behind the connect starts or the handshakes count for the storm
+				double now = Now();
+				bool storming = started && settled.load(std::memory_order_relaxed) == false;
+				std::vector<double>& service = storming ? stormService : idleService;
+				probes.DequeueAll([&](double enqueued) { service.push_back((now - enqueued) * 1000.0); });
+
+				if (started == false) {
+					if (go.load(std::memory_order_acquire)) {
+						// every OpenConnection of a login burst reaching the pump in the same iteration
+						stormStarted = now;
+						for (uint32_t i = 0; i < results.size(); ++i) {
+							driver.Start((int32_t)i, i, 0.0, now);
+						}
+						started = true;
+					} else {
+						continue;
+					}
+				}
+
+				driver.Advance(now);
+				if (driver.IsEmpty() && settled.load(std::memory_order_relaxed) == false) {
+					stormEnded = now;
+					settled.store(true, std::memory_order_release);
+				}
+			}
+		});
+
+		// the game thread side, a send every ProbeInterval before, during and a while after the storm
+		uint32_t sent = 0;
+		uint32_t idle = 0;
+		double deadline = Now() + AttemptTimeoutSeconds * 2;
+		while (idle < IdleProbes && Now() < deadline) {
+			if (settled.load(std::memory_order_acquire)) {
+				++idle;
+			}
+			while (probes.Enqueue(Now()) == false) {
+				std::this_thread::yield();
+			}
+			poller.Wakeup();
+
+			// the connects go out while a send is still on its way
+			if (++sent == IdleProbes / 4) {
+				go.store(true, std::memory_order_release);
+				poller.Wakeup();
+			}
+			std::this_thread::sleep_for(ProbeInterval);
+		}
+
+		stop.store(true, std::memory_order_release);
+		poller.Wakeup();
+		pump.join();
+
+		uint32_t connected = 0;
+		std::vector<double> connectMs;
+		for (uint32_t i = 0; i < Connects; ++i) {
+			connected += results[i].completed && results[i].outcome == NetCore::ConnectOutcome::Connected ? 1 : 0;
+			connectMs.push_back(results[i].seconds * 1000.0);
+		}
+
+		// the kernel finished every handshake against the backlog, the listener finds all of them
+		uint32_t accepted = 0;
+		for (int fd; (fd = ::accept(listener, nullptr, nullptr)) >= 0; ++accepted) {
+			::close(fd);
+		}
+
+		std::printf("  connects %u/%u connected, %u accepted, storm %.2f ms, connect p50 %.3f ms max %.3f ms\n", connected, Connects, accepted,
+			(stormEnded - stormStarted) * 1000.0, Percentile(connectMs, 0.5), Percentile(connectMs, 1.0));
+		std::printf("  refused  outcome %d errno %d after %.3f ms\n", (int)refused.outcome, refused.error, refused.seconds * 1000.0);
+		std::printf("  wakeups  storm %zu p50 %.3f ms p99 %.3f ms max %.3f ms, idle %zu p50 %.3f ms p99 %.3f ms max %.3f ms, limit %.1f ms\n",
+			stormService.size(), Percentile(stormService, 0.5), Percentile(stormService, 0.99), Percentile(stormService, 1.0),
+			idleService.size(), Percentile(idleService, 0.5), Percentile(idleService, 0.99), Percentile(idleService, 1.0), MaxServiceMs);
+		if (verbose) {
+			for (uint32_t i = 0; i < Connects; ++i) {
+				std::printf("  connect %-3u outcome %d errno %d %.3f ms\n", i, (int)results[i].outcome, results[i].error, connectMs[i]);
+			}
+		}
+
+		Check(settled.load(), "storm: connects did not settle");
+		Check(connected == Connects, "storm: connects to the listener did not complete");
+		Check(accepted == Connects, "storm: listener did not accept every completed connect");
+		Check(refused.completed && refused.outcome == NetCore::ConnectOutcome::Retired && refused.error == ECONNREFUSED
+			&& refused.seconds < AttemptTimeoutSeconds, "storm: closed port not reported as refused");
+		Check(idleService.empty() == false, "storm: no wakeup outside the storm");
+		Check(Percentile(stormService, 1.0) <= MaxServiceMs && Percentile(idleService, 1.0) <= MaxServiceMs, "storm: pump did not serve a wakeup in time");
+
+		for (SocketTransport::Result& result : results) {
+			if (result.fd >= 0) {
+				::close(result.fd);
+			}
+		}
+		::close(listener);
+	}
+}
+#endif
+
+int main(int argc, char** argv)
+{
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--verbose") {
+			verbose = true;
+		} else {
+			std::fprintf(stderr, "usage: %s [--verbose]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	std::printf("scripted transport, simulated clock\n");
+	RunFallback();
+	RunFailFast();
+	RunBackoff();
+	RunTimeouts();
+	RunResolve();
+	RunCancel();
+
+#if NETCORE_EPOLL
+	std::printf("loopback storm, epoll poller\n");
+	RunStorm();
+#else
+	std::printf("loopback storm needs the epoll poller, skipped\n");
+#endif
+
+	std::printf("%d failed\n", failures);
+	return failures;
+}
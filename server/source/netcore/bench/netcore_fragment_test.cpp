@@ -0,0 +1,333 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+// streamed bodies sliced by FragmentWriter, interleaved with small priority messages the way the session gather does it
+// (queued frames always go ahead of the next slice), cut at random read sizes through RecvRingBuffer and put back
+// together by FragmentReassembler.
+//   netcore_fragment_test [--seeds <count>] [--verbose]
+// a run fails when a body does not come back byte exact, a priority message is lost, reordered or held behind a slice
+// written after it was queued, or a broken slice sequence is not reported as corrupted.
+// the exit code is the number of failed checks (ctest runs it, see CMakeLists.txt)
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "netcore_fragment.h"
+#include "netcore_ring.h"
+
+namespace
+{
+	using Body = std::shared_ptr<std::vector<uint8_t>>;
+
+	struct AssembledBody
+	{
+		uint16_t msgID = 0;
+		std::vector<uint8_t> bytes;
+	};
+
+	struct VectorBuffer
+	{
+		using Buffer = AssembledBody;
+
+		static AssembledBody Alloc(uint16_t msgID, uint32_t totalSize)
+		{
+			AssembledBody body;
+			body.msgID = msgID;
+			body.bytes.reserve(totalSize);
+			return body;
+		}
+
+		static void Append(AssembledBody& body, const uint8_t* data, uint32_t size)
+		{
+			body.bytes.insert(body.bytes.end(), data, data + size);
+		}
+	};
+
+	constexpr uint16_t PriorityMsgID = MSG_FLAG_IDFIELD_CONTENT | 0x0101;
+	constexpr uint16_t StreamedMsgID = MSG_FLAG_IDFIELD_CONTENT | 0x0202;
+	constexpr uint32_t SendBufferBytes = 64 * 1024;
+	constexpr uint32_t SliceBytes = 16 * 1024;
+
+	struct PriorityFrame
+	{
+		uint32_t sequence = 0;
+		// slices the writer had put out when the message got queued, nothing written later may arrive ahead of it
+		uint64_t slicesBefore = 0;
+	};
+
+	int failures = 0;
+
+	void Check(bool ok, const char* what, uint32_t seed)
+	{
+		if (ok == false) {
+			std::printf("  FAILED seed %u: %s\n", seed, what);
+			++failures;
+		}
+	}
+
+	Body MakeBody(std::mt19937& rng, uint32_t size)
+	{
+		Body body = std::make_shared<std::vector<uint8_t>>(size);
+		for (uint8_t& byte : *body) {
+			byte = (uint8_t)rng();
+		}
+		return body;
+	}
+
+	void RunInterleaved(uint32_t seed, bool verbose)
+	{
+		std::mt19937 rng(seed);
+
+		// only bodies above one frame are streamed, sizes around the slice boundaries plus one large body that stays open for most of the run
+		std::vector<Body> bodies = {
+			MakeBody(rng, MAX_MESSIVE_BUF_SIZE + 1),
+			MakeBody(rng, 5 * SliceBytes),
+			MakeBody(rng, 5 * SliceBytes + 1),
+			MakeBody(rng, 1024 * 1024 + (rng() % 4096)),
+		};
+
+		NetCore::FragmentWriter<Body> writer;
+		NetCore::FragmentReassembler<VectorBuffer> reassembler;
+		NetCore::RecvRingBuffer ring(128 * 1024);
+
+		std::deque<PriorityFrame> queued;
+		std::deque<PriorityFrame> inFlight;
+		std::vector<uint8_t> sendBuffer(SendBufferBytes);
+		std::vector<uint8_t> wire;
+		std::vector<uint8_t> frameBytes;
+		std::vector<AssembledBody> completed;
+
+		size_t pushed = 0;
+		uint32_t nextSequence = 0;
+		uint32_t expectedSequence = 0;
+		uint64_t slicesWritten = 0;
+		uint64_t slicesReceived = 0;
+		bool corrupted = false;
+		bool priorityOrder = true;
+		bool priorityHeld = true;
+
+		auto pushBody = [&] {
+			const Body& body = bodies[pushed++];
+			writer.Push(body, StreamedMsgID, body->data(), (uint32_t)body->size());
+		};
+
+		pushBody();
+		pushBody();
+
+		size_t wireRead = 0;
+		for (uint32_t round = 0; round < 100000 && corrupted == false; ++round) {
+			// the game thread queues a few small messages between two gathers, now and then another large body
+			uint32_t burst = rng() % 4;
+			for (uint32_t i = 0; i < burst; ++i) {
+				queued.push_back(PriorityFrame{ nextSequence++, slicesWritten });
+			}
+			if (pushed < bodies.size() && rng() % 8 == 0) {
+				pushBody();
+			}
+
+			// one gather, queued frames always go ahead of the next slice
+			uint32_t pending = 0;
+			while (true) {
+				if (queued.empty() == false) {
+					uint32_t frameSize = MSG_HEADER_SIZE + sizeof(uint32_t);
+					if (SendBufferBytes - pending < frameSize) {
+						break;
+					}
+
+					uint8_t* cur = NetCore::WriteFrameHeader(&sendBuffer[pending], PriorityMsgID, sizeof(uint32_t));
+					std::memcpy(cur, &queued.front().sequence, sizeof(uint32_t));
+					pending += frameSize;
+					inFlight.push_back(queued.front());
+					queued.pop_front();
+					continue;
+				}
+
+				uint32_t frameSize = writer.WriteNext(&sendBuffer[pending], SendBufferBytes - pending, SliceBytes);
+				if (frameSize == 0) {
+					break;
+				}
+
+				pending += frameSize;
+				++slicesWritten;
+
+				// messages queued while the gather runs go ahead of the slice after this one
+				if (rng() % 3 == 0) {
+					queued.push_back(PriorityFrame{ nextSequence++, slicesWritten });
+				}
+			}
+			wire.insert(wire.end(), sendBuffer.begin(), sendBuffer.begin() + pending);
+
+			// the receiving socket hands out whatever it has, in reads of any size
+			while (wireRead < wire.size()) {
+				uint32_t contiguous = 0;
+				uint8_t* writable = ring.GetWritable(contiguous);
+				uint32_t read = std::min<uint32_t>({ contiguous, (uint32_t)(wire.size() - wireRead), (uint32_t)(1 + rng() % 20000) });
+				if (read == 0) {
+					break;
+				}
+				std::memcpy(writable, &wire[wireRead], read);
+				ring.Commit(read);
+				wireRead += read;
+
+				NetCore::RecvFrame frame;
+				NetCore::RecvRingBuffer::EFrameResult result;
+				while ((result = ring.PeekFrame(frame)) == NetCore::RecvRingBuffer::EFrameResult::Completed) {
+					frameBytes.resize(frame.GetSize());
+					frame.CopyTo(frameBytes.data());
+					ring.Consume(frame.GetSize());
+
+					uint16_t msgID = 0;
+					std::memcpy(&msgID, &frameBytes[MSG_OFFSET_ID], sizeof(uint16_t));
+					const uint8_t* body = &frameBytes[MSG_HEADER_SIZE];
+					uint32_t bodySize = frame.GetSize() - MSG_HEADER_SIZE;
+
+					if (msgID == FRAMEWORKMSG_FRAGMENT) {
+						++slicesReceived;
+						AssembledBody assembled;
+						NetCore::FragmentResult fed = reassembler.Feed(body, bodySize, assembled);
+						if (fed == NetCore::FragmentResult::Corrupted) {
+							corrupted = true;
+						} else if (fed == NetCore::FragmentResult::Completed) {
+							completed.push_back(std::move(assembled));
+						}
+						continue;
+					}
+
+					uint32_t sequence = 0;
+					std::memcpy(&sequence, body, sizeof(uint32_t));
+					if (inFlight.empty() || sequence != expectedSequence) {
+						priorityOrder = false;
+					} else {
+						// slices still in front of it were written before it was queued
+						if (slicesReceived > inFlight.front().slicesBefore) {
+							priorityHeld = false;
+						}
+						inFlight.pop_front();
+					}
+					++expectedSequence;
+				}
+				corrupted |= (result == NetCore::RecvRingBuffer::EFrameResult::Corrupted);
+			}
+
+			if (pushed == bodies.size() && writer.IsEmpty() && queued.empty() && wireRead == wire.size()) {
+				break;
+			}
+		}
+
+		Check(corrupted == false, "reassembler reported a valid slice sequence as corrupted", seed);
+		Check(priorityOrder, "priority messages lost or reordered", seed);
+		Check(priorityHeld, "priority message held behind a slice written after it was queued", seed);
+		Check(inFlight.empty() && queued.empty(), "priority messages never delivered", seed);
+		Check(reassembler.NumOpen() == 0, "streams left open after the last slice", seed);
+
+		// streams finish in the order their last slice went out, match them by content
+		bool exact = completed.size() == bodies.size();
+		for (const Body& body : bodies) {
+			auto match = std::find_if(completed.begin(), completed.end(), [&](const AssembledBody& assembled) {
+				return assembled.msgID == StreamedMsgID && assembled.bytes == *body;
+			});
+			exact &= (match != completed.end());
+		}
+		Check(exact, "streamed body not reassembled byte exact", seed);
+
+		if (verbose) {
+			std::printf("  seed %-4u %u priority, %llu slices, %zu bytes on the wire\n", seed, nextSequence, (unsigned long long)slicesWritten, wire.size());
+		}
+	}
+
+	// body of one slice frame, as the writer would put it after the frame header
+	std::vector<uint8_t> MakeSlice(uint16_t streamID, uint32_t totalSize, uint32_t offset, uint32_t sliceSize)
+	{
+		NetCore::FragmentSlice header;
+		header.streamID = streamID;
+		header.msgID = StreamedMsgID;
+		header.totalSize = totalSize;
+		header.offset = offset;
+
+		std::vector<uint8_t> body(NetCore::FragmentSlice::FixedSize + sliceSize, 0x5a);
+		header.Encode(body.data());
+		return body;
+	}
+
+	NetCore::FragmentResult FeedSlice(NetCore::FragmentReassembler<VectorBuffer>& reassembler, const std::vector<uint8_t>& body)
+	{
+		AssembledBody completed;
+		return reassembler.Feed(body.data(), (uint32_t)body.size(), completed);
+	}
+
+	void RunCorruption()
+	{
+		using NetCore::FragmentResult;
+		constexpr uint32_t Total = MAX_MESSIVE_BUF_SIZE + 1000;
+
+		{
+			NetCore::FragmentReassembler<VectorBuffer> reassembler;
+			std::vector<uint8_t> slice = MakeSlice(0, Total, 0, 1000);
+			slice.resize(NetCore::FragmentSlice::FixedSize - 1);
+			Check(FeedSlice(reassembler, slice) == FragmentResult::Corrupted, "short slice header accepted", 0);
+			Check(FeedSlice(reassembler, MakeSlice(0, Total, 0, 0)) == FragmentResult::Corrupted, "empty slice accepted", 0);
+			Check(FeedSlice(reassembler, MakeSlice(0, MAX_MESSIVE_BUF_SIZE, 0, 1000)) == FragmentResult::Corrupted, "stream that fits one frame accepted", 0);
+			Check(FeedSlice(reassembler, MakeSlice(0, MAX_STREAMED_MSG_SIZE + 1, 0, 1000)) == FragmentResult::Corrupted, "stream above the streamed limit accepted", 0);
+			Check(FeedSlice(reassembler, MakeSlice(0, Total, 1000, 1000)) == FragmentResult::Corrupted, "stream opened past offset 0", 0);
+		}
+
+		{
+			NetCore::FragmentReassembler<VectorBuffer> reassembler;
+			Check(FeedSlice(reassembler, MakeSlice(1, Total, 0, 1000)) == FragmentResult::Pending, "first slice not pending", 0);
+			Check(FeedSlice(reassembler, MakeSlice(1, Total, 2000, 1000)) == FragmentResult::Corrupted, "slice with a gap accepted", 0);
+		}
+
+		{
+			NetCore::FragmentReassembler<VectorBuffer> reassembler;
+			FeedSlice(reassembler, MakeSlice(1, Total, 0, 1000));
+			Check(FeedSlice(reassembler, MakeSlice(1, Total + 1, 1000, 1000)) == FragmentResult::Corrupted, "total size changed mid stream", 0);
+		}
+
+		{
+			NetCore::FragmentReassembler<VectorBuffer> reassembler;
+			FeedSlice(reassembler, MakeSlice(1, Total, 0, Total - 10));
+			Check(FeedSlice(reassembler, MakeSlice(1, Total, Total - 10, 20)) == FragmentResult::Corrupted, "slice past the total accepted", 0);
+		}
+
+		{
+			NetCore::FragmentReassembler<VectorBuffer> reassembler;
+			for (uint16_t stream = 0; stream < NetCore::MaxOpenFragmentStreams; ++stream) {
+				FeedSlice(reassembler, MakeSlice(stream, Total, 0, 1000));
+			}
+			Check(FeedSlice(reassembler, MakeSlice(NetCore::MaxOpenFragmentStreams, Total, 0, 1000)) == FragmentResult::Corrupted, "stream past the open limit accepted", 0);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t seeds = 8;
+	bool verbose = false;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--seeds" && i + 1 < argc) {
+			seeds = (uint32_t)std::max(1, std::atoi(argv[++i]));
+		} else if (arg == "--verbose") {
+			verbose = true;
+		} else {
+			std::fprintf(stderr, "usage: %s [--seeds <count>] [--verbose]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	std::printf("interleaved, %u seeds\n", seeds);
+	for (uint32_t seed = 1; seed <= seeds; ++seed) {
+		RunInterleaved(seed, verbose);
+	}
+
+	std::printf("corruption\n");
+	RunCorruption();
+
+	std::printf("%d failed\n", failures);
+	return failures;
+}
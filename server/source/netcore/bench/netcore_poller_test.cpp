@@ -0,0 +1,235 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+// readiness interest of the epoll poller on a connected stream pair: readability, writability asked for with Update()
+// while a tail is unsent, and both dropped. then a pump sends a large body to a reader that drains it slowly, once
+// waking on writability the way the ClientNet pump does for a session with an unsent tail, once polling every msec.
+//   netcore_poller_test [--verbose]
+// it fails when Wait() misses a socket that became readable or writable, wakes for an interest that was dropped, or the
+// writability driven pump wakes without the socket taking more bytes more than MaxEmptyWakeups times (the polling one
+// only reports how often it did).
+// the exit code is the number of failed checks (ctest runs it, see CMakeLists.txt)
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "netcore_poller.h"
+
+#if NETCORE_EPOLL
+#include <cerrno>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace
+{
+	constexpr size_t BodyBytes = 4 * 1024 * 1024;
+	constexpr size_t ReadBytes = 64 * 1024;
+	// the reader takes everything, then stalls like a congested link
+	constexpr auto ReadInterval = std::chrono::milliseconds(5);
+	constexpr uint32_t PollMsec = 1;
+	constexpr uint32_t IdleMsec = 100;
+	constexpr uint32_t MaxEmptyWakeups = 4;
+
+	int failures = 0;
+
+	void Check(bool ok, const char* what)
+	{
+		if (ok == false) {
+			std::printf("  FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	double Now()
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	struct Pair
+	{
+		int local = -1;
+		int peer = -1;
+
+		Pair()
+		{
+			int fds[2];
+			if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, fds) != 0) {
+				std::fprintf(stderr, "socketpair failed, errno %d\n", errno);
+				std::exit(-1);
+			}
+			local = fds[0];
+			peer = fds[1];
+		}
+
+		~Pair()
+		{
+			::close(local);
+			::close(peer);
+		}
+	};
+
+	// writes until the socket would block, returns the bytes it took
+	size_t Fill(int fd)
+	{
+		std::vector<uint8_t> chunk(64 * 1024);
+		size_t total = 0;
+		for (ssize_t sent; (sent = ::send(fd, chunk.data(), chunk.size(), MSG_NOSIGNAL)) > 0;) {
+			total += (size_t)sent;
+		}
+		return total;
+	}
+
+	size_t Drain(int fd)
+	{
+		std::vector<uint8_t> chunk(64 * 1024);
+		size_t total = 0;
+		for (ssize_t read; (read = ::recv(fd, chunk.data(), chunk.size(), 0)) > 0;) {
+			total += (size_t)read;
+		}
+		return total;
+	}
+
+	void RunInterest()
+	{
+		Pair pair;
+		NetCore::EpollPoller poller;
+		if (poller.Init() == false) {
+			std::fprintf(stderr, "epoll poller failed, errno %d\n", errno);
+			std::exit(-1);
+		}
+
+		Check(poller.Register(pair.local) && poller.Wait(0) == 0, "registered socket woke with nothing to read");
+
+		// the tail does not fit, writability is asked for while the peer reads nothing
+		size_t filled = Fill(pair.local);
+		Check(filled > 0 && poller.Update(pair.local, true, true), "write interest not set");
+		Check(poller.Wait(20) == 0, "full socket woke for writability");
+
+		std::thread reader([&]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			Drain(pair.peer);
+		});
+		double started = Now();
+		uint32_t woke = poller.Wait(2000);
+		double waited = Now() - started;
+		reader.join();
+		Check(woke == 1 && waited < 1.0, "drained peer did not wake the writer");
+
+		// the tail went out, writable alone must not wake it any more
+		Check(poller.Update(pair.local, true, false) && poller.Wait(30) == 0, "dropped write interest still woke");
+
+		Check(::send(pair.peer, "x", 1, MSG_NOSIGNAL) == 1 && poller.Wait(100) == 1, "readable socket did not wake");
+
+		// held back, the byte stays unread and must not wake it
+		Check(poller.Update(pair.local, false, false) && poller.Wait(30) == 0, "socket without interest woke");
+		Check(poller.Update(pair.local, true, false) && poller.Wait(0) == 1, "interest not added back");
+		Drain(pair.local);
+
+		// interest on a socket never registered adds it
+		Pair other;
+		Check(poller.Update(other.local, false, true) && poller.Wait(0) == 1, "unregistered socket not added");
+		Check(poller.Unregister(other.local) && poller.Unregister(pair.local), "sockets not unregistered");
+	}
+
+	struct PumpResult
+	{
+		size_t sent = 0;
+		uint32_t wakeups = 0;
+		// the socket took nothing, the wakeup was for nothing
+		uint32_t empty = 0;
+		double seconds = 0.0;
+	};
+
+	// the pump side of a session with a body larger than the socket buffer
+	PumpResult RunPump(bool writability)
+	{
+		Pair pair;
+		NetCore::EpollPoller poller;
+		poller.Init();
+		poller.Register(pair.local);
+
+		std::atomic<bool> stop{ false };
+		std::thread reader([&]() {
+			std::vector<uint8_t> chunk(ReadBytes);
+			while (stop.load(std::memory_order_acquire) == false) {
+				while (::recv(pair.peer, chunk.data(), chunk.size(), 0) > 0) {
+				}
+				std::this_thread::sleep_for(ReadInterval);
+			}
+		});
+
+		std::vector<uint8_t> body(BodyBytes, 0x5a);
+		PumpResult result;
+		bool watching = false;
+		double started = Now();
+		while (result.sent < body.size()) {
+			ssize_t sent = ::send(pair.local, body.data() + result.sent, body.size() - result.sent, MSG_NOSIGNAL);
+			if (sent > 0) {
+				result.sent += (size_t)sent;
+			} else if (result.wakeups > 0) {
+				++result.empty;
+			}
+
+			// an unsent tail, either the poller wakes once the socket takes more or the pump looks again shortly
+			bool blocked = result.sent < body.size();
+			if (writability && blocked != watching) {
+				poller.Update(pair.local, true, blocked);
+				watching = blocked;
+			}
+			if (blocked) {
+				poller.Wait(writability ? IdleMsec : PollMsec);
+				++result.wakeups;
+			}
+		}
+		result.seconds = Now() - started;
+
+		stop.store(true, std::memory_order_release);
+		reader.join();
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	bool verbose = false;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--verbose") {
+			verbose = true;
+		} else {
+			std::fprintf(stderr, "usage: %s [--verbose]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	std::printf("interest\n");
+	RunInterest();
+
+	std::printf("unsent tail, %zu bytes to a reader draining every %lld msec\n", BodyBytes, (long long)ReadInterval.count());
+	PumpResult driven = RunPump(true);
+	PumpResult polled = RunPump(false);
+	for (const auto& run : { std::make_pair("writability", driven), std::make_pair("1ms polling", polled) }) {
+		std::printf("  %-12s %u wakeups, %u for nothing, %.2f ms\n", run.first, run.second.wakeups, run.second.empty, run.second.seconds * 1000.0);
+	}
+	if (verbose) {
+		std::printf("  wakeups per MB, writability %.1f polling %.1f\n", driven.wakeups / (BodyBytes / 1048576.0), polled.wakeups / (BodyBytes / 1048576.0));
+	}
+
+	Check(driven.sent == BodyBytes && polled.sent == BodyBytes, "body did not go out");
+	Check(driven.empty <= MaxEmptyWakeups, "writability driven pump woke without the socket taking more");
+
+	std::printf("%d failed\n", failures);
+	return failures;
+}
+#else
+int main()
+{
+	std::printf("netcore_poller_test needs the epoll poller, skipped\n");
+	return 0;
+}
+#endif
@@ -0,0 +1,286 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+// session resume over a link that is cut mid-burst: two ResumeWindow endpoints exchange numbered content messages and
+// sequence acks over an in-order link, the link drops everything in flight, and the reconnect replays the tail each side
+// is missing the way FRAMEWORKMSG_RESUME_SESSION and its ack do in the plugin.
+//   netcore_resume_test [--seeds <count>] [--verbose]
+// a run fails when a message is lost, duplicated or reordered across a resume, a replay is refused although the budget
+// held the tail, a tail that was evicted is replayed instead of resynced, or the window numbering, acks or eviction are off.
+// the exit code is the number of failed checks (ctest runs it, see CMakeLists.txt)
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "netcore_resume.h"
+
+namespace
+{
+	// the payload is the sender's own count, the receiver expects them back as 0, 1, 2...
+	using Window = NetCore::ResumeWindow<uint32_t>;
+
+	constexpr uint32_t AckEvery = 32;
+	constexpr uint32_t Steps = 20000;
+	constexpr uint32_t Cuts = 4;
+
+	int failures = 0;
+
+	void Check(bool ok, const char* what)
+	{
+		if (ok == false) {
+			std::printf("  FAILED: %s\n", what);
+			++failures;
+		}
+	}
+
+	void RunWindow()
+	{
+		Window window;
+		Check(window.GetSent() == 0 && window.GetOldest() == 1 && window.GetUnackedPackets() == 0, "fresh window numbering");
+
+		for (uint32_t i = 0; i < 3; ++i) {
+			window.OnSent(i, 10, 16, 1024);
+		}
+		Check(window.GetSent() == 3 && window.GetOldest() == 1, "numbering after three sends");
+		Check(window.GetUnackedPackets() == 3 && window.GetUnackedBytes() == 30, "three sends kept");
+
+		window.Acknowledge(2);
+		Check(window.GetOldest() == 3 && window.GetUnackedPackets() == 1 && window.GetUnackedBytes() == 10, "ack pops what it covers");
+		window.Acknowledge(1);
+		Check(window.GetOldest() == 3 && window.GetUnackedPackets() == 1, "stale ack ignored");
+		window.Acknowledge(3);
+		Check(window.GetOldest() == 4 && window.GetUnackedPackets() == 0 && window.GetUnackedBytes() == 0, "ack of everything empties the window");
+
+		Check(window.OnReceived(2) == false && window.OnReceived(2), "ack due every second receive");
+		Check(window.TakeAck() == 2 && window.TakeAck() == 0, "ack taken once");
+
+		// by count, the oldest go first
+		window.Reset();
+		uint32_t evicted = 0;
+		for (uint32_t i = 0; i < 5; ++i) {
+			evicted += window.OnSent(i, 10, 3, 1024);
+		}
+		Check(evicted == 2 && window.GetOldest() == 3 && window.GetUnackedPackets() == 3, "evicted down to the packet budget");
+
+		// by bytes, the newest stays even larger than the budget
+		window.Reset();
+		window.OnSent(0, 60, 16, 100);
+		evicted = window.OnSent(1, 60, 16, 100);
+		Check(evicted == 1 && window.GetUnackedPackets() == 1 && window.GetUnackedBytes() == 60, "evicted down to the byte budget");
+		evicted = window.OnSent(2, 500, 16, 100);
+		Check(evicted == 1 && window.GetUnackedPackets() == 1 && window.GetUnackedBytes() == 500, "oversized newest packet kept");
+
+		// replay of the tail past the peer's received
+		window.Reset();
+		for (uint32_t i = 0; i < 5; ++i) {
+			window.OnSent(i, 10 + i, 16, 1024);
+		}
+		std::vector<uint32_t> replayed;
+		uint32_t replayedBytes = 0;
+		auto collect = [&](const uint32_t& packet, uint32_t size) { replayed.push_back(packet); replayedBytes += size; };
+		uint32_t count = 0;
+		Check(window.CountReplay(3, count) && count == 2, "replay count of the tail");
+		Check(window.CollectReplay(3, collect) && replayed == std::vector<uint32_t>{ 3, 4 } && replayedBytes == 27, "tail replayed in order");
+		replayed.clear();
+		Check(window.CollectReplay(5, collect) && replayed.empty(), "nothing missing, nothing replayed");
+		Check(window.CollectReplay(6, collect) == false && replayed.empty(), "peer ahead of what was sent refused");
+
+		window.OnSent(5, 10, 4, 1024);
+		Check(window.GetOldest() == 3, "evicted before the replay");
+		Check(window.CollectReplay(1, collect) == false && replayed.empty(), "evicted tail refused");
+		Check(window.CollectReplay(2, collect) && replayed == std::vector<uint32_t>{ 2, 3, 4, 5 }, "tail from the oldest kept replayed");
+	}
+
+	struct Frame
+	{
+		// sequence acks ride the same stream, they are not numbered
+		bool ack = false;
+		uint32_t value = 0;
+	};
+
+	struct Endpoint
+	{
+		Window window;
+		// what the peer sent us so far, nothing may be missing, doubled or out of order
+		uint32_t delivered = 0;
+		uint32_t sentPayloads = 0;
+		bool inOrder = true;
+	};
+
+	struct Link
+	{
+		std::deque<Frame> toServer;
+		std::deque<Frame> toClient;
+	};
+
+	struct Budget
+	{
+		uint32_t maxPackets = 0;
+		uint64_t maxBytes = 0;
+	};
+
+	void Send(Endpoint& from, std::deque<Frame>& out, const Budget& budget)
+	{
+		uint32_t payload = from.sentPayloads++;
+		from.window.OnSent(payload, 64, budget.maxPackets, budget.maxBytes);
+		out.push_back(Frame{ false, payload });
+	}
+
+	void Deliver(Endpoint& to, std::deque<Frame>& in, std::deque<Frame>& back)
+	{
+		Frame frame = in.front();
+		in.pop_front();
+
+		if (frame.ack) {
+			to.window.Acknowledge(frame.value);
+			return;
+		}
+
+		to.inOrder &= frame.value == to.delivered;
+		++to.delivered;
+		if (to.window.OnReceived(AckEvery)) {
+			back.push_back(Frame{ true, to.window.TakeAck() });
+		}
+	}
+
+	// the reconnect: both sides learn what the other received and send what is missing first, an evicted tail is a resync
+	bool Resume(Endpoint& client, Endpoint& server, Link& link)
+	{
+		uint32_t clientReceived = client.window.GetReceived();
+		uint32_t serverReceived = server.window.GetReceived();
+
+		uint32_t count = 0;
+		if (client.window.CountReplay(serverReceived, count) == false || server.window.CountReplay(clientReceived, count) == false) {
+			// both number from the repaired session on, the full state goes out again
+			client.window.Reset();
+			server.window.Reset();
+			client.delivered = server.sentPayloads = 0;
+			server.delivered = client.sentPayloads = 0;
+			return false;
+		}
+
+		client.window.CollectReplay(serverReceived, [&](const uint32_t& payload, uint32_t) { link.toServer.push_back(Frame{ false, payload }); });
+		server.window.CollectReplay(clientReceived, [&](const uint32_t& payload, uint32_t) { link.toClient.push_back(Frame{ false, payload }); });
+		// what the peer reports as received is acked too
+		client.window.Acknowledge(serverReceived);
+		server.window.Acknowledge(clientReceived);
+		return true;
+	}
+
+	struct RunResult
+	{
+		uint32_t resumes = 0;
+		uint32_t resyncs = 0;
+		uint32_t lostInFlight = 0;
+	};
+
+	RunResult RunLink(uint32_t seed, const Budget& budget, bool verbose)
+	{
+		std::mt19937 rng(seed);
+		Endpoint client;
+		Endpoint server;
+		Link link;
+		RunResult result;
+
+		uint32_t burst = 0;
+		for (uint32_t step = 0; step < Steps; ++step) {
+			// bursts of sends outrun the link for a while, then it catches up
+			if (burst == 0 && rng() % 64 == 0) {
+				burst = 20 + rng() % 100;
+			}
+			uint32_t sends = burst > 0 ? 2 : rng() % 2;
+			burst -= burst > 0 ? 1 : 0;
+			for (uint32_t i = 0; i < sends; ++i) {
+				Send(client, link.toServer, budget);
+				Send(server, link.toClient, budget);
+			}
+
+			for (uint32_t i = rng() % 4; i > 0 && link.toServer.empty() == false; --i) {
+				Deliver(server, link.toServer, link.toClient);
+			}
+			for (uint32_t i = rng() % 4; i > 0 && link.toClient.empty() == false; --i) {
+				Deliver(client, link.toClient, link.toServer);
+			}
+
+			// spread over the run, each one while a burst has both directions backed up by half an ack interval
+			uint32_t cuts = result.resumes + result.resyncs;
+			bool backedUp = link.toServer.size() > AckEvery / 2 && link.toClient.size() > AckEvery / 2;
+			if (cuts < Cuts && step >= Steps / (Cuts + 1) * (cuts + 1) && burst > 0 && backedUp) {
+				// the connection goes down with whatever of the burst did not make it out yet
+				result.lostInFlight += (uint32_t)(link.toServer.size() + link.toClient.size());
+				link.toServer.clear();
+				link.toClient.clear();
+				if (Resume(client, server, link)) {
+					++result.resumes;
+				} else {
+					++result.resyncs;
+				}
+			}
+		}
+
+		while (link.toServer.empty() == false || link.toClient.empty() == false) {
+			if (link.toServer.empty() == false) {
+				Deliver(server, link.toServer, link.toClient);
+			}
+			if (link.toClient.empty() == false) {
+				Deliver(client, link.toClient, link.toServer);
+			}
+		}
+
+		Check(result.resumes + result.resyncs == Cuts, "a cut found no burst to interrupt");
+		Check(client.inOrder && server.inOrder, "message lost, doubled or reordered");
+		Check(client.delivered == server.sentPayloads && server.delivered == client.sentPayloads, "messages missing after the link drained");
+		Check(client.window.GetSent() == client.sentPayloads && server.window.GetSent() == server.sentPayloads, "numbering drifted from the sends");
+
+		if (verbose) {
+			std::printf("  seed %-3u resumes %u resyncs %u lost in flight %u, delivered %u/%u, unacked %u/%u\n", seed, result.resumes,
+				result.resyncs, result.lostInFlight, server.delivered, client.delivered, client.window.GetUnackedPackets(),
+				server.window.GetUnackedPackets());
+		}
+		return result;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t seeds = 8;
+	bool verbose = false;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--seeds" && i + 1 < argc) {
+			seeds = (uint32_t)std::max(1, std::atoi(argv[++i]));
+		} else if (arg == "--verbose") {
+			verbose = true;
+		} else {
+			std::fprintf(stderr, "usage: %s [--seeds <count>] [--verbose]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	std::printf("window\n");
+	RunWindow();
+
+	// the plugin defaults, ClientNet.Resume.BufferPackets and ClientNet.Resume.BufferBytes
+	Budget roomy{ 2048, 256 * 1024 };
+	// less than one ack interval, every cut loses more than is kept
+	Budget tight{ AckEvery / 4, 256 * 1024 };
+
+	std::printf("link cut mid-burst, %u seeds\n", seeds);
+	for (uint32_t seed = 1; seed <= seeds; ++seed) {
+		RunResult result = RunLink(seed, roomy, verbose);
+		Check(result.resumes == Cuts && result.resyncs == 0, "replay refused although the buffer held the tail");
+	}
+
+	std::printf("buffer too small, %u seeds\n", seeds);
+	for (uint32_t seed = 1; seed <= seeds; ++seed) {
+		RunResult result = RunLink(seed, tight, verbose);
+		Check(result.resyncs == Cuts && result.resumes == 0, "evicted tail replayed instead of resynced");
+	}
+
+	std::printf("%d failed\n", failures);
+	return failures;
+}
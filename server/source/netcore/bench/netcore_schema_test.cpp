@@ -0,0 +1,224 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+// every generated MsgSchema body (framework_msg_struct.h, MsgSchema::Bodies) filled with random fields, encoded and
+// decoded back, then every truncated prefix of its encoding and random garbage fed to its Decode.
+// the bytes handed to Decode end right at a page nobody may read, an overread crashes the run.
+//   netcore_schema_test [--rounds <count>] [--verbose]
+// a run fails when a body does not come back equal or with another size than GetEncodedSize(), a truncated body
+// decodes, or a decode of garbage claims more bytes than it was given.
+// the exit code is the number of failed checks (ctest runs it, see CMakeLists.txt)
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "framework_msg_struct.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define NETCORE_SCHEMA_GUARD_PAGE 1
+#else
+#define NETCORE_SCHEMA_GUARD_PAGE 0
+#endif
+
+namespace
+{
+	constexpr uint32_t MaxStringBytes = 80;
+	constexpr uint32_t MaxArrayItems = 40;
+	constexpr uint32_t GarbagePerRound = 16;
+	constexpr size_t MaxGarbageBytes = 512;
+	// larger than any body the fill produces
+	constexpr size_t BufferBytes = 64 * 1024;
+
+	int failures = 0;
+
+	void Check(bool ok, const char* what, uint16_t msgID)
+	{
+		if (ok == false) {
+			std::printf("  FAILED: 0x%04x %s\n", msgID, what);
+			++failures;
+		}
+	}
+
+	// the bytes are copied to end where the readable memory ends, a PROT_NONE page follows
+	class GuardedBuffer
+	{
+	public:
+		GuardedBuffer()
+		{
+#if NETCORE_SCHEMA_GUARD_PAGE
+			size_t page = (size_t)::sysconf(_SC_PAGESIZE);
+			_readable = (BufferBytes + page - 1) / page * page;
+			void* memory = ::mmap(nullptr, _readable + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (memory == MAP_FAILED || ::mprotect((uint8_t*)memory + _readable, page, PROT_NONE) != 0) {
+				std::fprintf(stderr, "guard page failed\n");
+				std::exit(-1);
+			}
+			_memory = (uint8_t*)memory;
+			_mapped = _readable + page;
+#else
+			_readable = BufferBytes;
+			_fallback.resize(_readable);
+			_memory = _fallback.data();
+#endif
+		}
+
+		~GuardedBuffer()
+		{
+#if NETCORE_SCHEMA_GUARD_PAGE
+			::munmap(_memory, _mapped);
+#endif
+		}
+
+		GuardedBuffer(const GuardedBuffer&) = delete;
+		GuardedBuffer& operator=(const GuardedBuffer&) = delete;
+
+		const uint8_t* Place(const uint8_t* data, size_t size)
+		{
+			uint8_t* at = _memory + _readable - size;
+			if (size > 0) {
+				std::memcpy(at, data, size);
+			}
+			return at;
+		}
+
+	private:
+		uint8_t* _memory = nullptr;
+		size_t _readable = 0;
+		size_t _mapped = 0;
+#if NETCORE_SCHEMA_GUARD_PAGE == 0
+		std::vector<uint8_t> _fallback;
+#endif
+	};
+
+	// floats come from integers, a NaN would never compare equal
+	template <typename T>
+	void Fill(T& value, std::mt19937& rng)
+	{
+		if constexpr (std::is_same_v<T, bool>) {
+			value = (rng() & 1) != 0;
+		} else if constexpr (std::is_floating_point_v<T>) {
+			value = (T)(int32_t)rng() / 1024;
+		} else {
+			uint64_t bits = ((uint64_t)rng() << 32) | rng();
+			value = (T)bits;
+		}
+	}
+
+	void Fill(std::string& value, std::mt19937& rng)
+	{
+		value.resize(rng() % 4 == 0 ? 0 : rng() % MaxStringBytes);
+		for (char& c : value) {
+			c = (char)rng();
+		}
+	}
+
+	template <typename T>
+	void Fill(std::vector<T>& value, std::mt19937& rng)
+	{
+		value.resize(rng() % 4 == 0 ? 0 : rng() % MaxArrayItems);
+		for (T& item : value) {
+			Fill(item, rng);
+		}
+	}
+
+	template <typename TBody>
+	void RunBody(std::mt19937& rng, GuardedBuffer& guarded, uint32_t rounds, bool verbose)
+	{
+		size_t largest = 0;
+		uint32_t garbageDecoded = 0;
+		for (uint32_t round = 0; round < rounds; ++round) {
+			TBody body;
+			std::apply([&](auto&... fields) { (Fill(fields, rng), ...); }, body.Fields());
+
+			std::vector<uint8_t> encoded(body.GetEncodedSize());
+			uint8_t* end = body.Encode(encoded.data());
+			Check((size_t)(end - encoded.data()) == encoded.size(), "encoded another size than GetEncodedSize()", TBody::MsgID);
+			largest = std::max(largest, encoded.size());
+
+			TBody decoded;
+			size_t consumed = 0;
+			bool ok = decoded.Decode(guarded.Place(encoded.data(), encoded.size()), encoded.size(), consumed);
+			Check(ok && consumed == encoded.size(), "encoded body did not decode", TBody::MsgID);
+			Check(decoded.Fields() == body.Fields(), "decoded fields differ", TBody::MsgID);
+
+			// every field is needed, a body cut anywhere is short
+			for (size_t size = 0; size < encoded.size(); ++size) {
+				TBody truncated;
+				consumed = 0;
+				if (truncated.Decode(guarded.Place(encoded.data(), size), size, consumed)) {
+					Check(false, "truncated body decoded", TBody::MsgID);
+					break;
+				}
+			}
+
+			// random bytes, and the valid body with random bytes overwritten (length prefixes pointing anywhere)
+			std::vector<uint8_t> garbage;
+			for (uint32_t i = 0; i < GarbagePerRound; ++i) {
+				if (i % 2 == 0 || encoded.empty()) {
+					garbage.resize(rng() % MaxGarbageBytes);
+					for (uint8_t& byte : garbage) {
+						byte = (uint8_t)rng();
+					}
+				} else {
+					garbage = encoded;
+					for (uint32_t flips = 1 + rng() % 4; flips > 0; --flips) {
+						garbage[rng() % garbage.size()] = (uint8_t)rng();
+					}
+					garbage.resize(rng() % (garbage.size() + 1));
+				}
+
+				TBody any;
+				consumed = 0;
+				if (any.Decode(guarded.Place(garbage.data(), garbage.size()), garbage.size(), consumed)) {
+					Check(consumed <= garbage.size(), "decode of garbage consumed past its end", TBody::MsgID);
+					++garbageDecoded;
+				}
+			}
+		}
+
+		if (verbose) {
+			std::printf("  0x%04x %u rounds, largest %zu bytes, %u of the garbage decoded\n", TBody::MsgID, rounds, largest, garbageDecoded);
+		}
+	}
+
+	template <typename... TBodies>
+	void RunBodies(std::tuple<TBodies...>*, std::mt19937& rng, GuardedBuffer& guarded, uint32_t rounds, bool verbose)
+	{
+		(RunBody<TBodies>(rng, guarded, rounds, verbose), ...);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	uint32_t rounds = 200;
+	bool verbose = false;
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--rounds" && i + 1 < argc) {
+			rounds = (uint32_t)std::max(1, std::atoi(argv[++i]));
+		} else if (arg == "--verbose") {
+			verbose = true;
+		} else {
+			std::fprintf(stderr, "usage: %s [--rounds <count>] [--verbose]\n", argv[0]);
+			return -1;
+		}
+	}
+
+	std::mt19937 rng(1);
+	GuardedBuffer guarded;
+	std::printf("%zu bodies, %u rounds each%s\n", std::tuple_size_v<MsgSchema::Bodies>, rounds,
+		NETCORE_SCHEMA_GUARD_PAGE ? ", guard page after the bytes" : "");
+	RunBodies((MsgSchema::Bodies*)nullptr, rng, guarded, rounds, verbose);
+
+	std::printf("%d failed\n", failures);
+	return failures;
+}
@@ -0,0 +1,41 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+
+#include "netcore_types.h"
+
+struct evp_cipher_ctx_st;
+
+namespace NetCore
+{
+	// AES-CFB128 of the session bodies, one running context per direction. EVP lets openssl pick AES-NI.
+	// cfb is a stream mode, bodies are transformed in place and every body starts on a fresh block of the running iv,
+	// the same as the server side
+	class StreamCipher
+	{
+	public:
+		StreamCipher() = default;
+		~StreamCipher();
+
+		StreamCipher(StreamCipher&& other) noexcept;
+		StreamCipher& operator=(StreamCipher&& other) noexcept;
+		StreamCipher(const StreamCipher&) = delete;
+		StreamCipher& operator=(const StreamCipher&) = delete;
+
+		// 16, 24 or 32 byte key, the iv holds one AES block
+		bool Init(const uint8_t* key, size_t keySize, const uint8_t* iv, size_t ivSize);
+		void Reset();
+		bool IsInitialized() const { return _encCtx != nullptr; }
+
+		bool Encrypt(uint8_t* data, size_t size);
+		bool Decrypt(uint8_t* data, size_t size);
+
+	private:
+		bool Transform(evp_cipher_ctx_st* ctx, bool encrypt, uint8_t* data, size_t size);
+
+		evp_cipher_ctx_st* _encCtx = nullptr;
+		evp_cipher_ctx_st* _decCtx = nullptr;
+	};
+}
@@ -0,0 +1,71 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "netcore_types.h"
+
+namespace NetCore
+{
+	// one heartbeat round trip in microseconds, clientSent and clientReceived on the client clock,
+	// serverReceived and serverSent on the server clock
+	struct ClockSample
+	{
+		int64_t clientSent = 0;
+		int64_t serverReceived = 0;
+		int64_t serverSent = 0;
+		int64_t clientReceived = 0;
+
+		// round trip without the time the server held the request
+		int64_t GetDelay() const { return (clientReceived - clientSent) - (serverSent - serverReceived); }
+		// server clock minus client clock, off by half the asymmetry of the two directions
+		int64_t GetOffset() const { return ((serverReceived - clientSent) + (serverSent - clientReceived)) / 2; }
+	};
+
+	struct ClockEstimate
+	{
+		// server clock minus client clock, from the least delayed sample of the filter window
+		int64_t offset = 0;
+		// smoothed round trip, 1/8 gain like the TCP srtt
+		int64_t rtt = 0;
+		// least delayed sample of the window, the best case the link allows right now
+		int64_t minRtt = 0;
+		// smoothed difference of consecutive round trips, 1/16 gain like the RTP interarrival jitter
+		int64_t jitter = 0;
+		uint32_t samples = 0;
+
+		bool IsValid() const { return samples > 0; }
+	};
+
+	// NTP style estimate over the heartbeat exchange. the offset comes from the sample with the least delay among the last
+	// FilterSize, queueing only ever adds delay and skews the offset of a sample by up to half of what it added.
+	// older samples count as if they were delayed by what the clocks may have drifted apart since, so a slow probe rate
+	// does not keep a stale offset. plain arithmetic, the caller owns threading
+	class ClockEstimator
+	{
+	public:
+		static constexpr uint32_t FilterSize = 16;
+		// drift two oscillators may have against each other, per million
+		static constexpr int64_t MaxDriftPpm = 50;
+
+		// false for a sample whose stamps can not be right, it is dropped
+		bool AddSample(const ClockSample& sample);
+		void Reset();
+
+		const ClockEstimate& GetEstimate() const { return _estimate; }
+		// the filter window has filled once, the offset no longer moves with every sample
+		bool IsSettled() const { return _estimate.samples >= FilterSize; }
+
+	private:
+		struct FilterEntry
+		{
+			int64_t delay = 0;
+			int64_t offset = 0;
+			int64_t received = 0;
+		};
+
+		FilterEntry _window[FilterSize];
+		uint32_t _next = 0;
+		int64_t _lastDelay = 0;
+		ClockEstimate _estimate;
+	};
+}
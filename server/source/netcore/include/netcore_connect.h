@@ -0,0 +1,471 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "netcore_types.h"
+#include "netcore_timer.h"
+
+namespace NetCore
+{
+	// seconds, read again whenever one is needed so a change applies to connects already running
+	struct ConnectSettings
+	{
+		// before the next address is tried while the previous attempt is still pending
+		double attemptDelay = 0.25;
+		// one address may take to connect
+		double attemptTimeout = 5.0;
+		// before the first retry, doubled per retry up to backoffMax
+		double backoffBase = 0.5;
+		double backoffMax = 15.0;
+		// a try waits for its lookup
+		double resolveTimeout = 5.0;
+		// tries of a connection, each resolving and racing all addresses, before it is retired
+		int32_t retries = 6;
+	};
+
+	enum class AttemptState : uint8_t
+	{
+		Pending,
+		Connected,
+		Failed,
+		// only reported by the race, a socket never says so
+		TimedOut,
+	};
+
+	enum class TryFailure : uint8_t
+	{
+		ResolveTimedOut,
+		ResolveFailed,
+		// every address failed or timed out
+		RaceFailed,
+	};
+
+	enum class ConnectOutcome : uint8_t
+	{
+		Connected,
+		// the tries are used up
+		Retired,
+		// the timeout of the whole connect passed
+		TimedOut,
+	};
+
+	// retry delay of a connection, exponential with equal jitter so clients dropped together do not come back together
+	class Backoff
+	{
+	public:
+		// delay before the next try in seconds, grows with every call until Reset. random is uniform in [0, 1)
+		double Next(double base, double max, double random)
+		{
+			base = std::max(base, 0.01);
+			double ceiling = std::min(std::max(max, 0.01), base * (double)(1ull << std::min(_attempt, 20)));
+			++_attempt;
+
+			// half of the delay is fixed so a retry never comes right away, the other half spreads the clients
+			return ceiling * (0.5 + 0.5 * random);
+		}
+
+		void Reset() { _attempt = 0; }
+		int32_t GetAttempt() const { return _attempt; }
+
+	private:
+		int32_t _attempt = 0;
+	};
+
+	// TTransport supplies the sockets, the lookups and the settings of the pump thread, ConnectRace and ConnectDriver
+	// never wait and never read a clock, every call gets the time from the caller:
+	//	using Socket = ...;		a connecting socket, the race owns it until it is closed or handed over
+	//	using Address = ...;	a resolved address with the port set
+	//	using Context = ...;	what the owner keeps per connect, handed back to the calls below
+	//	ConnectSettings GetSettings();
+	//	double Random();		uniform in [0, 1), spreads the backoff
+	//	bool Open(const Address& address, Socket& socket);		non blocking connect, false when it failed right away
+	//	AttemptState Check(Socket& socket);		Pending, Connected or Failed
+	//	void Close(Socket& socket);
+	//	void OnAttempt(const Address& address, double seconds, AttemptState ended);
+	//	void BeginResolve(Context& context);		every try resolves again, a cache is up to the transport
+	//	bool TakeResolved(Context& context, std::vector<Address>& addresses);		false while the lookup runs, no addresses when it failed
+	//	void AbandonResolve(Context& context);		the lookup may still finish, its result is dropped
+	//	void OnTryFailed(Context& context, TryFailure failure, double retryIn);		retryIn < 0 when the connect is retired
+	//	void OnCompleted(Context& context, ConnectOutcome outcome, Socket* socket, const Address* address, double seconds);
+	// OnCompleted hands over the connected socket, both pointers are null unless the outcome is Connected
+
+	// Happy Eyeballs over all resolved addresses (RFC 8305): attempts start attemptDelay apart or as soon as the previous
+	// one failed, and run in parallel. the first connected socket wins and the others are closed
+	template <typename TTransport>
+	class ConnectRace
+	{
+	public:
+		using Socket = typename TTransport::Socket;
+		using Address = typename TTransport::Address;
+
+		ConnectRace() = default;
+		~ConnectRace() { Cancel(); }
+
+		ConnectRace(const ConnectRace&) = delete;
+		ConnectRace& operator=(const ConnectRace&) = delete;
+
+		// addresses in the order the attempts should start
+		void Start(TTransport& transport, std::vector<Address> addresses, double now)
+		{
+			Cancel();
+			_transport = &transport;
+			_addresses = std::move(addresses);
+			_next = 0;
+			_nextStart = now;
+		}
+
+		// seconds until Poll has something to do, the caller may wait that long on the sockets. never returns TimedOut
+		AttemptState Poll(double now, double& nextPoll)
+		{
+			if (_won) {
+				nextPoll = 0.0;
+				return AttemptState::Connected;
+			}
+
+			ConnectSettings settings = _transport->GetSettings();
+			double attemptTimeout = std::max(settings.attemptTimeout, 0.1);
+			for (size_t i = _attempts.size(); i-- > 0;) {
+				Attempt& attempt = _attempts[i];
+
+				AttemptState state = _transport->Check(attempt.socket);
+				if (state == AttemptState::Connected) {
+					_transport->OnAttempt(attempt.address, now - attempt.started, AttemptState::Connected);
+
+					_winner = std::move(attempt);
+					_won = true;
+					RemoveAttempt(i);
+					for (Attempt& loser : _attempts) {
+						_transport->Close(loser.socket);
+					}
+					_attempts.clear();
+
+					nextPoll = 0.0;
+					return AttemptState::Connected;
+				}
+
+				if (state == AttemptState::Failed || now - attempt.started >= attemptTimeout) {
+					_transport->OnAttempt(attempt.address, now - attempt.started, state == AttemptState::Failed ? AttemptState::Failed : AttemptState::TimedOut);
+					_transport->Close(attempt.socket);
+					RemoveAttempt(i);
+				}
+			}
+
+			// the next address goes right away once nothing is pending, otherwise after the attempt delay
+			while (_next < _addresses.size() && (_attempts.empty() || now >= _nextStart)) {
+				if (StartNext(now, settings) && now < _nextStart) {
+					break;
+				}
+			}
+
+			if (_attempts.empty()) {
+				nextPoll = 0.0;
+				return AttemptState::Failed;
+			}
+
+			nextPoll = attemptTimeout;
+			for (const Attempt& attempt : _attempts) {
+				nextPoll = std::min(nextPoll, attempt.started + attemptTimeout - now);
+			}
+			if (_next < _addresses.size()) {
+				nextPoll = std::min(nextPoll, _nextStart - now);
+			}
+			nextPoll = std::max(nextPoll, 0.0);
+			return AttemptState::Pending;
+		}
+
+		// the winning socket and its address, the race forgets both. false when nothing won
+		bool Release(Socket& socket, Address& address)
+		{
+			if (_won == false) {
+				return false;
+			}
+
+			socket = std::move(_winner.socket);
+			address = std::move(_winner.address);
+			_winner = Attempt();
+			_won = false;
+			return true;
+		}
+
+		void Cancel()
+		{
+			for (Attempt& attempt : _attempts) {
+				_transport->Close(attempt.socket);
+			}
+			_attempts.clear();
+
+			if (_won) {
+				_transport->Close(_winner.socket);
+				_winner = Attempt();
+				_won = false;
+			}
+		}
+
+		size_t GetStartedAttempts() const { return _next; }
+		size_t GetPendingAttempts() const { return _attempts.size(); }
+
+	private:
+		struct Attempt
+		{
+			Socket socket{};
+			Address address{};
+			double started = 0.0;
+		};
+
+		bool StartNext(double now, const ConnectSettings& settings)
+		{
+			Attempt attempt;
+			attempt.address = _addresses[_next++];
+			attempt.started = now;
+			if (_transport->Open(attempt.address, attempt.socket) == false) {
+				_transport->OnAttempt(attempt.address, 0.0, AttemptState::Failed);
+				return false;
+			}
+
+			// an attempt that failed right away lets the next one start without the delay
+			_nextStart = now + std::max(settings.attemptDelay, 0.0);
+			_attempts.push_back(std::move(attempt));
+			return true;
+		}
+
+		void RemoveAttempt(size_t i)
+		{
+			if (i + 1 != _attempts.size()) {
+				_attempts[i] = std::move(_attempts.back());
+			}
+			_attempts.pop_back();
+		}
+
+	private:
+		TTransport* _transport = nullptr;
+		std::vector<Address> _addresses;
+		std::vector<Attempt> _attempts;
+		size_t _next = 0;
+		double _nextStart = 0.0;
+		Attempt _winner;
+		bool _won = false;
+	};
+
+	// every connect in flight as a state machine of the pump thread: resolving, racing the addresses, waiting out the backoff.
+	// every deadline goes into a timer heap that bounds the pump wait, the transport wakes the pump when a lookup finished
+	// or a handshake ended. keys identify the connects (the session id in the plugin)
+	template <typename TTransport>
+	class ConnectDriver
+	{
+	public:
+		using Context = typename TTransport::Context;
+
+		explicit ConnectDriver(TTransport& transport)
+			: _transport(transport)
+		{
+		}
+
+		~ConnectDriver() { CancelAll(); }
+
+		ConnectDriver(const ConnectDriver&) = delete;
+		ConnectDriver& operator=(const ConnectDriver&) = delete;
+
+		// timeout 0 keeps retrying until the tries are used up. false when key is already connecting
+		bool Start(int32_t key, Context context, double timeout, double now)
+		{
+			auto inserted = _connects.try_emplace(key);
+			if (inserted.second == false) {
+				return false;
+			}
+
+			Connect& connect = inserted.first->second;
+			connect.context = std::move(context);
+			connect.timeout = timeout;
+			connect.started = now;
+
+			if (timeout != 0) {
+				_timers.Schedule(now + timeout, key);
+			}
+
+			BeginTry(connect, now);
+			return true;
+		}
+
+		// moves every connect as far as it can go, completed ones are reported and dropped
+		void Advance(double now)
+		{
+			// fired entries only clear the mark, every connect checks its own deadlines below
+			_timers.PopExpired(now, [&](int32_t key) {
+				auto found = _connects.find(key);
+				if (found != _connects.end() && found->second.scheduled <= now) {
+					found->second.scheduled = 0.0;
+				}
+			});
+
+			for (auto it = _connects.begin(); it != _connects.end();) {
+				if (Advance(it->first, it->second, now)) {
+					++it;
+				} else {
+					it = _connects.erase(it);
+				}
+			}
+		}
+
+		// connects still pending are dropped without a report
+		void CancelAll()
+		{
+			for (auto& pair : _connects) {
+				if (pair.second.stage == Stage::Resolving) {
+					_transport.AbandonResolve(pair.second.context);
+				}
+				pair.second.race.Cancel();
+			}
+			_connects.clear();
+			_timers.Reset();
+		}
+
+		bool IsEmpty() const { return _connects.empty(); }
+		size_t Num() const { return _connects.size(); }
+		// msec the pump may wait before a deadline of some connect is due, TimerHeap::NoDeadline when there is none
+		uint32_t GetWaitMsec(double now) const { return _timers.GetWaitMsec(now); }
+
+	private:
+		enum class Stage : uint8_t
+		{
+			Resolving,
+			Racing,
+			Waiting,
+		};
+
+		struct Connect
+		{
+			Context context{};
+			double timeout = 0.0;
+			double started = 0.0;
+
+			Stage stage = Stage::Waiting;
+			int32_t trying = 0;
+			double stageDeadline = 0.0;
+			// earliest deadline already in the timer heap, 0 once it fired
+			double scheduled = 0.0;
+
+			ConnectRace<TTransport> race;
+			Backoff backoff;
+		};
+
+		// false once the connect completed
+		bool Advance(int32_t key, Connect& connect, double now)
+		{
+			if (connect.timeout != 0 && now - connect.started >= connect.timeout) {
+				Complete(connect, ConnectOutcome::TimedOut, now);
+				return false;
+			}
+
+			if (connect.stage == Stage::Waiting) {
+				if (now < connect.stageDeadline) {
+					Schedule(key, connect, connect.stageDeadline);
+					return true;
+				}
+				BeginTry(connect, now);
+			}
+
+			if (connect.stage == Stage::Resolving) {
+				std::vector<typename TTransport::Address> addresses;
+				if (_transport.TakeResolved(connect.context, addresses) == false) {
+					if (now < connect.stageDeadline) {
+						Schedule(key, connect, connect.stageDeadline);
+						return true;
+					}
+
+					_transport.AbandonResolve(connect.context);
+					return Retry(key, connect, TryFailure::ResolveTimedOut, now);
+				}
+
+				if (addresses.empty()) {
+					return Retry(key, connect, TryFailure::ResolveFailed, now);
+				}
+
+				connect.race.Start(_transport, std::move(addresses), now);
+				connect.stage = Stage::Racing;
+			}
+
+			if (connect.stage == Stage::Racing) {
+				double nextPoll = 0.0;
+				switch (connect.race.Poll(now, nextPoll))
+				{
+				case AttemptState::Pending:
+					Schedule(key, connect, now + nextPoll);
+					return true;
+				case AttemptState::Connected:
+					Complete(connect, ConnectOutcome::Connected, now);
+					return false;
+				default:
+					return Retry(key, connect, TryFailure::RaceFailed, now);
+				}
+			}
+
+			return true;
+		}
+
+		void BeginTry(Connect& connect, double now)
+		{
+			connect.stage = Stage::Resolving;
+			connect.stageDeadline = now + std::max(_transport.GetSettings().resolveTimeout, 0.1);
+			// a cache hit may be ready before the first Advance
+			_transport.BeginResolve(connect.context);
+		}
+
+		// false once the tries are used up and the connect completed
+		bool Retry(int32_t key, Connect& connect, TryFailure failure, double now)
+		{
+			// the try is over, its lookup was taken or abandoned already
+			connect.stage = Stage::Waiting;
+			connect.race.Cancel();
+
+			ConnectSettings settings = _transport.GetSettings();
+			if (++connect.trying >= std::max(settings.retries, 1)) {
+				_transport.OnTryFailed(connect.context, failure, -1.0);
+				Complete(connect, ConnectOutcome::Retired, now);
+				return false;
+			}
+
+			double delay = connect.backoff.Next(settings.backoffBase, settings.backoffMax, _transport.Random());
+			_transport.OnTryFailed(connect.context, failure, delay);
+
+			connect.stageDeadline = now + delay;
+			Schedule(key, connect, connect.stageDeadline);
+			return true;
+		}
+
+		void Complete(Connect& connect, ConnectOutcome outcome, double now)
+		{
+			if (connect.stage == Stage::Resolving) {
+				_transport.AbandonResolve(connect.context);
+			}
+
+			typename TTransport::Socket socket{};
+			typename TTransport::Address address{};
+			if (outcome == ConnectOutcome::Connected && connect.race.Release(socket, address)) {
+				_transport.OnCompleted(connect.context, outcome, &socket, &address, now - connect.started);
+				return;
+			}
+
+			connect.race.Cancel();
+			_transport.OnCompleted(connect.context, outcome, nullptr, nullptr, now - connect.started);
+		}
+
+		void Schedule(int32_t key, Connect& connect, double deadline)
+		{
+			// one entry per connect is enough as long as no earlier deadline comes up
+			if (connect.scheduled == 0.0 || deadline < connect.scheduled) {
+				connect.scheduled = deadline;
+				_timers.Schedule(deadline, key);
+			}
+		}
+
+	private:
+		TTransport& _transport;
+		std::map<int32_t, Connect> _connects;
+		TimerHeap _timers;
+	};
+}
@@ -0,0 +1,188 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "netcore_types.h"
+#include "netcore_ring.h"
+
+#include "framework_msg_define.h"
+#include "anu_msg_define.h"
+#include "framework_msg_struct.h"
+
+namespace NetCore
+{
+	using FragmentSlice = MsgSchema::FRAMEWORKMSG_FRAGMENT_Body;
+
+	constexpr uint32_t MinFragmentSliceBytes = 1024;
+	constexpr uint32_t MaxFragmentSliceBytes = MAX_MESSIVE_BUF_SIZE - FragmentSlice::FixedSize;
+	// a peer opening streams without finishing them is not allowed to pin more memory than this
+	constexpr uint32_t MaxOpenFragmentStreams = 8;
+
+	// sending side of FRAMEWORKMSG_FRAGMENT, bodies larger than one frame go out slice by slice, round robin over the open
+	// streams. THandle keeps the body alive while its stream is open (a shared packet in the plugin), the writer only
+	// reads the body bytes it was given
+	template <typename THandle>
+	class FragmentWriter
+	{
+	public:
+		// wireMsgID keeps MSG_FLAG_IDFIELD_COMPACT
+		void Push(THandle handle, uint16_t wireMsgID, const uint8_t* body, uint32_t bodySize)
+		{
+			Stream stream;
+			stream.handle = std::move(handle);
+			stream.body = body;
+			stream.totalSize = bodySize;
+			stream.streamID = _nextStreamID++;
+			stream.msgID = wireMsgID;
+			_streams.push_back(std::move(stream));
+		}
+
+		// writes the next slice frame to out, returns the frame size, 0 when nothing is pending or capacity can not hold a slice
+		uint32_t WriteNext(uint8_t* out, uint32_t capacity, uint32_t sliceBytes)
+		{
+			if (_streams.empty()) {
+				return 0;
+			}
+
+			if (_next >= _streams.size()) {
+				_next = 0;
+			}
+
+			Stream& stream = _streams[_next];
+			uint32_t slice = std::min(sliceBytes, stream.totalSize - stream.offset);
+
+			uint32_t frameSize = MSG_HEADER_SIZE + (uint32_t)FragmentSlice::FixedSize + slice;
+			if (capacity < frameSize) {
+				return 0;
+			}
+
+			// written straight into the send buffer, the slices never become packets of their own
+			uint8_t* cur = WriteFrameHeader(out, FRAMEWORKMSG_FRAGMENT, (uint16_t)(frameSize - MSG_HEADER_SIZE));
+
+			FragmentSlice header;
+			header.streamID = stream.streamID;
+			header.msgID = stream.msgID;
+			header.totalSize = stream.totalSize;
+			header.offset = stream.offset;
+			cur = header.Encode(cur);
+
+			std::memcpy(cur, stream.body + stream.offset, slice);
+			stream.offset += slice;
+
+			if (stream.offset == stream.totalSize) {
+				// _next now points at the stream that followed
+				_streams.erase(_streams.begin() + _next);
+			} else {
+				++_next;
+			}
+
+			return frameSize;
+		}
+
+		bool IsEmpty() const { return _streams.empty(); }
+		size_t NumOpen() const { return _streams.size(); }
+
+		void Reset()
+		{
+			_streams.clear();
+			_next = 0;
+		}
+
+	private:
+		struct Stream
+		{
+			THandle handle;
+			const uint8_t* body = nullptr;
+			uint32_t totalSize = 0;
+			uint32_t offset = 0;
+			uint16_t streamID = 0;
+			uint16_t msgID = 0;
+		};
+
+		std::vector<Stream> _streams;
+		size_t _next = 0;
+		uint16_t _nextStreamID = 0;
+	};
+
+	enum class FragmentResult : uint8_t
+	{
+		Pending,
+		Completed,
+		Corrupted,
+	};
+
+	// receiving side of FRAMEWORKMSG_FRAGMENT, the slices of a stream are appended to one buffer sized from the first slice.
+	// TBuffer supplies the buffer:
+	//	using Buffer = ...;
+	//	static Buffer Alloc(uint16_t msgID, uint32_t totalSize);
+	//	static void Append(Buffer& buffer, const uint8_t* data, uint32_t size);
+	template <typename TBuffer>
+	class FragmentReassembler
+	{
+	public:
+		using Buffer = typename TBuffer::Buffer;
+
+		// body of one FRAMEWORKMSG_FRAGMENT frame, completed is set with the buffer of the original body
+		FragmentResult Feed(const uint8_t* body, uint32_t bodySize, Buffer& completed)
+		{
+			FragmentSlice header;
+			size_t consumed = 0;
+			if (header.Decode(body, bodySize, consumed) == false) {
+				return FragmentResult::Corrupted;
+			}
+
+			uint32_t slice = bodySize - (uint32_t)consumed;
+			if (slice == 0 || header.totalSize <= MAX_MESSIVE_BUF_SIZE || header.totalSize > MAX_STREAMED_MSG_SIZE) {
+				return FragmentResult::Corrupted;
+			}
+
+			auto stream = std::find_if(_streams.begin(), _streams.end(), [&](const Stream& open) { return open.streamID == header.streamID; });
+			if (stream == _streams.end()) {
+				if (header.offset != 0 || _streams.size() >= MaxOpenFragmentStreams) {
+					return FragmentResult::Corrupted;
+				}
+
+				// sized once from the announced total, the slices are appended without growing it
+				Stream opened;
+				opened.buffer = TBuffer::Alloc(header.msgID, header.totalSize);
+				opened.streamID = header.streamID;
+				opened.totalSize = header.totalSize;
+				_streams.push_back(std::move(opened));
+				stream = _streams.end() - 1;
+			}
+
+			// slices of one stream come in order over the same connection, anything else is a broken peer
+			if (header.totalSize != stream->totalSize || header.offset != stream->received || slice > stream->totalSize - stream->received) {
+				return FragmentResult::Corrupted;
+			}
+
+			TBuffer::Append(stream->buffer, body + consumed, slice);
+			stream->received += slice;
+			if (stream->received < stream->totalSize) {
+				return FragmentResult::Pending;
+			}
+
+			completed = std::move(stream->buffer);
+			_streams.erase(stream);
+			return FragmentResult::Completed;
+		}
+
+		size_t NumOpen() const { return _streams.size(); }
+		void Reset() { _streams.clear(); }
+
+	private:
+		struct Stream
+		{
+			Buffer buffer;
+			uint32_t totalSize = 0;
+			uint32_t received = 0;
+			uint16_t streamID = 0;
+		};
+
+		std::vector<Stream> _streams;
+	};
+}
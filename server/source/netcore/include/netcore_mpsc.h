@@ -0,0 +1,168 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include "netcore_types.h"
+
+namespace NetCore
+{
+	// destructive interference size of the desktop and mobile cores the client runs on
+	constexpr size_t CacheLineSize = 64;
+
+	// bounded multi producer / single consumer ring, no allocation per element.
+	// every cell carries a sequence number, producers claim slots with one CAS on the tail
+	// and the consumer drains without any atomic read-modify-write.
+	// a failed Enqueue leaves the item with the caller, the ring never drops anything itself
+	template <typename T>
+	class MpscQueue
+	{
+	public:
+		explicit MpscQueue(uint32_t capacity)
+		{
+			_capacity = RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity);
+			_mask = _capacity - 1;
+			_cells = new Cell[_capacity];
+			for (uint32_t i = 0; i < _capacity; ++i) {
+				_cells[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		~MpscQueue()
+		{
+			delete[] _cells;
+		}
+
+		MpscQueue(const MpscQueue&) = delete;
+		MpscQueue& operator=(const MpscQueue&) = delete;
+
+		bool Enqueue(const T& item)
+		{
+			return EnqueueBatch(&item, 1) == 1;
+		}
+
+		// item is only moved from when it got in
+		bool Enqueue(T&& item)
+		{
+			uint64_t pos = 0;
+			if (Claim(1, pos) == false) {
+				return false;
+			}
+
+			Cell& cell = _cells[pos & _mask];
+			cell.value = std::move(item);
+			cell.sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		// all or nothing, returns the number of enqueued items
+		uint32_t EnqueueBatch(const T* items, uint32_t count)
+		{
+			uint64_t pos = 0;
+			if (count == 0 || Claim(count, pos) == false) {
+				return 0;
+			}
+
+			for (uint32_t i = 0; i < count; ++i) {
+				Cell& cell = _cells[(pos + i) & _mask];
+				cell.value = items[i];
+				cell.sequence.store(pos + i + 1, std::memory_order_release);
+			}
+			return count;
+		}
+
+		// consumer only
+		bool Dequeue(T& item)
+		{
+			uint64_t pos = _head.value.load(std::memory_order_relaxed);
+			Cell& cell = _cells[pos & _mask];
+			if (cell.sequence.load(std::memory_order_acquire) != pos + 1) {
+				return false;
+			}
+
+			item = std::move(cell.value);
+			cell.value = T();
+			cell.sequence.store(pos + _capacity, std::memory_order_release);
+			_head.value.store(pos + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// consumer only, hands everything published so far to sink in order
+		template <typename TSink>
+		uint32_t DequeueAll(TSink&& sink)
+		{
+			uint32_t count = 0;
+			T item;
+			while (Dequeue(item)) {
+				sink(std::move(item));
+				++count;
+			}
+			return count;
+		}
+
+		// consumer only
+		void Empty()
+		{
+			T item;
+			while (Dequeue(item)) {
+			}
+		}
+
+		bool IsEmpty() const
+		{
+			return _head.value.load(std::memory_order_relaxed) == _tail.value.load(std::memory_order_relaxed);
+		}
+
+		uint32_t Num() const
+		{
+			return (uint32_t)(_tail.value.load(std::memory_order_relaxed) - _head.value.load(std::memory_order_relaxed));
+		}
+
+		uint32_t GetCapacity() const { return _capacity; }
+
+	private:
+		bool Claim(uint32_t count, uint64_t& pos)
+		{
+			if (count > _capacity) {
+				return false;
+			}
+
+			pos = _tail.value.load(std::memory_order_relaxed);
+			while (true) {
+				// the consumer frees cells in order, so the last cell of the range being free means all of them are
+				uint64_t last = pos + count - 1;
+				int64_t diff = (int64_t)_cells[last & _mask].sequence.load(std::memory_order_acquire) - (int64_t)last;
+				if (diff == 0) {
+					if (_tail.value.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed)) {
+						return true;
+					}
+				} else if (diff < 0) {
+					return false;
+				} else {
+					pos = _tail.value.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+	private:
+		struct Cell
+		{
+			std::atomic<uint64_t> sequence{ 0 };
+			T value;
+		};
+
+		struct alignas(CacheLineSize) PaddedCursor
+		{
+			std::atomic<uint64_t> value{ 0 };
+		};
+
+		PaddedCursor _head;
+		PaddedCursor _tail;
+
+		Cell* _cells = nullptr;
+		uint32_t _capacity = 0;
+		uint32_t _mask = 0;
+	};
+}
@@ -0,0 +1,52 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "netcore_types.h"
+
+#if defined(__linux__)
+	#define NETCORE_EPOLL	1
+#else
+	#define NETCORE_EPOLL	0
+#endif
+
+#if NETCORE_EPOLL
+namespace NetCore
+{
+	// readiness wait of the network pump on native descriptors, epoll with an eventfd for wakeups.
+	// Wait() returns on socket readability, writability asked for with Update(), connect completion, Wakeup() or timeout. the plugin wraps it as FNetPollerEpoll
+	class EpollPoller
+	{
+	public:
+		EpollPoller() = default;
+		~EpollPoller();
+
+		EpollPoller(const EpollPoller&) = delete;
+		EpollPoller& operator=(const EpollPoller&) = delete;
+
+		// false when epoll or the eventfd could not be created, errno tells why
+		bool Init();
+
+		// readable or closed by the peer
+		bool Register(int fd);
+		// a non blocking connect on its way, wakes once the handshake ended either way.
+		// unregister it before it is registered for readability
+		bool RegisterConnect(int fd);
+		bool Unregister(int fd);
+		// interest of a connected socket: readable unless the caller holds its reads back, writable while the caller has
+		// bytes the socket did not take. neither unregisters it, one not registered yet is added
+		bool Update(int fd, bool readable, bool writable);
+
+		// returns the socket events that woke it, a Wakeup() alone returns 0
+		uint32_t Wait(uint32_t timeoutMsec);
+		void Wakeup();
+
+	private:
+		bool Watch(int fd, uint32_t events);
+
+	private:
+		int _epoll = -1;
+		int _wakeup = -1;
+	};
+}
+#endif
@@ -0,0 +1,225 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "netcore_types.h"
+#include "netcore_varint.h"
+
+#include "framework_msg_define.h"
+#include "anu_msg_define.h"
+
+namespace NetCore
+{
+	// read only view of one frame, [uint16 bodySize][uint16 msgID][body], owned by someone else. decodes with the same rules
+	// as FNetPacket (fixed width, or varint on a compact body) and is only valid as long as the bytes under it are.
+	// bytes come from the wire, a short read leaves the value zeroed and marks the reader failed, IsValid tells after the last read.
+	// Derived only adds >> operators of its own container types, every read returns it so chains keep working.
+	template <typename Derived>
+	class TPacketReader
+	{
+	public:
+		TPacketReader() = default;
+
+		// frameSize covers the header, the cursor starts at the body
+		TPacketReader(const uint8_t* frame, uint32_t frameSize)
+			: _frame(frame), _end(frameSize), _rdCur(MSG_HEADER_SIZE)
+		{
+			if (frame == nullptr || frameSize < MSG_HEADER_SIZE) {
+				_frame = nullptr;
+				_end = _rdCur = 0;
+				_failed = true;
+			}
+		}
+
+		// any cursor inside a frame, a packet that was read partially
+		TPacketReader(const uint8_t* frame, uint32_t frameSize, uint32_t rdPos)
+			: TPacketReader(frame, frameSize)
+		{
+			_rdCur = std::min(std::max<uint32_t>(rdPos, MSG_HEADER_SIZE), _end);
+		}
+
+	protected:
+		const uint8_t* _frame = nullptr;
+		uint32_t _end = 0;
+		uint32_t _rdCur = 0;
+		bool _failed = false;
+
+	public:
+		bool IsValid() const { return _failed == false; }
+
+		uint16_t GetWireMsgID() const
+		{
+			uint16_t msgID = 0;
+			if (_frame) {
+				std::memcpy(&msgID, _frame + MSG_OFFSET_ID, sizeof(uint16_t));
+			}
+			return msgID;
+		}
+		uint16_t GetMsgID() const { return GetWireMsgID() & ~MSG_FLAG_IDFIELD_COMPACT; }
+		bool IsCompact() const { return IS_COMPACT_MSG(GetWireMsgID()); }
+
+		uint32_t GetBodySize() const { return _end > MSG_HEADER_SIZE ? _end - MSG_HEADER_SIZE : 0; }
+		uint32_t GetPacketSize() const { return _end; }
+		const uint8_t* GetPacketBuffer() const { return _frame; }
+
+		uint32_t GetRdPos() const { return _rdCur; }
+		const uint8_t* GetRdBuffer() const { return _frame + _rdCur; }
+		uint32_t GetRemainBytesToRead() const { return _end - _rdCur; }
+		bool AllDataRead() const { return _rdCur == _end; }
+
+		bool Skip(uint32_t size)
+		{
+			if (size > GetRemainBytesToRead()) {
+				_failed = true;
+				return false;
+			}
+
+			_rdCur += size;
+			return true;
+		}
+
+		bool ReadBytes(void* buf, uint32_t size)
+		{
+			if (size > GetRemainBytesToRead()) {
+				_failed = true;
+				return false;
+			}
+
+			if (size > 0) {
+				std::memcpy(buf, _frame + _rdCur, size);
+				_rdCur += size;
+			}
+			return true;
+		}
+
+		template <typename T>
+		bool ReadVarint(T& value)
+		{
+			uint64_t wire = 0;
+			const uint8_t* begin = _frame + _rdCur;
+			const uint8_t* end = Varint::Decode(begin, _frame + _end, wire);
+			if (end == nullptr) {
+				_failed = true;
+				return false;
+			}
+
+			value = Varint::FromWire<T>(wire);
+			_rdCur += (uint32_t)(end - begin);
+			return true;
+		}
+
+		// fixed width or varint by the compact flag
+		template <class T>
+		bool TryRead(T& arg)
+		{
+			if constexpr (IsVarintSerializable<T>::Value) {
+				if (IsCompact()) {
+					return ReadVarint(arg);
+				}
+			}
+			return ReadBytes(&arg, sizeof(T));
+		}
+
+		template <typename T>
+		bool ReadArray(T* items, uint16_t count)
+		{
+			static_assert(IsBulkSerializable<T>::Value, "ReadArray needs a bulk serializable element type");
+
+			if constexpr (IsVarintSerializable<T>::Value) {
+				if (IsCompact()) {
+					const uint8_t* begin = _frame + _rdCur;
+					const uint8_t* cur = begin;
+					if (Varint::DecodeArray(cur, _frame + _end, items, count) == false) {
+						_failed = true;
+						return false;
+					}
+
+					_rdCur += (uint32_t)(cur - begin);
+					return true;
+				}
+			}
+			return ReadBytes(items, (uint32_t)(count * sizeof(T)));
+		}
+
+		// generated message bodies (framework_msg_struct.h)
+		template <typename TBody>
+		bool ReadBody(TBody& body)
+		{
+			size_t consumed = 0;
+			if (body.Decode(_frame + _rdCur, GetRemainBytesToRead(), consumed) == false) {
+				_failed = true;
+				return false;
+			}
+
+			_rdCur += (uint32_t)consumed;
+			return true;
+		}
+
+		// length prefix of a string, clamped to what the body still holds
+		uint32_t ReadLength(uint32_t elementSize = 1)
+		{
+			uint16_t size = 0;
+			TryRead(size);
+			return std::min<uint32_t>(size, GetRemainBytesToRead() / elementSize);
+		}
+
+		template <class T>
+		Derived& operator >> (T& arg)
+		{
+			if (TryRead(arg) == false) {
+				arg = T{};
+			}
+			return Self();
+		}
+
+		Derived& operator >> (std::string& str)
+		{
+			uint32_t size = ReadLength();
+			str.assign((const char*)GetRdBuffer(), size);
+			_rdCur += size;
+			return Self();
+		}
+
+		Derived& operator >> (std::wstring& str)
+		{
+			uint32_t size = ReadLength(sizeof(wchar_t));
+			str.resize(size);
+			ReadBytes((void*)str.data(), size * (uint32_t)sizeof(wchar_t));
+			return Self();
+		}
+
+		template <typename T>
+		Derived& operator >> (std::vector<T>& vector)
+		{
+			uint16_t count = 0;
+			Self() >> count;
+
+			vector.resize(count);
+			if constexpr (IsBulkSerializable<T>::Value && !std::is_same_v<T, bool>) {
+				if (ReadArray(vector.data(), count) == false) {
+					vector.clear();
+				}
+			} else {
+				for (uint16_t i = 0; i < count; ++i) {
+					T value{};
+					Self() >> value;
+					vector[i] = value;
+				}
+			}
+			return Self();
+		}
+
+	protected:
+		Derived& Self() { return static_cast<Derived&>(*this); }
+	};
+
+	class PacketReader : public TPacketReader<PacketReader>
+	{
+	public:
+		using TPacketReader<PacketReader>::TPacketReader;
+	};
+}
@@ -0,0 +1,130 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <deque>
+#include <utility>
+
+#include "netcore_types.h"
+
+namespace NetCore
+{
+	// sequence numbers and retransmit buffer of one side of a resumable session, which outlives the connections under it.
+	// both sides count the content messages they sent since sign in or repair, the stream keeps them in order so the count
+	// is the sequence number and nothing is added to the frames. sent packets are kept with their wire size until the
+	// peer's ack covers them, bounded by a packet and a byte budget the caller passes in.
+	// sequence numbers wrap, every comparison goes by the distance
+	template <typename TPacket>
+	class ResumeWindow
+	{
+	public:
+		// a new numbering, after sign in or a full repair
+		void Reset()
+		{
+			_sent = _received = _acked = 0;
+			_unacked.clear();
+			_unackedBytes = 0;
+		}
+
+		// a content packet handed to the peer, returns the packets evicted to stay within the budget.
+		// the newest packet stays even when it is larger than the whole budget
+		uint32_t OnSent(TPacket packet, uint32_t size, uint32_t maxPackets, uint64_t maxBytes)
+		{
+			++_sent;
+			_unacked.push_back(Entry{ std::move(packet), size });
+			_unackedBytes += size;
+
+			uint32_t evicted = 0;
+			while (_unacked.size() > 1 && (_unacked.size() > maxPackets || _unackedBytes > maxBytes)) {
+				PopOldest();
+				++evicted;
+			}
+			return evicted;
+		}
+
+		// a content packet received from the peer, true once ackEvery of them are not acked yet
+		bool OnReceived(uint32_t ackEvery)
+		{
+			++_received;
+			return _received - _acked >= (ackEvery > 0 ? ackEvery : 1);
+		}
+
+		// count to put in the sequence ack, 0 when the last one is still current
+		uint32_t TakeAck()
+		{
+			if (_received == _acked) {
+				return 0;
+			}
+
+			_acked = _received;
+			return _received;
+		}
+
+		// the peer received our messages up to received
+		void Acknowledge(uint32_t received)
+		{
+			// the distance from the oldest kept tells how many the ack covers
+			int32_t covered = (int32_t)(received - GetOldest() + 1);
+			for (; covered > 0 && _unacked.empty() == false; --covered) {
+				PopOldest();
+			}
+		}
+
+		// our messages past the peer's received, false when the peer is ahead of what was sent or some of them were evicted
+		bool CountReplay(uint32_t received, uint32_t& count) const
+		{
+			// a peer ahead of what was sent is out of step, one behind the oldest kept missed an evicted packet
+			int32_t missing = (int32_t)(_sent - received);
+			if (missing < 0 || (size_t)missing > _unacked.size()) {
+				return false;
+			}
+
+			count = (uint32_t)missing;
+			return true;
+		}
+
+		// hands callback(packet, size) our messages past the peer's received in order, nothing when CountReplay fails
+		template <typename TCallback>
+		bool CollectReplay(uint32_t received, TCallback&& callback) const
+		{
+			uint32_t count = 0;
+			if (CountReplay(received, count) == false) {
+				return false;
+			}
+
+			for (size_t i = _unacked.size() - count; i < _unacked.size(); ++i) {
+				callback(_unacked[i].packet, _unacked[i].size);
+			}
+			return true;
+		}
+
+		uint32_t GetSent() const { return _sent; }
+		uint32_t GetReceived() const { return _received; }
+		// first sequence number still kept for a replay, GetSent() + 1 when nothing is
+		uint32_t GetOldest() const { return _sent - (uint32_t)_unacked.size() + 1; }
+		uint32_t GetUnackedPackets() const { return (uint32_t)_unacked.size(); }
+		uint64_t GetUnackedBytes() const { return _unackedBytes; }
+
+	private:
+		void PopOldest()
+		{
+			_unackedBytes -= _unacked.front().size;
+			_unacked.pop_front();
+		}
+
+	private:
+		struct Entry
+		{
+			TPacket packet;
+			uint32_t size = 0;
+		};
+
+		uint32_t _sent = 0;
+		uint32_t _received = 0;
+		uint32_t _acked = 0;
+
+		// sequence numbers GetOldest() to _sent
+		std::deque<Entry> _unacked;
+		uint64_t _unackedBytes = 0;
+	};
+}
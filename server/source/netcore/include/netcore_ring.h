@@ -0,0 +1,64 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+
+#include "netcore_types.h"
+
+namespace NetCore
+{
+	// a complete frame inside the ring, second segment is only set when the frame wraps around the end
+	struct RecvFrame
+	{
+		const uint8_t* head = nullptr;
+		uint32_t headSize = 0;
+		const uint8_t* tail = nullptr;
+		uint32_t tailSize = 0;
+
+		uint32_t GetSize() const { return headSize + tailSize; }
+		bool IsWrapped() const { return tailSize != 0; }
+		void CopyTo(uint8_t* dest) const;
+	};
+
+	// per session contiguous receive ring, filled by one socket read and sliced into length prefixed frames
+	class RecvRingBuffer
+	{
+	public:
+		enum class EFrameResult : uint8_t
+		{
+			Completed,
+			Incompleted,
+			Corrupted,
+		};
+
+		explicit RecvRingBuffer(uint32_t capacity = 128 * 1024);
+
+		uint8_t* GetWritable(uint32_t& contiguous);
+		void Commit(uint32_t bytes);
+
+		EFrameResult PeekFrame(RecvFrame& frame) const;
+		void Consume(uint32_t bytes);
+
+		uint32_t GetReadableBytes() const { return (uint32_t)(_tail - _head); }
+		uint32_t GetCapacity() const { return (uint32_t)_buffer.size(); }
+		void Reset() { _head = _tail = 0; }
+
+	private:
+		void PeekBytes(uint64_t offset, void* dest, uint32_t size) const;
+
+	private:
+		std::vector<uint8_t> _buffer;
+		uint64_t _mask = 0;
+		uint64_t _head = 0;
+		uint64_t _tail = 0;
+	};
+
+	// header of an outgoing frame, [uint16 bodySize][uint16 msgID]
+	inline uint8_t* WriteFrameHeader(uint8_t* out, uint16_t msgID, uint16_t bodySize)
+	{
+		std::memcpy(out, &bodySize, sizeof(uint16_t));
+		std::memcpy(out + sizeof(uint16_t), &msgID, sizeof(uint16_t));
+		return out + 2 * sizeof(uint16_t);
+	}
+}
@@ -0,0 +1,140 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <vector>
+
+#include "netcore_types.h"
+
+#include "anu_global_def.h"
+#include "anu_snapshot_delta.h"
+
+using SnapshotPatchGUID = int64;
+
+namespace NetCore
+{
+	// one record of a MOVE_SNAPSHOT_PATCH_NFY / MOVE_SNAPSHOT_NFY body, units the record did not carry stay zeroed.
+	// a SNAPSHOT_SYNC_DELTA_LOCATION unit arrives resolved, as location and rotation against the baselines
+	struct SnapshotRecord
+	{
+		SnapshotPatchGUID guid = 0;
+		uint8_t syncState = 0;
+		float location[3] = {};
+		float rotation = 0.0f;
+		MotionState motion = {};
+		uint32_t skillGUID = 0;
+		uint8_t controllerEnabled = 0;
+	};
+
+	namespace Detail
+	{
+		constexpr uint32_t SnapshotUnitIndex(uint8_t flag)
+		{
+			uint32_t index = 0;
+			while ((flag >> index) > 1) {
+				++index;
+			}
+			return index;
+		}
+
+		constexpr uint32_t SnapshotRecordHeadSize = sizeof(SnapshotPatchGUID) + sizeof(uint8_t);
+	}
+
+	// records (count, then guid + AmbiguousSnapshotData each) handed to the sink one by one in a single pass.
+	// sink.Begin(count) is called once the count is known to fit the body, sink.Add(index, record) per record.
+	// false on a malformed body or a delta without baseline, the sink has to drop what it got then.
+	template <typename TSink>
+	bool DecodeSnapshotRecords(const uint8_t* body, uint32_t bodySize, SnapshotDeltaBaselines* baselines, TSink& sink)
+	{
+		using namespace Detail;
+
+		uint16_t count = 0;
+		if (bodySize < sizeof(uint16_t)) {
+			return false;
+		}
+		std::memcpy(&count, body, sizeof(uint16_t));
+
+		// every record is at least a guid and its SyncState, a count past that can not be right
+		if ((uint32_t)count * SnapshotRecordHeadSize > bodySize - sizeof(uint16_t)) {
+			return false;
+		}
+
+		sink.Begin(count);
+
+		const uint8_t* cur = body + sizeof(uint16_t);
+		const uint8_t* end = body + bodySize;
+		for (uint16_t i = 0; i < count; ++i) {
+			if ((uint32_t)(end - cur) < SnapshotRecordHeadSize) {
+				return false;
+			}
+
+			SnapshotRecord record;
+			std::memcpy(&record.guid, cur, sizeof(SnapshotPatchGUID));
+			record.syncState = cur[sizeof(SnapshotPatchGUID)];
+
+			const SnapshotDataLayout& layout = SnapshotDataLayouts[record.syncState];
+			const uint8_t* units = cur + SnapshotRecordHeadSize;
+			if ((uint32_t)(end - units) < layout.Size) {
+				return false;
+			}
+
+			uint8_t syncState = record.syncState;
+			if ((syncState & SNAPSHOT_SYNC_ROTATION) != 0) {
+				std::memcpy(&record.rotation, units + layout.Offsets[SnapshotUnitIndex(SNAPSHOT_SYNC_ROTATION)], sizeof(SnapshotData<SNAPSHOT_SYNC_ROTATION>));
+			}
+			if ((syncState & SNAPSHOT_SYNC_LOCATION) != 0) {
+				std::memcpy(record.location, units + layout.Offsets[SnapshotUnitIndex(SNAPSHOT_SYNC_LOCATION)], sizeof(SnapshotData<SNAPSHOT_SYNC_LOCATION>));
+				if (baselines) {
+					baselines->UpdateLocation(record.guid, record.location);
+				}
+			}
+			if ((syncState & SNAPSHOT_SYNC_MOTION) != 0) {
+				std::memcpy(&record.motion, units + layout.Offsets[SnapshotUnitIndex(SNAPSHOT_SYNC_MOTION)], sizeof(SnapshotData<SNAPSHOT_SYNC_MOTION>));
+			}
+			if ((syncState & SNAPSHOT_SYNC_SKILL) != 0) {
+				std::memcpy(&record.skillGUID, units + layout.Offsets[SnapshotUnitIndex(SNAPSHOT_SYNC_SKILL)], sizeof(SnapshotData<SNAPSHOT_SYNC_SKILL>));
+			}
+			if ((syncState & SNAPSHOT_SYNC_CONTROLLER) != 0) {
+				std::memcpy(&record.controllerEnabled, units + layout.Offsets[SnapshotUnitIndex(SNAPSHOT_SYNC_CONTROLLER)], sizeof(SnapshotData<SNAPSHOT_SYNC_CONTROLLER>));
+			}
+
+			if ((syncState & SNAPSHOT_SYNC_DELTA_LOCATION) != 0) {
+				SnapshotDeltaData delta;
+				std::memcpy(&delta, units + layout.Offsets[SnapshotUnitIndex(SNAPSHOT_SYNC_DELTA_LOCATION)], sizeof(SnapshotDeltaData));
+
+				// a delta without a baseline means the two sides went out of step
+				if (baselines == nullptr || baselines->Decode(record.guid, delta, record.location, record.rotation) == false) {
+					return false;
+				}
+				record.syncState = (syncState & ~SNAPSHOT_SYNC_DELTA_LOCATION) | SNAPSHOT_SYNC_LOCATION | SNAPSHOT_SYNC_ROTATION;
+			}
+
+			sink.Add(i, record);
+			cur = units + layout.Size;
+		}
+
+		return cur == end;
+	}
+
+	// the same records as an array per unit, entry i of every array belongs to record i.
+	// reused between frames so the arrays only grow to the largest batch seen
+	struct SnapshotBatch
+	{
+		std::vector<SnapshotPatchGUID> guids;
+		std::vector<uint8_t> syncStates;
+		std::vector<float> locations;		// x, y, z per record
+		std::vector<float> rotations;
+		std::vector<MotionState> motions;
+		std::vector<uint32_t> skillGUIDs;
+		std::vector<uint8_t> controllersEnabled;
+
+		size_t Num() const { return guids.size(); }
+		void Reset();
+
+		// false on a malformed body, the batch is left empty then
+		bool Decode(const uint8_t* body, uint32_t bodySize, SnapshotDeltaBaselines* baselines = nullptr);
+
+		void Begin(uint16_t count);
+		void Add(uint16_t index, const SnapshotRecord& record);
+	};
+}
@@ -0,0 +1,67 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#include "netcore_types.h"
+
+namespace NetCore
+{
+	// deadlines of the pump thread in a binary min heap, the earliest one bounds the pump wait.
+	// entries are never removed early, an owner that moved on simply ignores its entry when it fires
+	class TimerHeap
+	{
+	public:
+		static constexpr uint32_t NoDeadline = 0xFFFFFFFFu;
+
+		void Schedule(double deadline, int32_t key)
+		{
+			_heap.push_back(Entry{ deadline, key });
+			std::push_heap(_heap.begin(), _heap.end(), std::greater<Entry>());
+		}
+
+		// hands the keys whose deadline passed to sink, earliest first
+		template <typename TSink>
+		uint32_t PopExpired(double now, TSink&& sink)
+		{
+			uint32_t count = 0;
+			while (_heap.empty() == false && _heap.front().deadline <= now) {
+				std::pop_heap(_heap.begin(), _heap.end(), std::greater<Entry>());
+				int32_t key = _heap.back().key;
+				_heap.pop_back();
+				sink(key);
+				++count;
+			}
+			return count;
+		}
+
+		// msec until the earliest deadline, rounded up so the pump never wakes just before it. NoDeadline when empty
+		uint32_t GetWaitMsec(double now) const
+		{
+			if (_heap.empty()) {
+				return NoDeadline;
+			}
+			double msec = std::ceil((_heap.front().deadline - now) * 1000.0);
+			return (uint32_t)std::min(std::max(msec, 0.0), (double)NoDeadline);
+		}
+
+		bool IsEmpty() const { return _heap.empty(); }
+		size_t Num() const { return _heap.size(); }
+		void Reset() { _heap.clear(); }
+
+	private:
+		struct Entry
+		{
+			double deadline = 0.0;
+			int32_t key = 0;
+
+			bool operator>(const Entry& other) const { return deadline > other.deadline; }
+		};
+
+		std::vector<Entry> _heap;
+	};
+}
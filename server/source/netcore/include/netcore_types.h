@@ -0,0 +1,85 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+	#include <intrin.h>
+#endif
+
+// the protocol core is plain C++17, built into the ClientNet plugin and into the standalone CMake target (netcore/CMakeLists.txt).
+// inside the engine the integer names below come from CoreMinimal, standalone builds define NETCORE_STANDALONE and get them here
+// so the shared protocol headers (anu_global_def.h, framework_msg_define.h) compile unchanged.
+#ifndef NETCORE_STANDALONE
+	#define NETCORE_STANDALONE	0
+#endif
+
+#if NETCORE_STANDALONE
+using int8 = std::int8_t;
+using int16 = std::int16_t;
+using int32 = std::int32_t;
+using int64 = std::int64_t;
+using uint8 = std::uint8_t;
+using uint16 = std::uint16_t;
+using uint32 = std::uint32_t;
+using uint64 = std::uint64_t;
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+	#include <arm_neon.h>
+	#define NETCORE_SIMD_NEON	1
+	#define NETCORE_SIMD_SSE2	0
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#include <emmintrin.h>
+	#define NETCORE_SIMD_NEON	0
+	#define NETCORE_SIMD_SSE2	1
+#else
+	#define NETCORE_SIMD_NEON	0
+	#define NETCORE_SIMD_SSE2	0
+#endif
+
+#define NETCORE_SIMD		(NETCORE_SIMD_NEON || NETCORE_SIMD_SSE2)
+
+namespace NetCore
+{
+	// element types whose wire form is exactly their memory image, arrays of them are copied with one memcpy.
+	// the plugin opts structs in with NETPACKET_BULK_SERIALIZABLE
+	template <typename T>
+	struct IsBulkSerializable
+	{
+		static constexpr bool Value = std::is_arithmetic_v<T> || std::is_enum_v<T>;
+	};
+
+	inline uint32_t CountTrailingZeros(uint32_t value)
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index = 0;
+		return _BitScanForward(&index, value) ? (uint32_t)index : 32;
+#else
+		return value == 0 ? 32 : (uint32_t)__builtin_ctz(value);
+#endif
+	}
+
+	inline uint32_t FloorLog2(uint64_t value)
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		unsigned long index = 0;
+		return _BitScanReverse64(&index, value) ? (uint32_t)index : 0;
+#else
+		return value == 0 ? 0 : 63 - (uint32_t)__builtin_clzll(value);
+#endif
+	}
+
+	inline uint32_t RoundUpToPowerOfTwo(uint32_t value)
+	{
+		uint32_t result = 1;
+		while (result < value) {
+			result <<= 1;
+		}
+		return result;
+	}
+}
@@ -0,0 +1,277 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <type_traits>
+
+#include "netcore_types.h"
+
+namespace NetCore
+{
+	// UTF-8 of the packet strings, [uint16 byte length][utf8 bytes] on the wire. TChar is the engine character type
+	// (two bytes, UTF-16, on every platform the client ships, four bytes with a wchar_t TCHAR) or a utf8 byte.
+	// chat, nicknames and dialog text are mostly ASCII, those runs are scanned, narrowed and widened sixteen bytes at a time.
+	// the plugin hands the rest to FPlatformString, standalone builds use the scalar codec below
+	struct Utf8
+	{
+		static constexpr uint32_t ReplacementChar = 0xFFFD;
+
+		////////////////////////////////////////////////////
+		// ASCII runs
+
+		template <typename TChar>
+		static uint32_t AsciiPrefix(const TChar* str, uint32_t len)
+		{
+			uint32_t i = 0;
+#if NETCORE_SIMD
+			if constexpr (sizeof(TChar) == 1) {
+				for (; len - i >= 16; i += 16) {
+#if NETCORE_SIMD_NEON
+					if (vmaxvq_u8(vld1q_u8((const uint8_t*)str + i)) >= 0x80) {
+						break;
+					}
+#else
+					if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(str + i))) != 0) {
+						break;
+					}
+#endif
+				}
+			} else if constexpr (sizeof(TChar) == 2) {
+				for (; len - i >= 8; i += 8) {
+#if NETCORE_SIMD_NEON
+					if (vmaxvq_u16(vld1q_u16((const uint16_t*)str + i)) >= 0x80) {
+						break;
+					}
+#else
+					__m128i chars = _mm_loadu_si128((const __m128i*)(str + i));
+					__m128i high = _mm_and_si128(chars, _mm_set1_epi16((int16_t)0xFF80));
+					if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) != 0xFFFF) {
+						break;
+					}
+#endif
+				}
+			}
+#endif
+			while (i < len && CodeUnit(str[i]) < 0x80) {
+				++i;
+			}
+			return i;
+		}
+
+		// count characters known to be ASCII
+		template <typename TChar>
+		static void NarrowAscii(const TChar* str, uint8_t* out, uint32_t count)
+		{
+			uint32_t i = 0;
+#if NETCORE_SIMD
+			if constexpr (sizeof(TChar) == 2) {
+				for (; count - i >= 16; i += 16) {
+#if NETCORE_SIMD_NEON
+					uint8x8_t low = vmovn_u16(vld1q_u16((const uint16_t*)str + i));
+					uint8x8_t high = vmovn_u16(vld1q_u16((const uint16_t*)str + i + 8));
+					vst1q_u8(out + i, vcombine_u8(low, high));
+#else
+					__m128i low = _mm_loadu_si128((const __m128i*)(str + i));
+					__m128i high = _mm_loadu_si128((const __m128i*)(str + i + 8));
+					_mm_storeu_si128((__m128i*)(out + i), _mm_packus_epi16(low, high));
+#endif
+				}
+			}
+#endif
+			for (; i < count; ++i) {
+				out[i] = (uint8_t)str[i];
+			}
+		}
+
+		// count bytes known to be ASCII
+		template <typename TChar>
+		static void WidenAscii(const uint8_t* utf8, TChar* out, uint32_t count)
+		{
+			uint32_t i = 0;
+#if NETCORE_SIMD
+			if constexpr (sizeof(TChar) == 2) {
+				for (; count - i >= 16; i += 16) {
+#if NETCORE_SIMD_NEON
+					uint8x16_t bytes = vld1q_u8(utf8 + i);
+					vst1q_u16((uint16_t*)out + i, vmovl_u8(vget_low_u8(bytes)));
+					vst1q_u16((uint16_t*)out + i + 8, vmovl_u8(vget_high_u8(bytes)));
+#else
+					__m128i bytes = _mm_loadu_si128((const __m128i*)(utf8 + i));
+					_mm_storeu_si128((__m128i*)(out + i), _mm_unpacklo_epi8(bytes, _mm_setzero_si128()));
+					_mm_storeu_si128((__m128i*)(out + i + 8), _mm_unpackhi_epi8(bytes, _mm_setzero_si128()));
+#endif
+				}
+			}
+#endif
+			for (; i < count; ++i) {
+				out[i] = (TChar)utf8[i];
+			}
+		}
+
+		////////////////////////////////////////////////////
+		// scalar codec, the non-ASCII tail.
+		// unpaired surrogates and malformed utf8 come out as U+FFFD, one per broken unit, the lengths agree with the conversion
+
+		// utf8 bytes of str
+		template <typename TChar>
+		static uint32_t EncodedLength(const TChar* str, uint32_t len)
+		{
+			uint32_t i = AsciiPrefix(str, len);
+			uint32_t size = i;
+			while (i < len) {
+				size += EncodedSize(NextCodePoint(str, len, i));
+			}
+			return size;
+		}
+
+		// out holds exactly EncodedLength(str, len) bytes, returns the bytes written
+		template <typename TChar>
+		static uint32_t Encode(const TChar* str, uint32_t len, uint8_t* out)
+		{
+			uint32_t i = AsciiPrefix(str, len);
+			NarrowAscii(str, out, i);
+
+			uint8_t* cur = out + i;
+			while (i < len) {
+				cur = WriteCodePoint(NextCodePoint(str, len, i), cur);
+			}
+			return (uint32_t)(cur - out);
+		}
+
+		// characters of the decoded utf8
+		template <typename TChar>
+		static uint32_t DecodedLength(const uint8_t* utf8, uint32_t size)
+		{
+			uint32_t i = AsciiPrefix(utf8, size);
+			uint32_t len = i;
+			while (i < size) {
+				uint32_t codePoint = NextCodePoint(utf8, size, i);
+				len += (sizeof(TChar) == 2 && codePoint >= 0x10000) ? 2 : 1;
+			}
+			return len;
+		}
+
+		// out holds exactly DecodedLength<TChar>(utf8, size) characters, no terminator is written. returns the characters written
+		template <typename TChar>
+		static uint32_t Decode(const uint8_t* utf8, uint32_t size, TChar* out)
+		{
+			uint32_t i = AsciiPrefix(utf8, size);
+			WidenAscii(utf8, out, i);
+
+			TChar* cur = out + i;
+			while (i < size) {
+				cur = WriteCodePoint(NextCodePoint(utf8, size, i), cur);
+			}
+			return (uint32_t)(cur - out);
+		}
+
+		////////////////////////////////////////////////////
+		// one code point at a time
+
+		static uint32_t EncodedSize(uint32_t codePoint)
+		{
+			return codePoint < 0x80 ? 1 : codePoint < 0x800 ? 2 : codePoint < 0x10000 ? 3 : 4;
+		}
+
+		// utf8 of one code point, returns the end
+		static uint8_t* WriteCodePoint(uint32_t codePoint, uint8_t* out)
+		{
+			if (codePoint < 0x80) {
+				*out++ = (uint8_t)codePoint;
+			} else if (codePoint < 0x800) {
+				*out++ = (uint8_t)(0xC0 | (codePoint >> 6));
+				*out++ = (uint8_t)(0x80 | (codePoint & 0x3F));
+			} else if (codePoint < 0x10000) {
+				*out++ = (uint8_t)(0xE0 | (codePoint >> 12));
+				*out++ = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+				*out++ = (uint8_t)(0x80 | (codePoint & 0x3F));
+			} else {
+				*out++ = (uint8_t)(0xF0 | (codePoint >> 18));
+				*out++ = (uint8_t)(0x80 | ((codePoint >> 12) & 0x3F));
+				*out++ = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+				*out++ = (uint8_t)(0x80 | (codePoint & 0x3F));
+			}
+			return out;
+		}
+
+		// one code point as characters, a surrogate pair with two byte characters. returns the end
+		template <typename TChar>
+		static TChar* WriteCodePoint(uint32_t codePoint, TChar* out)
+		{
+			if (sizeof(TChar) == 2 && codePoint >= 0x10000) {
+				codePoint -= 0x10000;
+				*out++ = (TChar)(0xD800 | (codePoint >> 10));
+				*out++ = (TChar)(0xDC00 | (codePoint & 0x3FF));
+			} else {
+				*out++ = (TChar)codePoint;
+			}
+			return out;
+		}
+
+		// code point at str[i] of a character string, i moves past it
+		template <typename TChar>
+		static uint32_t NextCodePoint(const TChar* str, uint32_t len, uint32_t& i)
+		{
+			uint32_t c = CodeUnit(str[i++]);
+			if constexpr (sizeof(TChar) == 2) {
+				if (c >= 0xD800 && c < 0xDC00 && i < len) {
+					uint32_t low = CodeUnit(str[i]);
+					if (low >= 0xDC00 && low < 0xE000) {
+						++i;
+						return 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+					}
+				}
+			}
+			return (c >= 0xD800 && c < 0xE000) || c > 0x10FFFF ? ReplacementChar : c;
+		}
+
+		// code point at utf8[i], i moves past it
+		static uint32_t NextCodePoint(const uint8_t* utf8, uint32_t size, uint32_t& i)
+		{
+			uint32_t lead = utf8[i++];
+			if (lead < 0x80) {
+				return lead;
+			}
+
+			uint32_t trail = 0;
+			uint32_t codePoint = 0;
+			uint32_t min = 0;
+			if (lead >= 0xC2 && lead < 0xE0) {
+				trail = 1; codePoint = lead & 0x1F; min = 0x80;
+			} else if (lead >= 0xE0 && lead < 0xF0) {
+				trail = 2; codePoint = lead & 0x0F; min = 0x800;
+			} else if (lead >= 0xF0 && lead < 0xF5) {
+				trail = 3; codePoint = lead & 0x07; min = 0x10000;
+			} else {
+				return ReplacementChar;
+			}
+
+			if (size - i < trail) {
+				return ReplacementChar;
+			}
+
+			for (uint32_t t = 0; t < trail; ++t) {
+				uint32_t next = utf8[i + t];
+				if ((next & 0xC0) != 0x80) {
+					return ReplacementChar;
+				}
+				codePoint = (codePoint << 6) | (next & 0x3F);
+			}
+
+			// overlong forms and encoded surrogates are broken too, the lead byte alone is replaced then
+			if (codePoint < min || codePoint > 0x10FFFF || (codePoint >= 0xD800 && codePoint < 0xE000)) {
+				return ReplacementChar;
+			}
+
+			i += trail;
+			return codePoint;
+		}
+
+	private:
+		template <typename TChar>
+		static uint32_t CodeUnit(TChar c)
+		{
+			return (uint32_t)(std::make_unsigned_t<TChar>)c;
+		}
+	};
+}
@@ -0,0 +1,191 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include <type_traits>
+
+#include "netcore_types.h"
+
+#define NETCORE_VARINT_MAX_SIZE		10
+
+namespace NetCore
+{
+	// integer types a compact body sends as LEB128, single byte types gain nothing and keep their raw form
+	template <typename T>
+	struct IsVarintSerializable
+	{
+		static constexpr bool Value = (std::is_integral_v<T> || std::is_enum_v<T>) && sizeof(T) > 1;
+	};
+
+	template <typename T, bool = std::is_enum_v<T>>
+	struct VarintWire
+	{
+		using Type = T;
+	};
+
+	template <typename T>
+	struct VarintWire<T, true>
+	{
+		using Type = std::underlying_type_t<T>;
+	};
+
+	// LEB128 of the compact bodies (MSG_FLAG_IDFIELD_COMPACT), signed values zigzagged first
+	struct Varint
+	{
+		template <typename T>
+		using TWire = typename VarintWire<T>::Type;
+
+		static uint64_t ZigZag(int64_t value) { return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63); }
+		static int64_t UnZigZag(uint64_t value) { return (int64_t)(value >> 1) ^ -(int64_t)(value & 1); }
+
+		template <typename T>
+		static uint64_t ToWire(T value)
+		{
+			using TValue = TWire<T>;
+			if constexpr (std::is_signed_v<TValue>) {
+				return ZigZag((int64_t)(TValue)value);
+			} else {
+				return (uint64_t)(TValue)value;
+			}
+		}
+
+		template <typename T>
+		static T FromWire(uint64_t wire)
+		{
+			using TValue = TWire<T>;
+			if constexpr (std::is_signed_v<TValue>) {
+				return (T)(TValue)UnZigZag(wire);
+			} else {
+				return (T)(TValue)wire;
+			}
+		}
+
+		static uint32_t Size(uint64_t wire)
+		{
+			return wire < 0x80 ? 1 : FloorLog2(wire) / 7 + 1;
+		}
+
+		// bytes a compact body saves on this value, negative when the varint is longer
+		template <typename T>
+		static int32_t Savings(T value)
+		{
+			return (int32_t)sizeof(T) - (int32_t)Size(ToWire(value));
+		}
+
+		static uint8_t* Encode(uint64_t wire, uint8_t* out)
+		{
+			while (wire >= 0x80) {
+				*out++ = (uint8_t)(wire | 0x80);
+				wire >>= 7;
+			}
+			*out++ = (uint8_t)wire;
+			return out;
+		}
+
+		// nullptr on a truncated or overlong value
+		static const uint8_t* Decode(const uint8_t* cur, const uint8_t* end, uint64_t& wire)
+		{
+			wire = 0;
+			for (uint32_t shift = 0; shift < 7 * NETCORE_VARINT_MAX_SIZE && cur < end; shift += 7) {
+				uint8_t byte = *cur++;
+				wire |= (uint64_t)(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0) {
+					return cur;
+				}
+			}
+			return nullptr;
+		}
+
+		// decodes count values, cur is advanced past them. false when the body is short or malformed
+		template <typename T>
+		static bool DecodeArray(const uint8_t*& cur, const uint8_t* end, T* items, uint32_t count)
+		{
+			uint32_t i = 0;
+#if NETCORE_SIMD
+			while (count - i >= 16 && end - cur >= 16) {
+				uint32_t continuation = ContinuationMask16(cur);
+				if (continuation == 0) {
+					// sixteen single byte values, counts, enums and small ids mostly look like this
+					for (uint32_t k = 0; k < 16; ++k) {
+						items[i + k] = FromWire<T>(cur[k]);
+					}
+					cur += 16;
+					i += 16;
+					continue;
+				}
+
+				// every cleared continuation bit closes a value, the open tail waits for the next chunk
+				uint8_t block[24] = {};
+				std::memcpy(block, cur, 16);
+
+				uint32_t ends = ~continuation & 0xFFFF;
+				uint32_t start = 0;
+				while (ends != 0 && i < count) {
+					uint32_t last = CountTrailingZeros(ends);
+					uint32_t length = last - start + 1;
+					if (length > 8) {
+						break;
+					}
+
+					uint64_t word = 0;
+					std::memcpy(&word, block + start, sizeof(uint64_t));
+					items[i++] = FromWire<T>(Gather7(word & LengthMask(length)));
+
+					start = last + 1;
+					ends &= ends - 1;
+				}
+
+				if (start == 0) {
+					// a value longer than eight bytes, rare enough for the scalar path
+					break;
+				}
+				cur += start;
+			}
+#endif
+			for (; i < count; ++i) {
+				uint64_t wire = 0;
+				cur = Decode(cur, end, wire);
+				if (cur == nullptr) {
+					return false;
+				}
+				items[i] = FromWire<T>(wire);
+			}
+			return true;
+		}
+
+	private:
+		static uint64_t LengthMask(uint32_t length)
+		{
+			return length >= 8 ? ~0ull : (1ull << (length * 8)) - 1;
+		}
+
+		// packs the low seven bits of each byte, the continuation bits fall out with the masks
+		static uint64_t Gather7(uint64_t word)
+		{
+			uint64_t value = word & 0x7Full;
+			value |= (word >> 1) & (0x7Full << 7);
+			value |= (word >> 2) & (0x7Full << 14);
+			value |= (word >> 3) & (0x7Full << 21);
+			value |= (word >> 4) & (0x7Full << 28);
+			value |= (word >> 5) & (0x7Full << 35);
+			value |= (word >> 6) & (0x7Full << 42);
+			value |= (word >> 7) & (0x7Full << 49);
+			return value;
+		}
+
+#if NETCORE_SIMD
+		// bit n is set when byte n has its continuation bit
+		static uint32_t ContinuationMask16(const uint8_t* data)
+		{
+#if NETCORE_SIMD_NEON
+			static const int8_t shifts[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 0, 1, 2, 3, 4, 5, 6, 7 };
+			uint8x16_t high = vshrq_n_u8(vld1q_u8(data), 7);
+			uint8x16_t weighted = vshlq_u8(high, vld1q_s8(shifts));
+			return (uint32_t)vaddv_u8(vget_low_u8(weighted)) | ((uint32_t)vaddv_u8(vget_high_u8(weighted)) << 8);
+#else
+			return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)data));
+#endif
+		}
+#endif
+	};
+}
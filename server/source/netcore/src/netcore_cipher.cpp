@@ -0,0 +1,93 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "netcore_cipher.h"
+
+#include <limits>
+#include <utility>
+
+#include <openssl/evp.h>
+
+namespace NetCore
+{
+	StreamCipher::~StreamCipher()
+	{
+		Reset();
+	}
+
+	StreamCipher::StreamCipher(StreamCipher&& other) noexcept
+		: _encCtx(std::exchange(other._encCtx, nullptr)), _decCtx(std::exchange(other._decCtx, nullptr))
+	{
+	}
+
+	StreamCipher& StreamCipher::operator=(StreamCipher&& other) noexcept
+	{
+		if (this != &other) {
+			Reset();
+			_encCtx = std::exchange(other._encCtx, nullptr);
+			_decCtx = std::exchange(other._decCtx, nullptr);
+		}
+		return *this;
+	}
+
+	bool StreamCipher::Init(const uint8_t* key, size_t keySize, const uint8_t* iv, size_t ivSize)
+	{
+		Reset();
+
+		const EVP_CIPHER* cipher = nullptr;
+		switch (keySize)
+		{
+		case 16: cipher = EVP_aes_128_cfb128(); break;
+		case 24: cipher = EVP_aes_192_cfb128(); break;
+		case 32: cipher = EVP_aes_256_cfb128(); break;
+		default: return false;
+		}
+
+		if (iv == nullptr || ivSize < (size_t)EVP_CIPHER_iv_length(cipher)) {
+			return false;
+		}
+
+		_encCtx = EVP_CIPHER_CTX_new();
+		_decCtx = EVP_CIPHER_CTX_new();
+		if (_encCtx == nullptr || _decCtx == nullptr ||
+			EVP_EncryptInit_ex(_encCtx, cipher, nullptr, key, iv) != 1 ||
+			EVP_DecryptInit_ex(_decCtx, cipher, nullptr, key, iv) != 1) {
+			Reset();
+			return false;
+		}
+		return true;
+	}
+
+	void StreamCipher::Reset()
+	{
+		EVP_CIPHER_CTX_free(_encCtx);
+		EVP_CIPHER_CTX_free(_decCtx);
+		_encCtx = _decCtx = nullptr;
+	}
+
+	bool StreamCipher::Encrypt(uint8_t* data, size_t size)
+	{
+		return Transform(_encCtx, true, data, size);
+	}
+
+	bool StreamCipher::Decrypt(uint8_t* data, size_t size)
+	{
+		return Transform(_decCtx, false, data, size);
+	}
+
+	bool StreamCipher::Transform(evp_cipher_ctx_st* ctx, bool encrypt, uint8_t* data, size_t size)
+	{
+		if (ctx == nullptr || size > (size_t)std::numeric_limits<int>::max()) {
+			return false;
+		}
+
+		if (size == 0) {
+			return true;
+		}
+
+		EVP_CIPHER_CTX_set_num(ctx, 0);
+
+		int written = 0;
+		int rt = encrypt ? EVP_EncryptUpdate(ctx, data, &written, data, (int)size) : EVP_DecryptUpdate(ctx, data, &written, data, (int)size);
+		return rt == 1 && written == (int)size;
+	}
+}
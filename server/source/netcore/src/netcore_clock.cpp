@@ -0,0 +1,61 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "netcore_clock.h"
+
+namespace NetCore
+{
+	bool ClockEstimator::AddSample(const ClockSample& sample)
+	{
+		// clocks that went back on either side, or a server that answered before it was asked
+		if (sample.clientReceived < sample.clientSent || sample.serverSent < sample.serverReceived) {
+			return false;
+		}
+
+		// timer granularity can leave a fast local round trip a little below the server hold time
+		int64_t delay = sample.GetDelay();
+		if (delay < 0) {
+			delay = 0;
+		}
+
+		_window[_next % FilterSize] = FilterEntry{ delay, sample.GetOffset(), sample.clientReceived };
+		++_next;
+
+		uint32_t filled = _next < FilterSize ? _next : FilterSize;
+		const FilterEntry* best = nullptr;
+		int64_t bestDistance = 0;
+		for (uint32_t i = 0; i < filled; ++i) {
+			const FilterEntry& entry = _window[i];
+			int64_t distance = entry.delay + (sample.clientReceived - entry.received) * 2 * MaxDriftPpm / 1000000;
+			if (best == nullptr || distance < bestDistance) {
+				best = &entry;
+				bestDistance = distance;
+			}
+		}
+
+		_estimate.offset = best->offset;
+		_estimate.minRtt = best->delay;
+
+		if (_estimate.samples == 0) {
+			_estimate.rtt = delay;
+			_estimate.jitter = 0;
+		} else {
+			_estimate.rtt += (delay - _estimate.rtt) / 8;
+			int64_t change = delay > _lastDelay ? delay - _lastDelay : _lastDelay - delay;
+			_estimate.jitter += (change - _estimate.jitter) / 16;
+		}
+
+		_lastDelay = delay;
+		++_estimate.samples;
+		return true;
+	}
+
+	void ClockEstimator::Reset()
+	{
+		for (FilterEntry& entry : _window) {
+			entry = FilterEntry{};
+		}
+		_next = 0;
+		_lastDelay = 0;
+		_estimate = ClockEstimate{};
+	}
+}
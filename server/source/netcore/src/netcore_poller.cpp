@@ -0,0 +1,103 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "netcore_poller.h"
+
+#if NETCORE_EPOLL
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace NetCore
+{
+	EpollPoller::~EpollPoller()
+	{
+		if (_wakeup >= 0) {
+			::close(_wakeup);
+		}
+
+		if (_epoll >= 0) {
+			::close(_epoll);
+		}
+	}
+
+	bool EpollPoller::Init()
+	{
+		_epoll = ::epoll_create1(EPOLL_CLOEXEC);
+		_wakeup = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+		if (_epoll < 0 || _wakeup < 0) {
+			return false;
+		}
+
+		return Watch(_wakeup, EPOLLIN);
+	}
+
+	bool EpollPoller::Register(int fd)
+	{
+		return Watch(fd, EPOLLIN | EPOLLRDHUP);
+	}
+
+	bool EpollPoller::RegisterConnect(int fd)
+	{
+		// writable once connected, EPOLLERR and EPOLLHUP come with a refused or reset handshake
+		return Watch(fd, EPOLLOUT);
+	}
+
+	bool EpollPoller::Unregister(int fd)
+	{
+		epoll_event ev = {};
+		return ::epoll_ctl(_epoll, EPOLL_CTL_DEL, fd, &ev) == 0;
+	}
+
+	bool EpollPoller::Update(int fd, bool readable, bool writable)
+	{
+		uint32_t events = (readable ? EPOLLIN | EPOLLRDHUP : 0) | (writable ? EPOLLOUT : 0);
+		if (events == 0) {
+			Unregister(fd);
+			return true;
+		}
+
+		epoll_event ev = {};
+		ev.events = events;
+		ev.data.fd = fd;
+		if (::epoll_ctl(_epoll, EPOLL_CTL_MOD, fd, &ev) == 0) {
+			return true;
+		}
+		return errno == ENOENT && Watch(fd, events);
+	}
+
+	uint32_t EpollPoller::Wait(uint32_t timeoutMsec)
+	{
+		constexpr int MaxEvents = 16;
+		epoll_event events[MaxEvents];
+
+		int count = ::epoll_wait(_epoll, events, MaxEvents, (int)timeoutMsec);
+		uint32_t sockets = 0;
+		for (int i = 0; i < count; ++i) {
+			if (events[i].data.fd != _wakeup) {
+				++sockets;
+				continue;
+			}
+
+			uint64_t value = 0;
+			while (::read(_wakeup, &value, sizeof(value)) > 0) {
+			}
+		}
+		return sockets;
+	}
+
+	void EpollPoller::Wakeup()
+	{
+		uint64_t value = 1;
+		[[maybe_unused]] ssize_t written = ::write(_wakeup, &value, sizeof(value));
+	}
+
+	bool EpollPoller::Watch(int fd, uint32_t events)
+	{
+		epoll_event ev = {};
+		ev.events = events;
+		ev.data.fd = fd;
+		return ::epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &ev) == 0;
+	}
+}
+#endif
@@ -0,0 +1,93 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "netcore_ring.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "framework_msg_define.h"
+#include "anu_msg_define.h"
+
+namespace NetCore
+{
+	void RecvFrame::CopyTo(uint8_t* dest) const
+	{
+		std::memcpy(dest, head, headSize);
+		if (tailSize > 0) {
+			std::memcpy(dest + headSize, tail, tailSize);
+		}
+	}
+
+	RecvRingBuffer::RecvRingBuffer(uint32_t capacity)
+	{
+		// a whole messive frame must always fit
+		capacity = RoundUpToPowerOfTwo(std::max<uint32_t>(capacity, (uint32_t)MAX_MESSIVE_BUF_SIZE + MSG_HEADER_SIZE));
+		_buffer.resize(capacity);
+		_mask = capacity - 1;
+	}
+
+	uint8_t* RecvRingBuffer::GetWritable(uint32_t& contiguous)
+	{
+		uint32_t free = GetCapacity() - GetReadableBytes();
+		uint32_t offset = (uint32_t)(_tail & _mask);
+
+		contiguous = std::min(free, GetCapacity() - offset);
+		return &_buffer[offset];
+	}
+
+	void RecvRingBuffer::Commit(uint32_t bytes)
+	{
+		assert(GetReadableBytes() + bytes <= GetCapacity());
+		_tail += bytes;
+	}
+
+	void RecvRingBuffer::PeekBytes(uint64_t offset, void* dest, uint32_t size) const
+	{
+		uint32_t start = (uint32_t)(offset & _mask);
+		uint32_t first = std::min(size, GetCapacity() - start);
+
+		std::memcpy(dest, &_buffer[start], first);
+		if (first < size) {
+			std::memcpy((uint8_t*)dest + first, &_buffer[0], size - first);
+		}
+	}
+
+	RecvRingBuffer::EFrameResult RecvRingBuffer::PeekFrame(RecvFrame& frame) const
+	{
+		uint32_t readable = GetReadableBytes();
+		if (readable < MSG_HEADER_SIZE) {
+			return EFrameResult::Incompleted;
+		}
+
+		uint16_t bodySize = 0;
+		PeekBytes(_head + MSG_OFFSET_SIZE, &bodySize, sizeof(uint16_t));
+		if (bodySize > MAX_MESSIVE_BUF_SIZE) {
+			return EFrameResult::Corrupted;
+		}
+
+		uint32_t packetSize = (uint32_t)bodySize + MSG_HEADER_SIZE;
+		if (readable < packetSize) {
+			return EFrameResult::Incompleted;
+		}
+
+		uint32_t start = (uint32_t)(_head & _mask);
+		uint32_t first = std::min(packetSize, GetCapacity() - start);
+
+		frame.head = &_buffer[start];
+		frame.headSize = first;
+		frame.tail = (first < packetSize) ? &_buffer[0] : nullptr;
+		frame.tailSize = packetSize - first;
+		return EFrameResult::Completed;
+	}
+
+	void RecvRingBuffer::Consume(uint32_t bytes)
+	{
+		assert(bytes <= GetReadableBytes());
+		_head += bytes;
+
+		// rewinding an empty ring keeps the next read contiguous
+		if (_head == _tail) {
+			_head = _tail = 0;
+		}
+	}
+}
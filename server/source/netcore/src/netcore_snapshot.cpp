@@ -0,0 +1,49 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "netcore_snapshot.h"
+
+namespace NetCore
+{
+	void SnapshotBatch::Reset()
+	{
+		guids.clear();
+		syncStates.clear();
+		locations.clear();
+		rotations.clear();
+		motions.clear();
+		skillGUIDs.clear();
+		controllersEnabled.clear();
+	}
+
+	bool SnapshotBatch::Decode(const uint8_t* body, uint32_t bodySize, SnapshotDeltaBaselines* baselines)
+	{
+		Reset();
+		if (DecodeSnapshotRecords(body, bodySize, baselines, *this) == false) {
+			Reset();
+			return false;
+		}
+		return true;
+	}
+
+	void SnapshotBatch::Begin(uint16_t count)
+	{
+		guids.resize(count);
+		syncStates.resize(count);
+		locations.resize((size_t)count * 3);
+		rotations.resize(count);
+		motions.resize(count);
+		skillGUIDs.resize(count);
+		controllersEnabled.resize(count);
+	}
+
+	void SnapshotBatch::Add(uint16_t index, const SnapshotRecord& record)
+	{
+		guids[index] = record.guid;
+		syncStates[index] = record.syncState;
+		std::memcpy(&locations[(size_t)index * 3], record.location, sizeof(record.location));
+		rotations[index] = record.rotation;
+		motions[index] = record.motion;
+		skillGUIDs[index] = record.skillGUID;
+		controllersEnabled[index] = record.controllerEnabled;
+	}
+}
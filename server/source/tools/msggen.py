@@ -0,0 +1,532 @@
+#!/usr/bin/env python3
+# Generates the protocol tables shared by the server and the client.
+#
+#   include/anu_msg_string.h      protocol and result code name tables, from anu_msg_define.h and framework_msg_define.h
+#   include/framework_msg_struct.h typed message bodies, from framework_msg.schema
+#
+# usage: python3 msggen.py [--include <dir>] [--check]
+
+import argparse
+import os
+import re
+import sys
+
+SCALARS = {
+	'bool': ('bool', 1),
+	'int8': ('int8_t', 1),
+	'uint8': ('uint8_t', 1),
+	'int16': ('int16_t', 2),
+	'uint16': ('uint16_t', 2),
+	'int32': ('int32_t', 4),
+	'uint32': ('uint32_t', 4),
+	'int64': ('int64_t', 8),
+	'uint64': ('uint64_t', 8),
+	'float': ('float', 4),
+	'double': ('double', 8),
+}
+
+LENGTH_PREFIX = 2
+
+GENERATED_BANNER = '// generated by server/source/tools/msggen.py from {}, do not edit\n'
+
+
+#####################################################################
+# define parsing
+#####################################################################
+
+DEFINE_RE = re.compile(r'^\s*#\s*define\s+(\w+)\s+(.+?)\s*(//.*)?$')
+CAST_RE = re.compile(r'\((?:uint8|uint16|uint32|int8|int16|int32|unsigned short|unsigned char)\)')
+
+
+class DefineSet:
+	def __init__(self):
+		self.values = {
+			'MSG_FLAG_IDFIELD_NO_DIR': 0x0000,
+			'MSG_FLAG_IDFIELD_REQMSG': 0x4000,
+			'MSG_FLAG_IDFIELD_ACKMSG': 0x8000,
+		}
+
+	def evaluate(self, expression):
+		expression = CAST_RE.sub('', expression)
+		expression = re.sub(r'MAKE_CONTENTMSG\(', '_content(', expression)
+		expression = re.sub(r'MAKE_SERVERMSG\(', '_server(', expression)
+		expression = re.sub(r'MAKE_FRAMEWORKMSG\(', '_framework(', expression)
+
+		scope = dict(self.values)
+		scope['_content'] = lambda direction, id: 0x3000 | direction | id
+		scope['_server'] = lambda direction, id: 0x3000 | 0x0800 | direction | id
+		scope['_framework'] = lambda direction, id: 0x2000 | direction | id
+		try:
+			value = eval(expression, {'__builtins__': {}}, scope)
+		except Exception:
+			return None
+		return value if isinstance(value, int) else None
+
+
+def parse_defines(path, defines):
+	"""returns [(name, value)] of message ids and {group: [(name, value)]} of result codes, in definition order"""
+	protocols = []
+	results = {}
+	result_order = []
+
+	ignore_next = False
+	result_group = None
+
+	with open(path, encoding='utf-8') as file:
+		for line in file:
+			stripped = line.strip()
+			if stripped.startswith('IGNORE_STRING_GENERATOR('):
+				ignore_next = True
+				continue
+
+			begin = re.match(r'RESULT_CODE_BEGIN\((\w+)\)', stripped)
+			if begin:
+				result_group = begin.group(1)
+				results[result_group] = []
+				result_order.append(result_group)
+				continue
+
+			if stripped.startswith('RESULT_CODE_END('):
+				result_group = None
+				continue
+
+			match = DEFINE_RE.match(line)
+			if match is None:
+				continue
+
+			name, expression = match.group(1), match.group(2)
+
+			value = defines.evaluate(expression)
+			if value is not None:
+				defines.values[name] = value
+
+			if result_group is not None:
+				if value is not None:
+					results[result_group].append((name, value))
+				continue
+
+			is_message = re.match(r'MAKE_(CONTENT|SERVER|FRAMEWORK)MSG\(', expression) is not None
+			if is_message and value is not None:
+				if ignore_next is False:
+					protocols.append((name, value))
+				ignore_next = False
+
+	return protocols, [(group, results[group]) for group in result_order]
+
+
+#####################################################################
+# anu_msg_string.h
+#####################################################################
+
+STRING_HEADER = '''#pragma once
+
+#include <string>
+#include <map>
+#include <sstream>
+#include <iomanip>
+
+namespace MsgHelper
+{
+	using msgid_t = unsigned short;
+	using errid_t = unsigned char;
+
+	struct ProtocolName
+	{
+		msgid_t msgID;
+		const wchar_t* name;
+	};
+
+'''
+
+STRING_LOOKUP = '''	inline constexpr int ProtocolCount = (int)(sizeof(ProtocolNames) / sizeof(ProtocolNames[0]));
+	inline constexpr int FrameworkProtocolCount = (int)(sizeof(FrameworkProtocolNames) / sizeof(FrameworkProtocolNames[0]));
+
+	constexpr bool IsSortedProtocolNames(const ProtocolName* names, int count)
+	{
+		for (int i = 1; i < count; ++i) {
+			if (names[i - 1].msgID >= names[i].msgID) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	static_assert(IsSortedProtocolNames(ProtocolNames, ProtocolCount), "ProtocolNames must be sorted by msgID without duplicates");
+	static_assert(IsSortedProtocolNames(FrameworkProtocolNames, FrameworkProtocolCount), "FrameworkProtocolNames must be sorted by msgID without duplicates");
+
+	constexpr int FindProtocolIndex(const ProtocolName* names, int count, msgid_t msgID)
+	{
+		int lo = 0;
+		int hi = count;
+		while (lo < hi) {
+			int mid = (lo + hi) / 2;
+			if (names[mid].msgID < msgID) {
+				lo = mid + 1;
+			}
+			else {
+				hi = mid;
+			}
+		}
+		return (lo < count && names[lo].msgID == msgID) ? lo : -1;
+	}
+
+	// dense index of a known content protocol, -1 otherwise
+	constexpr int FindProtocolIndex(msgid_t msgID)
+	{
+		return FindProtocolIndex(ProtocolNames, ProtocolCount, msgID);
+	}
+
+	constexpr const wchar_t* FindProtocolName(msgid_t msgID)
+	{
+		int index = FindProtocolIndex(msgID);
+		if (index >= 0) {
+			return ProtocolNames[index].name;
+		}
+
+		index = FindProtocolIndex(FrameworkProtocolNames, FrameworkProtocolCount, msgID);
+		return index < 0 ? nullptr : FrameworkProtocolNames[index].name;
+	}
+
+	inline std::wstring GetProtocolName(msgid_t msgID)
+	{
+		const wchar_t* name = FindProtocolName(msgID);
+		return name ? std::wstring(name) : std::wstring();
+	}
+
+	inline bool Contains(msgid_t msgID)
+	{
+		return FindProtocolIndex(msgID) >= 0;
+	}
+
+	inline std::wstring GetResultStringW(const std::map<errid_t, std::wstring>& container, errid_t errid)
+	{
+		using namespace std;
+
+		wostringstream woss;
+
+		auto it = container.find(errid);
+		if (it == container.end()) {
+			woss << L"0x" << setw(2) << setfill(L'0') << hex << errid;
+			return woss.str();
+		}
+		else {
+			return it->second;
+		}
+	}
+
+#pragma warning(push)
+#pragma warning(disable: 4244)
+	inline std::string GetResultStringA(const std::map<errid_t, std::wstring>& container, errid_t errid)
+	{
+		using namespace std;
+
+		ostringstream oss;
+
+		auto it = container.find(errid);
+		if (it == container.end()) {
+			oss << "0x" << setw(2) << setfill('0') << hex << errid;
+			return oss.str();
+		}
+		else {
+			string conv;
+			conv.assign(it->second.begin(), it->second.end());
+			return conv;
+		}
+	}
+#pragma warning(pop)
+'''
+
+STRING_FOOTER = '''
+#if WITH_EDITOR
+#define ANUMSG_GETRESULT(Group, Code) MsgHelper::GetResultStringW(MsgHelper::Group ## _Codes, Code).c_str()
+#elif defined(_DEBUG)
+#define ANUMSG_GETRESULT(Group, Code) MsgHelper::GetResultStringA(MsgHelper::Group ## _Codes, Code).c_str()
+#endif
+}
+'''
+
+
+def emit_name_table(name, comment, protocols):
+	first = {}
+	for protocol, value in protocols:
+		first.setdefault(value, protocol)
+
+	out = '\t// {}\n'.format(comment)
+	out += '\tinline constexpr ProtocolName {}[] =\n\t{{\n'.format(name)
+	for value in sorted(first):
+		out += '\t\t{{{}, L"{}"}},\n'.format(value, first[value])
+	out += '\t};\n\n'
+	return out
+
+
+def generate_strings(protocols, framework_protocols, results):
+	out = GENERATED_BANNER.format('anu_msg_define.h and framework_msg_define.h') + '\n'
+	out += STRING_HEADER
+	out += emit_name_table('ProtocolNames', 'sorted by msgID, the first definition wins when two protocols share an id', protocols)
+	out += emit_name_table('FrameworkProtocolNames', 'framework messages, kept apart so content indices stay dense', framework_protocols)
+	out += STRING_LOOKUP
+	for group, codes in results:
+		out += '\t\n\tstatic std::map<errid_t, std::wstring> {}_Codes\n\t{{\n'.format(group)
+		for name, value in codes:
+			out += '\t\t{{{}, L"{}"}},\n'.format(value, name)
+		out += '\t};\n'
+	out += STRING_FOOTER
+	return out
+
+
+#####################################################################
+# framework_msg_struct.h
+#####################################################################
+
+class Field:
+	def __init__(self, kind, type, name):
+		self.kind = kind		# scalar, string, array
+		self.type = type		# scalar type of the value or of the elements
+		self.name = name
+
+	@property
+	def fixed_size(self):
+		return SCALARS[self.type][1] if self.kind == 'scalar' else LENGTH_PREFIX
+
+
+def parse_schema(path):
+	text = open(path, encoding='utf-8').read()
+	text = re.sub(r'//[^\n]*', '', text)
+
+	messages = []
+	for match in re.finditer(r'message\s+(\w+)\s*\{([^}]*)\}', text):
+		name, body = match.group(1), match.group(2)
+		fields = []
+		for declaration in filter(None, (part.strip() for part in body.split(';'))):
+			array = re.fullmatch(r'array\s*<\s*(\w+)\s*>\s+(\w+)', declaration)
+			plain = re.fullmatch(r'(\w+)\s+(\w+)', declaration)
+			if array and array.group(1) in SCALARS:
+				fields.append(Field('array', array.group(1), array.group(2)))
+			elif plain and plain.group(1) == 'string':
+				fields.append(Field('string', None, plain.group(2)))
+			elif plain and plain.group(1) in SCALARS:
+				fields.append(Field('scalar', plain.group(1), plain.group(2)))
+			else:
+				sys.exit('{}: bad field "{}" in {}'.format(path, declaration, name))
+		messages.append((name, fields))
+	return messages
+
+
+def emit_body(name, msg_id, fields):
+	fixed = sum(field.fixed_size for field in fields)
+
+	lines = []
+	add = lines.append
+	add('\tstruct {}_Body'.format(name))
+	add('\t{')
+	add('\t\tstatic constexpr uint16_t MsgID = 0x{:04x};'.format(msg_id))
+	add('\t\t// scalars and length prefixes')
+	add('\t\tstatic constexpr size_t FixedSize = {};'.format(fixed))
+	if fields:
+		add('')
+	for field in fields:
+		if field.kind == 'scalar':
+			add('\t\t{} {} = {{}};'.format(SCALARS[field.type][0], field.name))
+		elif field.kind == 'string':
+			add('\t\tstd::string {};'.format(field.name))
+		else:
+			add('\t\tstd::vector<{}> {};'.format(SCALARS[field.type][0], field.name))
+
+	# size
+	add('')
+	add('\t\tsize_t GetEncodedSize() const')
+	add('\t\t{')
+	terms = ['FixedSize']
+	for field in fields:
+		if field.kind == 'string':
+			terms.append('Detail::ClampedLength({}.size())'.format(field.name))
+		elif field.kind == 'array':
+			terms.append('Detail::ClampedLength({}.size()) * sizeof({})'.format(field.name, SCALARS[field.type][0]))
+	add('\t\t\treturn {};'.format(' + '.join(terms)))
+	add('\t\t}')
+
+	# encode
+	add('')
+	add('\t\t// out has to hold GetEncodedSize() bytes, returns the end of the written body')
+	add('\t\tuint8_t* Encode(uint8_t* out) const')
+	add('\t\t{')
+	for field in fields:
+		if field.kind == 'scalar':
+			add('\t\t\tout = Detail::Put(out, {});'.format(field.name))
+		elif field.kind == 'string':
+			add('\t\t\tout = Detail::PutBytes(out, {0}.data(), Detail::ClampedLength({0}.size()), 1);'.format(field.name))
+		else:
+			add('\t\t\tout = Detail::PutBytes(out, {0}.data(), Detail::ClampedLength({0}.size()), sizeof({1}));'.format(field.name, SCALARS[field.type][0]))
+	add('\t\t\treturn out;')
+	add('\t\t}')
+
+	# decode, fixed runs are checked once, every variable payload once more
+	add('')
+	add('\t\t// false on a short body, consumed is set on success')
+	add('\t\tbool Decode(const uint8_t* data, size_t size, size_t& consumed)')
+	add('\t\t{')
+	add('\t\t\tconst uint8_t* cur = data;')
+	add('\t\t\tconst uint8_t* end = data + size;')
+
+	run = []
+
+	def flush_run():
+		if not run:
+			return
+		size = sum(field.fixed_size for field in run)
+		add('')
+		add('\t\t\tif ((size_t)(end - cur) < {}) {{'.format(size))
+		add('\t\t\t\treturn false;')
+		add('\t\t\t}')
+		for field in run:
+			if field.kind == 'scalar':
+				add('\t\t\tcur = Detail::Get(cur, {});'.format(field.name))
+			else:
+				add('\t\t\tuint16_t {}Count = 0;'.format(field.name))
+				add('\t\t\tcur = Detail::Get(cur, {}Count);'.format(field.name))
+		run.clear()
+
+	for index, field in enumerate(fields):
+		run.append(field)
+		if field.kind == 'scalar':
+			continue
+
+		# the prefix belongs to the run, the payload is checked on its own
+		flush_run()
+		element = 'char' if field.kind == 'string' else SCALARS[field.type][0]
+		add('')
+		add('\t\t\tif ((size_t)(end - cur) < (size_t){0}Count * sizeof({1})) {{'.format(field.name, element))
+		add('\t\t\t\treturn false;')
+		add('\t\t\t}')
+		if field.kind == 'string':
+			add('\t\t\t{0}.assign((const char*)cur, {0}Count);'.format(field.name))
+		else:
+			add('\t\t\t{0}.resize({0}Count);'.format(field.name))
+			add('\t\t\tif ({0}Count > 0) {{'.format(field.name))
+			add('\t\t\t\tstd::memcpy({0}.data(), cur, (size_t){0}Count * sizeof({1}));'.format(field.name, element))
+			add('\t\t\t}')
+		add('\t\t\tcur += (size_t){}Count * sizeof({});'.format(field.name, element))
+	flush_run()
+
+	add('')
+	add('\t\t\tconsumed = (size_t)(cur - data);')
+	add('\t\t\treturn true;')
+	add('\t\t}')
+
+	# field tuples, the round trip test fills and compares every body through them
+	names = ', '.join(field.name for field in fields)
+	add('')
+	add('\t\tauto Fields() {{ return std::tie({}); }}'.format(names))
+	add('\t\tauto Fields() const {{ return std::tie({}); }}'.format(names))
+	add('\t};')
+	return '\n'.join(lines) + '\n'
+
+
+STRUCT_HEADER = '''#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <vector>
+
+// wire layout matches FNetPacket: little endian, packed, strings and arrays prefixed with a uint16 count
+namespace MsgSchema
+{
+	namespace Detail
+	{
+		inline uint16_t ClampedLength(size_t length)
+		{
+			return length > 0xFFFF ? (uint16_t)0xFFFF : (uint16_t)length;
+		}
+
+		template <typename T>
+		inline uint8_t* Put(uint8_t* out, const T& value)
+		{
+			std::memcpy(out, &value, sizeof(T));
+			return out + sizeof(T);
+		}
+
+		inline uint8_t* PutBytes(uint8_t* out, const void* items, uint16_t count, size_t itemSize)
+		{
+			out = Put(out, count);
+			if (count > 0) {
+				std::memcpy(out, items, count * itemSize);
+			}
+			return out + count * itemSize;
+		}
+
+		template <typename T>
+		inline const uint8_t* Get(const uint8_t* cur, T& value)
+		{
+			std::memcpy(&value, cur, sizeof(T));
+			return cur + sizeof(T);
+		}
+	}
+
+'''
+
+
+def generate_structs(messages, defines):
+	out = GENERATED_BANNER.format('framework_msg.schema') + '\n'
+	out += STRUCT_HEADER
+	bodies = []
+	for name, fields in messages:
+		msg_id = defines.values.get(name)
+		if msg_id is None:
+			sys.exit('framework_msg.schema: {} is not defined in framework_msg_define.h'.format(name))
+		bodies.append(emit_body(name, msg_id, fields))
+	out += '\n'.join(bodies)
+	out += '\n\t// every body above, in schema order\n'
+	out += '\tusing Bodies = std::tuple<\n'
+	out += ',\n'.join('\t\t{}_Body'.format(name) for name, _ in messages)
+	out += '>;\n'
+	out += '}\n'
+	return out
+
+
+#####################################################################
+#####################################################################
+
+def write(path, content, check):
+	current = open(path, encoding='utf-8').read() if os.path.exists(path) else None
+	if current == content:
+		return True
+
+	if check:
+		print('{} is out of date'.format(path))
+		return False
+
+	with open(path, 'w', encoding='utf-8', newline='\n') as file:
+		file.write(content)
+	print('generated {}'.format(path))
+	return True
+
+
+def main():
+	parser = argparse.ArgumentParser()
+	parser.add_argument('--include', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'include'))
+	parser.add_argument('--check', action='store_true', help='fail when a generated file differs instead of writing it')
+	args = parser.parse_args()
+
+	include = os.path.normpath(args.include)
+	defines = DefineSet()
+
+	framework_protocols, _ = parse_defines(os.path.join(include, 'framework_msg_define.h'), defines)
+	protocols, results = parse_defines(os.path.join(include, 'anu_msg_define.h'), defines)
+	framework_protocols = [protocol for protocol in framework_protocols if protocol[0].startswith('FRAMEWORKMSG_')]
+
+	messages = parse_schema(os.path.join(include, 'framework_msg.schema'))
+
+	compact = defines.values['MSG_FLAG_IDFIELD_COMPACT']
+	for name, value in framework_protocols + protocols:
+		if value & compact:
+			sys.exit('{} = 0x{:04x} collides with MSG_FLAG_IDFIELD_COMPACT'.format(name, value))
+
+	ok = write(os.path.join(include, 'anu_msg_string.h'), generate_strings(protocols, framework_protocols, results), args.check)
+	ok = write(os.path.join(include, 'framework_msg_struct.h'), generate_structs(messages, defines), args.check) and ok
+	return 0 if ok else 1
+
+
+if __name__ == '__main__':
+	sys.exit(main())
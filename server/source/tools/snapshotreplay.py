@@ -0,0 +1,286 @@
+#!/usr/bin/env python3
+# Replays captured snapshot streams through the SNAPSHOT_SYNC_DELTA_LOCATION codec (include/anu_snapshot_delta.h).
+#
+# a capture is either a ClientNet.Capture file (FNetCapture, timestamped) or a run of frames as FNetPacket::WriteBuff
+# writes them, [uint16 bodySize][uint16 msgID][body]. without timestamps every MOVE_SNAPSHOT_PATCH_NFY / MOVE_SNAPSHOT_NFY
+# frame counts as one server tick of --tick-hz.
+# absolute locations are re-encoded as deltas the way the server would, with baselines per entity, and the report
+# compares bytes per entity per second of both forms and the largest reconstruction error.
+#
+# usage: python3 snapshotreplay.py <capture> [<capture> ...] [--tick-hz 10] [--steps-per-unit 8] [--yaw-bits 10]
+
+import argparse
+import math
+import os
+import re
+import struct
+import sys
+
+import msggen
+
+GUID_SIZE = 8
+
+# FNetCaptureFileHeader and FNetCaptureRecordHeader
+CAPTURE_MAGIC = 0x50434E41
+CAPTURE_HEADER = struct.Struct('<IHHd')
+CAPTURE_RECORD = struct.Struct('<QiB3x')
+CAPTURE_RECEIVED = 0
+
+# mirrors SnapshotDataUnitSizes, the empty units of the unused bits still take a byte
+UNIT_SIZES = [4, 12, 1, 4, 1, 8, 1, 1]
+
+SYNC_ROTATION = 0x01
+SYNC_LOCATION = 0x02
+SYNC_DELTA_LOCATION = 0x20
+
+
+def f32(value):
+	return struct.unpack('<f', struct.pack('<f', value))[0]
+
+
+def lround(value):
+	return int(math.copysign(math.floor(abs(value) + 0.5), value))
+
+
+def unit_offsets(state):
+	offsets = []
+	offset = 0
+	for bit in range(8):
+		offsets.append(offset)
+		if state & (1 << bit):
+			offset += UNIT_SIZES[bit]
+	return offsets, offset
+
+
+class Codec:
+	"""same arithmetic as SnapshotDeltaBaselines, in float32"""
+
+	def __init__(self, steps_per_unit, yaw_bits):
+		self.steps_per_unit = f32(steps_per_unit)
+		self.yaw_steps = 1 << yaw_bits
+		self.baselines = {}
+
+	def quantize_yaw(self, rotation):
+		turn = f32(math.fmod(rotation, 360.0))
+		if turn < 0.0:
+			turn = f32(turn + 360.0)
+		return lround(f32(turn * f32(self.yaw_steps / 360.0))) & (self.yaw_steps - 1)
+
+	def dequantize_yaw(self, yaw):
+		return f32(yaw * f32(360.0 / self.yaw_steps))
+
+	def encode(self, guid, location, rotation):
+		baseline = self.baselines.get(guid)
+		if baseline is None:
+			return None
+
+		steps = [lround(f32((location[axis] - baseline[axis]) * self.steps_per_unit)) for axis in range(3)]
+		if any(step < -32768 or step > 32767 for step in steps):
+			return None
+
+		for axis in range(3):
+			baseline[axis] = f32(baseline[axis] + f32(steps[axis] / self.steps_per_unit))
+		return list(baseline), self.dequantize_yaw(self.quantize_yaw(rotation))
+
+	def decode(self, guid, steps, yaw):
+		baseline = self.baselines.get(guid)
+		if baseline is None:
+			return None
+
+		for axis in range(3):
+			baseline[axis] = f32(baseline[axis] + f32(steps[axis] / self.steps_per_unit))
+		return list(baseline), self.dequantize_yaw(yaw)
+
+	def update_location(self, guid, location):
+		self.baselines[guid] = list(location)
+
+
+class Entity:
+	def __init__(self):
+		self.location = None
+		self.rotation = None
+		self.captured_bytes = 0
+		self.delta_bytes = 0
+		self.max_location_error = 0.0
+		self.max_yaw_error = 0.0
+
+
+class Replay:
+	def __init__(self, steps_per_unit, yaw_bits):
+		self.captured = Codec(steps_per_unit, yaw_bits)
+		self.simulated = Codec(steps_per_unit, yaw_bits)
+		self.entities = {}
+		self.ticks = 0
+		self.records = 0
+		self.deltas = 0
+		self.fallbacks = 0
+		self.malformed = 0
+
+	def feed_body(self, body):
+		if len(body) < 2:
+			self.malformed += 1
+			return
+
+		count = struct.unpack_from('<H', body, 0)[0]
+		offset = 2
+		for _ in range(count):
+			if offset + GUID_SIZE + 1 > len(body):
+				self.malformed += 1
+				return
+
+			guid = struct.unpack_from('<q', body, offset)[0]
+			state = body[offset + GUID_SIZE]
+			offsets, size = unit_offsets(state)
+			units = offset + GUID_SIZE + 1
+			if units + size > len(body):
+				self.malformed += 1
+				return
+
+			self.feed_record(guid, state, body, units, offsets, GUID_SIZE + 1 + size)
+			offset = units + size
+		self.ticks += 1
+
+	def feed_record(self, guid, state, body, units, offsets, record_size):
+		entity = self.entities.setdefault(guid, Entity())
+		entity.captured_bytes += record_size
+		self.records += 1
+
+		# what the server sent, a captured delta is resolved against the baselines of the capture
+		if state & SYNC_LOCATION:
+			entity.location = [f32(v) for v in struct.unpack_from('<3f', body, units + offsets[1])]
+			self.captured.update_location(guid, entity.location)
+		if state & SYNC_ROTATION:
+			entity.rotation = f32(struct.unpack_from('<f', body, units + offsets[0])[0])
+		if state & SYNC_DELTA_LOCATION:
+			steps = struct.unpack_from('<3h', body, units + offsets[5])
+			yaw = struct.unpack_from('<H', body, units + offsets[5] + 6)[0]
+			resolved = self.captured.decode(guid, steps, yaw)
+			if resolved is None:
+				self.malformed += 1
+				return
+			entity.location, entity.rotation = resolved
+
+		# the same record as the delta encoder would send it
+		location_units = state & (SYNC_LOCATION | SYNC_ROTATION | SYNC_DELTA_LOCATION)
+		if location_units == 0 or entity.location is None:
+			entity.delta_bytes += record_size
+			return
+
+		other = record_size - sum(UNIT_SIZES[bit] for bit in (0, 1, 5) if state & (1 << bit))
+		encoded = self.simulated.encode(guid, entity.location, entity.rotation or 0.0)
+		if encoded is None:
+			self.fallbacks += 1
+			self.simulated.update_location(guid, entity.location)
+			entity.delta_bytes += other + UNIT_SIZES[0] + UNIT_SIZES[1]
+			return
+
+		self.deltas += 1
+		entity.delta_bytes += other + UNIT_SIZES[5]
+
+		location, rotation = encoded
+		error = math.sqrt(sum((location[axis] - entity.location[axis]) ** 2 for axis in range(3)))
+		entity.max_location_error = max(entity.max_location_error, error)
+		if entity.rotation is not None:
+			turn = abs(math.fmod(rotation - entity.rotation, 360.0))
+			entity.max_yaw_error = max(entity.max_yaw_error, min(turn, 360.0 - turn))
+
+
+def read_frames(path, msg_ids, compact_flag):
+	"""yields (seconds or None, body) of the received snapshot frames"""
+	with open(path, 'rb') as file:
+		data = file.read()
+
+	offset = 0
+	seconds_per_cycle = None
+	if len(data) >= CAPTURE_HEADER.size and struct.unpack_from('<I', data, 0)[0] == CAPTURE_MAGIC:
+		_, version, _, seconds_per_cycle = CAPTURE_HEADER.unpack_from(data, 0)
+		if version != 1:
+			sys.exit('{}: capture version {} is not supported'.format(path, version))
+		offset = CAPTURE_HEADER.size
+
+	while offset < len(data):
+		seconds = None
+		if seconds_per_cycle is not None:
+			if offset + CAPTURE_RECORD.size > len(data):
+				break
+			cycles, _, direction = CAPTURE_RECORD.unpack_from(data, offset)
+			seconds = cycles * seconds_per_cycle
+			offset += CAPTURE_RECORD.size
+
+		if offset + 4 > len(data):
+			break
+		body_size, msg_id = struct.unpack_from('<HH', data, offset)
+		end = offset + 4 + body_size
+		if end > len(data):
+			sys.stderr.write('{}: truncated frame at {}\n'.format(path, offset))
+			return
+
+		# compact bodies are varint encoded, the record layout does not apply to them
+		received = seconds_per_cycle is None or direction == CAPTURE_RECEIVED
+		if received and (msg_id & ~compact_flag) in msg_ids and (msg_id & compact_flag) == 0:
+			yield seconds, data[offset + 4:end]
+		offset = end
+
+
+def main():
+	parser = argparse.ArgumentParser()
+	parser.add_argument('captures', nargs='+')
+	parser.add_argument('--include', default=os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', 'include'))
+	parser.add_argument('--tick-hz', type=float, default=10.0, help='snapshot frames per second of a capture without timestamps')
+	parser.add_argument('--steps-per-unit', type=float, help='overrides SNAPSHOT_DELTA_STEPS_PER_UNIT')
+	parser.add_argument('--yaw-bits', type=int, help='overrides SNAPSHOT_DELTA_YAW_BITS')
+	parser.add_argument('--top', type=int, default=10, help='entities listed by bytes')
+	args = parser.parse_args()
+
+	include = os.path.normpath(args.include)
+	defines = msggen.DefineSet()
+	msggen.parse_defines(os.path.join(include, 'framework_msg_define.h'), defines)
+	msggen.parse_defines(os.path.join(include, 'anu_msg_define.h'), defines)
+
+	with open(os.path.join(include, 'anu_global_def.h'), encoding='utf-8') as file:
+		source = file.read()
+	steps_per_unit = args.steps_per_unit or float(re.search(r'#define\s+SNAPSHOT_DELTA_STEPS_PER_UNIT\s+([\d.]+)', source).group(1))
+	yaw_bits = args.yaw_bits or int(re.search(r'#define\s+SNAPSHOT_DELTA_YAW_BITS\s+(\d+)', source).group(1))
+
+	msg_ids = {defines.values['MOVE_SNAPSHOT_PATCH_NFY'], defines.values['MOVE_SNAPSHOT_NFY']}
+	compact_flag = defines.values['MSG_FLAG_IDFIELD_COMPACT']
+
+	replay = Replay(steps_per_unit, yaw_bits)
+	timed = 0.0
+	for path in args.captures:
+		first = last = None
+		for stamp, body in read_frames(path, msg_ids, compact_flag):
+			replay.feed_body(body)
+			if stamp is not None:
+				first = stamp if first is None else first
+				last = stamp
+		if first is not None:
+			timed += last - first
+
+	if replay.ticks == 0:
+		sys.exit('no snapshot frames found')
+
+	# one tick more than the stamps span, the last frame covers its own interval too
+	seconds = timed + 1.0 / args.tick_hz if timed > 0.0 else replay.ticks / args.tick_hz
+	entities = replay.entities
+	captured = sum(entity.captured_bytes for entity in entities.values())
+	delta = sum(entity.delta_bytes for entity in entities.values())
+	max_location_error = max(entity.max_location_error for entity in entities.values())
+	max_yaw_error = max(entity.max_yaw_error for entity in entities.values())
+
+	print('steps per unit {:g}, yaw bits {}, {} ticks over {:.1f} s'.format(steps_per_unit, yaw_bits, replay.ticks, seconds))
+	print('entities {}, records {}, deltas {}, absolute fallbacks {}, malformed {}'.format(
+		len(entities), replay.records, replay.deltas, replay.fallbacks, replay.malformed))
+	print('bytes per entity per second: captured {:.1f}, delta {:.1f} ({:+.1f}%)'.format(
+		captured / len(entities) / seconds, delta / len(entities) / seconds, (delta - captured) * 100.0 / max(captured, 1)))
+	print('max reconstruction error: location {:.4f} units, yaw {:.4f} deg'.format(max_location_error, max_yaw_error))
+
+	print('\n{:>20} {:>12} {:>12} {:>10} {:>10}'.format('guid', 'captured B/s', 'delta B/s', 'loc err', 'yaw err'))
+	for guid, entity in sorted(entities.items(), key=lambda item: -item[1].captured_bytes)[:args.top]:
+		print('{:>20} {:>12.1f} {:>12.1f} {:>10.4f} {:>10.4f}'.format(
+			guid, entity.captured_bytes / seconds, entity.delta_bytes / seconds, entity.max_location_error, entity.max_yaw_error))
+	return 0
+
+
+if __name__ == '__main__':
+	sys.exit(main())
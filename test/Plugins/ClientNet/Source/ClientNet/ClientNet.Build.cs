@@ -17,17 +17,29 @@ namespace UnrealBuildTool.Rules
             CppStandard = CppStandardVersion.Cpp17;
             PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
 
+            string workspaceDirectory = Path.Combine(ModuleDirectory, "../../../../../");
+
+            // the protocol core is shared with its standalone CMake target, Private/NetCore.cpp compiles its sources
             PublicIncludePaths.AddRange(
                 new string[] {
+                    Path.Combine(workspaceDirectory, "server/source/include"),
+                    Path.Combine(workspaceDirectory, "server/source/netcore/include"),
                 }
             );
 
             PrivateIncludePaths.AddRange(
                 new string[] {
-                    "../../../../server/source/include"
+                    "../../../../server/source/include",
+                    Path.Combine(workspaceDirectory, "server/source/netcore"),
                 }
             );
 
+            // the network pump watches native socket descriptors with epoll
+            if (Target.Platform.IsInGroup(UnrealPlatformGroup.Unix) || Target.Platform == UnrealTargetPlatform.Android)
+            {
+                PrivateIncludePaths.Add(Path.Combine(EngineDirectory, "Source/Runtime/Sockets/Private"));
+            }
+
             PublicDependencyModuleNames.AddRange(
                 new string[]
                 {
@@ -11,6 +11,10 @@
 #include "Runtime/Core/Public/Async/Async.h"
 
 #include "framework_msg_define.h"
+#include "framework_msg_struct.h"
+#include "PacketCompression.h"
+#include "PacketFragmentation.h"
+#include "NetConnect.h"
 #include "anu_msg_string.h"
 
 #include "WebSession.h"
@@ -114,6 +118,12 @@ TSharedPtr<FConnector> UClientNet::StartClientNet(const FString& addr, int32 por
 	CloseClientNet();
 
 	_shutdownEvent = FPlatformProcess::GetSynchEventFromPool(true);
+	_poller = FNetPoller::Create();
+	_connectDriver = MakeUnique<FNetConnectDriver>(_poller.Get(), [this](const TSharedPtr<FSession>& session, ConnectResult result) {
+		AsyncTask(ENamedThreads::GameThread, [this, result, session] {
+			OnConnectCompleted(session, result);
+		});
+	});
 
 	_mainWorker = new FAsyncTask<FNetAsyncTask>([this] {
 		StartPumpNetIO();
@@ -147,10 +157,16 @@ void UClientNet::CloseClientNet()
 		_shutdownEvent->Trigger();
 	}
 
+	if (_poller) {
+		_poller->Wakeup();
+	}
+
 	if (_mainWorker) {
 		_mainWorker->EnsureCompletion();
 	}
 	SAFE_DELETE(_mainWorker);
+	_connectDriver.Reset();
+	_poller.Reset();
 
 	if (_shutdownEvent) {
 		FPlatformProcess::ReturnSynchEventToPool(_shutdownEvent);
@@ -172,17 +188,32 @@ void UClientNet::CloseClientNet()
 
 	_connectings.Empty();
 	_connectionIssues.Empty();
+	_connectRequests.Empty();
 
 	_postPendingQueue.Empty();
 	_receivedQueue.Empty();
+	_receivedOverflow.Empty();
+	_pumpNotices.Empty();
 	_contentMsgQueue.Empty();
+	_dispatcher.Empty();
 
 	_sessionEstablished = false;
+	_capabilities = 0;
+	_snapshotBaselines.Clear();
 	_authorizedWebSessions.Empty();
 
+	if (_resume.GetStats().resumes + _resume.GetStats().resyncs > 0) {
+		UE_LOG(LogClientNet, Verbose, TEXT("session resume %s"), *_resume.GetStats().ToString());
+	}
+	_resume.Reset(false);
+
 	_signinToken.Empty();
 	_sessionToken.Empty();
 
+	UE_LOG(LogClientNet, Verbose, TEXT("packet pool %s"), *FNetPacketPool::Get().GetStats().ToString());
+	if (_snapshotCoalescer.IsEnabled()) {
+		UE_LOG(LogClientNet, Verbose, TEXT("snapshot coalescer %s"), *_snapshotCoalescer.GetStats().ToString());
+	}
 	UE_LOG(LogClientNet, Verbose, TEXT("clientnet closed"));
 }
 
@@ -190,12 +221,14 @@ void UClientNet::StartContentService(int32 worldID)
 {
 	UE_LOG(LogClientNet, Verbose, TEXT("starting content service [%d] token[%s]"), worldID, *_signinToken);
 	
-	TSharedPacket req = AllocPacket(FRAMEWORKMSG_QUEUE_UP_IMMIGRATION_WORLD_REQ);
-	
-	*req << _signinToken << worldID;
+	MsgSchema::FRAMEWORKMSG_QUEUE_UP_IMMIGRATION_WORLD_REQ_Body body;
+	body.signinToken = TCHAR_TO_UTF8(*_signinToken);
+	body.worldID = worldID;
+
+	TSharedPacket req = AllocPacket(body);
 	if (_security->EncryptPacket(req) == false) {
 		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SECURITY_ERROR);
-		_contentMsgQueue.Enqueue(nfy);
+		_contentMsgQueue.Add(nfy);
 		return;
 	}
 
@@ -206,8 +239,10 @@ void UClientNet::ConfirmService(uint16 waitingNumber)
 {
 	UE_LOG(LogClientNet, Verbose, TEXT("enter service waitingNumber[%d]"), waitingNumber);
 
-	TSharedPacket req = AllocPacket(FRAMEWORKMSG_START_ENTER_WORLD_REQ);
-	*req << waitingNumber;
+	MsgSchema::FRAMEWORKMSG_START_ENTER_WORLD_REQ_Body body;
+	body.waitingNumber = waitingNumber;
+
+	TSharedPacket req = AllocPacket(body);
 	SendPacket(req);
 }
 
@@ -221,7 +256,7 @@ TSharedPtr<FConnector> UClientNet::CreateConnector(const FString& addr, int32 po
 {
 	FPacketRecvQueue recvQueue;
 	recvQueue.BindLambda([this](TSharedPacket& packet) {
-		_receivedQueue.Enqueue(packet);
+		return _receivedQueue.Enqueue(MoveTemp(packet));
 	});
 
 	auto sessionID = UClientNet::GenerateSessionID();
@@ -241,61 +276,20 @@ bool UClientNet::OpenConnection(TSharedPtr<FConnector> connector, float timeout)
 		return false;
 	}
 
-	auto task = new FAutoDeleteAsyncTask<FNetAsyncTask>([this, connector, timeout] {
-		
-		static const size_t RETIRE_COUNT = 10;
-		static const uint32 RETRY_INTERVAL = 3 * 1000;
-		
-		ConnectResult result = ConnectResult::Retired;
-		auto sessionID = connector->sessionID;
-		auto session = connector->session;
-		
-		auto started = FPlatformTime::Seconds();
-		size_t trying = 0;
-		while (trying < RETIRE_COUNT) {
-
-			if (timeout != 0 && FPlatformTime::Seconds() - started >= timeout) {
-				result = ConnectResult::Timeout;
-				break;
-			}
-
-			uint8* ip = (uint8*)&session->_ip;
-
-			if (session->Create(connector->addr, connector->port) == false) {
-				UE_LOG(LogClientNet, Warning, TEXT("failed to create session"));
-				goto WAITING_RETRY;
-			}
-			
-			UE_LOG(LogClientNet, Verbose, TEXT("connecting task started session_id[%d]"), sessionID);
-			if (!session->PrepareConnect()) {
-				UE_LOG(LogClientNet, Error, TEXT("failed to init session network environment session_id[%d]"), sessionID);
-				goto WAITING_RETRY;
-			}
-
-			UE_LOG(LogClientNet, Verbose, TEXT("trying to connect [%d.%d.%d.%d : %d]"), ip[3], ip[2], ip[1], ip[0], session->_port);
-			if (session->Connect()) {
-				result = ConnectResult::Success;
-				break;
-			}
-
-		WAITING_RETRY:
-			// close 
-			session->Close();
-			
-			++trying;
-			UE_LOG(LogClientNet, Warning, TEXT("failed to connect.. retry in %d msec"), RETRY_INTERVAL);
-			if (_shutdownEvent == nullptr || _shutdownEvent->Wait(RETRY_INTERVAL)) {
-				UE_LOG(LogClientNet, Verbose, TEXT("shutting down event triggered, closing connection task"));
-				break;
-			}
-		}
+	if (_poller.IsValid() == false || _connectDriver.IsValid() == false) {
+		UE_LOG(LogClientNet, Error, TEXT("netio pump not started"));
+		_connectings.Remove(connector->sessionID);
+		return false;
+	}
 
-		AsyncTask(ENamedThreads::GameThread, [this, result, session] {
-			OnConnectCompleted(session, result);
-		});
-	});
+	// the pump drives the connect, no thread waits on it
+	if (_connectRequests.Enqueue(TPair<TSharedPtr<FConnector>, float>(connector, timeout)) == false) {
+		UE_LOG(LogClientNet, Error, TEXT("connect requests overflowed, session_id[%d] dropped"), connector->sessionID);
+		_connectings.Remove(connector->sessionID);
+		return false;
+	}
 
-	task->StartBackgroundTask(_workerThreadPooler);
+	WakeupPump();
 	return true;
 }
 
@@ -309,17 +303,56 @@ void UClientNet::CloseSession(int32 sessionID)
 	UE_LOG(LogClientNet, Verbose, TEXT("close session_id[%d] intentionally"), sessionID);
 	SessionInfo info(sessionID, nullptr);
 	_connectionIssues.Enqueue(info);
+	WakeupPump();
+}
+
+void UClientNet::WakeupPump()
+{
+	if (_poller) {
+		_poller->Wakeup();
+	}
 }
 
 void UClientNet::StartPumpNetIO()
 {
 	UE_LOG(LogClientNet, Verbose, TEXT("starting pumping netio task"));
-	constexpr uint32 WAIT_TIMEOUT_MSEC = 1;
+	constexpr uint32 POLL_TIMEOUT_MSEC = 1;
+	constexpr uint32 IDLE_TIMEOUT_MSEC = 100;
+	constexpr uint32 CONNECT_POLL_TIMEOUT_MSEC = 10;
+
+	// sessions held back by a full received queue, their sockets are not watched for readability meanwhile
+	TSet<int32> stalled;
+	// sessions with an unsent tail, their sockets are watched for writability until it went out
+	TSet<int32> writing;
+
+	auto unwatch = [this, &stalled, &writing](TSharedPtr<FSession>& session) {
+		bool watched = stalled.Remove(session->_sessionID) == 0 || writing.Contains(session->_sessionID);
+		writing.Remove(session->_sessionID);
+		if (watched == false) {
+			return;
+		}
+		if (FSocket* socket = session->GetSocket()) {
+			_poller->Unregister(socket);
+		}
+	};
+
+	TArray<SessionInfo> issues;
+	TArray<TPair<int32, TSharedPacket>> requests;
+	TArray<TPair<TSharedPtr<FConnector>, float>> connects;
 
-	while (_shutdownEvent->Wait(WAIT_TIMEOUT_MSEC) == false)
+	uint32 timeout = 0;
+	while (true)
 	{
-		SessionInfo info;
-		while (_connectionIssues.Dequeue(info))
+		_poller->Wait(timeout);
+		if (_shutdownEvent->Wait(0)) {
+			break;
+		}
+
+		FlushPumpNotices();
+
+		issues.Reset();
+		_connectionIssues.DequeueAll(issues);
+		for (SessionInfo& info : issues)
 		{
 			int32 sessionID = info.Key;
 			check(sessionID != 0);
@@ -328,19 +361,33 @@ void UClientNet::StartPumpNetIO()
 			if (session.IsValid()) {
 				check(session->_sessionID == sessionID);
 				_sessions.Add(sessionID, session);
+				if (FSocket* socket = session->GetSocket()) {
+					_poller->Register(socket);
+				}
 			} else {
 				session = _sessions.FindRef(sessionID);
 				if (session.IsValid() == false) {
 					UE_LOG(LogClientNet, Error, TEXT("not a valid session_id[%d] trying to disconnect"), sessionID);
 					continue;
 				}
+				unwatch(session);
 				session->Close();
 				_sessions.Remove(sessionID);
 			}
 		}
 
-		TPair<int32, TSharedPacket> request;
-		while (_postPendingQueue.Dequeue(request)) {
+		// connects advance on every wakeup, a handshake that ended or a lookup that finished wakes the poller
+		double now = FPlatformTime::Seconds();
+		connects.Reset();
+		_connectRequests.DequeueAll(connects);
+		for (TPair<TSharedPtr<FConnector>, float>& connect : connects) {
+			_connectDriver->Start(connect.Key, connect.Value, now);
+		}
+		_connectDriver->Advance(now);
+
+		requests.Reset();
+		_postPendingQueue.DequeueAll(requests);
+		for (TPair<int32, TSharedPacket>& request : requests) {
 			int32 sessionID = request.Key;
 			if (TSharedPtr<FSession>* session = _sessions.Find(sessionID)) {
 				(*session)->SendPacket(request.Value);
@@ -353,14 +400,61 @@ void UClientNet::StartPumpNetIO()
 			++it;
 
 			TSharedPtr<FSession> session = current.Value();
-			if (session->PumpNetIO() == false || _simulateDisconnect) {
+			bool disconnected = session->PumpNetIO() == false;
+
+			// fault injection on the server connection, it goes down with whatever of the burst did not make it out yet
+			int32 countdown = _simulateDisconnect.load();
+			if (disconnected == false && countdown >= 0 && current.Key() == _simulateDisconnectSession.load()) {
+				countdown -= (int32)session->GetStats().lastPumpPacketsSent;
+				_simulateDisconnect = countdown > 0 ? countdown : -1;
+				disconnected = countdown <= 0;
+			}
+
+			if (disconnected) {
+				unwatch(session);
 				OnDisconnected(session);
 				current.RemoveCurrent();
-				_simulateDisconnect = false;
+				continue;
+			}
+
+			// a readable socket would wake a level triggered poller right away while nothing can be read from it.
+			// Sending() stops short only when the socket is full, writability wakes the pump once it takes more
+			bool receiveStalled = session->IsReceiveStalled();
+			bool sendBlocked = session->HasPendingSend();
+			if (receiveStalled != stalled.Contains(session->_sessionID) || sendBlocked != writing.Contains(session->_sessionID)) {
+				if (FSocket* socket = session->GetSocket()) {
+					_poller->SetInterest(socket, receiveStalled == false, sendBlocked);
+					if (receiveStalled) {
+						stalled.Add(session->_sessionID);
+					} else {
+						stalled.Remove(session->_sessionID);
+					}
+					if (sendBlocked) {
+						writing.Add(session->_sessionID);
+					} else {
+						writing.Remove(session->_sessionID);
+					}
+				}
+			}
+		}
+
+		bool noticesPending = FlushPumpNotices() == false;
+
+		// sessions waiting for room in the received queue still need polling, and so does every socket with its unsent tail
+		// when the poller can not wake on it
+		bool polling = noticesPending || stalled.Num() > 0 || (_poller->IsReadinessDriven() == false && _sessions.Num() > 0);
+		timeout = polling ? POLL_TIMEOUT_MSEC : IDLE_TIMEOUT_MSEC;
+
+		// connect deadlines come from the timer heap, handshakes without readiness are polled
+		if (_connectDriver->IsEmpty() == false) {
+			timeout = FMath::Min(timeout, _connectDriver->GetWaitMsec(FPlatformTime::Seconds()));
+			if (_poller->IsReadinessDriven() == false) {
+				timeout = FMath::Min(timeout, CONNECT_POLL_TIMEOUT_MSEC);
 			}
 		}
 	}
 
+	_connectDriver->CancelAll();
 	UE_LOG(LogClientNet, Verbose, TEXT("pumping netio task closed"));
 }
 
@@ -377,11 +471,12 @@ void UClientNet::OnConnectCompleted(TSharedPtr<FSession> session, ConnectResult
 
 	TSharedPacket noti = AllocPacket(msg, sessionID);
 	*noti << sessionID;
-	_receivedQueue.Enqueue(noti);
+	PostReceived(noti);
 
 	if (msg == CLIENTNETMSG_INTERNAL_CONNECTED) {
 		SessionInfo info(sessionID, session);
 		_connectionIssues.Enqueue(info);
+		WakeupPump();
 	}
 }
 
@@ -389,16 +484,34 @@ void UClientNet::OnDisconnected(TSharedPtr<FSession> session)
 {
 	auto sessionID = session->_sessionID;
 
+	// after whatever the session delivered before it went down
 	TSharedPacket noti = AllocPacket(CLIENTNETMSG_INTERNAL_DISCONNECTED, sessionID);
 	*noti << sessionID;
-	_receivedQueue.Enqueue(noti);
+	_pumpNotices.Emplace(noti);
 
 	_sessionEstablished = false;
-	_timer.Remove(TEXT("TokenRenewal"));
 
 	UE_LOG(LogClientNet, Error, TEXT("OnDisconnected sessionID:%u code:%u"), sessionID, UClientNet::_socketSubsystem->GetLastErrorCode());
 }
 
+void UClientNet::PostReceived(TSharedPacket packet)
+{
+	// once one notice waits, the ones after it wait too so the game thread sees them in order
+	if (_receivedOverflow.Num() > 0 || _receivedQueue.Enqueue(MoveTemp(packet)) == false) {
+		_receivedOverflow.Emplace(MoveTemp(packet));
+	}
+}
+
+bool UClientNet::FlushPumpNotices()
+{
+	int32 posted = 0;
+	while (posted < _pumpNotices.Num() && _receivedQueue.Enqueue(_pumpNotices[posted])) {
+		++posted;
+	}
+	_pumpNotices.RemoveAt(0, posted, EAllowShrinking::No);
+	return _pumpNotices.Num() == 0;
+}
+
 TSharedPtr<FConnector> UClientNet::RestartClientNet(float delay, float timeout)
 {
 	if (_addr.IsSet() == false || _addr->IsEmpty() || _port.IsSet() == false || *_port == 0) {
@@ -415,17 +528,30 @@ TSharedPtr<FConnector> UClientNet::RestartClientNet(float delay, float timeout)
 
 TSharedPacket UClientNet::AllocPacket(uint16 msgID, int32 sessionID)
 {
-	TSharedPacket packet = MakeShared<FNetPacket>(msgID);
+	TSharedPacket packet = FNetPacketPool::Get().Alloc(msgID);
 	packet->SetSessionID(sessionID);
+	if (_compactOpcodes[msgID]) {
+		packet->SetCompact(true);
+	}
 	return packet;
 }
 
+void UClientNet::SetCompactEncoding(uint16 msgID, bool enabled)
+{
+	// framework and internal messages keep the fixed layout the handshake relies on
+	if ((msgID & MSG_FLAG_IDFIELD_CONTENT) != MSG_FLAG_IDFIELD_CONTENT || IS_COMPACT_MSG(msgID)) {
+		UE_LOG(LogClientNet, Warning, TEXT("compact encoding is for content messages only msg_id[0x%x]"), msgID);
+		return;
+	}
+
+	_compactOpcodes[msgID] = enabled;
+}
+
 bool UClientNet::SendPacket(TSharedPacket& packet, bool framework)
 {
 #if !UE_BUILD_SHIPPING
-	auto itr = MsgHelper::ProtocolMap.find(packet->GetMsgID());
-	if (itr != MsgHelper::ProtocolMap.end()) {
-		UE_LOG(LogClientNet, Verbose, TEXT("[REQ] %s"), WCHAR_TO_TCHAR(itr->second.c_str()));
+	if (const wchar_t* name = MsgHelper::FindProtocolName(packet->GetMsgID())) {
+		UE_LOG(LogClientNet, Verbose, TEXT("[REQ] %s"), WCHAR_TO_TCHAR(name));
 	}
 #endif
 	if (_serverSession.IsSet() == false) {
@@ -438,8 +564,43 @@ bool UClientNet::SendPacket(TSharedPacket& packet, bool framework)
 		return false;
 	}
 
-	TPair<int32, TSharedPacket> send(*_serverSession, packet);
-	return _postPendingQueue.Enqueue(send);
+	if (PostPacket(packet) == false) {
+		return false;
+	}
+
+	// kept for a replay even when the connection drops before the pump got to it, the server numbers content messages only
+	if ((packet->GetMsgID() & MSG_FLAG_IDFIELD_CONTENT) == MSG_FLAG_IDFIELD_CONTENT) {
+		_resume.OnSent(packet);
+	}
+	return true;
+}
+
+bool UClientNet::PostPacket(const TSharedPacket& packet)
+{
+	// without the capability the peer would read a streamed body as a broken frame
+	packet->FinalizeHeader();
+	if (packet->IsStreamed() && (_capabilities & FRAMEWORK_CAPABILITY_FRAGMENT) == 0) {
+		UE_LOG(LogClientNet, Error, TEXT("body of msg_id[0x%x] needs fragmentation the session did not agree on, size[%u]"), packet->GetMsgID(), packet->GetBodySize());
+		return false;
+	}
+
+	// by the id, not by how it was sent: framework bodies are small or encrypted and ciphertext does not shrink
+	TSharedPacket sending = packet;
+	bool content = (packet->GetMsgID() & MSG_FLAG_IDFIELD_CONTENT) == MSG_FLAG_IDFIELD_CONTENT;
+	if (content && (_capabilities & FRAMEWORK_CAPABILITY_LZ4) != 0) {
+		if (TSharedPacket envelope = FPacketCompression::Compress(packet)) {
+			sending = envelope;
+		}
+	}
+
+	TPair<int32, TSharedPacket> send(*_serverSession, sending);
+	if (_postPendingQueue.Enqueue(MoveTemp(send)) == false) {
+		UE_LOG(LogClientNet, Error, TEXT("post pending queue overflowed, msg_id[0x%x] dropped"), packet->GetMsgID());
+		return false;
+	}
+
+	WakeupPump();
+	return true;
 }
 
 TSharedRef<IHttpRequest, ESPMode::ThreadSafe> UClientNet::AllocHTTP(EHTTPRequestVerb verb, EHTTPContentType contentType, float timeOut)
@@ -641,59 +802,215 @@ void  UClientNet::SetExternalHandler(FOnWebSocketPacket handler)
 
 void UClientNet::TestDisconnect()
 {
-	_simulateDisconnect = true;
+	TestDisconnect(0);
+}
+
+void UClientNet::TestDisconnect(int32 afterSentPackets)
+{
+	// the pump does not read _serverSession, it gets the session to drop along with the count
+	_simulateDisconnectSession = _serverSession.Get(0);
+	_simulateDisconnect = FMath::Max(afterSentPackets, 0);
+	WakeupPump();
 }
 
 void UClientNet::Tick(float deltaTime)
 {
 	_timer.Tick(deltaTime);
+	TickReplay();
+
+	// handlers may enqueue follow-ups, those are drained in the same tick.
+	// draining makes room for the sessions the pump held back, they are read again on its next round
+	while (true) {
+		_receivedQueue.DequeueAll(_dispatchBatch);
+		_dispatchBatch.Append(MoveTemp(_receivedOverflow));
+		_receivedOverflow.Reset();
+		if (_dispatchBatch.Num() == 0) {
+			break;
+		}
 
-	TSharedPacket packet;
-	while (_receivedQueue.Dequeue(packet)) {
-		ConsumePacket(packet);
+		for (TSharedPacket& packet : _dispatchBatch) {
+			ConsumePacket(MoveTemp(packet));
+		}
+		_dispatchBatch.Reset();
 	}
 
-	while (_contentMsgQueue.Dequeue(packet)) {
-		_contentHandlers.ExecuteIfBound(packet);
+	// content goes through the budgeted dispatcher, whatever does not fit spills into the next frame
+	_dispatcher.BeginFrame();
+
+	Swap(_dispatchBatch, _contentMsgQueue);
+	_snapshotCoalescer.Coalesce(_dispatchBatch);
+	for (TSharedPacket& packet : _dispatchBatch) {
+		_dispatcher.Push(MoveTemp(packet));
 	}
+	_dispatchBatch.Reset();
+
+	_dispatcher.Dispatch([this](TSharedPacket& packet) {
+		uint64 start = FPlatformTime::Cycles64();
+		_contentHandlers.ExecuteIfBound(packet);
+		FNetTelemetry::Get().RecordHandled(packet->GetMsgID(), start, FPlatformTime::Cycles64(), packet->GetTimestamp());
+		if (packet->GetCompactSavings() != 0) {
+			FNetTelemetry::Get().RecordCompactSavings(packet->GetMsgID(), packet->GetCompactSavings(), false);
+		}
+	});
 
 	TSharedWebSocketPacket webSocketPacket;
-	while (_receivedWebSocketQueue.Dequeue(webSocketPacket)) {
+	while (_dispatcher.TryCharge() && _receivedWebSocketQueue.Dequeue(webSocketPacket)) {
 		_webSocketContentHandler.ExecuteIfBound(webSocketPacket);
 	}
+
+	_dispatcher.EndFrame();
+
+	FNetTelemetry::Get().Tick(deltaTime);
+}
+
+bool UClientNet::StartReplay(const FString& path, bool realtime)
+{
+	StopReplay();
+
+	TUniquePtr<FNetReplay> replay = MakeUnique<FNetReplay>();
+	if (replay->reader.Open(path) == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("failed to open capture [%s]"), *path);
+		return false;
+	}
+
+	replay->realtime = realtime;
+	replay->startSeconds = FPlatformTime::Seconds();
+	_replay = MoveTemp(replay);
+
+	UE_LOG(LogClientNet, Display, TEXT("replay started [%s] %s"), *path, realtime ? TEXT("realtime") : TEXT("max speed"));
+	return true;
+}
+
+void UClientNet::StopReplay()
+{
+	if (_replay.IsValid() == false) {
+		return;
+	}
+
+	double seconds = FPlatformTime::Seconds() - _replay->startSeconds;
+	UE_LOG(LogClientNet, Display, TEXT("replay finished frames[%llu] bytes[%llu] seconds[%.3f] frames/s[%.0f], handler cost per message id in ClientNet.Telemetry"),
+		_replay->frames, _replay->bytes, seconds, seconds > 0.0 ? _replay->frames / seconds : 0.0);
+	_replay.Reset();
+}
+
+void UClientNet::TickReplay()
+{
+	if (_replay.IsValid() == false) {
+		return;
+	}
+
+	// at max speed one tick never feeds more than the handlers drain
+	static constexpr int32 MaxFramesPerTick = 4096;
+
+	FNetReplay& replay = *_replay;
+	double elapsed = FPlatformTime::Seconds() - replay.startSeconds;
+
+	// a full received queue holds the capture back like it holds back the sessions
+	for (int32 fed = 0; fed < MaxFramesPerTick && _receivedOverflow.Num() == 0;) {
+		if (replay.pendingFrame == nullptr && replay.reader.Next(replay.pending, replay.pendingFrame, replay.pendingSize) == false) {
+			StopReplay();
+			return;
+		}
+
+		if (replay.pending.direction != ENetCaptureDirection::Received) {
+			replay.pendingFrame = nullptr;
+			continue;
+		}
+
+		if (replay.firstCycles == 0) {
+			replay.firstCycles = replay.pending.cycles;
+		}
+
+		if (replay.realtime && (replay.pending.cycles - replay.firstCycles) * replay.reader.GetSecondsPerCycle() > elapsed) {
+			break;
+		}
+
+		// envelopes are unwrapped straight out of the mapping like the session does out of its ring
+		FNetPacketView view(replay.pendingFrame, replay.pendingSize);
+		int64 timestamp = (int64)FPlatformTime::Cycles64();
+
+		TSharedPacket packet;
+		FFrameUnwrapper::EResult unwrapped;
+		if (FFrameUnwrapper::IsEnvelope(view.GetMsgID())) {
+			unwrapped = replay.unwrapper.Unwrap(view, replay.pending.sessionID, timestamp, packet);
+		} else {
+			packet = FNetPacketPool::Get().AllocFrame(replay.pendingSize);
+			::memcpy(packet->GetPacketBuffer(), replay.pendingFrame, replay.pendingSize);
+			packet->IncWrPos(replay.pendingSize);
+			packet->SetRdPos(0);
+			packet->SetSessionID(replay.pending.sessionID);
+			packet->SetTimestamp(timestamp);
+			unwrapped = replay.unwrapper.Unwrap(packet);
+		}
+
+		replay.bytes += replay.pendingSize;
+		replay.pendingFrame = nullptr;
+		++replay.frames;
+		++fed;
+
+		if (unwrapped == FFrameUnwrapper::EResult::Corrupted) {
+			UE_LOG(LogClientNet, Warning, TEXT("corrupted envelope in capture, replay stopped"));
+			StopReplay();
+			return;
+		}
+
+		if (unwrapped == FFrameUnwrapper::EResult::Ready) {
+			PostReceived(MoveTemp(packet));
+		}
+	}
 }
 
-inline std::set<uint16> ignoreProtocols =
+// too frequent to be logged per packet
+constexpr bool IsQuietProtocol(uint16 msgID)
 {
-	MOVE_SNAPSHOT_PATCH_NFY,
-	DEBUG_LOCATION_ACK,
-	DEBUG_VOXEL_ACK,
-};
+	switch (msgID) {
+	case MOVE_SNAPSHOT_PATCH_NFY:
+	case DEBUG_LOCATION_ACK:
+	case DEBUG_VOXEL_ACK:
+		return true;
+	default:
+		return false;
+	}
+}
 
 bool UClientNet::ConsumePacket(TSharedPacket packet)
 {
 	uint16 msgID = packet->GetMsgID();
 
 #if !UE_BUILD_SHIPPING
-	auto itr = MsgHelper::ProtocolMap.find(msgID);
-	if (itr != MsgHelper::ProtocolMap.end() && ignoreProtocols.find(msgID) == ignoreProtocols.end()) {
-		UE_LOG(LogClientNet, Verbose, TEXT("[REC] %s"), WCHAR_TO_TCHAR(itr->second.c_str()));
+	if (IsQuietProtocol(msgID) == false) {
+		if (const wchar_t* name = MsgHelper::FindProtocolName(msgID)) {
+			UE_LOG(LogClientNet, Verbose, TEXT("[REC] %s"), WCHAR_TO_TCHAR(name));
+		}
 	}
 #endif
 
+	// content of the server session is numbered for a resume, acks go out in batches
+	if ((msgID & MSG_FLAG_IDFIELD_CONTENT) == MSG_FLAG_IDFIELD_CONTENT && _serverSession.IsSet() && packet->GetSessionID() == *_serverSession) {
+		if (_resume.OnReceived()) {
+			SendSequenceAck();
+		}
+	}
+
 	FOnPacket* handler = _handlers.Find(msgID);
 	if (handler == nullptr) {
-		OnUnhandledMsg(packet);
+		OnUnhandledMsg(MoveTemp(packet));
 		return false;
 	}
 
+	uint64 start = FPlatformTime::Cycles64();
 	handler->Execute(packet);
+	FNetTelemetry::Get().RecordHandled(msgID, start, FPlatformTime::Cycles64(), packet->GetTimestamp());
+	if (packet->GetCompactSavings() != 0) {
+		FNetTelemetry::Get().RecordCompactSavings(msgID, packet->GetCompactSavings(), false);
+	}
 	return true;
 }
 
 void UClientNet::OnUnhandledMsg(TSharedPacket packet)
 {
-	_contentMsgQueue.Enqueue(packet);
+	// forwarded as it is, the content handlers read the same buffer
+	_contentMsgQueue.Emplace(MoveTemp(packet));
 }
 
 bool UClientNet::SendWebSocket(TSharedWebSocketPacket& packet, int32 sessionID)
@@ -2,7 +2,10 @@
 
 #include "ClientNet.h"
 #include "Timer.h"
+#include "PacketCompression.h"
+#include "PacketFragmentation.h"
 #include "framework_msg_define.h"
+#include "framework_msg_struct.h"
 #include "anu_global_def.h"
 
 void UClientNet::RegisterPacketHandlers()
@@ -24,6 +27,8 @@ void UClientNet::RegisterPacketHandlers()
 	REGISTER_HANDLER(FRAMEWORKMSG_DISCONTINUE_SESSION);
 	REGISTER_HANDLER(FRAMEWORKMSG_RENEWAL_SESSION_ACK);
 	REGISTER_HANDLER(FRAMEWORKMSG_REPAIR_SESSION_ACK);
+	REGISTER_HANDLER(FRAMEWORKMSG_RESUME_SESSION_ACK);
+	REGISTER_HANDLER(FRAMEWORKMSG_SEQUENCE_ACK);
 	REGISTER_HANDLER(FRAMEWORKMSG_HANDOVER_ACK);
 
 	REGISTER_HANDLER(FRAMEWORKMSG_SECURITY_EXCHANGE_ACK);
@@ -37,12 +42,32 @@ void UClientNet::RegisterPacketHandlers()
 
 void UClientNet::AddPacketHandler(uint16 msg, const FOnPacket& handler)
 {
-	_handlers.Emplace(msg, handler);
+	_handlers.Add(msg, handler);
 }
 
 void UClientNet::SendHeartbeats()
 {
-	TSharedPacket req = AllocPacket(FRAMEWORKMSG_HEART_BEAT_REQ);
+	MsgSchema::FRAMEWORKMSG_HEART_BEAT_REQ_Body body;
+	body.clientSent = _clock.OnProbeSent(FPlatformTime::Seconds());
+
+	TSharedPacket req = AllocPacket(body);
+	SendPacket(req, true);
+
+	// a quiet session still lets the server trim its replay buffer
+	SendSequenceAck();
+}
+
+void UClientNet::SendSequenceAck()
+{
+	uint32 received = _resume.TakeAck();
+	if (received == 0) {
+		return;
+	}
+
+	MsgSchema::FRAMEWORKMSG_SEQUENCE_ACK_Body body;
+	body.received = received;
+
+	TSharedPacket req = AllocPacket(body);
 	SendPacket(req, true);
 }
 
@@ -68,14 +93,18 @@ void UClientNet::OnCLIENTNETMSG_INTERNAL_CONNECTED(TSharedPacket packet)
 		Request_SETUP_CORD();
 	});
 
-	const static float HEART_BEAT_INTERVAL_SEC = 10.0f;
-	_timer.AddTask(TEXT("HeartBeat"), HEART_BEAT_INTERVAL_SEC, RepeatableTaskDelegate::CreateLambda([this]() -> bool {
-		SendHeartbeats();
+	// the probe interval adapts to the estimate and the content, the task only checks whether one is due
+	_clock.Reset();
+	const static float HEART_BEAT_CHECK_INTERVAL_SEC = 0.25f;
+	_timer.AddTask(TEXT("HeartBeat"), HEART_BEAT_CHECK_INTERVAL_SEC, RepeatableTaskDelegate::CreateLambda([this]() -> bool {
+		if (_clock.IsProbeDue(FPlatformTime::Seconds())) {
+			SendHeartbeats();
+		}
 		return true;
 	}));
 
 	TSharedPacket req = AllocPacket(CLIENTNETMSG_INTERNAL_CONNECTED);
-	_contentMsgQueue.Enqueue(req);
+	_contentMsgQueue.Add(req);
 }
 
 void UClientNet::OnCLIENTNETMSG_INTERNAL_DISCONNECTED(TSharedPacket packet)
@@ -84,20 +113,39 @@ void UClientNet::OnCLIENTNETMSG_INTERNAL_DISCONNECTED(TSharedPacket packet)
 	*packet >> sessionID;
 
 	_timer.Remove(TEXT("HeartBeat"));
+	_timer.Remove(TEXT("TokenRenewal"));
+
+	// read by PostPacket on this thread, the next setup cord negotiates again
+	_capabilities = 0;
 	
 	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_DISCONNECTED);
 	*nfy << sessionID;
-	_contentMsgQueue.Enqueue(nfy);
+	_contentMsgQueue.Add(nfy);
 }
 
-void UClientNet::OnFRAMEWORKMSG_SETUP_CORD(TSharedPacket)
+void UClientNet::OnFRAMEWORKMSG_SETUP_CORD(TSharedPacket packet)
 {
+	// a server without capabilities answers with a body that does not decode, nothing is enabled then
+	MsgSchema::FRAMEWORKMSG_SETUP_CORD_Body body;
+	if (packet->ReadBody(body)) {
+		_capabilities = body.capabilities & _offeredCapabilities;
+	}
+	UE_LOG(LogClientNet, Verbose, TEXT("setup cord capabilities offered[0x%02x] enabled[0x%02x]"), _offeredCapabilities, _capabilities);
+
 	Reqeust_SECURITY_EXCHANGE();
 }
 
-void UClientNet::OnFRAMEWORKMSG_HEART_BEAT_ACK(TSharedPacket)
+void UClientNet::OnFRAMEWORKMSG_HEART_BEAT_ACK(TSharedPacket packet)
 {
+	// a server without clock probes answers with an empty body
+	MsgSchema::FRAMEWORKMSG_HEART_BEAT_ACK_Body ack;
+	if (packet->ReadBody(ack) == false) {
+		return;
+	}
 
+	if (_clock.OnProbeAnswered(ack.clientSent, ack.serverReceived, ack.serverSent, packet->GetTimestamp()) == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("heartbeat stamps out of order sent[%lld] server received[%lld] server sent[%lld]"), (int64)ack.clientSent, (int64)ack.serverReceived, (int64)ack.serverSent);
+	}
 }
 
 void UClientNet::OnFRAMEWORKMSG_SIGN_IN_ACK(TSharedPacket packet)
@@ -119,6 +167,10 @@ void UClientNet::OnFRAMEWORKMSG_SIGN_IN_ACK(TSharedPacket packet)
 
 			*packet >> _signinToken;
 			*packet >> _sessionToken;
+
+			// numbering and delta baselines start over with the new session on both sides
+			_resume.Reset((_capabilities & FRAMEWORK_CAPABILITY_RESUME) != 0);
+			_snapshotBaselines.Clear();
 			
 			_accountInfo->_characters.Empty();
 			
@@ -150,7 +202,7 @@ void UClientNet::OnFRAMEWORKMSG_SIGN_IN_ACK(TSharedPacket packet)
 			TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SIGN_IN);
 			*nfy << result;
 			*nfy << code;
-			_contentMsgQueue.Enqueue(nfy);
+			_contentMsgQueue.Add(nfy);
 		}
 		break;
 		case SIGN_IN_INVALID_ACCOUNT_STATE:
@@ -160,14 +212,14 @@ void UClientNet::OnFRAMEWORKMSG_SIGN_IN_ACK(TSharedPacket packet)
 
 			TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SIGN_IN);
 			*nfy << result;
-			_contentMsgQueue.Enqueue(nfy);
+			_contentMsgQueue.Add(nfy);
 		}
 		break;
 		default:
 		{
 			TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SIGN_IN);
 			*nfy << result;
-			_contentMsgQueue.Enqueue(nfy);
+			_contentMsgQueue.Add(nfy);
 		}
 		break;
 	}
@@ -177,16 +229,20 @@ void UClientNet::OnFRAMEWORKMSG_WORLD_LIST_ACK(TSharedPacket packet)
 {
 	_activeWorldIDs.Empty();
 
-	uint16 count = *packet;
-	UE_LOG(LogClientNet, Verbose, TEXT("received world lists [%d]"), count);
+	// the login flow waits for the notice, a list that does not decode goes out empty
+	MsgSchema::FRAMEWORKMSG_WORLD_LIST_ACK_Body ack;
+	if (packet->ReadBody(ack) == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("malformed FRAMEWORKMSG_WORLD_LIST_ACK size[%u]"), packet->GetBodySize());
+		ack.worldIDs.clear();
+	}
+	UE_LOG(LogClientNet, Verbose, TEXT("received world lists [%d]"), (int32)ack.worldIDs.size());
 
-	for (int16 i = 0; i < count; ++i) {
-		uint32 worldID = *packet;
+	for (uint32 worldID : ack.worldIDs) {
 		_activeWorldIDs.Add(worldID);
 	}
 
 	TSharedPacket req = AllocPacket(CLIENTNETMSG_INTERNAL_WORLD_LIST_RECEIVED);
-	_contentMsgQueue.Enqueue(req);
+	_contentMsgQueue.Add(req);
 }
 
 void UClientNet::OnFRAMEWORKMSG_QUEUE_UP_IMMIGRATION_WORLD_ACK(TSharedPacket packet)
@@ -200,7 +256,7 @@ void UClientNet::OnFRAMEWORKMSG_QUEUE_UP_IMMIGRATION_WORLD_ACK(TSharedPacket pac
 			*packet >> messages;
 			*nfy << messages;
 		}
-		_receivedQueue.Enqueue(nfy);
+		PostReceived(nfy);
 		UE_LOG(LogClientNet, Verbose, TEXT("queue up immigration failed code:%u"), result);
 		return;
 	}
@@ -214,26 +270,30 @@ void UClientNet::OnFRAMEWORKMSG_QUEUE_UP_IMMIGRATION_WORLD_ACK(TSharedPacket pac
 
 	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_QUEUE_UP);
 	*nfy << result << waitingNumber << processedNumber;
-	_receivedQueue.Enqueue(nfy);
+	PostReceived(nfy);
 
 	UE_LOG(LogClientNet, Verbose, TEXT("queue up immigration number:%u processed:%u remain:%u"), waitingNumber, processedNumber, (uint16)(waitingNumber - processedNumber));
 }
 
 void UClientNet::OnFRAMEWORKMSG_IMMIGRATION_WORLD(TSharedPacket packet)
 {
-	uint16 processedNumber = *packet;
+	MsgSchema::FRAMEWORKMSG_IMMIGRATION_WORLD_Body body;
+	if (packet->ReadBody(body) == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("malformed FRAMEWORKMSG_IMMIGRATION_WORLD size[%u]"), packet->GetBodySize());
+		return;
+	}
 	
 	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_IMMIGRATION);
-	*nfy << processedNumber;
-	_receivedQueue.Enqueue(nfy);
+	*nfy << body.processedNumber;
+	PostReceived(nfy);
 
-	UE_LOG(LogClientNet, Verbose, TEXT("processe immigration number:%u"), processedNumber);
+	UE_LOG(LogClientNet, Verbose, TEXT("processe immigration number:%u"), body.processedNumber);
 }
 
 void UClientNet::OnFRAMEWORKMSG_IMMIGRATION_COMPLETED(TSharedPacket)
 {
 	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_IMMIGRATION_COMPLETED);
-	_receivedQueue.Enqueue(nfy);
+	PostReceived(nfy);
 	UE_LOG(LogClientNet, Verbose, TEXT("immigration completed"));
 }
 
@@ -250,7 +310,7 @@ void UClientNet::OnFRAMEWORKMSG_START_ENTER_WORLD_ACK(TSharedPacket packet)
 
 		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_START_ENTER_WORLD);
 		*nfy << result << waitingEntryID << (uint64)timestamp;
-		_contentMsgQueue.Enqueue(nfy);
+		_contentMsgQueue.Add(nfy);
 
 		StartWebSocketService();
 	}
@@ -265,11 +325,14 @@ void UClientNet::OnFRAMEWORKMSG_START_ENTER_WORLD_ACK(TSharedPacket packet)
 
 void UClientNet::OnFRAMEWORKMSG_DISCONTINUE_SESSION(TSharedPacket packet)
 {
-	uint8 reason = *packet;
+	// a short body still ends the session, the reason stays 0
+	MsgSchema::FRAMEWORKMSG_DISCONTINUE_SESSION_Body body;
+	packet->ReadBody(body);
+	uint8 reason = body.reason;
 
 	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_DISCONTINUE_SESSION);
 	*nfy << reason;
-	_contentMsgQueue.Enqueue(nfy);
+	_contentMsgQueue.Add(nfy);
 
 	UE_LOG(LogClientNet, Verbose, TEXT("FRAMEWORKMSG_DISCONTINUE_SESSION reason[%u] serverSession[%u]"), reason, *_serverSession);
 
@@ -277,6 +340,9 @@ void UClientNet::OnFRAMEWORKMSG_DISCONTINUE_SESSION(TSharedPacket packet)
 	CloseSession(*_serverSession);
 
 	_sessionEstablished = false;
+	_capabilities = 0;
+	_snapshotBaselines.Clear();
+	_resume.Reset(false);
 	_serverSession = 0;
 	_sessionToken.Empty();
 	_signinToken.Empty();
@@ -287,11 +353,16 @@ void UClientNet::OnFRAMEWORKMSG_RENEWAL_SESSION_ACK(TSharedPacket packet)
 {
 	if (_security->DecryptPacket(packet) == false) {
 		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SECURITY_ERROR);
-		_contentMsgQueue.Enqueue(nfy);
+		_contentMsgQueue.Add(nfy);
 		return;
 	}
 
-	*packet >> _sessionToken;
+	MsgSchema::FRAMEWORKMSG_RENEWAL_SESSION_ACK_Body ack;
+	if (packet->ReadBody(ack) == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("malformed FRAMEWORKMSG_RENEWAL_SESSION_ACK size[%u]"), packet->GetBodySize());
+		return;
+	}
+	_sessionToken = UTF8_TO_TCHAR(ack.sessionToken.c_str());
 	
 	UE_LOG(LogClientNet, Verbose, TEXT("renewal session [%s]"), *_sessionToken);
 }
@@ -300,7 +371,7 @@ void UClientNet::OnFRAMEWORKMSG_REPAIR_SESSION_ACK(TSharedPacket packet)
 {
 	if (_security->DecryptPacket(packet) == false) {
 		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SECURITY_ERROR);
-		_contentMsgQueue.Enqueue(nfy);
+		_contentMsgQueue.Add(nfy);
 		return;
 	}
 	
@@ -308,7 +379,7 @@ void UClientNet::OnFRAMEWORKMSG_REPAIR_SESSION_ACK(TSharedPacket packet)
 	if (error != RESULT_SUCCEEDED) {
 		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_REPAIR_SESSION);
 		*nfy << error;
-		_contentMsgQueue.Enqueue(nfy);
+		_contentMsgQueue.Add(nfy);
 		return;
 	}
 
@@ -316,34 +387,83 @@ void UClientNet::OnFRAMEWORKMSG_REPAIR_SESSION_ACK(TSharedPacket packet)
 	*packet >> _signinToken;
 	*packet >> _sessionToken;
 
+	// a full resync follows, both sides number and keep delta baselines from the repaired session on
+	_resume.Reset((_capabilities & FRAMEWORK_CAPABILITY_RESUME) != 0);
+	_snapshotBaselines.Clear();
+
 	ScheduleSessionTokenRenewal();
 
 	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_REPAIR_SESSION);
 	*nfy << error;
 	*nfy << type;
 	nfy->WriteBytes(packet->GetRdBuffer(), packet->GetRemainBytesToRead());
-	_contentMsgQueue.Enqueue(nfy);
+	_contentMsgQueue.Add(nfy);
 
 	_sessionEstablished = true;
 }
 
+void UClientNet::OnFRAMEWORKMSG_RESUME_SESSION_ACK(TSharedPacket packet)
+{
+	MsgSchema::FRAMEWORKMSG_RESUME_SESSION_ACK_Body ack;
+	TArray<TSharedPacket> replay;
+	bool resumed = packet->ReadBody(ack) && ack.result == RESULT_SUCCEEDED && _resume.CollectReplay(ack.received, replay);
+	if (resumed == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("session resume refused result[%u] received[%u] oldest[%u], repairing with a full resync"), ack.result, ack.received, _resume.GetOldest());
+		_resume.RecordResync();
+		Request_REPAIR_SESSION();
+		return;
+	}
+
+	_sessionEstablished = true;
+	ScheduleSessionTokenRenewal();
+
+	// the server replays its tail on its own, ours goes out ahead of anything the content sends from now on
+	for (const TSharedPacket& sending : replay) {
+		PostPacket(sending);
+	}
+	_resume.Acknowledge(ack.received);
+	_resume.RecordResumed(replay);
+
+	UE_LOG(LogClientNet, Verbose, TEXT("session resumed sent[%u] received[%u] replayed[%d]"), _resume.GetSent(), _resume.GetReceived(), replay.Num());
+
+	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_RESUME_SESSION);
+	*nfy << (uint32)replay.Num();
+	_contentMsgQueue.Add(nfy);
+}
+
+void UClientNet::OnFRAMEWORKMSG_SEQUENCE_ACK(TSharedPacket packet)
+{
+	MsgSchema::FRAMEWORKMSG_SEQUENCE_ACK_Body ack;
+	if (packet->ReadBody(ack) == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("malformed FRAMEWORKMSG_SEQUENCE_ACK size[%u]"), packet->GetBodySize());
+		return;
+	}
+
+	_resume.Acknowledge(ack.received);
+}
+
 void UClientNet::OnFRAMEWORKMSG_HANDOVER_ACK(TSharedPacket packet)
 {
-	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_HANDOVER);
-	nfy->WriteBytes(packet->GetRdBuffer(), packet->GetRemainBytesToRead());
-	_contentMsgQueue.Enqueue(nfy);
+	// the whole body goes to the content as it is, the packet is handed over instead of copied
+	packet->Retag(CLIENTNETMSG_INTERNAL_HANDOVER);
+	_contentMsgQueue.Add(MoveTemp(packet));
 }
 
 void UClientNet::OnFRAMEWORKMSG_SECURITY_EXCHANGE_ACK(TSharedPacket packet)
 {
 	if (_security->LoadSecurityExchangeContext(packet) == false) {
 		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SECURITY_ERROR);
-		_contentMsgQueue.Enqueue(nfy);
+		_contentMsgQueue.Add(nfy);
 		return;
 	}
 
+	// a resume replays only what the drop cut off, the repair makes the content resync everything
 	if (_sessionToken.IsEmpty() == false) {
-		Request_REPAIR_SESSION();
+		if (_resume.IsEnabled() && (_capabilities & FRAMEWORK_CAPABILITY_RESUME) != 0) {
+			Request_RESUME_SESSION();
+		} else {
+			Request_REPAIR_SESSION();
+		}
 		return;
 	}
 
@@ -355,7 +475,7 @@ void UClientNet::OnFRAMEWORKMSG_SECURITY_ERROR(TSharedPacket)
 	UE_LOG(LogClientNet, Warning, TEXT("OnFRAMEWORKMSG_SECURITY_ERROR"));
 
 	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SECURITY_ERROR);
-	_contentMsgQueue.Enqueue(nfy);
+	_contentMsgQueue.Add(nfy);
 }
 
 void UClientNet::OnFRAMEWORKMSG_CONTENT_SERVICE_SHUTDOWN(TSharedPacket)
@@ -363,13 +483,20 @@ void UClientNet::OnFRAMEWORKMSG_CONTENT_SERVICE_SHUTDOWN(TSharedPacket)
 	UE_LOG(LogClientNet, Warning, TEXT("OnFRAMEWORKMSG_CONTENT_SERVICE_SHUTDOWN"));
 
 	TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_CONTENT_SERVICE_SHUTDOWN);
-	_contentMsgQueue.Enqueue(nfy);
+	_contentMsgQueue.Add(nfy);
 }
 
 void UClientNet::Request_SETUP_CORD()
 {
-	TSharedPacket req = AllocPacket(FRAMEWORKMSG_SETUP_CORD);
-	*req << "AnuClient";
+	_offeredCapabilities = FPacketCompression::GetOfferedCapabilities() | FPacketFragmentation::GetOfferedCapabilities() | FSessionResume::GetOfferedCapabilities();
+	// delta baselines survive a resumed connection, sign in, repair and discontinue drop them
+	_capabilities = 0;
+
+	MsgSchema::FRAMEWORKMSG_SETUP_CORD_Body body;
+	body.clientName = "AnuClient";
+	body.capabilities = _offeredCapabilities;
+
+	TSharedPacket req = AllocPacket(body);
 	SendPacket(req, true);
 }
 
@@ -381,32 +508,28 @@ void UClientNet::Request_WORLD_LIST()
 	SendPacket(req);
 
 	TSharedPacket noti = AllocPacket(CLIENTNETMSG_INTERNAL_WORLD_LIST_REQUESTED);
-	_receivedQueue.Enqueue(noti);
+	PostReceived(noti);
 }
 
 void UClientNet::Request_LOGIN()
 {
-	TSharedPacket req = AllocPacket(FRAMEWORKMSG_SIGN_IN_REQ);
-	{
-		std::string platform_id = TCHAR_TO_UTF8(*_accountInfo->_platform_id);
-		*req << platform_id << _accountInfo->_platform_code;
-	}
-	{
-		std::string market{ TCHAR_TO_UTF8(*_accountInfo->_market) };
-		std::string os{ TCHAR_TO_UTF8(*_accountInfo->_os) };
-		std::string os_version{ TCHAR_TO_UTF8(*_accountInfo->_os_version) };
-		std::string device_model{ TCHAR_TO_UTF8(*_accountInfo->_device_model) };
-
-		std::string country{ TCHAR_TO_UTF8(*_accountInfo->_country) };
-		std::string lang{ TCHAR_TO_UTF8(*_accountInfo->_language) };
-		std::string accessToken{ TCHAR_TO_UTF8(*_accountInfo->_gamebaseAccessToken) };
-
-		*req << market << os << os_version << device_model << country << lang << _accountInfo->_timeZone << accessToken;
-	}
+	MsgSchema::FRAMEWORKMSG_SIGN_IN_REQ_Body body;
+	body.platformID = TCHAR_TO_UTF8(*_accountInfo->_platform_id);
+	body.platformCode = _accountInfo->_platform_code;
+	body.market = TCHAR_TO_UTF8(*_accountInfo->_market);
+	body.os = TCHAR_TO_UTF8(*_accountInfo->_os);
+	body.osVersion = TCHAR_TO_UTF8(*_accountInfo->_os_version);
+	body.deviceModel = TCHAR_TO_UTF8(*_accountInfo->_device_model);
+	body.country = TCHAR_TO_UTF8(*_accountInfo->_country);
+	body.language = TCHAR_TO_UTF8(*_accountInfo->_language);
+	body.timeZone = _accountInfo->_timeZone;
+	body.accessToken = TCHAR_TO_UTF8(*_accountInfo->_gamebaseAccessToken);
+
+	TSharedPacket req = AllocPacket(body);
 
 	if (_security->EncryptPacket(req) == false) {
 		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SECURITY_ERROR);
-		_contentMsgQueue.Enqueue(nfy);
+		_contentMsgQueue.Add(nfy);
 		return;
 	}
 
@@ -415,12 +538,14 @@ void UClientNet::Request_LOGIN()
 
 void UClientNet::Request_RENEWAL_SESSION()
 {
-	TSharedPacket req = AllocPacket(FRAMEWORKMSG_RENEWAL_SESSION_REQ);
-	*req << _sessionToken;
+	MsgSchema::FRAMEWORKMSG_RENEWAL_SESSION_REQ_Body body;
+	body.sessionToken = TCHAR_TO_UTF8(*_sessionToken);
+
+	TSharedPacket req = AllocPacket(body);
 
 	if (_security->EncryptPacket(req) == false) {
 		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SECURITY_ERROR);
-		_contentMsgQueue.Enqueue(nfy);
+		_contentMsgQueue.Add(nfy);
 		return;
 	}
 
@@ -429,12 +554,37 @@ void UClientNet::Request_RENEWAL_SESSION()
 
 void UClientNet::Request_REPAIR_SESSION()
 {
-	TSharedPacket req = AllocPacket(FRAMEWORKMSG_REPAIR_SESSION_REQ);
-	*req << _sessionToken << _signinToken;
+	MsgSchema::FRAMEWORKMSG_REPAIR_SESSION_REQ_Body body;
+	body.sessionToken = TCHAR_TO_UTF8(*_sessionToken);
+	body.signinToken = TCHAR_TO_UTF8(*_signinToken);
+
+	TSharedPacket req = AllocPacket(body);
+
+	if (_security->EncryptPacket(req) == false) {
+		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SECURITY_ERROR);
+		_contentMsgQueue.Add(nfy);
+		return;
+	}
+
+	SendPacket(req, true);
+}
+
+void UClientNet::Request_RESUME_SESSION()
+{
+	MsgSchema::FRAMEWORKMSG_RESUME_SESSION_REQ_Body body;
+	body.sessionToken = TCHAR_TO_UTF8(*_sessionToken);
+	body.signinToken = TCHAR_TO_UTF8(*_signinToken);
+	body.received = _resume.GetReceived();
+	body.sent = _resume.GetSent();
+	body.oldest = _resume.GetOldest();
+
+	UE_LOG(LogClientNet, Verbose, TEXT("resume session sent[%u] received[%u] oldest[%u]"), body.sent, body.received, body.oldest);
+
+	TSharedPacket req = AllocPacket(body);
 
 	if (_security->EncryptPacket(req) == false) {
 		TSharedPacket nfy = AllocPacket(CLIENTNETMSG_INTERNAL_SECURITY_ERROR);
-		_contentMsgQueue.Enqueue(nfy);
+		_contentMsgQueue.Add(nfy);
 		return;
 	}
 
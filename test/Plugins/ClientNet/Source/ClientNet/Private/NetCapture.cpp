@@ -0,0 +1,193 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "NetCapture.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#include "ClientNet.h"
+
+TAutoConsoleVariable<int32> CVar_ClientNetCaptureFlushBytes(TEXT("ClientNet.Capture.FlushBytes"), 256 * 1024, TEXT("captured bytes gathered in memory before they are written out"));
+
+static FAutoConsoleCommand CCmd_ClientNetCapture(
+	TEXT("ClientNet.Capture"),
+	TEXT("ClientNet.Capture [start [path]|stop], records every frame of the client sessions with its timestamp"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+		FString command = args.Num() > 0 ? args[0].ToLower() : TEXT("start");
+		if (command == TEXT("stop")) {
+			FNetCapture::Get().Stop();
+		} else {
+			FNetCapture::Get().Start(args.Num() > 1 ? args[1] : FString());
+		}
+	}));
+
+static FAutoConsoleCommandWithWorldAndArgs CCmd_ClientNetReplay(
+	TEXT("ClientNet.Replay"),
+	TEXT("ClientNet.Replay <path> [realtime] | stop, feeds the received frames of a capture through the handlers, as fast as possible unless realtime"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& args, UWorld* world) {
+		UGameInstance* gameInstance = world ? world->GetGameInstance() : nullptr;
+		UClientNet* clientNet = gameInstance ? gameInstance->GetSubsystem<UClientNet>() : nullptr;
+		if (clientNet == nullptr || args.Num() == 0) {
+			return;
+		}
+
+		if (args[0].Equals(TEXT("stop"), ESearchCase::IgnoreCase)) {
+			clientNet->StopReplay();
+		} else {
+			clientNet->StartReplay(args[0], args.Num() > 1 && args[1].Equals(TEXT("realtime"), ESearchCase::IgnoreCase));
+		}
+	}));
+
+FNetCapture& FNetCapture::Get()
+{
+	// never destroyed, like the packet pool
+	static FNetCapture* capture = new FNetCapture();
+	return *capture;
+}
+
+bool FNetCapture::Start(const FString& path)
+{
+	FScopeLock lock(&_lock);
+	if (_file.IsValid()) {
+		UE_LOG(LogClientNet, Warning, TEXT("capture already running [%s]"), *_path);
+		return false;
+	}
+
+	_path = path.IsEmpty()
+		? FPaths::Combine(FPaths::ProfilingDir(), TEXT("ClientNet"), FString::Printf(TEXT("capture-%s.ncap"), *FDateTime::Now().ToString()))
+		: path;
+
+	IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+	platformFile.CreateDirectoryTree(*FPaths::GetPath(_path));
+
+	_file.Reset(platformFile.OpenWrite(*_path));
+	if (_file.IsValid() == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("failed to open capture [%s]"), *_path);
+		return false;
+	}
+
+	FNetCaptureFileHeader header;
+	header.secondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+	_file->Write((const uint8*)&header, sizeof(header));
+
+	_records = _bytes = 0;
+	_staging.Reset();
+	_capturing = true;
+
+	UE_LOG(LogClientNet, Display, TEXT("capture started [%s]"), *_path);
+	return true;
+}
+
+void FNetCapture::Stop()
+{
+	FScopeLock lock(&_lock);
+	if (_file.IsValid() == false) {
+		return;
+	}
+
+	_capturing = false;
+	FlushLocked();
+	_file.Reset();
+
+	UE_LOG(LogClientNet, Display, TEXT("capture stopped [%s] records[%llu] bytes[%llu]"), *_path, _records, _bytes);
+}
+
+void FNetCapture::Append(ENetCaptureDirection direction, int32 sessionID, uint64 cycles, const uint8* frame, uint32 frameSize)
+{
+	FNetCaptureRecordHeader record;
+	record.cycles = cycles;
+	record.sessionID = sessionID;
+	record.direction = direction;
+
+	FScopeLock lock(&_lock);
+	if (_file.IsValid() == false) {
+		return;
+	}
+
+	_staging.Append((const uint8*)&record, sizeof(record));
+	_staging.Append(frame, frameSize);
+	++_records;
+
+	if (_staging.Num() >= CVar_ClientNetCaptureFlushBytes.GetValueOnAnyThread()) {
+		FlushLocked();
+	}
+}
+
+void FNetCapture::FlushLocked()
+{
+	if (_staging.Num() == 0) {
+		return;
+	}
+
+	if (_file->Write(_staging.GetData(), _staging.Num())) {
+		_bytes += _staging.Num();
+	} else {
+		UE_LOG(LogClientNet, Warning, TEXT("capture write failed [%s], capture stopped"), *_path);
+		_capturing = false;
+		_file.Reset();
+	}
+
+	_staging.Reset();
+}
+
+bool FNetCaptureReader::Open(const FString& path)
+{
+	Close();
+
+	_mapped.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*path));
+	if (_mapped.IsValid() == false || _mapped->GetFileSize() < (int64)sizeof(FNetCaptureFileHeader)) {
+		Close();
+		return false;
+	}
+
+	_region.Reset(_mapped->MapRegion(0, _mapped->GetFileSize()));
+	if (_region.IsValid() == false) {
+		Close();
+		return false;
+	}
+
+	_data = _region->GetMappedPtr();
+	_size = _region->GetMappedSize();
+
+	FNetCaptureFileHeader header;
+	::memcpy(&header, _data, sizeof(header));
+	if (header.magic != NET_CAPTURE_MAGIC || header.version != NET_CAPTURE_VERSION) {
+		Close();
+		return false;
+	}
+
+	_secondsPerCycle = header.secondsPerCycle;
+	Rewind();
+	return true;
+}
+
+void FNetCaptureReader::Close()
+{
+	_region.Reset();
+	_mapped.Reset();
+	_data = nullptr;
+	_size = _cursor = 0;
+}
+
+bool FNetCaptureReader::Next(FNetCaptureRecordHeader& record, const uint8*& frame, uint32& frameSize)
+{
+	int64 head = sizeof(FNetCaptureRecordHeader) + MSG_HEADER_SIZE;
+	if (_data == nullptr || _cursor + head > _size) {
+		return false;
+	}
+
+	::memcpy(&record, _data + _cursor, sizeof(record));
+	frame = _data + _cursor + sizeof(record);
+
+	uint16 bodySize = 0;
+	::memcpy(&bodySize, frame + MSG_OFFSET_SIZE, sizeof(uint16));
+	frameSize = MSG_HEADER_SIZE + bodySize;
+	if (_cursor + (int64)sizeof(record) + frameSize > _size) {
+		return false;
+	}
+
+	_cursor += sizeof(record) + frameSize;
+	return true;
+}
@@ -0,0 +1,52 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "NetClock.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+TAutoConsoleVariable<float> CVar_ClientNetClockProbeInterval(TEXT("ClientNet.Clock.ProbeInterval"), 10.f, TEXT("seconds between heartbeat probes once the clock estimate settled"));
+TAutoConsoleVariable<float> CVar_ClientNetClockFastProbeInterval(TEXT("ClientNet.Clock.FastProbeInterval"), 1.f, TEXT("seconds between heartbeat probes while the estimate settles or timing is latency sensitive"));
+
+int64 FNetClock::CyclesToMicros(uint64 cycles)
+{
+	return (int64)(FPlatformTime::ToSeconds64(cycles) * 1000000.0);
+}
+
+void FNetClock::Reset()
+{
+	_estimator.Reset();
+	_lastProbe = _nextProbe = 0.0;
+}
+
+void FNetClock::SetLatencySensitive(bool sensitive)
+{
+	_latencySensitive = sensitive;
+
+	// going fast takes effect right away instead of after the slow interval ran out
+	_nextProbe = FMath::Min(_nextProbe, _lastProbe + GetProbeInterval());
+}
+
+int64 FNetClock::OnProbeSent(double now)
+{
+	_lastProbe = now;
+	_nextProbe = now + GetProbeInterval();
+	return NowMicros();
+}
+
+bool FNetClock::OnProbeAnswered(int64 clientSent, int64 serverReceived, int64 serverSent, int64 receivedCycles)
+{
+	NetCore::ClockSample sample;
+	sample.clientSent = clientSent;
+	sample.serverReceived = serverReceived;
+	sample.serverSent = serverSent;
+	sample.clientReceived = CyclesToMicros((uint64)receivedCycles);
+	return _estimator.AddSample(sample);
+}
+
+double FNetClock::GetProbeInterval() const
+{
+	if (_latencySensitive || _estimator.IsSettled() == false) {
+		return FMath::Max(CVar_ClientNetClockFastProbeInterval.GetValueOnAnyThread(), 0.1f);
+	}
+	return FMath::Max(CVar_ClientNetClockProbeInterval.GetValueOnAnyThread(), 0.1f);
+}
@@ -0,0 +1,449 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "NetConnect.h"
+#include "NetPoller.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+
+#include "ClientNet.h"
+
+TAutoConsoleVariable<float> CVar_ClientNetConnectDnsTTL(TEXT("ClientNet.Connect.DnsTTL"), 60.f, TEXT("seconds a resolved host is reused, 0 resolves on every connect"));
+TAutoConsoleVariable<float> CVar_ClientNetConnectAttemptDelay(TEXT("ClientNet.Connect.AttemptDelay"), 0.25f, TEXT("seconds before the next address is tried while the previous attempt is still pending"));
+TAutoConsoleVariable<float> CVar_ClientNetConnectAttemptTimeout(TEXT("ClientNet.Connect.AttemptTimeout"), 5.f, TEXT("seconds one address may take to connect"));
+TAutoConsoleVariable<float> CVar_ClientNetConnectBackoffBase(TEXT("ClientNet.Connect.BackoffBase"), 0.5f, TEXT("seconds before the first retry of a failed connection, doubled per retry"));
+TAutoConsoleVariable<float> CVar_ClientNetConnectBackoffMax(TEXT("ClientNet.Connect.BackoffMax"), 15.f, TEXT("upper bound of the retry delay in seconds"));
+TAutoConsoleVariable<float> CVar_ClientNetConnectDnsTimeout(TEXT("ClientNet.Connect.DnsTimeout"), 5.f, TEXT("seconds a connect waits for its lookup before it retries, the lookup itself goes on and fills the cache"));
+TAutoConsoleVariable<int32> CVar_ClientNetConnectRetries(TEXT("ClientNet.Connect.Retries"), 6, TEXT("tries of a connection, each resolving and racing all addresses, before it is retired"));
+
+static FAutoConsoleCommand CCmd_ClientNetConnect(
+	TEXT("ClientNet.Connect"),
+	TEXT("ClientNet.Connect [stats|reset|flushdns], resolution and connect latencies of the client network"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+		FString command = args.Num() > 0 ? args[0].ToLower() : TEXT("stats");
+		if (command == TEXT("reset")) {
+			FNetConnectTelemetry::Get().Reset();
+		} else if (command == TEXT("flushdns")) {
+			FNetResolver::Get().Flush();
+		} else {
+			UE_LOG(LogClientNet, Display, TEXT("%s"), *FNetConnectTelemetry::Get().GetStats().ToString());
+		}
+	}));
+
+namespace
+{
+	// RFC 8305 ordering, families alternate starting with the one the resolver preferred
+	TArray<TSharedRef<FInternetAddr>> InterleaveFamilies(const FAddressInfoResult& result)
+	{
+		TArray<TSharedRef<FInternetAddr>> preferred;
+		TArray<TSharedRef<FInternetAddr>> others;
+		TSet<FString> seen;
+
+		FName first = NAME_None;
+		for (const FAddressInfoResultData& data : result.Results) {
+			bool duplicated = false;
+			seen.Add(data.Address->ToString(false), &duplicated);
+			if (duplicated) {
+				continue;
+			}
+
+			FName family = data.Address->GetProtocolType();
+			if (first.IsNone()) {
+				first = family;
+			}
+			(family == first ? preferred : others).Add(data.Address);
+		}
+
+		TArray<TSharedRef<FInternetAddr>> ordered;
+		ordered.Reserve(preferred.Num() + others.Num());
+		for (int32 i = 0; i < FMath::Max(preferred.Num(), others.Num()); ++i) {
+			if (i < preferred.Num()) {
+				ordered.Add(preferred[i]);
+			}
+			if (i < others.Num()) {
+				ordered.Add(others[i]);
+			}
+		}
+		return ordered;
+	}
+
+	FString HistogramToString(const uint64 (&histogram)[NET_CONNECT_HISTOGRAM_BUCKETS])
+	{
+		FString text;
+		for (int32 bucket = 0; bucket < NET_CONNECT_HISTOGRAM_BUCKETS; ++bucket) {
+			if (histogram[bucket] == 0) {
+				continue;
+			}
+
+			if (text.IsEmpty() == false) {
+				text += TEXT(" ");
+			}
+			if (bucket == NET_CONNECT_HISTOGRAM_BUCKETS - 1) {
+				text += FString::Printf(TEXT(">=%u:%llu"), 1u << (bucket - 1), histogram[bucket]);
+			} else {
+				text += FString::Printf(TEXT("<%u:%llu"), 1u << bucket, histogram[bucket]);
+			}
+		}
+		return text;
+	}
+}
+
+FNetResolver& FNetResolver::Get()
+{
+	// never destroyed, lookups still in flight call back into it
+	static FNetResolver* resolver = new FNetResolver();
+	return *resolver;
+}
+
+void FNetResolver::Resolve(const FString& host, FOnResolved&& callback)
+{
+	FNetResolveResult result;
+	ISocketSubsystem* subsystem = UClientNet::_socketSubsystem;
+	if (subsystem == nullptr || host.IsEmpty()) {
+		callback(result);
+		return;
+	}
+
+	// a literal address is parsed, not resolved
+	TSharedPtr<FInternetAddr> literal = subsystem->GetAddressFromString(host);
+	if (literal.IsValid() && literal->IsValid()) {
+		result.addresses.Add(literal.ToSharedRef());
+		result.cached = true;
+		callback(result);
+		return;
+	}
+
+	FString key = host.ToLower();
+	double now = FPlatformTime::Seconds();
+	{
+		FScopeLock lock(&_lock);
+		if (FEntry* entry = _cache.Find(key)) {
+			if (entry->expires > now) {
+				result.addresses = entry->addresses;
+				result.cached = true;
+			} else {
+				_cache.Remove(key);
+			}
+		}
+
+		if (result.cached == false) {
+			// a second connect to the same host waits for the lookup already running
+			if (TArray<FOnResolved>* waiters = _inFlight.Find(key)) {
+				waiters->Add(MoveTemp(callback));
+				return;
+			}
+			_inFlight.Add(key).Add(MoveTemp(callback));
+		}
+	}
+
+	if (result.cached) {
+		FNetConnectTelemetry::Get().RecordResolve(0.0, true, false);
+		callback(result);
+		return;
+	}
+
+	subsystem->GetAddressInfoAsync([this, key, now](FAddressInfoResult info) {
+		OnResolved(key, InterleaveFamilies(info), now);
+	}, *host, nullptr, EAddressInfoFlags::Default, NAME_None, ESocketType::SOCKTYPE_Streaming);
+}
+
+void FNetResolver::OnResolved(const FString& key, TArray<TSharedRef<FInternetAddr>>&& addresses, double started)
+{
+	double now = FPlatformTime::Seconds();
+	float ttl = CVar_ClientNetConnectDnsTTL.GetValueOnAnyThread();
+
+	TArray<FOnResolved> waiters;
+	{
+		FScopeLock lock(&_lock);
+		// failures are not cached, the backoff of the caller already spaces the retries
+		if (addresses.Num() > 0 && ttl > 0.f) {
+			FEntry& entry = _cache.FindOrAdd(key);
+			entry.addresses = addresses;
+			entry.expires = now + ttl;
+		}
+		_inFlight.RemoveAndCopyValue(key, waiters);
+	}
+
+	FNetConnectTelemetry::Get().RecordResolve(now - started, false, addresses.Num() == 0);
+	if (addresses.Num() == 0) {
+		UE_LOG(LogClientNet, Warning, TEXT("failed to resolve host[%s] in %.3f sec"), *key, now - started);
+	}
+
+	FNetResolveResult result;
+	result.addresses = MoveTemp(addresses);
+	for (FOnResolved& waiter : waiters) {
+		waiter(result);
+	}
+}
+
+void FNetResolver::Flush()
+{
+	FScopeLock lock(&_lock);
+	_cache.Empty();
+}
+
+void FNetConnectDriver::FResolveSlot::Abandon()
+{
+	FScopeLock scope(&lock);
+	abandoned = true;
+	poller = nullptr;
+}
+
+FNetConnectDriver::FNetConnectDriver(FNetPoller* poller, FOnCompleted&& onCompleted)
+	: _driver(_transport)
+{
+	_transport.poller = poller;
+	_transport.onCompleted = MoveTemp(onCompleted);
+}
+
+FNetConnectDriver::~FNetConnectDriver()
+{
+	_driver.CancelAll();
+}
+
+void FNetConnectDriver::Start(const TSharedPtr<FConnector>& connector, float timeout, double now)
+{
+	int32 sessionID = connector->sessionID;
+
+	FTransport::Context context;
+	context.connector = connector;
+	if (_driver.Start(sessionID, MoveTemp(context), timeout, now) == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("session_id[%d] is already connecting"), sessionID);
+		return;
+	}
+
+	UE_LOG(LogClientNet, Verbose, TEXT("connecting started session_id[%d]"), sessionID);
+}
+
+NetCore::ConnectSettings FNetConnectDriver::FTransport::GetSettings()
+{
+	NetCore::ConnectSettings settings;
+	settings.attemptDelay = CVar_ClientNetConnectAttemptDelay.GetValueOnAnyThread();
+	settings.attemptTimeout = CVar_ClientNetConnectAttemptTimeout.GetValueOnAnyThread();
+	settings.backoffBase = CVar_ClientNetConnectBackoffBase.GetValueOnAnyThread();
+	settings.backoffMax = CVar_ClientNetConnectBackoffMax.GetValueOnAnyThread();
+	settings.resolveTimeout = CVar_ClientNetConnectDnsTimeout.GetValueOnAnyThread();
+	settings.retries = CVar_ClientNetConnectRetries.GetValueOnAnyThread();
+	return settings;
+}
+
+double FNetConnectDriver::FTransport::Random()
+{
+	return FMath::FRand();
+}
+
+bool FNetConnectDriver::FTransport::Open(const Address& address, Socket& socket)
+{
+	socket = FSession::CreateSocket(address->GetProtocolType());
+	if (socket == nullptr) {
+		return false;
+	}
+
+	UE_LOG(LogClientNet, Verbose, TEXT("trying to connect [%s]"), *address->ToString(true));
+
+	// a non blocking connect reports would block while the handshake is on its way
+	if (socket->Connect(*address) == false) {
+		ESocketErrors error = UClientNet::_socketSubsystem->GetLastErrorCode();
+		if (error != SE_EWOULDBLOCK && error != SE_EINPROGRESS) {
+			UE_LOG(LogClientNet, Verbose, TEXT("connect to [%s] failed error[%d]"), *address->ToString(true), (int32)error);
+			socket->Close();
+			UClientNet::_socketSubsystem->DestroySocket(socket);
+			socket = nullptr;
+			return false;
+		}
+	}
+
+	if (poller) {
+		poller->RegisterConnect(socket);
+	}
+	return true;
+}
+
+NetCore::AttemptState FNetConnectDriver::FTransport::Check(Socket& socket)
+{
+	// writable means the handshake ended, only a connected socket has a peer
+	if (socket->Wait(ESocketWaitConditions::WaitForWrite, FTimespan::Zero())) {
+		TSharedRef<FInternetAddr> peer = UClientNet::_socketSubsystem->CreateInternetAddr();
+		if (socket->GetPeerAddress(*peer)) {
+			return NetCore::AttemptState::Connected;
+		}
+	}
+
+	return socket->GetConnectionState() == SCS_ConnectionError ? NetCore::AttemptState::Failed : NetCore::AttemptState::Pending;
+}
+
+void FNetConnectDriver::FTransport::Close(Socket& socket)
+{
+	if (poller) {
+		poller->Unregister(socket);
+	}
+	socket->Close();
+	UClientNet::_socketSubsystem->DestroySocket(socket);
+	socket = nullptr;
+}
+
+void FNetConnectDriver::FTransport::OnAttempt(const Address& address, double seconds, NetCore::AttemptState ended)
+{
+	if (ended != NetCore::AttemptState::Connected && seconds > 0.0) {
+		UE_LOG(LogClientNet, Verbose, TEXT("connect to [%s] %s after %.3f sec"), *address->ToString(true), ended == NetCore::AttemptState::Failed ? TEXT("failed") : TEXT("timed out"), seconds);
+	}
+	FNetConnectTelemetry::Get().RecordAttempt(seconds, ended == NetCore::AttemptState::Connected);
+}
+
+void FNetConnectDriver::FTransport::BeginResolve(Context& context)
+{
+	FConnector& connector = *context.connector;
+	connector.session->Create(connector.addr, connector.port);
+
+	context.resolving = MakeShared<FResolveSlot, ESPMode::ThreadSafe>();
+	context.resolving->poller = poller;
+
+	// the callback may run right away on a cache hit, or later on the resolver thread
+	FNetResolver::Get().Resolve(connector.addr, [slot = context.resolving](const FNetResolveResult& result) {
+		FScopeLock lock(&slot->lock);
+		if (slot->abandoned) {
+			return;
+		}
+
+		slot->result = result;
+		slot->ready = true;
+		if (slot->poller) {
+			slot->poller->Wakeup();
+		}
+	});
+}
+
+bool FNetConnectDriver::FTransport::TakeResolved(Context& context, std::vector<Address>& addresses)
+{
+	FNetResolveResult resolved;
+	{
+		FScopeLock lock(&context.resolving->lock);
+		if (context.resolving->ready == false) {
+			return false;
+		}
+		resolved = MoveTemp(context.resolving->result);
+	}
+	context.resolving.Reset();
+
+	addresses.reserve(resolved.addresses.Num());
+	for (const TSharedRef<FInternetAddr>& address : resolved.addresses) {
+		TSharedRef<FInternetAddr> target = address->Clone();
+		target->SetPort(context.connector->port);
+		addresses.push_back(target);
+	}
+	return true;
+}
+
+void FNetConnectDriver::FTransport::AbandonResolve(Context& context)
+{
+	if (context.resolving.IsValid()) {
+		context.resolving->Abandon();
+		context.resolving.Reset();
+	}
+}
+
+void FNetConnectDriver::FTransport::OnTryFailed(Context& context, NetCore::TryFailure failure, double retryIn)
+{
+	int32 sessionID = context.connector->sessionID;
+	if (failure == NetCore::TryFailure::ResolveTimedOut) {
+		UE_LOG(LogClientNet, Warning, TEXT("resolving host[%s] timed out session_id[%d]"), *context.connector->addr, sessionID);
+	} else if (failure == NetCore::TryFailure::ResolveFailed) {
+		UE_LOG(LogClientNet, Error, TEXT("failed to resolve host[%s] session_id[%d]"), *context.connector->addr, sessionID);
+	}
+
+	if (retryIn >= 0.0) {
+		UE_LOG(LogClientNet, Warning, TEXT("failed to connect session_id[%d].. retry in %.2f sec"), sessionID, retryIn);
+	}
+}
+
+void FNetConnectDriver::FTransport::OnCompleted(Context& context, NetCore::ConnectOutcome outcome, Socket* socket, const Address* address, double seconds)
+{
+	TSharedPtr<FSession> session = context.connector->session;
+	ConnectResult result = outcome == NetCore::ConnectOutcome::TimedOut ? ConnectResult::Timeout : ConnectResult::Retired;
+	if (outcome == NetCore::ConnectOutcome::Connected) {
+		// the session registers it for readability
+		if (poller) {
+			poller->Unregister(*socket);
+		}
+		session->Attach(*socket, *address);
+		result = ConnectResult::Success;
+
+		UE_LOG(LogClientNet, Verbose, TEXT("connected to [%s] session_id[%d] in %.3f sec"), *(*address)->ToString(true), session->GetSessionID(), seconds);
+	}
+
+	FNetConnectTelemetry::Get().RecordCompleted(seconds, result == ConnectResult::Success);
+	onCompleted(session, result);
+}
+
+FNetConnectTelemetry& FNetConnectTelemetry::Get()
+{
+	// never destroyed, like the packet pool
+	static FNetConnectTelemetry* telemetry = new FNetConnectTelemetry();
+	return *telemetry;
+}
+
+void FNetConnectTelemetry::AddToHistogram(uint64 (&histogram)[NET_CONNECT_HISTOGRAM_BUCKETS], double seconds)
+{
+	uint32 msec = (uint32)FMath::Clamp(seconds * 1000.0, 0.0, (double)MAX_uint32);
+	int32 bucket = msec == 0 ? 0 : (int32)FMath::FloorLog2(msec) + 1;
+	++histogram[FMath::Min(bucket, NET_CONNECT_HISTOGRAM_BUCKETS - 1)];
+}
+
+void FNetConnectTelemetry::RecordResolve(double seconds, bool cached, bool failed)
+{
+	FScopeLock lock(&_lock);
+	++_stats.resolves;
+	if (cached) {
+		++_stats.resolveCacheHits;
+		return;
+	}
+
+	if (failed) {
+		++_stats.resolveFailures;
+	}
+	AddToHistogram(_stats.resolveHistogram, seconds);
+}
+
+void FNetConnectTelemetry::RecordAttempt(double seconds, bool connected)
+{
+	FScopeLock lock(&_lock);
+	++_stats.attempts;
+	if (connected) {
+		AddToHistogram(_stats.connectHistogram, seconds);
+	} else {
+		++_stats.attemptFailures;
+	}
+}
+
+void FNetConnectTelemetry::RecordCompleted(double seconds, bool connected)
+{
+	FScopeLock lock(&_lock);
+	if (connected) {
+		++_stats.connects;
+		AddToHistogram(_stats.totalHistogram, seconds);
+	} else {
+		++_stats.retires;
+	}
+}
+
+FNetConnectStats FNetConnectTelemetry::GetStats() const
+{
+	FScopeLock lock(&_lock);
+	return _stats;
+}
+
+void FNetConnectTelemetry::Reset()
+{
+	FScopeLock lock(&_lock);
+	_stats = FNetConnectStats();
+}
+
+FString FNetConnectStats::ToString() const
+{
+	return FString::Printf(TEXT("resolves[%llu] cache hits[%llu] resolve failures[%llu] attempts[%llu] attempt failures[%llu] connects[%llu] retires[%llu] resolve msec[%s] connect msec[%s] total msec[%s]"),
+		resolves, resolveCacheHits, resolveFailures, attempts, attemptFailures, connects, retires,
+		*HistogramToString(resolveHistogram), *HistogramToString(connectHistogram), *HistogramToString(totalHistogram));
+}
@@ -0,0 +1,23 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+// the protocol core sources (server/source/netcore/src) are compiled into the plugin here,
+// the standalone CMake target builds the same files with NETCORE_STANDALONE.
+// the plugin headers include the core headers (netcore/include) and wrap them in engine types, the tests and
+// benchmarks of the core run with the standalone target, see its CMakeLists.txt
+
+#include "CoreMinimal.h"
+
+#define UI UI_ST
+THIRD_PARTY_INCLUDES_START
+#include <openssl/evp.h>
+THIRD_PARTY_INCLUDES_END
+#undef UI
+
+#include "src/netcore_ring.cpp"
+#include "src/netcore_snapshot.cpp"
+#include "src/netcore_cipher.cpp"
+#include "src/netcore_clock.cpp"
+
+#if PLATFORM_LINUX || PLATFORM_ANDROID
+#include "src/netcore_poller.cpp"
+#endif
@@ -3,6 +3,8 @@
 #include "NetPacket.h"
 #include "GenericPlatform/GenericPlatformFile.h"
 
+bool FNetPacket::bEstimateCompactSavings = false;
+
 FNetPacket::FNetPacket()
 {
 	_buffer.resize(MAX_MSGBUF_SIZE, 0);
@@ -14,16 +16,24 @@ FNetPacket::FNetPacket(uint16 id)
 	SetMsgID(id);
 }
 
+FNetPacket::FNetPacket(uint16 id, size_t capacity)
+{
+	Recycle(capacity);
+	SetRdPos(0);
+	SetWrPos(0);
+	SetMsgID(id);
+}
+
 FNetPacket::~FNetPacket()
 {
 	_buffer.clear();
 }
 
-void FNetPacket::Resize(uint16 size)
+void FNetPacket::Resize(uint32 size)
 {
 	size += MSG_HEADER_SIZE;
 
-	uint16 block = (size / MAX_MSGBUF_SIZE) + 1;
+	uint32 block = (size / MAX_MSGBUF_SIZE) + 1;
 	size = MAX_MSGBUF_SIZE * block;
 
 	_buffer.resize(size);
@@ -31,6 +41,7 @@ void FNetPacket::Resize(uint16 size)
 
 void FNetPacket::WriteBuff(IFileHandle* fileHandle)
 {
+	FinalizeHeader();
 	fileHandle->Write(&_buffer.at(0), GetWrPos());
 }
 
@@ -40,7 +51,7 @@ bool FNetPacket::ReadBuff(IFileHandle* fileHandle)
 		return false;
 	}
 
-	uint16 bodySize{ GetBodySize() };
+	uint32 bodySize{ GetBodySize() };
 	if (bodySize == 0) {
 		return true;
 	}
@@ -50,7 +61,7 @@ bool FNetPacket::ReadBuff(IFileHandle* fileHandle)
 	return fileHandle->Read(&_buffer.at(MSG_HEADER_SIZE), bodySize);
 }
 
-bool FNetPacket::SetRdPos(uint16 pos)
+bool FNetPacket::SetRdPos(uint32 pos)
 {
 	if (MSG_HEADER_SIZE + pos > GetCapacity()) {
 		return false;
@@ -60,7 +71,7 @@ bool FNetPacket::SetRdPos(uint16 pos)
 	return true;
 }
 
-bool FNetPacket::SetWrPos(uint16 pos)
+bool FNetPacket::SetWrPos(uint32 pos)
 {
 	if (MSG_HEADER_SIZE + pos > GetCapacity()) {
 		return false;
@@ -73,6 +84,7 @@ bool FNetPacket::SetWrPos(uint16 pos)
 void FNetPacket::Reset()
 {
 	_rdCur = _wrCur = MSG_HEADER_SIZE;
+	_compactSavings = 0;
 
 	_buffer.clear();
 	_buffer.resize(MAX_MSGBUF_SIZE, 0);
@@ -80,6 +92,29 @@ void FNetPacket::Reset()
 	ClearHeader();
 }
 
+void FNetPacket::Recycle(size_t capacity)
+{
+	// keeps the grown buffer, only the header has to be zeroed for reuse
+	if (_buffer.size() < capacity) {
+		_buffer.resize(capacity);
+	}
+
+	_rdCur = _wrCur = 0;
+	_sessionID = 0;
+	_timestamp = 0;
+	_compactSavings = 0;
+
+	ClearHeader();
+}
+
+void FNetPacket::SetCompact(bool compact)
+{
+	check(_wrCur <= MSG_HEADER_SIZE);
+
+	uint16 msgID = GetMsgID();
+	SetMsgID(compact ? (uint16)(msgID | MSG_FLAG_IDFIELD_COMPACT) : msgID);
+}
+
 void FNetPacket::SetDataSizeAtHeader(uint16 size)
 {
 	::memcpy(&_buffer.at(MSG_OFFSET_SIZE), (uint8*)&size, sizeof(uint16));
@@ -92,21 +127,21 @@ bool FNetPacket::IsReceivingPacketCompleted()
 	return (written >= MSG_HEADER_SIZE && written == GetPacketSize());
 }
 
-void FNetPacket::ReadBytesReverse(void* buf, uint16 size)
+void FNetPacket::ReadBytesReverse(void* buf, uint32 size)
 {
 	if (size > _wrCur) {
 		return;
 	}
 
-	_wrCur = (uint16)(_wrCur - size);
+	_wrCur = _wrCur - size;
 
 	uint8* src = GetWrBuffer();
 	::memcpy(buf, src, size);
 
-	SetDataSizeAtHeader(_wrCur - MSG_HEADER_SIZE);
+	FinalizeHeader();
 }
 
-void FNetPacket::ReadBytes(void* buf, uint16 size)
+void FNetPacket::ReadBytes(void* buf, uint32 size)
 {
 	if (size <= 0 || (_rdCur + size) > _wrCur) {
 		return;
@@ -115,54 +150,105 @@ void FNetPacket::ReadBytes(void* buf, uint16 size)
 	uint8* src = GetRdBuffer();
 	::memcpy(buf, src, size);
 
-	_rdCur = (uint16)(_rdCur + size);
+	_rdCur = _rdCur + size;
+}
+
+bool FNetPacket::WriteBytes(const void* buf, uint32 size)
+{
+	if (Reserve(size) == false) {
+		return false;
+	}
+
+	uint8* cur = GetWrBuffer();
+	::memcpy(cur, buf, size);
+
+	_wrCur = _wrCur + size;
+	return true;
 }
 
-void FNetPacket::WriteBytes(const void* buf, uint16 size)
+bool FNetPacket::Reserve(uint32 size)
 {
-	uint16 availableBufSize = GetAvailableBufSize();
+	uint32 availableBufSize = GetAvailableBufSize();
 
 	if (availableBufSize < size) {
-		uint16 chunkCount = (size - availableBufSize) / MAX_MSGBUF_SIZE + 1;
-		uint16 required = chunkCount * MAX_MSGBUF_SIZE;
-		size_t resizing = GetCapacity() + required;
+		size_t required = (size_t)_wrCur + size;
+		if (required > MAX_STREAMED_MSG_SIZE) {
+			ensureMsgf(false, TEXT("body of msg_id[%d] passes MAX_STREAMED_MSG_SIZE"), GetMsgID());
+			return false;
+		}
+
+		// frame sized bodies grow by blocks, streamed ones double so a large body is not copied per block
+		size_t resizing = GetCapacity() + ((size - availableBufSize) / MAX_MSGBUF_SIZE + 1) * MAX_MSGBUF_SIZE;
 		if (resizing > MAX_MESSIVE_BUF_SIZE) {
-			return;
+			resizing = FMath::Min<size_t>(FMath::Max(resizing, GetCapacity() * 2), MAX_STREAMED_MSG_SIZE);
 		}
 
 		_buffer.resize(resizing);
 	}
+	return true;
+}
 
-	uint8* cur = GetWrBuffer();
-	::memcpy(cur, buf, size);
+void FNetPacket::WriteString(const TCHAR* str, int32 len)
+{
+	int32 size = FNetString::Utf8Length(str, len);
+	if (size > MAX_uint16) {
+		ensureMsgf(false, TEXT("string of %d utf8 bytes does not fit the length prefix of msg_id[%d]"), size, GetMsgID());
+		size = len = 0;
+	}
+
+	*this << (uint16)size;
+	if (size == 0 || Reserve((uint32)size) == false) {
+		return;
+	}
+
+	FNetString::EncodeUtf8(str, len, GetWrBuffer(), size);
+	IncWrPos((uint32)size);
+}
 
-	_wrCur = (uint16)(_wrCur + size);
+void FNetPacket::ReadString(FString& str)
+{
+	uint16 size = 0;
+	TryRead(size);
+	size = (uint16)FMath::Min<uint32>(size, GetRemainBytesToRead());
+
+	FNetString::DecodeUtf8(_buffer.data() + _rdCur, size, str);
+	IncRdPos(size);
+}
+
+void FNetPacket::ReadString(FName& name)
+{
+	uint16 size = 0;
+	TryRead(size);
+	size = (uint16)FMath::Min<uint32>(size, GetRemainBytesToRead());
 
-	SetDataSizeAtHeader(_wrCur - MSG_HEADER_SIZE);
+	name = FNetString::DecodeName(_buffer.data() + _rdCur, size);
+	IncRdPos(size);
 }
 
 uint16 FNetPacket::CopyMsg(FNetPacket* src)
 {
 	uint8* srcBuffer = nullptr;
-	uint16 dataSizeToCopy = 0;
+	uint32 dataSizeToCopy = 0;
 
+	src->FinalizeHeader();
 	dataSizeToCopy = src->GetBodySize();
 	srcBuffer = src->GetBufferAt(MSG_HEADER_SIZE);
 	//src->ForceStopRead();
 
-	uint16 availableBufSize = GetAvailableBufSize();
+	uint32 availableBufSize = GetAvailableBufSize();
 	if (availableBufSize < dataSizeToCopy) {
-		uint16 bufferCount = dataSizeToCopy / MAX_MSGBUF_SIZE + 1;
+		uint32 bufferCount = dataSizeToCopy / MAX_MSGBUF_SIZE + 1;
 		if (GetCapacity() + bufferCount * MAX_MSGBUF_SIZE > MAX_MESSIVE_BUF_SIZE) {
 			return ERR_OUT_OF_MAX_SIZE;
 		}
 	}
 
 	WriteBytes(srcBuffer, dataSizeToCopy);
-	return dataSizeToCopy;
+	return (uint16)dataSizeToCopy;
 }
 
 void FNetPacket::RecordTimestamp()
 {
-	_timestamp = FDateTime::Now().ToUnixTimestamp();
+	// monotonic cycles, only ever compared against FPlatformTime::Cycles64()
+	_timestamp = (int64)FPlatformTime::Cycles64();
 }
@@ -0,0 +1,145 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "NetPoller.h"
+#include "Sockets.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+
+#include "ClientNet.h"
+
+#define CLIENTNET_EPOLL_POLLER (PLATFORM_LINUX || PLATFORM_ANDROID)
+
+#if CLIENTNET_EPOLL_POLLER
+#include "BSDSockets/SocketsBSD.h"
+
+#include "netcore_poller.h"
+
+#include <cerrno>
+#endif
+
+/////////////////////////////////////////////////////////////////////
+// event only, sockets are still polled by the pump
+/////////////////////////////////////////////////////////////////////
+
+class FNetPollerEvent : public FNetPoller
+{
+public:
+	FNetPollerEvent()
+	{
+		_event = FPlatformProcess::GetSynchEventFromPool(false);
+	}
+
+	virtual ~FNetPollerEvent()
+	{
+		FPlatformProcess::ReturnSynchEventToPool(_event);
+		_event = nullptr;
+	}
+
+	virtual bool Register(FSocket*) override { return false; }
+	virtual bool RegisterConnect(FSocket*) override { return false; }
+	virtual void Unregister(FSocket*) override {}
+	virtual bool SetInterest(FSocket*, bool, bool) override { return false; }
+
+	virtual void Wait(uint32 timeoutMsec) override
+	{
+		_event->Wait(timeoutMsec);
+	}
+
+	virtual void Wakeup() override
+	{
+		_event->Trigger();
+	}
+
+	virtual bool IsReadinessDriven() const override { return false; }
+
+private:
+	FEvent* _event = nullptr;
+};
+
+#if CLIENTNET_EPOLL_POLLER
+/////////////////////////////////////////////////////////////////////
+// epoll with an eventfd for wakeups
+/////////////////////////////////////////////////////////////////////
+
+class FNetPollerEpoll : public FNetPoller
+{
+public:
+	bool Init()
+	{
+		return _poller.Init();
+	}
+
+	virtual bool Register(FSocket* socket) override
+	{
+		return Watched(_poller.Register(GetDescriptor(socket)));
+	}
+
+	virtual bool RegisterConnect(FSocket* socket) override
+	{
+		return Watched(_poller.RegisterConnect(GetDescriptor(socket)));
+	}
+
+	virtual void Unregister(FSocket* socket) override
+	{
+		if (_poller.Unregister(GetDescriptor(socket)) == false && _unwatched > 0) {
+			--_unwatched;
+		}
+	}
+
+	virtual bool SetInterest(FSocket* socket, bool readable, bool writable) override
+	{
+		if (readable == false && writable == false) {
+			Unregister(socket);
+			return true;
+		}
+		return Watched(_poller.Update(GetDescriptor(socket), readable, writable));
+	}
+
+	virtual void Wait(uint32 timeoutMsec) override
+	{
+		_poller.Wait(timeoutMsec);
+	}
+
+	virtual void Wakeup() override
+	{
+		_poller.Wakeup();
+	}
+
+	virtual bool IsReadinessDriven() const override { return _unwatched == 0; }
+
+private:
+	bool Watched(bool watched)
+	{
+		if (watched == false) {
+			UE_LOG(LogClientNet, Warning, TEXT("failed to watch socket errno[%d], falling back to polling"), errno);
+			++_unwatched;
+		}
+		return watched;
+	}
+
+	static int32 GetDescriptor(FSocket* socket)
+	{
+		return (int32)static_cast<FSocketBSD*>(socket)->GetNativeSocket();
+	}
+
+private:
+	NetCore::EpollPoller _poller;
+	int32 _unwatched = 0;
+};
+#endif
+
+/////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////
+
+TUniquePtr<FNetPoller> FNetPoller::Create()
+{
+#if CLIENTNET_EPOLL_POLLER
+	TUniquePtr<FNetPollerEpoll> poller = MakeUnique<FNetPollerEpoll>();
+	if (poller->Init()) {
+		return poller;
+	}
+	UE_LOG(LogClientNet, Warning, TEXT("failed to create epoll poller errno[%d], falling back to event poller"), errno);
+#endif
+
+	return MakeUnique<FNetPollerEvent>();
+}
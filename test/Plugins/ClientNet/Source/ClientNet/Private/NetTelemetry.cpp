@@ -0,0 +1,314 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "NetTelemetry.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#include "ClientNet.h"
+
+#include "anu_msg_string.h"
+
+TAutoConsoleVariable<float> CVar_ClientNetTelemetryDumpInterval(TEXT("ClientNet.Telemetry.DumpInterval"), 0.f, TEXT("seconds between telemetry dumps into Saved/Profiling/ClientNet, 0 disables"));
+TAutoConsoleVariable<FString> CVar_ClientNetTelemetryDumpFormat(TEXT("ClientNet.Telemetry.DumpFormat"), TEXT("csv"), TEXT("format of the periodic telemetry dump, csv or json"));
+static FAutoConsoleVariableRef CVar_ClientNetTelemetryCompactEstimate(TEXT("ClientNet.Telemetry.CompactEstimate"), FNetPacket::bEstimateCompactSavings,
+	TEXT("count what compact encoding would save on fixed width bodies, reported as compact_saved_in/out"));
+
+static FAutoConsoleCommand CCmd_ClientNetTelemetry(
+	TEXT("ClientNet.Telemetry"),
+	TEXT("ClientNet.Telemetry [log|csv|json|reset], per message id counters of the client network"),
+	FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& args) {
+		FString command = args.Num() > 0 ? args[0].ToLower() : TEXT("log");
+		if (command == TEXT("reset")) {
+			FNetTelemetry::Get().Reset();
+		} else if (command == TEXT("csv") || command == TEXT("json")) {
+			FNetTelemetry::Get().Dump(command);
+		} else {
+			UE_LOG(LogClientNet, Display, TEXT("%s"), *FNetTelemetry::Get().ToCSV());
+		}
+	}));
+
+namespace
+{
+	double ToUsec(uint64 cycles)
+	{
+		return FPlatformTime::ToSeconds64(cycles) * 1000000.0;
+	}
+
+	FString GetOpcodeName(uint16 msgID)
+	{
+		if (const wchar_t* name = MsgHelper::FindProtocolName(msgID)) {
+			return WCHAR_TO_TCHAR(name);
+		}
+		return FString::Printf(TEXT("0x%04x"), msgID);
+	}
+}
+
+FNetTelemetry& FNetTelemetry::Get()
+{
+	// never destroyed, like the packet pool
+	static FNetTelemetry* telemetry = new FNetTelemetry();
+	return *telemetry;
+}
+
+FNetTelemetry::FNetTelemetry()
+{
+	_slotOf.Init(0, 0x10000);
+	_msgIDOf.Add(0);
+
+	auto assign = [this](uint16 msgID) {
+		if (_slotOf[msgID] == 0) {
+			_slotOf[msgID] = (uint16)_msgIDOf.Num();
+			_msgIDOf.Add(msgID);
+		}
+	};
+
+	// client internal ids live in the low byte, framework and content ids come from the generated tables
+	for (uint16 id = 1; id <= 0xFF; ++id) {
+		assign(id);
+	}
+
+	for (const MsgHelper::ProtocolName& protocol : MsgHelper::FrameworkProtocolNames) {
+		assign(protocol.msgID);
+	}
+
+	for (const MsgHelper::ProtocolName& protocol : MsgHelper::ProtocolNames) {
+		assign(protocol.msgID);
+	}
+}
+
+FNetTelemetry::FBlock& FNetTelemetry::GetThreadBlock()
+{
+	thread_local FBlock* block = nullptr;
+	if (block == nullptr) {
+		block = new FBlock();
+		block->counters = MakeUnique<FCounters[]>(_msgIDOf.Num());
+
+		FScopeLock lock(&_blocksLock);
+		_blocks.Add(block);
+	}
+	return *block;
+}
+
+FNetTelemetry::FCounters& FNetTelemetry::GetCounters(uint16 msgID)
+{
+	return GetThreadBlock().counters[_slotOf[msgID]];
+}
+
+void FNetTelemetry::RecordReceived(uint16 msgID, uint32 bytes)
+{
+	FCounters& counters = GetCounters(msgID);
+	Add(counters.countIn, 1);
+	Add(counters.bytesIn, bytes);
+}
+
+void FNetTelemetry::RecordSent(uint16 msgID, uint32 bytes)
+{
+	FCounters& counters = GetCounters(msgID);
+	Add(counters.countOut, 1);
+	Add(counters.bytesOut, bytes);
+}
+
+void FNetTelemetry::RecordCompactSavings(uint16 msgID, int32 bytes, bool outgoing)
+{
+	// two's complement, the snapshot reads it back as signed
+	FCounters& counters = GetCounters(msgID);
+	Add(outgoing ? counters.compactSavedOut : counters.compactSavedIn, (uint64)(int64)bytes);
+}
+
+void FNetTelemetry::RecordCompression(uint16 msgID, uint32 rawBytes, uint32 wireBytes, uint64 compressCycles, uint64 decompressCycles)
+{
+	FCounters& counters = GetCounters(msgID);
+	Add(counters.lz4Count, 1);
+	Add(counters.lz4RawBytes, rawBytes);
+	Add(counters.lz4WireBytes, wireBytes);
+	Add(counters.lz4CompressCycles, compressCycles);
+	Add(counters.lz4DecompressCycles, decompressCycles);
+}
+
+void FNetTelemetry::RecordHandled(uint16 msgID, uint64 startCycles, uint64 endCycles, int64 timestamp)
+{
+	uint64 handlerCycles = endCycles - startCycles;
+
+	FCounters& counters = GetCounters(msgID);
+	Add(counters.handled, 1);
+	Add(counters.handlerCycles, handlerCycles);
+	Max(counters.handlerMaxCycles, handlerCycles);
+
+	uint64 usec = (uint64)ToUsec(handlerCycles);
+	int32 bucket = usec == 0 ? 0 : FMath::Min<int32>(FMath::FloorLog2_64(usec) + 1, NET_TELEMETRY_HISTOGRAM_BUCKETS - 1);
+	Add(counters.handlerHistogram[bucket], 1);
+
+	if (timestamp > 0 && startCycles >= (uint64)timestamp) {
+		uint64 dwell = startCycles - (uint64)timestamp;
+		Add(counters.dwellCycles, dwell);
+		Max(counters.dwellMaxCycles, dwell);
+	}
+}
+
+TArray<FNetOpcodeTelemetry> FNetTelemetry::Snapshot() const
+{
+	TArray<FNetOpcodeTelemetry> opcodes;
+	opcodes.SetNum(_msgIDOf.Num());
+
+	{
+		FScopeLock lock(&_blocksLock);
+		for (const FBlock* block : _blocks) {
+			for (int32 slot = 0; slot < _msgIDOf.Num(); ++slot) {
+				const FCounters& counters = block->counters[slot];
+				FNetOpcodeTelemetry& opcode = opcodes[slot];
+
+				opcode.countIn += counters.countIn.load(std::memory_order_relaxed);
+				opcode.bytesIn += counters.bytesIn.load(std::memory_order_relaxed);
+				opcode.countOut += counters.countOut.load(std::memory_order_relaxed);
+				opcode.bytesOut += counters.bytesOut.load(std::memory_order_relaxed);
+				opcode.handled += counters.handled.load(std::memory_order_relaxed);
+				opcode.handlerCycles += counters.handlerCycles.load(std::memory_order_relaxed);
+				opcode.handlerMaxCycles = FMath::Max(opcode.handlerMaxCycles, counters.handlerMaxCycles.load(std::memory_order_relaxed));
+				for (int32 i = 0; i < NET_TELEMETRY_HISTOGRAM_BUCKETS; ++i) {
+					opcode.handlerHistogram[i] += counters.handlerHistogram[i].load(std::memory_order_relaxed);
+				}
+				opcode.dwellCycles += counters.dwellCycles.load(std::memory_order_relaxed);
+				opcode.dwellMaxCycles = FMath::Max(opcode.dwellMaxCycles, counters.dwellMaxCycles.load(std::memory_order_relaxed));
+				opcode.compactSavedIn += (int64)counters.compactSavedIn.load(std::memory_order_relaxed);
+				opcode.compactSavedOut += (int64)counters.compactSavedOut.load(std::memory_order_relaxed);
+				opcode.lz4Count += counters.lz4Count.load(std::memory_order_relaxed);
+				opcode.lz4RawBytes += counters.lz4RawBytes.load(std::memory_order_relaxed);
+				opcode.lz4WireBytes += counters.lz4WireBytes.load(std::memory_order_relaxed);
+				opcode.lz4CompressCycles += counters.lz4CompressCycles.load(std::memory_order_relaxed);
+				opcode.lz4DecompressCycles += counters.lz4DecompressCycles.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	TArray<FNetOpcodeTelemetry> active;
+	for (int32 slot = 0; slot < opcodes.Num(); ++slot) {
+		FNetOpcodeTelemetry& opcode = opcodes[slot];
+		if (opcode.countIn == 0 && opcode.countOut == 0 && opcode.handled == 0 && opcode.lz4Count == 0) {
+			continue;
+		}
+
+		opcode.msgID = _msgIDOf[slot];
+		opcode.name = slot == 0 ? TEXT("UNKNOWN") : GetOpcodeName(opcode.msgID);
+		active.Emplace(MoveTemp(opcode));
+	}
+	return active;
+}
+
+void FNetTelemetry::Reset()
+{
+	// racing writers may keep a few increments, good enough for telemetry
+	FScopeLock lock(&_blocksLock);
+	for (FBlock* block : _blocks) {
+		for (int32 slot = 0; slot < _msgIDOf.Num(); ++slot) {
+			FCounters& counters = block->counters[slot];
+			counters.countIn.store(0, std::memory_order_relaxed);
+			counters.bytesIn.store(0, std::memory_order_relaxed);
+			counters.countOut.store(0, std::memory_order_relaxed);
+			counters.bytesOut.store(0, std::memory_order_relaxed);
+			counters.handled.store(0, std::memory_order_relaxed);
+			counters.handlerCycles.store(0, std::memory_order_relaxed);
+			counters.handlerMaxCycles.store(0, std::memory_order_relaxed);
+			for (std::atomic<uint64>& bucket : counters.handlerHistogram) {
+				bucket.store(0, std::memory_order_relaxed);
+			}
+			counters.dwellCycles.store(0, std::memory_order_relaxed);
+			counters.dwellMaxCycles.store(0, std::memory_order_relaxed);
+			counters.compactSavedIn.store(0, std::memory_order_relaxed);
+			counters.compactSavedOut.store(0, std::memory_order_relaxed);
+			counters.lz4Count.store(0, std::memory_order_relaxed);
+			counters.lz4RawBytes.store(0, std::memory_order_relaxed);
+			counters.lz4WireBytes.store(0, std::memory_order_relaxed);
+			counters.lz4CompressCycles.store(0, std::memory_order_relaxed);
+			counters.lz4DecompressCycles.store(0, std::memory_order_relaxed);
+		}
+	}
+}
+
+FString FNetTelemetry::ToCSV() const
+{
+	FString csv = TEXT("msg_id,name,count_in,bytes_in,count_out,bytes_out,handled,handler_avg_us,handler_max_us,dwell_avg_us,dwell_max_us,compact_saved_in,compact_saved_out,lz4_count,lz4_raw_bytes,lz4_wire_bytes,lz4_compress_us,lz4_decompress_us");
+	for (int32 i = 0; i < NET_TELEMETRY_HISTOGRAM_BUCKETS; ++i) {
+		csv += FString::Printf(TEXT(",handler_lt_%llu_us"), 1ull << i);
+	}
+	csv += TEXT("\n");
+
+	for (const FNetOpcodeTelemetry& opcode : Snapshot()) {
+		double handled = FMath::Max<double>(opcode.handled, 1);
+		csv += FString::Printf(TEXT("0x%04x,%s,%llu,%llu,%llu,%llu,%llu,%.2f,%.2f,%.2f,%.2f,%lld,%lld,%llu,%llu,%llu,%.2f,%.2f"),
+			opcode.msgID, *opcode.name,
+			opcode.countIn, opcode.bytesIn, opcode.countOut, opcode.bytesOut,
+			opcode.handled, ToUsec(opcode.handlerCycles) / handled, ToUsec(opcode.handlerMaxCycles),
+			ToUsec(opcode.dwellCycles) / handled, ToUsec(opcode.dwellMaxCycles),
+			opcode.compactSavedIn, opcode.compactSavedOut,
+			opcode.lz4Count, opcode.lz4RawBytes, opcode.lz4WireBytes, ToUsec(opcode.lz4CompressCycles), ToUsec(opcode.lz4DecompressCycles));
+		for (uint64 bucket : opcode.handlerHistogram) {
+			csv += FString::Printf(TEXT(",%llu"), bucket);
+		}
+		csv += TEXT("\n");
+	}
+	return csv;
+}
+
+FString FNetTelemetry::ToJSON() const
+{
+	FString json = TEXT("[\n");
+
+	TArray<FNetOpcodeTelemetry> opcodes = Snapshot();
+	for (int32 i = 0; i < opcodes.Num(); ++i) {
+		const FNetOpcodeTelemetry& opcode = opcodes[i];
+		double handled = FMath::Max<double>(opcode.handled, 1);
+
+		FString histogram;
+		for (int32 bucket = 0; bucket < NET_TELEMETRY_HISTOGRAM_BUCKETS; ++bucket) {
+			histogram += FString::Printf(TEXT("%s%llu"), bucket == 0 ? TEXT("") : TEXT(","), opcode.handlerHistogram[bucket]);
+		}
+
+		json += FString::Printf(TEXT("\t{\"msg_id\":%u,\"name\":\"%s\",\"count_in\":%llu,\"bytes_in\":%llu,\"count_out\":%llu,\"bytes_out\":%llu,")
+			TEXT("\"handled\":%llu,\"handler_avg_us\":%.2f,\"handler_max_us\":%.2f,\"dwell_avg_us\":%.2f,\"dwell_max_us\":%.2f,")
+			TEXT("\"compact_saved_in\":%lld,\"compact_saved_out\":%lld,")
+			TEXT("\"lz4_count\":%llu,\"lz4_raw_bytes\":%llu,\"lz4_wire_bytes\":%llu,\"lz4_compress_us\":%.2f,\"lz4_decompress_us\":%.2f,\"handler_histogram\":[%s]}%s\n"),
+			opcode.msgID, *opcode.name,
+			opcode.countIn, opcode.bytesIn, opcode.countOut, opcode.bytesOut,
+			opcode.handled, ToUsec(opcode.handlerCycles) / handled, ToUsec(opcode.handlerMaxCycles),
+			ToUsec(opcode.dwellCycles) / handled, ToUsec(opcode.dwellMaxCycles),
+			opcode.compactSavedIn, opcode.compactSavedOut,
+			opcode.lz4Count, opcode.lz4RawBytes, opcode.lz4WireBytes, ToUsec(opcode.lz4CompressCycles), ToUsec(opcode.lz4DecompressCycles),
+			*histogram, i + 1 < opcodes.Num() ? TEXT(",") : TEXT(""));
+	}
+
+	json += TEXT("]\n");
+	return json;
+}
+
+bool FNetTelemetry::Dump(const FString& format) const
+{
+	bool json = format.Equals(TEXT("json"), ESearchCase::IgnoreCase);
+	FString path = FPaths::Combine(FPaths::ProfilingDir(), TEXT("ClientNet"),
+		FString::Printf(TEXT("telemetry-%s.%s"), *FDateTime::Now().ToString(), json ? TEXT("json") : TEXT("csv")));
+
+	if (FFileHelper::SaveStringToFile(json ? ToJSON() : ToCSV(), *path) == false) {
+		UE_LOG(LogClientNet, Warning, TEXT("failed to write telemetry [%s]"), *path);
+		return false;
+	}
+
+	UE_LOG(LogClientNet, Display, TEXT("telemetry written [%s]"), *path);
+	return true;
+}
+
+void FNetTelemetry::Tick(float deltaTime)
+{
+	float interval = CVar_ClientNetTelemetryDumpInterval.GetValueOnGameThread();
+	if (interval <= 0.f) {
+		_dumpElapsed = 0.f;
+		return;
+	}
+
+	_dumpElapsed += deltaTime;
+	if (_dumpElapsed >= interval) {
+		_dumpElapsed = 0.f;
+		Dump(CVar_ClientNetTelemetryDumpFormat.GetValueOnGameThread());
+	}
+}
@@ -0,0 +1,135 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "PacketCompression.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Compression.h"
+
+#include "PacketPool.h"
+#include "NetTelemetry.h"
+
+#include "framework_msg_struct.h"
+
+TAutoConsoleVariable<bool> CVar_ClientNetCompression(TEXT("ClientNet.Compression"), true, TEXT("offer lz4 compression of large bodies during setup cord"));
+TAutoConsoleVariable<int32> CVar_ClientNetCompressionThreshold(TEXT("ClientNet.Compression.Threshold"), 1024, TEXT("bodies from this size on are sent lz4 compressed once the session agreed on it"));
+TAutoConsoleVariable<bool> CVar_ClientNetCompressionProbe(TEXT("ClientNet.Compression.Probe"), false, TEXT("trial compress received bodies above the threshold, ratio and cost per message id go to the telemetry"));
+
+namespace
+{
+	using FEnvelope = MsgSchema::FRAMEWORKMSG_COMPRESSED_Body;
+
+	constexpr uint32 MaxBodySize = MAX_MESSIVE_BUF_SIZE - MSG_HEADER_SIZE;
+
+	// keeps MSG_FLAG_IDFIELD_COMPACT, GetMsgID strips it
+	uint16 GetWireMsgID(const TSharedPacket& packet)
+	{
+		uint16 msgID = 0;
+		::memcpy(&msgID, packet->GetBufferAt(MSG_OFFSET_ID), sizeof(uint16));
+		return msgID;
+	}
+}
+
+uint8 FPacketCompression::GetOfferedCapabilities()
+{
+	return CVar_ClientNetCompression.GetValueOnAnyThread() ? FRAMEWORK_CAPABILITY_LZ4 : 0;
+}
+
+uint32 FPacketCompression::GetThreshold()
+{
+	return (uint32)FMath::Max(CVar_ClientNetCompressionThreshold.GetValueOnAnyThread(), 0);
+}
+
+TSharedPacket FPacketCompression::Compress(const TSharedPacket& packet)
+{
+	uint32 bodySize = packet->GetBodySize();
+	// the envelope only knows frame sized bodies, streamed ones go out as they are
+	if (bodySize < GetThreshold() || bodySize <= FEnvelope::FixedSize || bodySize > MaxBodySize) {
+		return nullptr;
+	}
+
+	uint64 start = FPlatformTime::Cycles64();
+
+	// the block has to leave the envelope smaller than the body, lz4 gives up once it can not
+	int32 capacity = (int32)(bodySize - FEnvelope::FixedSize - 1);
+	TSharedPacket envelope = FNetPacketPool::Get().Alloc(FRAMEWORKMSG_COMPRESSED, bodySize);
+	envelope->SetSessionID(packet->GetSessionID());
+
+	FEnvelope header;
+	header.msgID = GetWireMsgID(packet);
+	header.bodySize = (uint16)bodySize;
+	envelope->WriteBody(header);
+
+	int32 compressedSize = capacity;
+	if (FCompression::CompressMemory(NAME_LZ4, envelope->GetWrBuffer(), compressedSize, packet->GetBufferAt(MSG_HEADER_SIZE), (int32)bodySize) == false) {
+		return nullptr;
+	}
+
+	envelope->IncWrPos((uint32)compressedSize);
+	envelope->FinalizeHeader();
+
+	FNetTelemetry::Get().RecordCompression(packet->GetMsgID(), bodySize, envelope->GetBodySize(), FPlatformTime::Cycles64() - start, 0);
+	return envelope;
+}
+
+TSharedPacket FPacketCompression::Decompress(const TSharedPacket& envelope)
+{
+	TSharedPacket packet = Decompress(FNetPacketView(*envelope));
+	if (packet.IsValid()) {
+		packet->SetSessionID(envelope->GetSessionID());
+		packet->SetTimestamp(envelope->GetTimestamp());
+	}
+	return packet;
+}
+
+TSharedPacket FPacketCompression::Decompress(FNetPacketView envelope)
+{
+	FEnvelope header;
+	if (envelope.ReadBody(header) == false || header.bodySize > MaxBodySize || envelope.GetRemainBytesToRead() == 0) {
+		return nullptr;
+	}
+
+	uint64 start = FPlatformTime::Cycles64();
+
+	TSharedPacket packet = FNetPacketPool::Get().Alloc(header.msgID, header.bodySize);
+	if (FCompression::UncompressMemory(NAME_LZ4, packet->GetWrBuffer(), header.bodySize, envelope.GetRdBuffer(), envelope.GetRemainBytesToRead()) == false) {
+		return nullptr;
+	}
+
+	packet->IncWrPos(header.bodySize);
+	packet->FinalizeHeader();
+
+	FNetTelemetry::Get().RecordCompression(packet->GetMsgID(), header.bodySize, envelope.GetBodySize(), 0, FPlatformTime::Cycles64() - start);
+	return packet;
+}
+
+void FPacketCompression::Probe(const TSharedPacket& packet)
+{
+	if (CVar_ClientNetCompressionProbe.GetValueOnAnyThread() == false) {
+		return;
+	}
+
+	uint32 bodySize = packet->GetBodySize();
+	if (bodySize < GetThreshold() || bodySize == 0) {
+		return;
+	}
+
+	// scratch of the receiving thread, grown once to the largest body seen
+	thread_local TArray<uint8> compressed;
+	thread_local TArray<uint8> restored;
+
+	int32 bound = FCompression::CompressMemoryBound(NAME_LZ4, (int32)bodySize);
+	compressed.SetNumUninitialized(bound, EAllowShrinking::No);
+	restored.SetNumUninitialized(bodySize, EAllowShrinking::No);
+
+	uint64 start = FPlatformTime::Cycles64();
+	int32 compressedSize = bound;
+	if (FCompression::CompressMemory(NAME_LZ4, compressed.GetData(), compressedSize, packet->GetBufferAt(MSG_HEADER_SIZE), (int32)bodySize) == false) {
+		return;
+	}
+
+	uint64 compressedAt = FPlatformTime::Cycles64();
+	FCompression::UncompressMemory(NAME_LZ4, restored.GetData(), (int32)bodySize, compressed.GetData(), compressedSize);
+
+	FNetTelemetry::Get().RecordCompression(packet->GetMsgID(), bodySize, FEnvelope::FixedSize + compressedSize,
+		compressedAt - start, FPlatformTime::Cycles64() - compressedAt);
+}
@@ -0,0 +1,183 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "PacketDispatcher.h"
+#include "HAL/PlatformTime.h"
+#include "Stats/Stats.h"
+
+#include "framework_msg_define.h"
+#include "anu_msg_define.h"
+
+DECLARE_STATS_GROUP(TEXT("ClientNet"), STATGROUP_ClientNet, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Dispatched"), STAT_ClientNetDispatched, STATGROUP_ClientNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Spilled"), STAT_ClientNetSpilled, STATGROUP_ClientNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Backlog Normal"), STAT_ClientNetBacklogNormal, STATGROUP_ClientNet);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Backlog Bulk"), STAT_ClientNetBacklogBulk, STATGROUP_ClientNet);
+
+FString FNetDispatchStats::ToString() const
+{
+	return FString::Printf(TEXT("[dispatched:%u] [spilled:%u] [backlog:%u/%u/%u] [elapsed:%.1fus] [total dispatched:%llu] [total spilled:%llu] [spilled frames:%u] [peak backlog:%u]"),
+		dispatched, spilled,
+		backlog[(uint8)ENetDispatchPriority::Critical], backlog[(uint8)ENetDispatchPriority::Normal], backlog[(uint8)ENetDispatchPriority::Bulk],
+		elapsedUsec, totalDispatched, totalSpilled, spilledFrames, peakBacklog);
+}
+
+TSharedPacket FPacketDispatcher::FBacklog::Pop()
+{
+	TSharedPacket packet = MoveTemp(packets[head++]);
+	if (head == packets.Num()) {
+		packets.Reset();
+		head = 0;
+	} else if (head >= 1024 && head * 2 >= packets.Num()) {
+		// a long spill keeps appending behind the head, drop the consumed prefix now and then
+		packets.RemoveAt(0, head, EAllowShrinking::No);
+		head = 0;
+	}
+	return packet;
+}
+
+void FPacketDispatcher::FBacklog::Empty()
+{
+	packets.Reset();
+	head = 0;
+}
+
+FPacketDispatcher::FPacketDispatcher()
+{
+	_priorities.Init((uint8)ENetDispatchPriority::Normal, 0x10000);
+
+	for (uint32 msgID = 0; msgID < 0x10000; ++msgID) {
+		// client internal messages carry no category bits
+		if ((msgID & MSG_FLAG_IDFIELD_CONTENT) == 0 || (msgID & MSG_FLAG_IDFIELD_CONTENT) == MSG_FLAG_IDFIELD_FRAMEWORK) {
+			_priorities[msgID] = (uint8)ENetDispatchPriority::Critical;
+		}
+	}
+
+	// spawns and despawns travel with the movement, a move never overtakes the spawn of its object
+	static const uint16 movements[] = {
+		WORLD_OBJ_ADD_NFY, WORLD_OBJ_DEL_NFY,
+		MOVE_ACK, MOVE_NFY,
+		MOVE_TO_ACK, MOVE_TO_NFY,
+		MOVE_LOCATION_NFY,
+		MOVE_WITH_CONSTANT_VELOCITY_NFY,
+		MOVE_SNAPSHOT_NFY,
+		MOVE_SNAPSHOT_INIT_ACK, MOVE_SNAPSHOT_INIT_NFY,
+		MOVE_SNAPSHOT_PATCH_NFY,
+		MOVE_HISTORY_NFY,
+	};
+	for (uint16 msgID : movements) {
+		SetPriority(msgID, ENetDispatchPriority::Critical);
+	}
+
+	SetPriority(ITEM_UPDATED_NFY, ENetDispatchPriority::Bulk);
+}
+
+void FPacketDispatcher::SetPriority(uint16 msgID, ENetDispatchPriority priority)
+{
+	check(priority < ENetDispatchPriority::Max);
+	_priorities[msgID] = (uint8)priority;
+}
+
+void FPacketDispatcher::Push(TSharedPacket&& packet)
+{
+	uint8 priority = _priorities[packet->GetMsgID()];
+	_backlogs[priority].packets.Emplace(MoveTemp(packet));
+}
+
+void FPacketDispatcher::BeginFrame()
+{
+	_frameStartCycles = FPlatformTime::Cycles64();
+	_budgetCycles = (uint64)(_budget.timeUsec / 1000000.0 / FPlatformTime::GetSecondsPerCycle64());
+	_frameCharged = 0;
+
+	_stats.dispatched = 0;
+	_stats.spilled = 0;
+}
+
+bool FPacketDispatcher::IsOverBudget() const
+{
+	if (_budget.packets > 0 && _frameCharged >= _budget.packets) {
+		return true;
+	}
+
+	if (_budget.timeUsec > 0 && FPlatformTime::Cycles64() - _frameStartCycles >= _budgetCycles) {
+		return true;
+	}
+	return false;
+}
+
+void FPacketDispatcher::Dispatch(TFunctionRef<void(TSharedPacket&)> handler)
+{
+	FBacklog& critical = _backlogs[(uint8)ENetDispatchPriority::Critical];
+	while (critical.Num() > 0) {
+		TSharedPacket packet = critical.Pop();
+		handler(packet);
+		++_stats.dispatched;
+	}
+
+	FBacklog& normal = _backlogs[(uint8)ENetDispatchPriority::Normal];
+	while (normal.Num() > 0 && IsOverBudget() == false) {
+		TSharedPacket packet = normal.Pop();
+		handler(packet);
+		++_stats.dispatched;
+		++_frameCharged;
+	}
+
+	FBacklog& bulk = _backlogs[(uint8)ENetDispatchPriority::Bulk];
+	uint32 bulkDispatched = 0;
+	while (bulk.Num() > 0 && (bulkDispatched < _budget.minBulkPackets || IsOverBudget() == false)) {
+		TSharedPacket packet = bulk.Pop();
+		handler(packet);
+		++_stats.dispatched;
+		++_frameCharged;
+		++bulkDispatched;
+	}
+}
+
+bool FPacketDispatcher::TryCharge()
+{
+	if (IsOverBudget()) {
+		return false;
+	}
+
+	++_frameCharged;
+	return true;
+}
+
+void FPacketDispatcher::EndFrame()
+{
+	uint32 backlog = 0;
+	for (uint8 i = 0; i < (uint8)ENetDispatchPriority::Max; ++i) {
+		_stats.backlog[i] = (uint32)_backlogs[i].Num();
+		backlog += _stats.backlog[i];
+	}
+
+	_stats.spilled = backlog;
+	_stats.elapsedUsec = FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - _frameStartCycles) * 1000.0;
+	_stats.totalDispatched += _stats.dispatched;
+	_stats.totalSpilled += _stats.spilled;
+	_stats.peakBacklog = FMath::Max(_stats.peakBacklog, backlog);
+	if (_stats.spilled > 0) {
+		++_stats.spilledFrames;
+	}
+
+	SET_DWORD_STAT(STAT_ClientNetDispatched, _stats.dispatched);
+	SET_DWORD_STAT(STAT_ClientNetSpilled, _stats.spilled);
+	SET_DWORD_STAT(STAT_ClientNetBacklogNormal, _stats.backlog[(uint8)ENetDispatchPriority::Normal]);
+	SET_DWORD_STAT(STAT_ClientNetBacklogBulk, _stats.backlog[(uint8)ENetDispatchPriority::Bulk]);
+}
+
+void FPacketDispatcher::Empty()
+{
+	for (FBacklog& backlog : _backlogs) {
+		backlog.Empty();
+	}
+}
+
+uint32 FPacketDispatcher::GetBacklog() const
+{
+	uint32 total = 0;
+	for (const FBacklog& backlog : _backlogs) {
+		total += (uint32)backlog.Num();
+	}
+	return total;
+}
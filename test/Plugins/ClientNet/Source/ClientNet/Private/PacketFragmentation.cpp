@@ -0,0 +1,68 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "PacketFragmentation.h"
+#include "HAL/IConsoleManager.h"
+
+#include "PacketPool.h"
+
+TAutoConsoleVariable<bool> CVar_ClientNetFragmentation(TEXT("ClientNet.Fragmentation"), true, TEXT("offer streaming of bodies larger than one frame during setup cord"));
+TAutoConsoleVariable<int32> CVar_ClientNetFragmentationSliceBytes(TEXT("ClientNet.Fragmentation.SliceBytes"), 16 * 1024, TEXT("slice bytes per FRAMEWORKMSG_FRAGMENT frame, smaller slices let other messages through sooner"));
+
+uint8 FPacketFragmentation::GetOfferedCapabilities()
+{
+	return CVar_ClientNetFragmentation.GetValueOnAnyThread() ? FRAMEWORK_CAPABILITY_FRAGMENT : 0;
+}
+
+uint32 FPacketFragmentation::GetSliceBytes()
+{
+	return FMath::Clamp<uint32>((uint32)FMath::Max(CVar_ClientNetFragmentationSliceBytes.GetValueOnAnyThread(), 0), NetCore::MinFragmentSliceBytes, NetCore::MaxFragmentSliceBytes);
+}
+
+void FPacketFragmenter::Push(const TSharedPacket& packet)
+{
+	check(packet->IsStreamed());
+
+	// keeps MSG_FLAG_IDFIELD_COMPACT, GetMsgID strips it
+	uint16 msgID = 0;
+	::memcpy(&msgID, packet->GetBufferAt(MSG_OFFSET_ID), sizeof(uint16));
+	_writer.Push(packet, msgID, packet->GetBufferAt(MSG_HEADER_SIZE), packet->GetBodySize());
+}
+
+uint32 FPacketFragmenter::WriteNext(uint8* out, uint32 capacity)
+{
+	return _writer.WriteNext(out, capacity, FPacketFragmentation::GetSliceBytes());
+}
+
+TSharedPacket FPacketReassembler::FPooledBuffer::Alloc(uint16 msgID, uint32 totalSize)
+{
+	return FNetPacketPool::Get().Alloc(msgID, totalSize);
+}
+
+void FPacketReassembler::FPooledBuffer::Append(TSharedPacket& packet, const uint8* data, uint32 size)
+{
+	packet->WriteBytes(data, size);
+}
+
+FPacketReassembler::EResult FPacketReassembler::Feed(const TSharedPacket& fragment, TSharedPacket& completed)
+{
+	EResult result = Feed(FNetPacketView(*fragment), completed);
+	if (result == EResult::Completed) {
+		completed->SetSessionID(fragment->GetSessionID());
+		completed->SetTimestamp(fragment->GetTimestamp());
+	}
+	return result;
+}
+
+FPacketReassembler::EResult FPacketReassembler::Feed(FNetPacketView fragment, TSharedPacket& completed)
+{
+	switch (_reassembler.Feed(fragment.GetRdBuffer(), fragment.GetRemainBytesToRead(), completed)) {
+	case NetCore::FragmentResult::Pending:
+		return EResult::Pending;
+	case NetCore::FragmentResult::Completed:
+		completed->FinalizeHeader();
+		completed->SetRdPos(0);
+		return EResult::Completed;
+	default:
+		return EResult::Corrupted;
+	}
+}
@@ -0,0 +1,172 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "PacketPool.h"
+#include "Misc/ScopeLock.h"
+
+FString FNetPacketPoolStats::ToString() const
+{
+	return FString::Printf(TEXT("[hits:%llu] [misses:%llu] [discarded:%llu] [handles:%llu] [outstanding:%d] [highwater:%d] [pooled:%d]"),
+		hits, misses, discarded, handles, outstanding, highWater, pooled);
+}
+
+FNetPacketPool& FNetPacketPool::Get()
+{
+	// never destroyed, packets may still be released while statics are torn down
+	static FNetPacketPool* pool = new FNetPacketPool();
+	return *pool;
+}
+
+FNetPacketPool::FNetPacketPool()
+{
+	_buckets[(uint8)ESizeClass::Small].maxRetained = 1024;
+	_buckets[(uint8)ESizeClass::Regular].maxRetained = 256;
+	_buckets[(uint8)ESizeClass::Messive].maxRetained = 16;
+}
+
+FNetPacketPool::~FNetPacketPool()
+{
+	Trim();
+}
+
+FNetPacketPool::ESizeClass FNetPacketPool::Classify(size_t required)
+{
+	if (required <= MIN_MSGBUF_SIZE) {
+		return ESizeClass::Small;
+	}
+
+	if (required <= MAX_MSGBUF_SIZE) {
+		return ESizeClass::Regular;
+	}
+
+	return ESizeClass::Messive;
+}
+
+size_t FNetPacketPool::GetClassCapacity(ESizeClass sizeClass)
+{
+	switch (sizeClass)
+	{
+	case ESizeClass::Small:
+		return MIN_MSGBUF_SIZE;
+	case ESizeClass::Regular:
+		return MAX_MSGBUF_SIZE;
+	default:
+		return MAX_MESSIVE_BUF_SIZE;
+	}
+}
+
+TSharedPacket FNetPacketPool::Alloc(uint16 msgID, uint32 bodySize)
+{
+	FNetPacket* packet = Acquire((size_t)bodySize + MSG_HEADER_SIZE);
+	packet->SetRdPos(0);
+	packet->SetWrPos(0);
+	packet->SetMsgID(msgID);
+	return Wrap(packet);
+}
+
+TSharedPacket FNetPacketPool::AllocFrame(uint32 packetSize)
+{
+	return Wrap(Acquire(FMath::Max<size_t>(packetSize, MSG_HEADER_SIZE)));
+}
+
+FNetPacket* FNetPacketPool::Acquire(size_t required)
+{
+	ESizeClass sizeClass = Classify(required);
+	size_t capacity = FMath::Max(GetClassCapacity(sizeClass), required);
+
+	FNetPacket* packet = nullptr;
+	{
+		FBucket& bucket = _buckets[(uint8)sizeClass];
+		FScopeLock lock(&bucket.lock);
+		if (bucket.packets.Num() > 0) {
+			packet = bucket.packets.Pop(EAllowShrinking::No);
+		}
+	}
+
+	if (packet) {
+		++_hits;
+	} else {
+		++_misses;
+		packet = new FNetPacket(0, capacity);
+	}
+	packet->Recycle(capacity);
+
+	int32 outstanding = ++_outstanding;
+	int32 highWater = _highWater.load(std::memory_order_relaxed);
+	while (outstanding > highWater && !_highWater.compare_exchange_weak(highWater, outstanding, std::memory_order_relaxed)) {
+	}
+
+	return packet;
+}
+
+void FNetPacketPool::Release(FNetPacket* packet)
+{
+	--_outstanding;
+
+	// streamed bodies are rare and large, holding on to their buffers is not worth it
+	size_t capacity = packet->GetCapacity();
+	if (capacity < MIN_MSGBUF_SIZE || capacity > (size_t)MAX_MESSIVE_BUF_SIZE + MSG_HEADER_SIZE) {
+		++_discarded;
+		delete packet;
+		return;
+	}
+
+	// a grown packet goes back to the largest class it can fully serve
+	ESizeClass sizeClass = ESizeClass::Messive;
+	if (capacity < MAX_MSGBUF_SIZE) {
+		sizeClass = ESizeClass::Small;
+	} else if (capacity < MAX_MESSIVE_BUF_SIZE) {
+		sizeClass = ESizeClass::Regular;
+	}
+
+	{
+		FBucket& bucket = _buckets[(uint8)sizeClass];
+		FScopeLock lock(&bucket.lock);
+		if (bucket.packets.Num() < bucket.maxRetained) {
+			bucket.packets.Push(packet);
+			return;
+		}
+	}
+
+	++_discarded;
+	delete packet;
+}
+
+TSharedPacket FNetPacketPool::Wrap(FNetPacket* packet)
+{
+	++_handles;
+	return TSharedPacket(packet, [this](FNetPacket* released) {
+		Release(released);
+	});
+}
+
+FNetPacketPoolStats FNetPacketPool::GetStats() const
+{
+	FNetPacketPoolStats stats;
+	stats.hits = _hits.load(std::memory_order_relaxed);
+	stats.misses = _misses.load(std::memory_order_relaxed);
+	stats.discarded = _discarded.load(std::memory_order_relaxed);
+	stats.handles = _handles.load(std::memory_order_relaxed);
+	stats.outstanding = _outstanding.load(std::memory_order_relaxed);
+	stats.highWater = _highWater.load(std::memory_order_relaxed);
+
+	for (const FBucket& bucket : _buckets) {
+		FScopeLock lock(&bucket.lock);
+		stats.pooled += bucket.packets.Num();
+	}
+	return stats;
+}
+
+void FNetPacketPool::Trim()
+{
+	for (FBucket& bucket : _buckets) {
+		TArray<FNetPacket*> packets;
+		{
+			FScopeLock lock(&bucket.lock);
+			packets = MoveTemp(bucket.packets);
+		}
+
+		for (FNetPacket* packet : packets) {
+			delete packet;
+		}
+	}
+}
@@ -71,7 +71,7 @@ bool Security::LoadSecurityExchangeContext(TSharedPacket& packet)
 	SecurityContext context;
 	
 	if (packet->GetRemainBytesToRead() == 0) {
-		_securityContext.emplace(context);
+		_securityContext.emplace(std::move(context));
 		return true;
 	}
 
@@ -88,46 +88,38 @@ bool Security::LoadSecurityExchangeContext(TSharedPacket& packet)
 	context.dec_iv = vi;
 	context.enc_iv = vi;
 
-	_securityContext.emplace(context);
+	if (ExpandKey(context) == false) {
+		return false;
+	}
+
+	_securityContext.emplace(std::move(context));
 
 	return true;
 }
 
-bool Security::EncryptPacket(TSharedPacket& packet)
+bool Security::ExpandKey(SecurityContext& context)
 {
-	if (_securityContext.has_value() == false) {
-		check(false);
+	std::vector<uint8>& userKey = context.userKey.value();
+	if (userKey.empty() || context.enc_iv.size() < AES_BLOCK_SIZE) {
 		return false;
 	}
 
-	if (_securityContext->isActivated() == false) {
-		return true;
-	}
-
-	std::vector<uint8>& userKey = _securityContext->userKey.value();
-	
-	AES_KEY encKey;
 	int len = (int)userKey.size() * 8;
-	int rt = AES_set_encrypt_key(&userKey[0], len, &encKey);
-	if (rt < 0) {
+	if (AES_set_encrypt_key(&userKey[0], len, &context.aesKey) < 0) {
 		return false;
-	};
-
-	uint16 dataSize = packet->GetBodySize();
-	
-	std::vector<uint8> buffer;
-	buffer.resize(dataSize);
-	int return_iv_length = 0;
+	}
 
-	AES_cfb128_encrypt(packet->GetBufferAt(MSG_HEADER_SIZE), &buffer[0], buffer.size(), &encKey, &_securityContext->enc_iv[0], &return_iv_length, AES_ENCRYPT);
-	
-	packet->SetWrPos(0);
-	packet->WriteBytes(&buffer[0], dataSize);
+#if CLIENTNET_SECURITY_USE_EVP
+	// both directions start from the same iv
+	if (context.cipher.Init(&userKey[0], userKey.size(), &context.enc_iv[0], context.enc_iv.size()) == false) {
+		return false;
+	}
+#endif
 
 	return true;
 }
 
-bool Security::DecryptPacket(TSharedPacket& packet)
+bool Security::Transform(TSharedPacket& packet, bool encrypt)
 {
 	if (_securityContext.has_value() == false) {
 		check(false);
@@ -138,27 +130,39 @@ bool Security::DecryptPacket(TSharedPacket& packet)
 		return true;
 	}
 
-	std::vector<uint8>& userKey = _securityContext->userKey.value();
-	
-	AES_KEY encKey;
-	int len = (int)userKey.size() * 8;
-	int rt = AES_set_encrypt_key(&userKey[0], len, &encKey);
-	if (rt < 0) {
-		return false;
-	};
+	if (encrypt) {
+		packet->FinalizeHeader();
+	}
 
-	uint16 dataSize = packet->GetBodySize();
+	uint32 dataSize = packet->GetBodySize();
+	if (dataSize == 0) {
+		return true;
+	}
 
-	std::vector<uint8> buffer;
-	buffer.resize(dataSize);
-	int return_iv_length = 0;
+	// cfb is a stream mode, the body is transformed in place
+	uint8* body = packet->GetBufferAt(MSG_HEADER_SIZE);
 
-	AES_cfb128_encrypt(packet->GetBufferAt(MSG_HEADER_SIZE), &buffer[0], buffer.size(), &encKey, &_securityContext->dec_iv[0], &return_iv_length, AES_DECRYPT);
-	
-	packet->SetWrPos(0);
-	packet->WriteBytes(&buffer[0], dataSize);
+#if CLIENTNET_SECURITY_USE_EVP
+	// every packet starts on a fresh block of the running iv, same as the server side
+	NetCore::StreamCipher& cipher = _securityContext->cipher;
+	return encrypt ? cipher.Encrypt(body, dataSize) : cipher.Decrypt(body, dataSize);
+#else
+	std::vector<uint8>& iv = encrypt ? _securityContext->enc_iv : _securityContext->dec_iv;
+	int return_iv_length = 0;
 
+	AES_cfb128_encrypt(body, body, dataSize, &_securityContext->aesKey, &iv[0], &return_iv_length, encrypt ? AES_ENCRYPT : AES_DECRYPT);
 	return true;
+#endif
+}
+
+bool Security::EncryptPacket(TSharedPacket& packet)
+{
+	return Transform(packet, true);
+}
+
+bool Security::DecryptPacket(TSharedPacket& packet)
+{
+	return Transform(packet, false);
 }
 
 bool Security::DecryptRSA(TSharedPacket& packet)
@@ -168,7 +172,7 @@ bool Security::DecryptRSA(TSharedPacket& packet)
 		return false;
 	}
 
-	uint16 size = packet->GetBodySize();
+	uint32 size = packet->GetBodySize();
 
 	std::vector<uint8> buffer;
 	buffer.resize(size * 2);
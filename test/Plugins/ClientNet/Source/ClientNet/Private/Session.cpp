@@ -1,12 +1,55 @@
 // Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
 
 #include "Session.h"
+#include "PacketPool.h"
+#include "PacketCompression.h"
+#include "NetCapture.h"
 #include "Sockets.h"
 #include "SocketSubsystem.h"
 #include "IPAddress.h"
 
 #include "ClientNet.h"
 
+FFrameUnwrapper::EResult FFrameUnwrapper::Unwrap(TSharedPacket& packet)
+{
+	if (IsEnvelope(packet->GetMsgID())) {
+		TSharedPacket unwrapped;
+		EResult result = Unwrap(FNetPacketView(*packet), packet->GetSessionID(), packet->GetTimestamp(), unwrapped);
+		if (result == EResult::Ready) {
+			packet = MoveTemp(unwrapped);
+		}
+		return result;
+	}
+
+	FPacketCompression::Probe(packet);
+	return EResult::Ready;
+}
+
+FFrameUnwrapper::EResult FFrameUnwrapper::Unwrap(FNetPacketView frame, int32 sessionID, int64 timestamp, TSharedPacket& packet)
+{
+	if (frame.GetMsgID() == FRAMEWORKMSG_FRAGMENT) {
+		switch (_reassembler.Feed(frame, packet))
+		{
+		case FPacketReassembler::EResult::Completed:
+			break;
+		case FPacketReassembler::EResult::Pending:
+			return EResult::Pending;
+		default:
+			return EResult::Corrupted;
+		}
+	} else {
+		check(frame.GetMsgID() == FRAMEWORKMSG_COMPRESSED);
+		packet = FPacketCompression::Decompress(frame);
+		if (packet.IsValid() == false) {
+			return EResult::Corrupted;
+		}
+	}
+
+	packet->SetSessionID(sessionID);
+	packet->SetTimestamp(timestamp);
+	return EResult::Ready;
+}
+
 FSession::FSession(int32 sessionID, FPacketRecvQueue& recvQueue)
 {
 	_sessionID = sessionID;
@@ -20,50 +63,55 @@ FSession::~FSession()
 		_socket = nullptr;
 	}
 
-	_buildingPacket.Reset();
+	_recvBuffer.Reset();
 	_sendingQueue.Empty();
+	_sendBuffer.clear();
 }
 
-bool FSession::Create(const FString& host, int32 port)
+void FSession::Create(const FString& host, int32 port)
 {
 	_host = host;
 	_port = port;
-	_ip = 0;
+	_remoteAddr.Reset();
+
+	_recvBuffer.Reset();
+	_undelivered.Reset();
+	_unwrapper.Reset();
+	_fragmenter.Reset();
+	_sendCursor = _sendPending = 0;
+	SetSendFlushBytes(_sendFlushBytes);
+}
 
-	_socket = UClientNet::_socketSubsystem->CreateSocket(NAME_Stream, TEXT("ClientNet.TCPSocket"), false);
-	if (_socket == nullptr) {
-		return false;
+FSocket* FSession::CreateSocket(const FName& protocolType)
+{
+	FSocket* socket = UClientNet::_socketSubsystem->CreateSocket(NAME_Stream, TEXT("ClientNet.TCPSocket"), protocolType);
+	if (socket == nullptr) {
+		return nullptr;
 	}
 
-	bool failed = !_socket->SetReuseAddr(false) || !_socket->SetLinger(false, 0) || !_socket->SetRecvErr();
+	bool failed = !socket->SetReuseAddr(false) || !socket->SetLinger(false, 0) || !socket->SetRecvErr() || !socket->SetNonBlocking(true);
 	if (failed) {
-		UClientNet::_socketSubsystem->DestroySocket(_socket);
-		return false;
+		UClientNet::_socketSubsystem->DestroySocket(socket);
+		return nullptr;
 	}
 
 	static const int32 MAX_SOCKET_BUFF_SIZE = 1024 * 124;
 
+	// buffer sizes go in before the handshake so the window scale is negotiated for them
 	int32 newSize = 0;
-	_socket->SetReceiveBufferSize(MAX_SOCKET_BUFF_SIZE, newSize);
-	_socket->SetSendBufferSize(MAX_SOCKET_BUFF_SIZE, newSize);
+	socket->SetReceiveBufferSize(MAX_SOCKET_BUFF_SIZE, newSize);
+	socket->SetSendBufferSize(MAX_SOCKET_BUFF_SIZE, newSize);
 	
-	_socket->SetNoDelay(true);
+	socket->SetNoDelay(true);
 
-	return true;
+	return socket;
 }
 
-bool FSession::Connect()
+void FSession::Attach(FSocket* socket, const TSharedPtr<FInternetAddr>& remoteAddr)
 {
-	TSharedRef<FInternetAddr> addr = UClientNet::_socketSubsystem->CreateInternetAddr();
-	addr->SetIp(_ip);
-	addr->SetPort(_port);
-
-	if (_socket->Connect(*addr) == false) {
-		return false;
-	}
-
-	_socket->SetNonBlocking(true);
-	return true;
+	check(_socket == nullptr);
+	_socket = socket;
+	_remoteAddr = remoteAddr;
 }
 
 void FSession::Close()
@@ -74,35 +122,22 @@ void FSession::Close()
 
 	_socket->Close();
 
+	// allocations per received packet are the pool handles over packets received
+	UE_LOG(LogClientNet, Verbose, TEXT("session closed session_id[%d] packets received[%llu] frames copied[%llu] in place[%llu] stalls[%llu]"),
+		_sessionID, _stats.packetsReceived, _stats.framesCopied, _stats.framesInPlace, _stats.recvStalls);
+
 	UClientNet::_socketSubsystem->DestroySocket(_socket);
 	_socket = nullptr;
 }
 
-bool FSession::PrepareConnect()
+void FSession::SendPacket(const TSharedPacket& packet)
 {
-	if (_socket == nullptr || _host.IsEmpty()) {
-		return false;
-	}
-
-	FAddressInfoResult result = UClientNet::_socketSubsystem->GetAddressInfo(*_host, nullptr, EAddressInfoFlags::Default, NAME_None);
-	if (result.Results.Num() <= 0) {
-		return false;
-	}
-
-	for (auto& data : result.Results) {
-		uint32 ip = 0;
-		data.Address->GetIp(ip);
-		if (ip != 0 && _ip == 0) {
-			_ip = ip;
-			break;
-		}
+	packet->FinalizeHeader();
+	if (packet->IsStreamed()) {
+		_fragmenter.Push(packet);
+		return;
 	}
-	
-	return (bool)_ip != 0;
-};
 
-void FSession::SendPacket(const TSharedPacket& packet)
-{
 	_sendingQueue.Enqueue(packet);
 }
 
@@ -125,72 +160,241 @@ bool FSession::PumpNetIO()
 
 bool FSession::Receiving()
 {
-	while (true)
+	// frames left in the ring by a stall go first, the socket is not read while the queue is still full
+	if (DispatchFrames() == false) {
+		return false;
+	}
+
+	while (IsReceiveStalled() == false)
 	{
+		uint32 writable = 0;
+		uint8* buffer = _recvBuffer.GetWritable(writable);
+		check(writable > 0);
+
 		int32 bytesRead = 0;
-		if (_buildingPacket.IsValid() == false) {
-			_buildingPacket = MakeShared<FNetPacket>();
-			_buildingPacket->SetSessionID(_sessionID);
+		if (_socket->Recv(buffer, writable, bytesRead) == false) {
+			return false;
+		}
+		++_stats.recvCalls;
+
+		if (bytesRead == 0) {
+			break;
+		}
+
+		_recvBuffer.Commit(bytesRead);
+		_stats.bytesReceived += bytesRead;
+
+		if (DispatchFrames() == false) {
+			return false;
+		}
+
+		// a short read means the socket has been drained
+		if ((uint32)bytesRead < writable) {
+			break;
+		}
+	}
+
+	return true;
+}
+
+bool FSession::Deliver(TSharedPacket& packet)
+{
+	if (_receivedQueue.IsBound() == false || _receivedQueue.Execute(packet)) {
+		return true;
+	}
+
+	_undelivered = MoveTemp(packet);
+	++_stats.recvStalls;
+	return false;
+}
+
+bool FSession::DispatchFrames()
+{
+	if (_undelivered.IsValid()) {
+		TSharedPacket packet = MoveTemp(_undelivered);
+		if (Deliver(packet) == false) {
+			return true;
 		}
+	}
 
-		uint16 remains = 0;
-		if (_buildingPacket->GetWrPos() < MSG_HEADER_SIZE) {
+	FRecvFrame frame;
+	while (true)
+	{
+		auto result = _recvBuffer.PeekFrame(frame);
+		if (result == FRecvRingBuffer::EFrameResult::Incompleted) {
+			break;
+		}
 
-			remains = MSG_HEADER_SIZE - _buildingPacket->GetWrPos();
+		if (result == FRecvRingBuffer::EFrameResult::Corrupted) {
+			UE_LOG(LogClientNet, Error, TEXT("corrupted frame received session_id[%d]"), _sessionID);
+			return false;
+		}
 
-		} else {
-			uint16 packetSize = _buildingPacket->GetPacketSize();
-			if (packetSize > _buildingPacket->GetCapacity()) {
-				_buildingPacket->Resize(packetSize);
+		uint32 packetSize = frame.GetSize();
+		int64 timestamp = (int64)FPlatformTime::Cycles64();
+		++_stats.packetsReceived;
+
+		// envelopes are decoded where they lie in the ring, only the message they carry gets a packet.
+		// the few frames that wrap around the end take the copying path below
+		if (frame.IsWrapped() == false) {
+			FNetPacketView view(frame.head, packetSize);
+			uint16 msgID = view.GetMsgID();
+			if (FFrameUnwrapper::IsEnvelope(msgID)) {
+				FNetTelemetry::Get().RecordReceived(msgID, packetSize);
+				if (FNetCapture::Get().IsCapturing()) {
+					FNetCapture::Get().Append(ENetCaptureDirection::Received, _sessionID, timestamp, frame.head, packetSize);
+				}
+
+				TSharedPacket packet;
+				auto unwrapped = _unwrapper.Unwrap(view, _sessionID, timestamp, packet);
+				_recvBuffer.Consume(packetSize);
+				++_stats.framesInPlace;
+
+				if (unwrapped == FFrameUnwrapper::EResult::Corrupted) {
+					UE_LOG(LogClientNet, Error, TEXT("corrupted envelope received session_id[%d] msg_id[0x%x]"), _sessionID, msgID);
+					return false;
+				}
+
+				if (unwrapped == FFrameUnwrapper::EResult::Ready && Deliver(packet) == false) {
+					break;
+				}
+				continue;
 			}
-			remains = packetSize - _buildingPacket->GetWrPos();
 		}
 
-		check(remains > 0 && remains <= MAX_MESSIVE_BUF_SIZE);
+		TSharedPacket packet = FNetPacketPool::Get().AllocFrame(packetSize);
+		frame.CopyTo(packet->GetPacketBuffer());
+		_recvBuffer.Consume(packetSize);
+		++_stats.framesCopied;
 
-		if (_socket->Recv(_buildingPacket->GetWrBuffer(), remains, bytesRead) == false) {
-			_buildingPacket.Reset();
+		packet->IncWrPos(packetSize);
+		packet->SetRdPos(0);
+		packet->SetSessionID(_sessionID);
+		packet->SetTimestamp(timestamp);
+
+		FNetTelemetry::Get().RecordReceived(packet->GetMsgID(), packetSize);
+		if (FNetCapture::Get().IsCapturing()) {
+			FNetCapture::Get().Append(ENetCaptureDirection::Received, _sessionID, timestamp, packet->GetPacketBuffer(), packetSize);
+		}
+
+		// unwrapped here so the handlers and the dispatcher only ever see the original message
+		uint16 msgID = packet->GetMsgID();
+		auto unwrapped = _unwrapper.Unwrap(packet);
+		if (unwrapped == FFrameUnwrapper::EResult::Corrupted) {
+			UE_LOG(LogClientNet, Error, TEXT("corrupted envelope received session_id[%d] msg_id[0x%x]"), _sessionID, msgID);
 			return false;
 		}
-		
-		if (bytesRead == 0) {
+
+		if (unwrapped == FFrameUnwrapper::EResult::Pending) {
+			continue;
+		}
+
+		if (Deliver(packet) == false) {
+			break;
+		}
+	}
+
+	return true;
+}
+
+void FSession::SetSendFlushBytes(uint32 bytes)
+{
+	_sendFlushBytes = FMath::Max<uint32>(bytes, MSG_HEADER_SIZE);
+
+	// any single frame still has to fit behind a partially sent batch
+	size_t capacity = (size_t)_sendFlushBytes + MAX_MESSIVE_BUF_SIZE + MSG_HEADER_SIZE;
+	if (_sendBuffer.size() < capacity) {
+		_sendBuffer.resize(capacity);
+	}
+}
+
+uint32 FSession::GatherSendingPackets()
+{
+	// move the unsent tail of the previous batch to the front
+	if (_sendCursor > 0) {
+		_sendPending -= _sendCursor;
+		if (_sendPending > 0) {
+			::memmove(&_sendBuffer[0], &_sendBuffer[_sendCursor], _sendPending);
+		}
+		_sendCursor = 0;
+	}
+
+	uint32 gathered = 0;
+	TSharedPacket* next = nullptr;
+	while (_sendPending < _sendFlushBytes) {
+
+		// queued packets always go ahead of the next slice of a streamed body
+		next = _sendingQueue.Peek();
+		if (next == nullptr) {
+			uint32 frameSize = _fragmenter.WriteNext(&_sendBuffer[_sendPending], (uint32)_sendBuffer.size() - _sendPending);
+			if (frameSize == 0) {
+				break;
+			}
+
+			if (FNetCapture::Get().IsCapturing()) {
+				FNetCapture::Get().Append(ENetCaptureDirection::Sent, _sessionID, FPlatformTime::Cycles64(), &_sendBuffer[_sendPending], frameSize);
+			}
+
+			_sendPending += frameSize;
+			++gathered;
+			FNetTelemetry::Get().RecordSent(FRAMEWORKMSG_FRAGMENT, frameSize);
+			continue;
+		}
+
+		uint32 packetSize = (*next)->GetPacketSize();
+		if (_sendPending + packetSize > _sendBuffer.size()) {
 			break;
 		}
 
-		_buildingPacket->IncWrPos(bytesRead);
+		::memcpy(&_sendBuffer[_sendPending], (*next)->GetPacketBuffer(), packetSize);
+		if (FNetCapture::Get().IsCapturing()) {
+			FNetCapture::Get().Append(ENetCaptureDirection::Sent, _sessionID, FPlatformTime::Cycles64(), &_sendBuffer[_sendPending], packetSize);
+		}
+		_sendPending += packetSize;
+		++gathered;
 
-		if (_buildingPacket->IsReceivingPacketCompleted()) {
-			_buildingPacket->SetRdPos(0);
-			_receivedQueue.ExecuteIfBound(_buildingPacket);
-			_buildingPacket.Reset();
+		FNetTelemetry::Get().RecordSent((*next)->GetMsgID(), packetSize);
+		if ((*next)->GetCompactSavings() != 0) {
+			FNetTelemetry::Get().RecordCompactSavings((*next)->GetMsgID(), (*next)->GetCompactSavings(), true);
 		}
+
+		_sendingQueue.Pop();
 	}
 
-	return true;
+	return gathered;
 }
 
 bool FSession::Sending()
 {
-	TSharedPacket packet;
-	while (_sendingQueue.Dequeue(packet)) {
+	_stats.lastPumpBytesSent = 0;
+	_stats.lastPumpPacketsSent = 0;
 
-		int32 remainBytes = packet->GetPacketSize();
-		uint8* buffer = packet->GetPacketBuffer();
+	while (true)
+	{
+		_stats.lastPumpPacketsSent += GatherSendingPackets();
+		if (_sendPending == 0) {
+			break;
+		}
 
-		while (remainBytes > 0) {
+		int32 sent = 0;
+		if (_socket->Send(&_sendBuffer[_sendCursor], _sendPending - _sendCursor, sent) == false) {
+			ESocketErrors err = UClientNet::_socketSubsystem->GetLastErrorCode();
+			UE_LOG(LogClientNet, Error, TEXT("failed to send session_id[%d] error[%d]"), _sessionID, (int32)err);
+			return false;
+		}
+		++_stats.sendCalls;
 
-			int32 sent = 0;
-			if (_socket->Send(buffer, remainBytes, sent) == false) {
-				ESocketErrors err = UClientNet::_socketSubsystem->GetLastErrorCode();
-				packet.Reset();
-				return false;
-			}
+		check(_sendPending - _sendCursor >= (uint32)sent);
+		_sendCursor += sent;
+		_stats.lastPumpBytesSent += sent;
 
-			check(remainBytes >= sent);
-			remainBytes -= sent;
-			buffer += sent;
+		// would block or partially sent, the rest is resumed on the next pump
+		if (_sendCursor < _sendPending) {
+			break;
 		}
 	}
 
+	_stats.bytesSent += _stats.lastPumpBytesSent;
+	_stats.packetsSent += _stats.lastPumpPacketsSent;
 	return true;
 }
@@ -0,0 +1,78 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "SessionResume.h"
+#include "HAL/IConsoleManager.h"
+
+#include "framework_msg_define.h"
+
+TAutoConsoleVariable<bool> CVar_ClientNetResume(TEXT("ClientNet.Resume"), true, TEXT("offer session resume during setup cord, a reconnect replays the missing tail instead of a full resync"));
+TAutoConsoleVariable<int32> CVar_ClientNetResumeBufferPackets(TEXT("ClientNet.Resume.BufferPackets"), 2048, TEXT("unacknowledged content packets kept for a replay after reconnect"));
+TAutoConsoleVariable<int32> CVar_ClientNetResumeBufferBytes(TEXT("ClientNet.Resume.BufferBytes"), 256 * 1024, TEXT("bytes of unacknowledged content packets kept for a replay after reconnect"));
+TAutoConsoleVariable<int32> CVar_ClientNetResumeAckEvery(TEXT("ClientNet.Resume.AckEvery"), 32, TEXT("received content packets between two sequence acks, heartbeats ack whatever is left"));
+
+FString FSessionResumeStats::ToString() const
+{
+	return FString::Printf(TEXT("[resumes:%llu] [resyncs:%llu] [replayed:%llu] [replayedBytes:%llu] [evicted:%llu]"),
+		resumes, resyncs, replayedPackets, replayedBytes, evicted);
+}
+
+uint8 FSessionResume::GetOfferedCapabilities()
+{
+	return CVar_ClientNetResume.GetValueOnAnyThread() ? FRAMEWORK_CAPABILITY_RESUME : 0;
+}
+
+void FSessionResume::Reset(bool enabled)
+{
+	_enabled = enabled;
+	_window.Reset();
+}
+
+void FSessionResume::OnSent(const TSharedPacket& packet)
+{
+	if (_enabled == false) {
+		return;
+	}
+
+	uint32 maxPackets = (uint32)FMath::Max(CVar_ClientNetResumeBufferPackets.GetValueOnAnyThread(), 0);
+	uint64 maxBytes = (uint64)FMath::Max(CVar_ClientNetResumeBufferBytes.GetValueOnAnyThread(), 0);
+	_stats.evicted += _window.OnSent(packet, packet->GetPacketSize(), maxPackets, maxBytes);
+}
+
+bool FSessionResume::OnReceived()
+{
+	if (_enabled == false) {
+		return false;
+	}
+
+	return _window.OnReceived((uint32)FMath::Max(CVar_ClientNetResumeAckEvery.GetValueOnAnyThread(), 1));
+}
+
+void FSessionResume::Acknowledge(uint32 received)
+{
+	_window.Acknowledge(received);
+}
+
+uint32 FSessionResume::TakeAck()
+{
+	return _enabled ? _window.TakeAck() : 0;
+}
+
+bool FSessionResume::CollectReplay(uint32 received, TArray<TSharedPacket>& packets) const
+{
+	uint32 count = 0;
+	if (_window.CountReplay(received, count) == false) {
+		return false;
+	}
+
+	packets.Reset(count);
+	return _window.CollectReplay(received, [&packets](const TSharedPacket& packet, uint32) { packets.Add(packet); });
+}
+
+void FSessionResume::RecordResumed(const TArray<TSharedPacket>& replayed)
+{
+	++_stats.resumes;
+	_stats.replayedPackets += replayed.Num();
+	for (const TSharedPacket& packet : replayed) {
+		_stats.replayedBytes += packet->GetPacketSize();
+	}
+}
@@ -0,0 +1,60 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "SnapshotBatch.h"
+
+static_assert(sizeof(NetCore::SnapshotRecord::location) == sizeof(FVector3f), "location unit is copied as one FVector3f");
+
+void FSnapshotBatch::Reset()
+{
+	Guids.Reset();
+	SyncStates.Reset();
+	Locations.Reset();
+	Rotations.Reset();
+	Motions.Reset();
+	SkillGUIDs.Reset();
+	ControllersEnabled.Reset();
+}
+
+bool FSnapshotBatch::Decode(const TSharedPacket& packet, SnapshotDeltaBaselines* baselines)
+{
+	// records are read by their fixed layout
+	if (packet->IsCompact()) {
+		Reset();
+		return false;
+	}
+
+	return Decode(packet->GetBufferAt(MSG_HEADER_SIZE), packet->GetBodySize(), baselines);
+}
+
+bool FSnapshotBatch::Decode(const uint8* body, uint32 bodySize, SnapshotDeltaBaselines* baselines)
+{
+	Reset();
+	if (NetCore::DecodeSnapshotRecords(body, bodySize, baselines, *this) == false) {
+		Reset();
+		return false;
+	}
+	return true;
+}
+
+void FSnapshotBatch::Begin(uint16 count)
+{
+	Guids.SetNumUninitialized(count, EAllowShrinking::No);
+	SyncStates.SetNumUninitialized(count, EAllowShrinking::No);
+	Locations.SetNumUninitialized(count, EAllowShrinking::No);
+	Rotations.SetNumUninitialized(count, EAllowShrinking::No);
+	Motions.SetNumUninitialized(count, EAllowShrinking::No);
+	SkillGUIDs.SetNumUninitialized(count, EAllowShrinking::No);
+	ControllersEnabled.SetNumUninitialized(count, EAllowShrinking::No);
+}
+
+void FSnapshotBatch::Add(uint16 index, const NetCore::SnapshotRecord& record)
+{
+	// the record comes zeroed where it carried no unit, every entry is written
+	Guids[index] = record.guid;
+	SyncStates[index] = record.syncState;
+	::memcpy(&Locations[index], record.location, sizeof(FVector3f));
+	Rotations[index] = record.rotation;
+	Motions[index] = record.motion;
+	SkillGUIDs[index] = record.skillGUID;
+	ControllersEnabled[index] = record.controllerEnabled;
+}
@@ -0,0 +1,198 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#include "SnapshotCoalescer.h"
+#include "PacketPool.h"
+
+#include "anu_global_def.h"
+
+namespace
+{
+	constexpr uint32 MaxPatchBodySize = MAX_MESSIVE_BUF_SIZE - MSG_HEADER_SIZE;
+	constexpr uint8 LocationUnits = SNAPSHOT_SYNC_LOCATION | SNAPSHOT_SYNC_ROTATION | SNAPSHOT_SYNC_DELTA_LOCATION;
+
+	uint32 GetRecordSize(uint8 syncState)
+	{
+		return sizeof(SnapshotPatchGUID) + (uint32)AmbiguousSnapshotData::CompressedSz(syncState);
+	}
+}
+
+FString FSnapshotCoalescerStats::ToString() const
+{
+	return FString::Printf(TEXT("[packets in:%llu] [packets out:%llu] [passed through:%llu] [patches in:%llu] [merged:%llu] [delivered:%llu]"),
+		packetsIn, packetsOut, passedThrough, patchesIn, patchesMerged, patchesDelivered);
+}
+
+FSnapshotCoalescer::FSnapshotCoalescer()
+{
+	for (uint8 size : SnapshotDataUnitSizes) {
+		check(size <= sizeof(FRecord::units[0]));
+	}
+
+	// skill is an event, two casts in one frame must both reach the handler
+	_mergeableMask = SNAPSHOT_SYNC_ROTATION | SNAPSHOT_SYNC_LOCATION | SNAPSHOT_SYNC_MOTION | SNAPSHOT_SYNC_CONTROLLER;
+}
+
+void FSnapshotCoalescer::Coalesce(TArray<TSharedPacket>& batch)
+{
+	if (_enabled == false) {
+		return;
+	}
+
+	bool patched = false;
+	for (const TSharedPacket& packet : batch) {
+		if (packet->GetMsgID() == MOVE_SNAPSHOT_PATCH_NFY) {
+			patched = true;
+			break;
+		}
+	}
+
+	if (patched == false) {
+		return;
+	}
+
+	TArray<TSharedPacket> coalesced;
+	coalesced.Reserve(batch.Num());
+
+	// only a run of consecutive patches is folded, anything else between them (a spawn, a despawn, a skill result)
+	// closes the run so no patch moves across it
+	int32 sessionID = 0;
+	for (TSharedPacket& packet : batch) {
+		if (packet->GetMsgID() == MOVE_SNAPSHOT_PATCH_NFY) {
+			++_stats.packetsIn;
+			if (Merge(packet)) {
+				sessionID = packet->GetSessionID();
+				continue;
+			}
+
+			++_stats.passedThrough;
+		}
+
+		Flush(coalesced, sessionID);
+		coalesced.Emplace(MoveTemp(packet));
+	}
+
+	Flush(coalesced, sessionID);
+	batch = MoveTemp(coalesced);
+}
+
+bool FSnapshotCoalescer::Merge(TSharedPacket& packet)
+{
+	// records are read by their fixed layout
+	if (packet->IsCompact()) {
+		return false;
+	}
+
+	const uint8* body = packet->GetBufferAt(MSG_HEADER_SIZE);
+	uint32 bodySize = packet->GetBodySize();
+	if (bodySize < sizeof(uint16)) {
+		return false;
+	}
+
+	uint16 count = 0;
+	::memcpy(&count, body, sizeof(uint16));
+
+	// validate the whole body before touching any record
+	uint32 offset = sizeof(uint16);
+	for (uint16 i = 0; i < count; ++i) {
+		if (offset + sizeof(SnapshotPatchGUID) + sizeof(uint8) > bodySize) {
+			return false;
+		}
+
+		offset += GetRecordSize(body[offset + sizeof(SnapshotPatchGUID)]);
+		if (offset > bodySize) {
+			return false;
+		}
+	}
+
+	if (offset != bodySize) {
+		return false;
+	}
+
+	offset = sizeof(uint16);
+	for (uint16 i = 0; i < count; ++i) {
+		SnapshotPatchGUID guid = 0;
+		::memcpy(&guid, body + offset, sizeof(SnapshotPatchGUID));
+
+		uint8 syncState = body[offset + sizeof(SnapshotPatchGUID)];
+		const uint8* unit = body + offset + sizeof(SnapshotPatchGUID) + sizeof(uint8);
+		offset += GetRecordSize(syncState);
+
+		++_stats.patchesIn;
+
+		FRecord* record = nullptr;
+		if (int32* open = _openRecords.Find(guid)) {
+			FRecord& candidate = _records[*open];
+			// a delta is relative to everything before it, it can not be folded with another location of the object
+			bool deltaOrdered = ((candidate.syncState | syncState) & SNAPSHOT_SYNC_DELTA_LOCATION) != 0
+				&& (candidate.syncState & LocationUnits) != 0 && (syncState & LocationUnits) != 0;
+			if ((candidate.syncState & syncState & ~_mergeableMask) == 0 && deltaOrdered == false) {
+				record = &candidate;
+				++_stats.patchesMerged;
+			}
+		}
+
+		if (record == nullptr) {
+			int32 index = _records.AddDefaulted();
+			_openRecords.Add(guid, index);
+
+			record = &_records[index];
+			record->guid = guid;
+		}
+
+		for (uint8 bit = 0; bit < 8; ++bit) {
+			if ((syncState & (1 << bit)) == 0) {
+				continue;
+			}
+
+			::memcpy(record->units[bit], unit, SnapshotDataUnitSizes[bit]);
+			unit += SnapshotDataUnitSizes[bit];
+		}
+		record->syncState |= syncState;
+	}
+
+	return true;
+}
+
+void FSnapshotCoalescer::Flush(TArray<TSharedPacket>& merged, int32 sessionID)
+{
+	int32 begin = 0;
+	while (begin < _records.Num()) {
+		// sized up front so the writes never grow the buffer
+		uint32 bodySize = sizeof(uint16);
+		int32 end = begin;
+		while (end < _records.Num() && end - begin < MAX_uint16) {
+			uint32 recordSize = GetRecordSize(_records[end].syncState);
+			if (bodySize + recordSize > MaxPatchBodySize) {
+				break;
+			}
+			bodySize += recordSize;
+			++end;
+		}
+
+		uint16 count = (uint16)(end - begin);
+		TSharedPacket packet = FNetPacketPool::Get().Alloc(MOVE_SNAPSHOT_PATCH_NFY, (uint16)bodySize);
+		packet->SetSessionID(sessionID);
+		*packet << count;
+
+		for (int32 i = begin; i < end; ++i) {
+			const FRecord& record = _records[i];
+			*packet << record.guid << record.syncState;
+
+			for (uint8 bit = 0; bit < 8; ++bit) {
+				if ((record.syncState & (1 << bit)) != 0) {
+					packet->WriteBytes(record.units[bit], SnapshotDataUnitSizes[bit]);
+				}
+			}
+		}
+
+		packet->FinalizeHeader();
+		merged.Emplace(MoveTemp(packet));
+		++_stats.packetsOut;
+		_stats.patchesDelivered += count;
+
+		begin = end;
+	}
+
+	_records.Reset();
+	_openRecords.Reset();
+}
@@ -9,10 +9,22 @@
 
 #include "Worker.h"
 #include "NetPacket.h"
+#include "PacketPool.h"
 #include "Session.h"
 #include "WebSession.h"
 #include "Timer.h"
 #include "Security.h"
+#include "NetPoller.h"
+#include "NetConnect.h"
+#include "NetQueue.h"
+#include "PacketDispatcher.h"
+#include "PacketHandlerTable.h"
+#include "SnapshotCoalescer.h"
+#include "SessionResume.h"
+#include "NetClock.h"
+#include "anu_snapshot_delta.h"
+#include "NetTelemetry.h"
+#include "NetCapture.h"
 
 #include "ClientNet.generated.h"
 
@@ -22,7 +34,6 @@ class IHttpRequest;
 
 struct CLIENTNET_API FWebSession;
 
-DECLARE_DELEGATE_OneParam(FOnPacket, TSharedPacket);
 DECLARE_DELEGATE_OneParam(FOnWebSocketPacket, TSharedWebSocketPacket);
 DEFINE_LOG_CATEGORY_STATIC(LogClientNet, Verbose, All);
 
@@ -42,6 +53,7 @@ DEFINE_LOG_CATEGORY_STATIC(LogClientNet, Verbose, All);
 #define CLIENTNETMSG_INTERNAL_SECURITY_ERROR		(uint16)0x0E
 #define CLIENTNETMSG_INTERNAL_DISCONTINUE_SESSION	(uint16)0x0F
 #define CLIENTNETMSG_INTERNAL_CONTENT_SERVICE_SHUTDOWN	(uint16)0x10
+#define CLIENTNETMSG_INTERNAL_RESUME_SESSION		(uint16)0x11
 
 #define REGISTER_PACKET_HANDLER(className, msg) \
 	AddPacketHandler(msg, FOnPacket::CreateUObject(this, &className::On##msg))
@@ -168,6 +180,23 @@ struct CLIENTNET_API FClientAccountInfo
 
 using SessionInfo = TPair<int32, TSharedPtr<FSession>>;
 
+// progress of UClientNet::StartReplay
+struct FNetReplay
+{
+	FNetCaptureReader reader;
+	FFrameUnwrapper unwrapper;
+	bool realtime = false;
+
+	FNetCaptureRecordHeader pending;
+	const uint8* pendingFrame = nullptr;
+	uint32 pendingSize = 0;
+
+	uint64 firstCycles = 0;
+	double startSeconds = 0.0;
+	uint64 frames = 0;
+	uint64 bytes = 0;
+};
+
 UCLASS()
 class CLIENTNET_API UClientNet : public UGameInstanceSubsystem
 {
@@ -182,12 +211,17 @@ private:
 	FQueuedThreadPool* _workerThreadPooler = nullptr;
 	FAsyncTask<FNetAsyncTask>* _mainWorker = nullptr;
 
-	TQueue<SessionInfo> _connectionIssues;
+	TNetMpscQueue<SessionInfo> _connectionIssues{ 256 };
+	// connectors with their timeout, handed to the connect driver of the pump
+	TNetMpscQueue<TPair<TSharedPtr<FConnector>, float>> _connectRequests{ 256 };
+	// pump thread only
+	TUniquePtr<FNetConnectDriver> _connectDriver;
 
 	FEvent* _shutdownEvent = nullptr;
+	TUniquePtr<FNetPoller> _poller;
 	FClientNetTimer _timer;
 
-	TMap<uint16, FOnPacket> _handlers;
+	FPacketHandlerTable _handlers;
 	FOnPacket _contentHandlers;
 
 	TMap<int32, TSharedPtr<FSession>> _sessions;
@@ -195,14 +229,35 @@ private:
 	TMap<int32, UWebSession*> _webSessions;
 	TMap<int32, TSharedPtr<FConnector>> _connectings;
 
-	TQueue<TPair<int32, TSharedPacket>> _postPendingQueue;
-	TQueue<TSharedPacket> _receivedQueue;
-	TQueue<TSharedPacket> _contentMsgQueue;
+	TNetMpscQueue<TPair<int32, TSharedPacket>> _postPendingQueue{ 4096 };
+	// a full queue holds the sessions back, the pump stops reading them until Tick drained it
+	TNetMpscQueue<TSharedPacket> _receivedQueue{ 16384 };
+	// notices raised on the game thread while the received queue was full, consumed behind it in order
+	TArray<TSharedPacket> _receivedOverflow;
+	// pump thread only, disconnect notices the full received queue did not take yet
+	TArray<TSharedPacket> _pumpNotices;
+	// game thread only
+	TArray<TSharedPacket> _contentMsgQueue;
+	TArray<TSharedPacket> _dispatchBatch;
+	FPacketDispatcher _dispatcher;
+	FSnapshotCoalescer _snapshotCoalescer;
+	// SNAPSHOT_SYNC_DELTA_LOCATION baselines of the server session, game thread only
+	SnapshotDeltaBaselines _snapshotBaselines;
+	TUniquePtr<FNetReplay> _replay;
+	// content messages sent with MSG_FLAG_IDFIELD_COMPACT
+	TBitArray<> _compactOpcodes{ false, 0x10000 };
 
 	TOptional<FString> _addr;
 	TOptional<int32> _port;
 	TOptional<int32> _serverSession;
 	bool _sessionEstablished = false;
+	// FRAMEWORK_CAPABILITY_* offered in setup cord and the subset the server enabled
+	uint8 _offeredCapabilities = 0;
+	uint8 _capabilities = 0;
+	// content messages of the server session numbered across reconnects
+	FSessionResume _resume;
+	// round trip and server clock from the heartbeats
+	FNetClock _clock;
 
 	FClientAccountInfo* _accountInfo = nullptr;
 	TSet<int32> _activeWorldIDs;
@@ -218,7 +273,9 @@ private:
 	FString _webSocketAddress;
 	TSet<int32> _authorizedWebSessions;
 
-	bool _simulateDisconnect = false;
+	// packets the server session still sends before a simulated disconnect, -1 when none is pending
+	std::atomic<int32> _simulateDisconnect{ -1 };
+	std::atomic<int32> _simulateDisconnectSession{ 0 };
 
 public:
 	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
@@ -240,10 +297,49 @@ public:
 	void RegisterPacketHandlers();
 	void SetExternalHandler(FOnPacket handler);
 
+	// content dispatch limits, framework and movement messages are never deferred
+	void SetDispatchBudget(const FNetDispatchBudget& budget) { _dispatcher.SetBudget(budget); }
+	void SetDispatchPriority(uint16 msgID, ENetDispatchPriority priority) { _dispatcher.SetPriority(msgID, priority); }
+	const FNetDispatchStats& GetDispatchStats() const { return _dispatcher.GetStats(); }
+
+	// merges the snapshot patches of a frame into one update per object, off by default
+	void SetSnapshotCoalescing(bool enabled) { _snapshotCoalescer.SetEnabled(enabled); }
+	const FSnapshotCoalescerStats& GetSnapshotCoalescerStats() const { return _snapshotCoalescer.GetStats(); }
+	// handed to FSnapshotBatch::Decode, dropped whenever a new server session is set up
+	SnapshotDeltaBaselines& GetSnapshotBaselines() { return _snapshotBaselines; }
+
+	// varint bodies for a content message, the server has to accept the compact flag for it
+	void SetCompactEncoding(uint16 msgID, bool enabled);
+
+	// feeds the received frames of a capture (FNetCapture) through the receive queue, ConsumePacket and the content handlers,
+	// paced by the recorded timestamps or as fast as the queue takes them. meant to run without a live server session
+	bool StartReplay(const FString& path, bool realtime);
+	void StopReplay();
+	bool IsReplaying() const { return _replay.IsValid(); }
+
 	TSharedPtr<FConnector> CreateConnector(const FString& addr, int32 port);
 
 	TSharedPacket AllocPacket(uint16 msgID, int32 sessionID = 0);
+	// exact sized packet carrying a generated message body
+	template <typename TBody, typename TEnableIf<std::is_class_v<TBody>, void*>::Type = nullptr>
+	TSharedPacket AllocPacket(const TBody& body, int32 sessionID = 0)
+	{
+		TSharedPacket packet = FNetPacketPool::Get().Alloc(TBody::MsgID, (uint32)body.GetEncodedSize());
+		packet->SetSessionID(sessionID);
+		packet->WriteBody(body);
+		return packet;
+	}
 	bool SendPacket(TSharedPacket& packet, bool framework = false);
+	const FSessionResumeStats& GetResumeStats() const { return _resume.GetStats(); }
+
+	// heartbeat estimate of the link to the server session, plain reads cheap enough for every frame
+	const FNetClockEstimate& GetClockEstimate() const { return _clock.GetEstimate(); }
+	double GetRoundTripSeconds() const { return _clock.GetRoundTripSeconds(); }
+	double GetJitterSeconds() const { return _clock.GetJitterSeconds(); }
+	// server clock in microseconds, the local clock until the first heartbeat was answered
+	int64 GetServerTimeMicros() const { return _clock.GetServerTimeMicros(); }
+	// heartbeats go out at ClientNet.Clock.FastProbeInterval while set, for combat and other timing critical phases
+	void SetLatencySensitive(bool sensitive) { _clock.SetLatencySensitive(sensitive); }
 
 	bool HasConnection();
 	const TSet<int32>& GetActiveServerIDs() { return _activeWorldIDs; }
@@ -264,18 +360,29 @@ public:
 	void SetExternalHandler(FOnWebSocketPacket handler);
 
 	void TestDisconnect();
+	// drops the server connection once that many more packets went out, a burst is cut in the middle with a count above 0
+	void TestDisconnect(int32 afterSentPackets);
 
 private:
 	bool OpenConnection(TSharedPtr<FConnector> connector, float timeout = 0);
 	void StartPumpNetIO();
+	void WakeupPump();
 
 	void OnConnectCompleted(TSharedPtr<FSession> session, ConnectResult result);
 	void OnDisconnected(TSharedPtr<FSession> session);
+	// game thread producers of the received queue
+	void PostReceived(TSharedPacket packet);
+	// pump thread, true once every pending notice went into the received queue
+	bool FlushPumpNotices();
 
 	void SendHeartbeats();
+	void SendSequenceAck();
+	// compresses and queues a checked packet for the pump
+	bool PostPacket(const TSharedPacket& packet);
 	void ScheduleSessionTokenRenewal();
 
 	bool ConsumePacket(TSharedPacket packet);
+	void TickReplay();
 	void OnUnhandledMsg(TSharedPacket packet);
 
 	void AddPacketHandler(uint16 msg, const FOnPacket& handler);
@@ -295,6 +402,8 @@ private:
 	void OnFRAMEWORKMSG_DISCONTINUE_SESSION(TSharedPacket);
 	void OnFRAMEWORKMSG_RENEWAL_SESSION_ACK(TSharedPacket);
 	void OnFRAMEWORKMSG_REPAIR_SESSION_ACK(TSharedPacket);
+	void OnFRAMEWORKMSG_RESUME_SESSION_ACK(TSharedPacket);
+	void OnFRAMEWORKMSG_SEQUENCE_ACK(TSharedPacket);
 	void OnFRAMEWORKMSG_HANDOVER_ACK(TSharedPacket);
 
 	void OnFRAMEWORKMSG_SECURITY_EXCHANGE_ACK(TSharedPacket);
@@ -307,6 +416,7 @@ private:
 	void Request_LOGIN();
 	void Request_RENEWAL_SESSION();
 	void Request_REPAIR_SESSION();
+	void Request_RESUME_SESSION();
 	void Reqeust_SECURITY_EXCHANGE();
 	
 	// websocket internal
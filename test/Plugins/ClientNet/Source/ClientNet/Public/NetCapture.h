@@ -0,0 +1,94 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "Async/MappedFileHandle.h"
+
+#include <atomic>
+
+#define NET_CAPTURE_MAGIC		(uint32)0x50434E41	// "ANCP"
+#define NET_CAPTURE_VERSION		(uint16)1
+
+enum class ENetCaptureDirection : uint8
+{
+	Received,
+	Sent,
+};
+
+#pragma pack(push, 1)
+
+// start of a capture file, records follow back to back
+struct FNetCaptureFileHeader
+{
+	uint32 magic = NET_CAPTURE_MAGIC;
+	uint16 version = NET_CAPTURE_VERSION;
+	uint16 reserved = 0;
+	// of the capturing machine, the record stamps are FPlatformTime::Cycles64()
+	double secondsPerCycle = 0.0;
+};
+
+// followed by the frame exactly as it was on the wire, [uint16 bodySize][uint16 msgID][body]
+struct FNetCaptureRecordHeader
+{
+	uint64 cycles = 0;
+	int32 sessionID = 0;
+	ENetCaptureDirection direction = ENetCaptureDirection::Received;
+	uint8 reserved[3] = {};
+};
+
+#pragma pack(pop)
+
+// every frame the sessions receive and send, appended by the pump thread.
+// records gather in memory and reach the file in large writes, a frame never waits on the disk.
+class CLIENTNET_API FNetCapture
+{
+public:
+	static FNetCapture& Get();
+
+	// game thread, Saved/Profiling/ClientNet/capture-<date>.ncap when path is empty
+	bool Start(const FString& path = FString());
+	void Stop();
+	bool IsCapturing() const { return _capturing.load(std::memory_order_relaxed); }
+
+	void Append(ENetCaptureDirection direction, int32 sessionID, uint64 cycles, const uint8* frame, uint32 frameSize);
+
+private:
+	FNetCapture() = default;
+
+	void FlushLocked();
+
+private:
+	mutable FCriticalSection _lock;
+	TUniquePtr<IFileHandle> _file;
+	TArray<uint8> _staging;
+	FString _path;
+	uint64 _records = 0;
+	uint64 _bytes = 0;
+
+	std::atomic<bool> _capturing{ false };
+};
+
+// reads a capture through a memory mapping, frames point into it until Close
+class CLIENTNET_API FNetCaptureReader
+{
+public:
+	bool Open(const FString& path);
+	void Close();
+
+	// false at the end or on a truncated record
+	bool Next(FNetCaptureRecordHeader& record, const uint8*& frame, uint32& frameSize);
+	void Rewind() { _cursor = sizeof(FNetCaptureFileHeader); }
+
+	double GetSecondsPerCycle() const { return _secondsPerCycle; }
+
+private:
+	TUniquePtr<IMappedFileHandle> _mapped;
+	TUniquePtr<IMappedFileRegion> _region;
+	const uint8* _data = nullptr;
+	int64 _size = 0;
+	int64 _cursor = 0;
+	double _secondsPerCycle = 0.0;
+};
@@ -0,0 +1,46 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+
+#include "netcore_clock.h"
+
+using FNetClockEstimate = NetCore::ClockEstimate;
+
+// heartbeat probes and the round trip and server clock estimate they feed, game thread only.
+// a probe goes out every ClientNet.Clock.ProbeInterval seconds, every ClientNet.Clock.FastProbeInterval while the estimate
+// settles or the content asked for latency sensitive timing
+class CLIENTNET_API FNetClock
+{
+public:
+	// the local clock the probes carry, microseconds of FPlatformTime::Cycles64() like the packet timestamps
+	static int64 CyclesToMicros(uint64 cycles);
+	static int64 NowMicros() { return CyclesToMicros(FPlatformTime::Cycles64()); }
+
+	// a new server connection, another server may run another clock
+	void Reset();
+	void SetLatencySensitive(bool sensitive);
+	bool IsLatencySensitive() const { return _latencySensitive; }
+
+	bool IsProbeDue(double now) const { return now >= _nextProbe; }
+	// client stamp of the probe about to go out
+	int64 OnProbeSent(double now);
+	// receivedCycles is the timestamp of the answer packet, taken by the pump as it arrived
+	bool OnProbeAnswered(int64 clientSent, int64 serverReceived, int64 serverSent, int64 receivedCycles);
+
+	const FNetClockEstimate& GetEstimate() const { return _estimator.GetEstimate(); }
+	double GetRoundTripSeconds() const { return GetEstimate().rtt / 1000000.0; }
+	double GetJitterSeconds() const { return GetEstimate().jitter / 1000000.0; }
+	// the server clock right now, the local one until a probe was answered
+	int64 GetServerTimeMicros() const { return NowMicros() + GetEstimate().offset; }
+
+private:
+	double GetProbeInterval() const;
+
+	NetCore::ClockEstimator _estimator;
+	double _lastProbe = 0.0;
+	double _nextProbe = 0.0;
+	bool _latencySensitive = false;
+};
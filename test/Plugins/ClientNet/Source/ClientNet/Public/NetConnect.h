@@ -0,0 +1,168 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include "netcore_connect.h"
+
+class FSocket;
+class FInternetAddr;
+class FNetPoller;
+struct FConnector;
+struct FSession;
+enum class ConnectResult : uint8;
+
+#define NET_CONNECT_HISTOGRAM_BUCKETS		16
+
+struct CLIENTNET_API FNetResolveResult
+{
+	// interleaved by family in the order connect attempts should start (RFC 8305)
+	TArray<TSharedRef<FInternetAddr>> addresses;
+	bool cached = false;
+
+	bool IsEmpty() const { return addresses.Num() == 0; }
+};
+
+// non blocking host resolution with a cache of ClientNet.Connect.DnsTTL seconds.
+// a literal address never reaches the resolver, lookups of a host already in flight share its result
+class CLIENTNET_API FNetResolver
+{
+public:
+	using FOnResolved = TFunction<void(const FNetResolveResult&)>;
+
+	static FNetResolver& Get();
+
+	// callback runs right away on a cache hit, otherwise on the thread that finished the lookup
+	void Resolve(const FString& host, FOnResolved&& callback);
+	void Flush();
+
+private:
+	FNetResolver() = default;
+
+	void OnResolved(const FString& key, TArray<TSharedRef<FInternetAddr>>&& addresses, double started);
+
+	struct FEntry
+	{
+		TArray<TSharedRef<FInternetAddr>> addresses;
+		double expires = 0.0;
+	};
+
+	FCriticalSection _lock;
+	TMap<FString, FEntry> _cache;
+	TMap<FString, TArray<FOnResolved>> _inFlight;
+};
+
+// every FConnector in flight as a state machine of the pump thread, see NetCore::ConnectDriver: resolving, racing the
+// addresses (Happy Eyeballs), waiting out the backoff. the attempts are non blocking FSockets the poller wakes the pump for
+// once their handshake ended, lookups go through FNetResolver. pump thread only, except for the resolver callbacks.
+class CLIENTNET_API FNetConnectDriver
+{
+public:
+	using FOnCompleted = TFunction<void(const TSharedPtr<FSession>&, ConnectResult)>;
+
+	FNetConnectDriver(FNetPoller* poller, FOnCompleted&& onCompleted);
+	~FNetConnectDriver();
+
+	// timeout 0 keeps retrying until the attempts are used up
+	void Start(const TSharedPtr<FConnector>& connector, float timeout, double now);
+	// moves every connect as far as it can go, completed ones are reported and dropped
+	void Advance(double now) { _driver.Advance(now); }
+	// connects still pending are dropped without a report, their connector promise resolves when it is released
+	void CancelAll() { _driver.CancelAll(); }
+
+	bool IsEmpty() const { return _driver.IsEmpty(); }
+	// msec the pump may wait before a deadline of some connect is due
+	uint32 GetWaitMsec(double now) const { return _driver.GetWaitMsec(now); }
+
+private:
+	// filled by the resolver thread, which wakes the poller unless the pump already gave up on the lookup
+	struct FResolveSlot
+	{
+		FCriticalSection lock;
+		FNetPoller* poller = nullptr;
+		bool ready = false;
+		bool abandoned = false;
+		FNetResolveResult result;
+
+		void Abandon();
+	};
+
+	// the engine side of the core driver, settings come from the ClientNet.Connect CVars
+	class FTransport
+	{
+	public:
+		using Socket = FSocket*;
+		using Address = TSharedPtr<FInternetAddr>;
+
+		struct Context
+		{
+			TSharedPtr<FConnector> connector;
+			TSharedPtr<FResolveSlot, ESPMode::ThreadSafe> resolving;
+		};
+
+		FNetPoller* poller = nullptr;
+		FOnCompleted onCompleted;
+
+		NetCore::ConnectSettings GetSettings();
+		double Random();
+
+		bool Open(const Address& address, Socket& socket);
+		NetCore::AttemptState Check(Socket& socket);
+		void Close(Socket& socket);
+		void OnAttempt(const Address& address, double seconds, NetCore::AttemptState ended);
+
+		void BeginResolve(Context& context);
+		bool TakeResolved(Context& context, std::vector<Address>& addresses);
+		void AbandonResolve(Context& context);
+
+		void OnTryFailed(Context& context, NetCore::TryFailure failure, double retryIn);
+		void OnCompleted(Context& context, NetCore::ConnectOutcome outcome, Socket* socket, const Address* address, double seconds);
+	};
+
+	// the driver keeps a reference to the transport
+	FTransport _transport;
+	NetCore::ConnectDriver<FTransport> _driver;
+};
+
+struct CLIENTNET_API FNetConnectStats
+{
+	uint64 resolves = 0;
+	uint64 resolveCacheHits = 0;
+	uint64 resolveFailures = 0;
+	uint64 attempts = 0;
+	uint64 attemptFailures = 0;
+	uint64 connects = 0;
+	uint64 retires = 0;
+
+	// bucket n counts latencies below 2^n msec, the last one everything above
+	uint64 resolveHistogram[NET_CONNECT_HISTOGRAM_BUCKETS] = {};
+	uint64 connectHistogram[NET_CONNECT_HISTOGRAM_BUCKETS] = {};
+	// from OpenConnection to the connected socket, resolution and retries included
+	uint64 totalHistogram[NET_CONNECT_HISTOGRAM_BUCKETS] = {};
+
+	FString ToString() const;
+};
+
+// connections are rare, one lock is cheap enough
+class CLIENTNET_API FNetConnectTelemetry
+{
+public:
+	static FNetConnectTelemetry& Get();
+
+	void RecordResolve(double seconds, bool cached, bool failed);
+	void RecordAttempt(double seconds, bool connected);
+	void RecordCompleted(double seconds, bool connected);
+
+	FNetConnectStats GetStats() const;
+	void Reset();
+
+private:
+	FNetConnectTelemetry() = default;
+
+	static void AddToHistogram(uint64 (&histogram)[NET_CONNECT_HISTOGRAM_BUCKETS], double seconds);
+
+	mutable FCriticalSection _lock;
+	FNetConnectStats _stats;
+};
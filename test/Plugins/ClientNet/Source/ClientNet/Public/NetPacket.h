@@ -14,24 +14,48 @@
 #include "framework_msg_define.h"
 #include "anu_msg_define.h"
 
+#include "NetVarint.h"
+#include "NetString.h"
+
+// element types whose wire form is exactly their memory image, containers of them are copied with one memcpy.
+// structs opt in with NETPACKET_BULK_SERIALIZABLE only when no custom operator << / >> exists for them.
+// the trait is the protocol core's, so FNetPacketView and the core reader agree on it
+template <typename T>
+using TIsNetPacketBulkSerializable = NetCore::IsBulkSerializable<T>;
+
+#define NETPACKET_BULK_SERIALIZABLE(Type)															\
+template <> struct NetCore::IsBulkSerializable<Type>												\
+{																									\
+	static_assert(std::is_trivially_copyable_v<Type>, #Type " must be trivially copyable");		\
+	static constexpr bool Value = true;																\
+};
+
 class CLIENTNET_API FNetPacket
 {
 public:
 	FNetPacket();
 	FNetPacket(uint16 id);
+	FNetPacket(uint16 id, size_t capacity);
 	~FNetPacket();
 
 private:
 	std::vector<uint8> _buffer;
-	uint16 _rdCur = 0;
-	uint16 _wrCur = 0;
+	// 32 bit so a body can outgrow one frame, Session streams those as FRAMEWORKMSG_FRAGMENT
+	uint32 _rdCur = 0;
+	uint32 _wrCur = 0;
 
 	int32 _sessionID = 0;
 	int64 _timestamp = 0;
+	// bytes the compact encoding saved, or would save on a fixed width body while estimating
+	int32 _compactSavings = 0;
 
 public:
+	// fixed width bodies count what compact encoding would save them, for the telemetry report
+	static bool bEstimateCompactSavings;
+
 	void Reset();
-	void Resize(uint16 size);
+	void Resize(uint32 size);
+	void Recycle(size_t capacity);
 
 	void WriteBuff(IFileHandle* fileHandle);
 	bool ReadBuff(IFileHandle* fileHandle);
@@ -41,12 +65,34 @@ public:
 	void ClearHeader() { ::memset(&_buffer[0], 0, MSG_HEADER_SIZE); }
 
 	void SetMsgID(uint16 wMsgID) { *((uint16*)&_buffer[MSG_OFFSET_ID]) = wMsgID; }
-	uint16 GetMsgID() const { return *((uint16*)&_buffer[MSG_OFFSET_ID]); }
+	// the compact flag rides in the id field, handlers only ever see the plain id
+	uint16 GetMsgID() const { return *((uint16*)&_buffer[MSG_OFFSET_ID]) & ~MSG_FLAG_IDFIELD_COMPACT; }
+
+	// forwards the body under another id without copying it, the compact flag stays since the layout does not change
+	void Retag(uint16 msgID)
+	{
+		uint16& field = *((uint16*)&_buffer[MSG_OFFSET_ID]);
+		field = (field & MSG_FLAG_IDFIELD_COMPACT) | msgID;
+		_rdCur = MSG_HEADER_SIZE;
+	}
 
-	uint16 GetBodySize() const { return *((uint16*)&_buffer[MSG_OFFSET_SIZE]); }
-	uint16 GetPacketSize() const { return GetBodySize() + MSG_HEADER_SIZE; }
-	uint16 GetAvailableBufSize() { return (uint16)(_buffer.size() - _wrCur); }
+	// only before the first write, the flag decides how the body is laid out
+	void SetCompact(bool compact);
+	bool IsCompact() const { return IS_COMPACT_MSG(*((uint16*)&_buffer[MSG_OFFSET_ID])); }
+	int32 GetCompactSavings() const { return _compactSavings; }
+
+	uint32 GetBodySize() const
+	{
+		uint16 size = *((uint16*)&_buffer[MSG_OFFSET_SIZE]);
+		return size == MSG_BODY_SIZE_STREAMED ? _wrCur - MSG_HEADER_SIZE : size;
+	}
+	uint32 GetPacketSize() const { return GetBodySize() + MSG_HEADER_SIZE; }
+	uint32 GetAvailableBufSize() { return (uint32)(_buffer.size() - _wrCur); }
+	// body larger than one frame may carry
+	bool IsStreamed() const { return _wrCur > (uint32)MAX_MESSIVE_BUF_SIZE + MSG_HEADER_SIZE; }
 	void SetDataSizeAtHeader(uint16 size);
+	// writes do not touch the header, the size is stamped once before the packet leaves
+	void FinalizeHeader() { SetDataSizeAtHeader(IsStreamed() ? MSG_BODY_SIZE_STREAMED : (uint16)(_wrCur - MSG_HEADER_SIZE)); }
 
 	bool IsReceivingPacketCompleted();
 
@@ -55,6 +101,7 @@ public:
 	int32 GetSessionID() { return _sessionID; }
 
 	void RecordTimestamp();
+	void SetTimestamp(int64 timestamp) { _timestamp = timestamp; }
 	int64 GetTimestamp() { return _timestamp; }
 
 	bool IsFromRemote() { return _sessionID != 0; }
@@ -62,33 +109,42 @@ public:
 
 	////////////////////////////////////////////////////
 	// buffer offset
-	bool SetRdPos(uint16 pos);
-	bool SetWrPos(uint16 pos);
+	bool SetRdPos(uint32 pos);
+	bool SetWrPos(uint32 pos);
 
-	uint16 GetRdPos() { return _rdCur; }
-	uint16 GetWrPos() { return _wrCur; }
+	uint32 GetRdPos() { return _rdCur; }
+	uint32 GetWrPos() { return _wrCur; }
 
-	void IncRdPos(uint16 pos) { _rdCur += pos; }
-	void IncWrPos(uint16 pos) { _wrCur += pos; }
+	void IncRdPos(uint32 pos) { _rdCur += pos; }
+	void IncWrPos(uint32 pos) { _wrCur += pos; }
 
-	void DecRdPos(uint16 pos) { _rdCur -= pos; }
-	void DecWrPos(uint16 pos) { _wrCur -= pos; }
+	void DecRdPos(uint32 pos) { _rdCur -= pos; }
+	void DecWrPos(uint32 pos) { _wrCur -= pos; }
 
 	bool AllDataRead() { return (_rdCur == _wrCur); }
-	uint16 GetRemainBytesToRead() { return (_wrCur - _rdCur); }
+	uint32 GetRemainBytesToRead() { return (_wrCur - _rdCur); }
 	void ForceStopRead() { _rdCur = _wrCur; }
 
 	////////////////////////////////////////////////////
 	// buffer pointer
-	void ReadBytes(void* buf, uint16 size);
-	void WriteBytes(const void* buf, uint16 size);
-	void ReadBytesReverse(void* buf, uint16 size);
+	void ReadBytes(void* buf, uint32 size);
+	// false when the body would pass MAX_STREAMED_MSG_SIZE, nothing is written then
+	bool WriteBytes(const void* buf, uint32 size);
+	// room for size more bytes at the write cursor, same limit as WriteBytes
+	bool Reserve(uint32 size);
+
+	// utf8 with one length prefix, encoded straight into the buffer
+	void WriteString(const TCHAR* str, int32 len);
+	// decoded straight into the storage of str
+	void ReadString(FString& str);
+	void ReadString(FName& name);
+	void ReadBytesReverse(void* buf, uint32 size);
 
 	size_t GetCapacity() { return _buffer.size(); }
 	uint8* GetRdBuffer() { return &_buffer.at(_rdCur); }
 	uint8* GetWrBuffer() { return &_buffer.at(_wrCur); }
 
-	uint8* GetBufferAt(uint16 offset)
+	uint8* GetBufferAt(uint32 offset)
 	{
 		return &_buffer.at(offset);
 	}
@@ -98,8 +154,195 @@ public:
 		return &_buffer.at(0);
 	}
 
+	// copies the body of src, forwarding a whole received body is cheaper with Retag
 	uint16 CopyMsg(FNetPacket* src);
 
+	template <typename T>
+	void WriteArray(const T* items, uint16 count)
+	{
+		static_assert(TIsNetPacketBulkSerializable<T>::Value, "WriteArray needs a bulk serializable element type");
+
+		if constexpr (TIsNetPacketVarint<T>::Value) {
+			if (IsCompact()) {
+				WriteVarintArray(items, count);
+				return;
+			}
+			EstimateCompactSavings(items, count);
+		}
+
+		size_t size = (size_t)count * sizeof(T);
+		if (size == 0) {
+			return;
+		}
+
+		if (size > MAX_STREAMED_MSG_SIZE) {
+			check(false);
+			return;
+		}
+
+		WriteBytes(items, (uint32)size);
+	}
+
+	template <typename T>
+	bool ReadArray(T* items, uint16 count)
+	{
+		static_assert(TIsNetPacketBulkSerializable<T>::Value, "ReadArray needs a bulk serializable element type");
+
+		if constexpr (TIsNetPacketVarint<T>::Value) {
+			if (IsCompact()) {
+				return ReadVarintArray(items, count);
+			}
+			EstimateCompactSavings(items, count);
+		}
+
+		size_t size = (size_t)count * sizeof(T);
+		if (GetRdPos() + size > GetWrPos()) {
+			check(false);
+			return false;
+		}
+
+		if (size > 0) {
+			::memcpy((uint8*)items, GetRdBuffer(), size);
+			IncRdPos((uint32)size);
+		}
+		return true;
+	}
+
+	// generated message bodies (framework_msg_struct.h), encoded in place with a single reservation
+	template <typename TBody>
+	bool WriteBody(const TBody& body)
+	{
+		size_t size = body.GetEncodedSize();
+		if (_wrCur + size > MAX_STREAMED_MSG_SIZE) {
+			check(false);
+			return false;
+		}
+
+		if (GetAvailableBufSize() < size) {
+			_buffer.resize(_wrCur + size);
+		}
+
+		body.Encode(_buffer.data() + _wrCur);
+		IncWrPos((uint32)size);
+		return true;
+	}
+
+	template <typename TBody>
+	bool ReadBody(TBody& body)
+	{
+		size_t consumed = 0;
+		if (body.Decode(_buffer.data() + _rdCur, GetRemainBytesToRead(), consumed) == false) {
+			return false;
+		}
+
+		IncRdPos((uint32)consumed);
+		return true;
+	}
+
+	////////////////////////////////////////////////////
+	// compact encoding, see MSG_FLAG_IDFIELD_COMPACT
+	template <typename T>
+	void WriteVarint(T value)
+	{
+		uint8 bytes[NET_VARINT_MAX_SIZE];
+		uint8* end = FNetVarint::Encode(FNetVarint::ToWire(value), bytes);
+		WriteBytes(bytes, (uint32)(end - bytes));
+		_compactSavings += (int32)sizeof(T) - (int32)(end - bytes);
+	}
+
+	template <typename T>
+	bool ReadVarint(T& value)
+	{
+		const uint8* begin = _buffer.data() + _rdCur;
+		uint64_t wire = 0;
+		const uint8* end = FNetVarint::Decode(begin, _buffer.data() + _wrCur, wire);
+		if (end == nullptr) {
+			return false;
+		}
+
+		value = FNetVarint::FromWire<T>(wire);
+		IncRdPos((uint32)(end - begin));
+		_compactSavings += (int32)sizeof(T) - (int32)(end - begin);
+		return true;
+	}
+
+	template <typename T>
+	void WriteVarintArray(const T* items, uint16 count)
+	{
+		// worst case reserved once, the tail is given back after encoding
+		size_t reserve = (size_t)count * NET_VARINT_MAX_SIZE;
+		if (GetAvailableBufSize() < reserve) {
+			size_t capacity = FMath::Min<size_t>(_wrCur + reserve, MAX_STREAMED_MSG_SIZE);
+			if (_buffer.size() < capacity) {
+				_buffer.resize(capacity);
+			}
+		}
+
+		uint8* begin = _buffer.data() + _wrCur;
+		uint8* cur = begin;
+		uint8* limit = _buffer.data() + _buffer.size();
+		for (uint16 i = 0; i < count; ++i) {
+			if (limit - cur < NET_VARINT_MAX_SIZE) {
+				check(false);
+				break;
+			}
+			cur = FNetVarint::Encode(FNetVarint::ToWire(items[i]), cur);
+		}
+
+		IncWrPos((uint32)(cur - begin));
+		_compactSavings += (int32)(count * sizeof(T)) - (int32)(cur - begin);
+	}
+
+	template <typename T>
+	bool ReadVarintArray(T* items, uint16 count)
+	{
+		const uint8* begin = _buffer.data() + _rdCur;
+		const uint8* cur = begin;
+		if (FNetVarint::DecodeArray(cur, _buffer.data() + _wrCur, items, count) == false) {
+			check(false);
+			return false;
+		}
+
+		IncRdPos((uint32)(cur - begin));
+		_compactSavings += (int32)(count * sizeof(T)) - (int32)(cur - begin);
+		return true;
+	}
+
+	// fixed width or varint by the compact flag, false when the body is short
+	template <class T>
+	bool TryRead(T& arg)
+	{
+		if constexpr (TIsNetPacketVarint<T>::Value) {
+			if (IsCompact()) {
+				return ReadVarint(arg);
+			}
+		}
+
+		uint16 size = sizeof(T);
+		if ((GetRdPos() + size) > GetWrPos()) {
+			return false;
+		}
+
+		::memcpy((uint8*)&arg, GetRdBuffer(), size);
+		IncRdPos(size);
+
+		if constexpr (TIsNetPacketVarint<T>::Value) {
+			EstimateCompactSavings(&arg, 1);
+		}
+		return true;
+	}
+
+private:
+	template <typename T>
+	void EstimateCompactSavings(const T* items, uint16 count)
+	{
+		if (bEstimateCompactSavings) {
+			for (uint16 i = 0; i < count; ++i) {
+				_compactSavings += FNetVarint::Savings(items[i]);
+			}
+		}
+	}
+
 public:
 	template <class T>
 	void ReadBytesReverseEx(T& arg)
@@ -113,21 +356,15 @@ public:
 		DecWrPos(size);
 		::memcpy((uint8*)&arg, GetWrBuffer(), size);
 
-		SetDataSizeAtHeader(GetWrPos() - MSG_HEADER_SIZE);
+		FinalizeHeader();
 	}
 
 	template <class T>
 	void ReadBytesEx(T& arg)
 	{
-		uint16 size = sizeof(T);
-		if ((GetRdPos() + size) > GetWrPos()) {
+		if (TryRead(arg) == false) {
 			check(false);
-			return;
 		}
-
-		::memcpy((uint8*)&arg, GetRdBuffer(), size);
-
-		IncRdPos(size);
 	}
 
 	template <class T>
@@ -144,6 +381,14 @@ public:
 	template <class T>
 	FNetPacket& operator << (const T& arg)
 	{
+		if constexpr (TIsNetPacketVarint<T>::Value) {
+			if (IsCompact()) {
+				WriteVarint(arg);
+				return *this;
+			}
+			EstimateCompactSavings(&arg, 1);
+		}
+
 		WriteBytes((void*)&arg, sizeof(T));
 		return *this;
 	}
@@ -158,7 +403,7 @@ public:
 	FNetPacket& operator << (const char* rhs)
 	{
 		uint16 size = (!rhs) ? 0 : (uint16)(::strlen(rhs));
-		WriteBytes(&size, sizeof(uint16));
+		*this << size;
 
 		if (size < 1) {
 			return *this;
@@ -171,7 +416,7 @@ public:
 	FNetPacket& operator << (const wchar_t* rhs)
 	{
 		uint16 size = (!rhs) ? 0 : (uint16)(::wcslen(rhs));
-		WriteBytes(&size, sizeof(uint16));
+		*this << size;
 
 		if (size < 1) {
 			return *this;
@@ -190,7 +435,7 @@ public:
 	FNetPacket& operator >> (std::wstring& str)
 	{
 		uint16 size = 0;
-		ReadBytes(&size, sizeof(uint16));
+		TryRead(size);
 		if (size > 0) {
 			if (size > GetRemainBytesToRead()) {
 				size = GetRemainBytesToRead();
@@ -214,7 +459,7 @@ public:
 	FNetPacket& operator >> (std::string& str)
 	{
 		uint16 size = 0;
-		ReadBytes(&size, sizeof(uint16));
+		TryRead(size);
 		if (size > 0) {
 			if (size > GetRemainBytesToRead()) {
 				size = GetRemainBytesToRead();
@@ -231,30 +476,29 @@ public:
 	//--------------------------------------------------------------
 	FNetPacket& operator << (const FString& str)
 	{
-		std::string string{ TCHAR_TO_UTF8(*str) };
-		return *this << string.c_str();
+		WriteString(*str, str.Len());
+		return *this;
 	}
 
 	FNetPacket& operator >> (FString& str)
 	{
-		std::string temp;
-		*this >> temp;
-		str = UTF8_TO_TCHAR(temp.c_str());
+		ReadString(str);
 		return *this;
 	}
 
 	//--------------------------------------------------------------
 	FNetPacket& operator << (const FName& str)
 	{
-		std::string string{ TCHAR_TO_UTF8(*str.ToString()) };
-		return *this << string.c_str();
+		// the name entry is copied out once, no FString in between
+		TStringBuilder<FName::StringBufferSize> builder;
+		str.AppendString(builder);
+		WriteString(builder.GetData(), builder.Len());
+		return *this;
 	}
 
 	FNetPacket& operator >> (FName& str)
 	{
-		std::string temp;
-		*this >> temp;
-		str = UTF8_TO_TCHAR(temp.c_str());
+		ReadString(str);
 		return *this;
 	}
 
@@ -264,8 +508,14 @@ public:
 	{
 		uint16 count = vector.size();
 		*this << count;
-		for (uint16 idx = 0; idx < count; ++idx) {
-			*this << vector[idx];
+
+		// vector<bool> is packed into bits, it keeps the element path
+		if constexpr (TIsNetPacketBulkSerializable<T>::Value && !std::is_same_v<T, bool>) {
+			WriteArray(vector.data(), count);
+		} else {
+			for (uint16 idx = 0; idx < count; ++idx) {
+				*this << vector[idx];
+			}
 		}
 		return *this;
 	}
@@ -276,9 +526,14 @@ public:
 		uint16 count = 0;
 		*this >> count;
 
-		vector.resize(count);
-		for (uint16 i = 0; i < count; ++i) {
-			*this >> vector[i];
+		if constexpr (TIsNetPacketBulkSerializable<T>::Value && !std::is_same_v<T, bool>) {
+			vector.resize(count);
+			ReadArray(vector.data(), count);
+		} else {
+			vector.resize(count);
+			for (uint16 i = 0; i < count; ++i) {
+				*this >> vector[i];
+			}
 		}
 		return *this;
 	}
@@ -288,8 +543,13 @@ public:
 	{
 		uint16 count = vector.Num();
 		*this << count;
-		for (uint16 idx = 0; idx < count; ++idx) {
-			*this << vector[idx];
+
+		if constexpr (TIsNetPacketBulkSerializable<T>::Value) {
+			WriteArray(vector.GetData(), count);
+		} else {
+			for (uint16 idx = 0; idx < count; ++idx) {
+				*this << vector[idx];
+			}
 		}
 		return *this;
 	}
@@ -300,9 +560,16 @@ public:
 		uint16 count = 0;
 		*this >> count;
 
-		vector.SetNum(count);
-		for (uint16 i = 0; i < count; ++i) {
-			*this >> vector[i];
+		if constexpr (TIsNetPacketBulkSerializable<T>::Value) {
+			vector.SetNumUninitialized(count);
+			if (ReadArray(vector.GetData(), count) == false) {
+				vector.Reset();
+			}
+		} else {
+			vector.SetNum(count);
+			for (uint16 i = 0; i < count; ++i) {
+				*this >> vector[i];
+			}
 		}
 		return *this;
 	}
@@ -397,13 +664,8 @@ public:
 	}
 
 #define _GET_TYPED_VALUE(type)              \
-	uint16 length = sizeof(type);           \
-    if ((GetRdPos() + length) > GetWrPos()) { \
-		return 0;                           \
-	}                                       \
-	type temp;                              \
-	::memcpy((uint8*)&temp, GetRdBuffer(), length); \
-	IncRdPos(length);                       \
+	type temp = 0;                          \
+	TryRead(temp);                          \
 	return temp;
 
 #define _GET_STRING_VALUE(type)              \
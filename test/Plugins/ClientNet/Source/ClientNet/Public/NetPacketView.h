@@ -0,0 +1,67 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NetPacket.h"
+
+#include "netcore_reader.h"
+
+// read only view of one frame, [uint16 bodySize][uint16 msgID][body], that is owned by someone else: the session receive
+// ring, a capture mapping or a packet. the decoding is the protocol core's reader (netcore_reader.h) with the same rules as
+// FNetPacket, this adds the engine containers. bytes come from the wire, so a short read does not assert,
+// it leaves the value zeroed and marks the view failed, IsValid tells after the last read.
+class FNetPacketView : public NetCore::TPacketReader<FNetPacketView>
+{
+	using Super = NetCore::TPacketReader<FNetPacketView>;
+
+public:
+	using Super::Super;
+	using Super::operator>>;
+
+	FNetPacketView() = default;
+
+	// the unread part of a packet, the packet cursor does not move
+	explicit FNetPacketView(FNetPacket& packet)
+		: Super(packet.GetPacketBuffer(), packet.GetWrPos(), packet.GetRdPos())
+	{
+	}
+
+	// converted straight from the frame, no std::string in between
+	FNetPacketView& operator >> (FString& str)
+	{
+		uint32 size = ReadLength();
+		FNetString::DecodeUtf8(GetRdBuffer(), size, str);
+		_rdCur += size;
+		return *this;
+	}
+
+	FNetPacketView& operator >> (FName& str)
+	{
+		uint32 size = ReadLength();
+		str = FNetString::DecodeName(GetRdBuffer(), size);
+		_rdCur += size;
+		return *this;
+	}
+
+	template <typename T>
+	FNetPacketView& operator >> (TArray<T>& vector)
+	{
+		uint16 count = 0;
+		*this >> count;
+
+		if constexpr (TIsNetPacketBulkSerializable<T>::Value) {
+			vector.SetNumUninitialized(count);
+			if (ReadArray(vector.GetData(), count) == false) {
+				vector.Reset();
+			}
+		} else {
+			vector.SetNum(count);
+			for (uint16 i = 0; i < count; ++i) {
+				*this >> vector[i];
+			}
+		}
+		return *this;
+	}
+};
@@ -0,0 +1,33 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FSocket;
+
+// readiness wait for the network pump, wakes on socket readability, writability asked for with SetInterest(),
+// connect completion, Wakeup() or timeout
+class CLIENTNET_API FNetPoller
+{
+public:
+	static TUniquePtr<FNetPoller> Create();
+
+	virtual ~FNetPoller() {}
+
+	// false when the platform can not watch the socket and the pump has to poll it
+	virtual bool Register(FSocket* socket) = 0;
+	// a socket with a non blocking connect on its way, wakes once the handshake ended either way.
+	// unregister it before it is registered for readability
+	virtual bool RegisterConnect(FSocket* socket) = 0;
+	virtual void Unregister(FSocket* socket) = 0;
+	// interest of a registered socket: readable unless the pump holds its reads back, writable while its session has an
+	// unsent tail. neither unregisters it. false when the platform can not watch the socket and the pump has to poll it
+	virtual bool SetInterest(FSocket* socket, bool readable, bool writable) = 0;
+
+	virtual void Wait(uint32 timeoutMsec) = 0;
+	virtual void Wakeup() = 0;
+
+	// true when socket readability wakes Wait(), otherwise the caller has to poll with a short timeout
+	virtual bool IsReadinessDriven() const = 0;
+};
@@ -0,0 +1,22 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "netcore_mpsc.h"
+
+// bounded multi producer / single consumer ring, see NetCore::MpscQueue
+template <typename T>
+class TNetMpscQueue : public NetCore::MpscQueue<T>
+{
+public:
+	using NetCore::MpscQueue<T>::MpscQueue;
+	using NetCore::MpscQueue<T>::DequeueAll;
+
+	// consumer only, appends everything published so far
+	uint32 DequeueAll(TArray<T>& items)
+	{
+		return NetCore::MpscQueue<T>::DequeueAll([&items](T&& item) { items.Emplace(MoveTemp(item)); });
+	}
+};
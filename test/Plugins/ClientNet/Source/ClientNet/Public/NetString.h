@@ -0,0 +1,86 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "netcore_utf8.h"
+
+// TCHAR <-> UTF-8 of the packet strings, [uint16 byte length][utf8 bytes] on the wire.
+// chat, nicknames and dialog text are mostly ASCII, those runs are narrowed and widened sixteen characters at a time
+// and only the rest goes through FPlatformString.
+struct FNetString
+{
+	// utf8 bytes of str
+	static int32 Utf8Length(const TCHAR* str, int32 len)
+	{
+		int32 ascii = AsciiPrefix(str, len);
+		return ascii == len ? len : ascii + FPlatformString::ConvertedLength<UTF8CHAR>(str + ascii, len - ascii);
+	}
+
+	// out holds exactly Utf8Length(str, len) bytes
+	static void EncodeUtf8(const TCHAR* str, int32 len, uint8* out, int32 size)
+	{
+		int32 ascii = AsciiPrefix(str, len);
+		NarrowAscii(str, out, ascii);
+		if (ascii < len) {
+			FPlatformString::Convert((UTF8CHAR*)out + ascii, size - ascii, str + ascii, len - ascii);
+		}
+	}
+
+	// characters of the decoded utf8
+	static int32 DecodedLength(const uint8* utf8, int32 size)
+	{
+		int32 ascii = AsciiPrefix(utf8, size);
+		return ascii == size ? size : ascii + FPlatformString::ConvertedLength<TCHAR>((const UTF8CHAR*)utf8 + ascii, size - ascii);
+	}
+
+	// out holds exactly DecodedLength(utf8, size) characters, no terminator is written
+	static void DecodeUtf8(const uint8* utf8, int32 size, TCHAR* out, int32 len)
+	{
+		int32 ascii = AsciiPrefix(utf8, size);
+		WidenAscii(utf8, out, ascii);
+		if (ascii < size) {
+			FPlatformString::Convert(out + ascii, len - ascii, (const UTF8CHAR*)utf8 + ascii, size - ascii);
+		}
+	}
+
+	// straight into the storage of str, which keeps its allocation when it is large enough
+	static void DecodeUtf8(const uint8* utf8, int32 size, FString& str)
+	{
+		int32 len = DecodedLength(utf8, size);
+		if (len == 0) {
+			str.Reset();
+			return;
+		}
+
+		auto& chars = str.GetCharArray();
+		chars.SetNumUninitialized(len + 1, EAllowShrinking::No);
+		DecodeUtf8(utf8, size, chars.GetData(), len);
+		chars[len] = TEXT('\0');
+	}
+
+	// ASCII names are looked up from the bytes as they are, FName keeps those narrow anyway
+	static FName DecodeName(const uint8* utf8, int32 size)
+	{
+		if (AsciiPrefix(utf8, size) == size) {
+			return FName(size, (const ANSICHAR*)utf8);
+		}
+
+		TArray<TCHAR, TInlineAllocator<NAME_SIZE>> chars;
+		chars.SetNumUninitialized(DecodedLength(utf8, size));
+		DecodeUtf8(utf8, size, chars.GetData(), chars.Num());
+		return FName(chars.Num(), chars.GetData());
+	}
+
+	////////////////////////////////////////////////////
+	// ASCII runs, see NetCore::Utf8
+
+	static int32 AsciiPrefix(const TCHAR* str, int32 len) { return (int32)NetCore::Utf8::AsciiPrefix(str, (uint32)len); }
+	static int32 AsciiPrefix(const uint8* utf8, int32 size) { return (int32)NetCore::Utf8::AsciiPrefix(utf8, (uint32)size); }
+
+	// count characters known to be ASCII
+	static void NarrowAscii(const TCHAR* str, uint8* out, int32 count) { NetCore::Utf8::NarrowAscii(str, out, (uint32)count); }
+	// count bytes known to be ASCII
+	static void WidenAscii(const uint8* utf8, TCHAR* out, int32 count) { NetCore::Utf8::WidenAscii(utf8, out, (uint32)count); }
+};
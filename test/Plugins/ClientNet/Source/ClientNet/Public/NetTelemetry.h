@@ -0,0 +1,124 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include <atomic>
+
+#define NET_TELEMETRY_HISTOGRAM_BUCKETS		16
+
+// aggregated counters of one message id
+struct CLIENTNET_API FNetOpcodeTelemetry
+{
+	uint16 msgID = 0;
+	FString name;
+
+	uint64 countIn = 0;
+	uint64 bytesIn = 0;
+	uint64 countOut = 0;
+	uint64 bytesOut = 0;
+
+	uint64 handled = 0;
+	uint64 handlerCycles = 0;
+	uint64 handlerMaxCycles = 0;
+	// bucket n counts handler times below 2^n usec, the last one everything above
+	uint64 handlerHistogram[NET_TELEMETRY_HISTOGRAM_BUCKETS] = {};
+
+	uint64 dwellCycles = 0;
+	uint64 dwellMaxCycles = 0;
+
+	// bytes compact encoding saved, or would save while ClientNet.Telemetry.CompactEstimate is on
+	int64 compactSavedIn = 0;
+	int64 compactSavedOut = 0;
+
+	// lz4 envelopes sent and received, plus trial compressions while ClientNet.Compression.Probe is on
+	uint64 lz4Count = 0;
+	uint64 lz4RawBytes = 0;
+	uint64 lz4WireBytes = 0;
+	uint64 lz4CompressCycles = 0;
+	uint64 lz4DecompressCycles = 0;
+};
+
+// always on per message id counters.
+// every thread writes its own block without atomic read-modify-write, readers sum the blocks.
+class CLIENTNET_API FNetTelemetry
+{
+public:
+	static FNetTelemetry& Get();
+
+	void RecordReceived(uint16 msgID, uint32 bytes);
+	void RecordSent(uint16 msgID, uint32 bytes);
+	// cycles of the handler call, timestamp is the cycle stamp taken when the frame left the receive buffer, 0 when unknown
+	void RecordHandled(uint16 msgID, uint64 startCycles, uint64 endCycles, int64 timestamp);
+	// negative when the varints came out longer than the fixed width fields
+	void RecordCompactSavings(uint16 msgID, int32 bytes, bool outgoing);
+	// msgID of the original body, wire bytes include the envelope fields
+	void RecordCompression(uint16 msgID, uint32 rawBytes, uint32 wireBytes, uint64 compressCycles, uint64 decompressCycles);
+
+	TArray<FNetOpcodeTelemetry> Snapshot() const;
+	void Reset();
+
+	FString ToCSV() const;
+	FString ToJSON() const;
+	bool Dump(const FString& format) const;
+
+	// game thread, drives the periodic dump
+	void Tick(float deltaTime);
+
+private:
+	FNetTelemetry();
+
+	struct FCounters
+	{
+		std::atomic<uint64> countIn;
+		std::atomic<uint64> bytesIn;
+		std::atomic<uint64> countOut;
+		std::atomic<uint64> bytesOut;
+		std::atomic<uint64> handled;
+		std::atomic<uint64> handlerCycles;
+		std::atomic<uint64> handlerMaxCycles;
+		std::atomic<uint64> handlerHistogram[NET_TELEMETRY_HISTOGRAM_BUCKETS];
+		std::atomic<uint64> dwellCycles;
+		std::atomic<uint64> dwellMaxCycles;
+		std::atomic<uint64> compactSavedIn;
+		std::atomic<uint64> compactSavedOut;
+		std::atomic<uint64> lz4Count;
+		std::atomic<uint64> lz4RawBytes;
+		std::atomic<uint64> lz4WireBytes;
+		std::atomic<uint64> lz4CompressCycles;
+		std::atomic<uint64> lz4DecompressCycles;
+	};
+
+	struct FBlock
+	{
+		TUniquePtr<FCounters[]> counters;
+	};
+
+	FCounters& GetCounters(uint16 msgID);
+	FBlock& GetThreadBlock();
+
+	static void Add(std::atomic<uint64>& counter, uint64 value)
+	{
+		// single writer, a plain load and store is enough and never locks the bus
+		counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+	}
+
+	static void Max(std::atomic<uint64>& counter, uint64 value)
+	{
+		if (value > counter.load(std::memory_order_relaxed)) {
+			counter.store(value, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	// msgID to dense slot, slot 0 collects the ids nobody registered
+	TArray<uint16> _slotOf;
+	TArray<uint16> _msgIDOf;
+
+	mutable FCriticalSection _blocksLock;
+	TArray<FBlock*> _blocks;
+
+	float _dumpElapsed = 0.f;
+};
@@ -0,0 +1,20 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "netcore_timer.h"
+
+// deadlines of the pump thread, see NetCore::TimerHeap. GetWaitMsec returns MAX_uint32 when empty
+class FNetTimerHeap : public NetCore::TimerHeap
+{
+public:
+	using NetCore::TimerHeap::PopExpired;
+
+	// keys whose deadline passed, earliest first
+	void PopExpired(double now, TArray<int32>& keys)
+	{
+		NetCore::TimerHeap::PopExpired(now, [&keys](int32 key) { keys.Add(key); });
+	}
+};
@@ -0,0 +1,16 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "netcore_varint.h"
+
+#define NET_VARINT_MAX_SIZE		NETCORE_VARINT_MAX_SIZE
+
+// integer types a compact packet sends as LEB128, signed ones zigzagged first.
+// single byte types gain nothing and keep their raw form.
+template <typename T>
+using TIsNetPacketVarint = NetCore::IsVarintSerializable<T>;
+
+using FNetVarint = NetCore::Varint;
@@ -0,0 +1,28 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NetPacket.h"
+#include "NetPacketView.h"
+
+// lz4 envelope of large bodies, FRAMEWORKMSG_COMPRESSED carries the original id and body size ahead of one lz4 block.
+// both sides only send it once FRAMEWORK_CAPABILITY_LZ4 was agreed during FRAMEWORKMSG_SETUP_CORD.
+class CLIENTNET_API FPacketCompression
+{
+public:
+	// capabilities offered in FRAMEWORKMSG_SETUP_CORD
+	static uint8 GetOfferedCapabilities();
+	static uint32 GetThreshold();
+
+	// envelope of a finalized packet, null when the body is small or does not shrink
+	static TSharedPacket Compress(const TSharedPacket& packet);
+	// original packet with the session and timestamp of the envelope, null on a corrupted envelope
+	static TSharedPacket Decompress(const TSharedPacket& envelope);
+	// straight out of a view on the receive ring, the caller stamps session and timestamp
+	static TSharedPacket Decompress(FNetPacketView envelope);
+
+	// trial compression of a received body for the telemetry report, the packet is left untouched
+	static void Probe(const TSharedPacket& packet);
+};
@@ -0,0 +1,93 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NetPacket.h"
+
+enum class ENetDispatchPriority : uint8
+{
+	Critical,	// internal, framework, spawn / despawn and movement, never deferred
+	Normal,
+	Bulk,		// first to spill into later frames
+	Max
+};
+
+// per frame limits for the non critical classes, 0 disables a limit
+struct CLIENTNET_API FNetDispatchBudget
+{
+	uint32 timeUsec = 4000;
+	uint32 packets = 0;
+	// bulk packets dispatched every frame even when the budget is spent, keeps bulk from starving
+	uint32 minBulkPackets = 8;
+};
+
+struct CLIENTNET_API FNetDispatchStats
+{
+	// last frame
+	uint32 backlog[(uint8)ENetDispatchPriority::Max] = {};
+	uint32 dispatched = 0;
+	uint32 spilled = 0;
+	double elapsedUsec = 0;
+
+	// accumulated
+	uint64 totalDispatched = 0;
+	uint64 totalSpilled = 0;
+	uint32 spilledFrames = 0;
+	uint32 peakBacklog = 0;
+
+	FString ToString() const;
+};
+
+// game thread only, holds received content packets by priority class and hands them out within a per frame budget.
+// packets of one class are dispatched in the order they arrived. across classes there is no order: Critical goes out
+// the frame it arrives and overtakes Normal and Bulk spilled from earlier frames, Normal overtakes spilled Bulk.
+// a message whose handler needs an earlier one to have run (a move needs the spawn of its object) has to be in the same
+// class as that one or a lower one, and handlers of the lower classes have to cope with an object that is already gone
+class CLIENTNET_API FPacketDispatcher
+{
+public:
+	FPacketDispatcher();
+
+	void SetBudget(const FNetDispatchBudget& budget) { _budget = budget; }
+	const FNetDispatchBudget& GetBudget() const { return _budget; }
+
+	void SetPriority(uint16 msgID, ENetDispatchPriority priority);
+	ENetDispatchPriority GetPriority(uint16 msgID) const { return (ENetDispatchPriority)_priorities[msgID]; }
+
+	void Push(TSharedPacket&& packet);
+
+	void BeginFrame();
+	void Dispatch(TFunctionRef<void(TSharedPacket&)> handler);
+	// charges one packet dispatched outside of the backlogs, false once the budget is spent
+	bool TryCharge();
+	void EndFrame();
+
+	void Empty();
+	uint32 GetBacklog() const;
+	const FNetDispatchStats& GetStats() const { return _stats; }
+
+private:
+	struct FBacklog
+	{
+		TArray<TSharedPacket> packets;
+		int32 head = 0;
+
+		int32 Num() const { return packets.Num() - head; }
+		TSharedPacket Pop();
+		void Empty();
+	};
+
+	bool IsOverBudget() const;
+
+private:
+	FNetDispatchBudget _budget;
+	FNetDispatchStats _stats;
+	TArray<uint8> _priorities;
+	FBacklog _backlogs[(uint8)ENetDispatchPriority::Max];
+
+	uint64 _frameStartCycles = 0;
+	uint64 _budgetCycles = 0;
+	uint32 _frameCharged = 0;
+};
@@ -0,0 +1,70 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NetPacket.h"
+#include "NetPacketView.h"
+
+#include "netcore_fragment.h"
+
+// streaming of bodies larger than one frame, FRAMEWORKMSG_FRAGMENT carries the original id, the total size and
+// the offset of every slice. both sides only stream once FRAMEWORK_CAPABILITY_FRAGMENT was agreed during FRAMEWORKMSG_SETUP_CORD.
+class CLIENTNET_API FPacketFragmentation
+{
+public:
+	// capabilities offered in FRAMEWORKMSG_SETUP_CORD
+	static uint8 GetOfferedCapabilities();
+	// slice bytes per frame, small enough to let other messages through between slices
+	static uint32 GetSliceBytes();
+};
+
+// sending side of a session, owned by the pump thread
+class CLIENTNET_API FPacketFragmenter
+{
+public:
+	// a finalized packet IsStreamed() says is too large for one frame
+	void Push(const TSharedPacket& packet);
+
+	// writes the next slice frame to out, round robin over the open streams.
+	// returns the frame size, 0 when nothing is pending or capacity can not hold a slice
+	uint32 WriteNext(uint8* out, uint32 capacity);
+
+	bool IsEmpty() const { return _writer.IsEmpty(); }
+	void Reset() { _writer.Reset(); }
+
+private:
+	// the packet keeps the body the writer reads from alive
+	NetCore::FragmentWriter<TSharedPacket> _writer;
+};
+
+// receiving side of a session, owned by the pump thread
+class CLIENTNET_API FPacketReassembler
+{
+public:
+	enum class EResult : uint8
+	{
+		Pending,
+		Completed,
+		Corrupted,
+	};
+
+	// slices are copied into one buffer sized from the first slice, completed is set with the original packet.
+	// the view may point straight into the receive ring, the caller stamps session and timestamp on completed
+	EResult Feed(FNetPacketView fragment, TSharedPacket& completed);
+	EResult Feed(const TSharedPacket& fragment, TSharedPacket& completed);
+	void Reset() { _reassembler.Reset(); }
+
+private:
+	// pool packets as the reassembly buffer
+	struct FPooledBuffer
+	{
+		using Buffer = TSharedPacket;
+
+		static TSharedPacket Alloc(uint16 msgID, uint32 totalSize);
+		static void Append(TSharedPacket& packet, const uint8* data, uint32 size);
+	};
+
+	NetCore::FragmentReassembler<FPooledBuffer> _reassembler;
+};
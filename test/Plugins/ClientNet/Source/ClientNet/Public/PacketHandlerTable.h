@@ -0,0 +1,49 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NetPacket.h"
+
+DECLARE_DELEGATE_OneParam(FOnPacket, TSharedPacket);
+
+// direct indexed by msgID, a 64k slot byte map in front of a compact handler array.
+// one load and one index per lookup, no hashing and no probing.
+class CLIENTNET_API FPacketHandlerTable
+{
+public:
+	FPacketHandlerTable()
+	{
+		_slots.Init(0, 0x10000);
+	}
+
+	void Add(uint16 msgID, const FOnPacket& handler)
+	{
+		uint8 slot = _slots[msgID];
+		if (slot != 0) {
+			_handlers[slot - 1] = handler;
+			return;
+		}
+
+		check(_handlers.Num() < MAX_uint8);
+		_handlers.Add(handler);
+		_slots[msgID] = (uint8)_handlers.Num();
+	}
+
+	FOnPacket* Find(uint16 msgID)
+	{
+		uint8 slot = _slots[msgID];
+		return slot != 0 ? &_handlers[slot - 1] : nullptr;
+	}
+
+	void Empty()
+	{
+		::memset(_slots.GetData(), 0, _slots.Num());
+		_handlers.Reset();
+	}
+
+private:
+	TArray<uint8> _slots;
+	TArray<FOnPacket> _handlers;
+};
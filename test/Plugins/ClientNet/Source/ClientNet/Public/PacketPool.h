@@ -0,0 +1,80 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include "NetPacket.h"
+
+#include <atomic>
+
+#define MIN_MSGBUF_SIZE		(uint16)256
+
+struct CLIENTNET_API FNetPacketPoolStats
+{
+	uint64 hits = 0;
+	uint64 misses = 0;
+	uint64 discarded = 0;
+	// shared handles handed out, each one allocates its reference controller
+	uint64 handles = 0;
+	int32 outstanding = 0;
+	int32 highWater = 0;
+	int32 pooled = 0;
+
+	FString ToString() const;
+};
+
+// recycles FNetPacket buffers by size class, the deleter of every TSharedPacket handed out returns it here.
+class CLIENTNET_API FNetPacketPool
+{
+public:
+	enum class ESizeClass : uint8
+	{
+		Small,		// MIN_MSGBUF_SIZE
+		Regular,	// MAX_MSGBUF_SIZE
+		Messive,	// MAX_MESSIVE_BUF_SIZE
+		Max
+	};
+
+	static FNetPacketPool& Get();
+
+	// packet ready to be written, cursors at the start of the body
+	TSharedPacket Alloc(uint16 msgID, uint32 bodySize = 0);
+	// raw frame buffer for the receive path, cursors at the start of the header
+	TSharedPacket AllocFrame(uint32 packetSize);
+
+	FNetPacketPoolStats GetStats() const;
+	void Trim();
+
+private:
+	FNetPacketPool();
+	~FNetPacketPool();
+
+	FNetPacketPool(const FNetPacketPool&) = delete;
+	FNetPacketPool& operator=(const FNetPacketPool&) = delete;
+
+	static ESizeClass Classify(size_t required);
+	static size_t GetClassCapacity(ESizeClass sizeClass);
+
+	FNetPacket* Acquire(size_t required);
+	void Release(FNetPacket* packet);
+	TSharedPacket Wrap(FNetPacket* packet);
+
+private:
+	struct FBucket
+	{
+		mutable FCriticalSection lock;
+		TArray<FNetPacket*> packets;
+		int32 maxRetained = 0;
+	};
+
+	FBucket _buckets[(uint8)ESizeClass::Max];
+
+	std::atomic<uint64> _hits = 0;
+	std::atomic<uint64> _misses = 0;
+	std::atomic<uint64> _discarded = 0;
+	std::atomic<uint64> _handles = 0;
+	std::atomic<int32> _outstanding = 0;
+	std::atomic<int32> _highWater = 0;
+};
@@ -0,0 +1,11 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "netcore_ring.h"
+
+// socket reads land in the ring, complete frames are sliced out of it in place
+using FRecvFrame = NetCore::RecvFrame;
+using FRecvRingBuffer = NetCore::RecvRingBuffer;
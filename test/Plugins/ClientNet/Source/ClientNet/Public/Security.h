@@ -7,6 +7,7 @@
 #include "NetPacket.h"
 #include <vector>
 #include <optional>
+#include <memory>
 
 #define UI UI_ST
 THIRD_PARTY_INCLUDES_START
@@ -18,14 +19,26 @@ THIRD_PARTY_INCLUDES_START
 #include <openssl/err.h>
 #include <openssl/rand.h>
 #include <openssl/aes.h>
+#include <openssl/evp.h>
 THIRD_PARTY_INCLUDES_END
 #undef UI
 
+#include "netcore_cipher.h"
+
+// the protocol core's EVP cipher lets openssl pick AES-NI, the low level AES_KEY path stays as fallback
+#ifndef CLIENTNET_SECURITY_USE_EVP
+#define CLIENTNET_SECURITY_USE_EVP 1
+#endif
+
 struct SecurityContext {
 	std::optional<std::vector<uint8>> userKey;
 	std::vector<uint8> dec_iv;
 	std::vector<uint8> enc_iv;
 
+	// expanded once when the exchange is loaded, the running iv lives in here afterwards
+	AES_KEY aesKey;
+	NetCore::StreamCipher cipher;
+
 	bool isActivated() {
 		if (userKey.has_value()) {
 			return true;
@@ -51,6 +64,8 @@ public:
 
 private:
 	bool DecryptRSA(TSharedPacket& packet);
+	bool ExpandKey(SecurityContext& context);
+	bool Transform(TSharedPacket& packet, bool encrypt);
 
 	RSA* _rsa = nullptr;
 	BIGNUM* _bigNum = nullptr;
@@ -7,12 +7,59 @@
 
 #include "Worker.h"
 #include "NetPacket.h"
+#include "NetPacketView.h"
+#include "RecvBuffer.h"
+#include "PacketFragmentation.h"
 
 class FSocket;
-DECLARE_DELEGATE_OneParam(FPacketRecvQueue, TSharedPacket&)
+class FInternetAddr;
+// false when the receive queue is full, the packet stays with the session and is offered again on the next pump
+DECLARE_DELEGATE_RetVal_OneParam(bool, FPacketRecvQueue, TSharedPacket&)
 
 #define SAFE_DELETE(x)	{ delete (x); (x) = nullptr; }
 
+// written by the pump thread only
+struct FSessionStats
+{
+	uint64 recvCalls = 0;
+	uint64 bytesReceived = 0;
+	uint64 packetsReceived = 0;
+	// received frames that needed a pooled packet of their own, and envelopes decoded where they lay in the receive ring
+	uint64 framesCopied = 0;
+	uint64 framesInPlace = 0;
+	// pumps that stopped reading because the receive queue was full
+	uint64 recvStalls = 0;
+
+	uint64 sendCalls = 0;
+	uint64 bytesSent = 0;
+	uint64 packetsSent = 0;
+	uint32 lastPumpBytesSent = 0;
+	uint32 lastPumpPacketsSent = 0;
+};
+
+// transport envelopes of received frames, shared by the session and the capture replay
+class CLIENTNET_API FFrameUnwrapper
+{
+public:
+	enum class EResult : uint8
+	{
+		Ready,
+		Pending,
+		Corrupted,
+	};
+
+	static bool IsEnvelope(uint16 msgID) { return msgID == FRAMEWORKMSG_FRAGMENT || msgID == FRAMEWORKMSG_COMPRESSED; }
+
+	// packet is replaced by the original message once it is Ready
+	EResult Unwrap(TSharedPacket& packet);
+	// envelope frame owned by someone else, packet is set with the original message once it is Ready
+	EResult Unwrap(FNetPacketView frame, int32 sessionID, int64 timestamp, TSharedPacket& packet);
+	void Reset() { _reassembler.Reset(); }
+
+private:
+	FPacketReassembler _reassembler;
+};
+
 struct FSession
 {
 	FSession(int32 sessionID, FPacketRecvQueue& recvQueue);
@@ -20,26 +67,50 @@ struct FSession
 
 	int32 _sessionID = 0;
 	FString _host;
-	uint32 _ip = 0;
 	int32 _port = 0;
+	// the address the connect race won with
+	TSharedPtr<FInternetAddr> _remoteAddr;
 
 private:
 	FSocket* _socket = nullptr;
-	TSharedPacket _buildingPacket;
+	FRecvRingBuffer _recvBuffer;
 	FPacketRecvQueue _receivedQueue;
+	// the packet the receive queue did not take, nothing more is read until it went through
+	TSharedPacket _undelivered;
 	TQueue<TSharedPacket> _sendingQueue;
+	FSessionStats _stats;
+
+	// streamed bodies go out slice by slice behind whatever small packet is queued
+	FPacketFragmenter _fragmenter;
+	FFrameUnwrapper _unwrapper;
+
+	// packets dequeued in one pump are coalesced here and flushed with as few sends as possible
+	std::vector<uint8> _sendBuffer;
+	uint32 _sendCursor = 0;
+	uint32 _sendPending = 0;
+	uint32 _sendFlushBytes = 16 * 1024;
 
 public:
-	bool Create(const FString& host, int32 port);
+	void Create(const FString& host, int32 port);
+	// takes over the connected socket of the race
+	void Attach(FSocket* socket, const TSharedPtr<FInternetAddr>& remoteAddr);
 	void Close();
 
-	bool Connect();
-	bool PrepareConnect();
+	// non blocking stream socket with the session options, for one connect attempt
+	static FSocket* CreateSocket(const FName& protocolType);
 	bool PumpNetIO();
 	void SendPacket(const TSharedPacket& packet);
 	int32 GetSessionID() { return _sessionID; }
+	const FSessionStats& GetStats() const { return _stats; }
+	FSocket* GetSocket() { return _socket; }
+	bool IsReceiveStalled() const { return _undelivered.IsValid(); }
+	bool HasPendingSend() { return _sendCursor < _sendPending || _sendingQueue.IsEmpty() == false || _fragmenter.IsEmpty() == false; }
+	void SetSendFlushBytes(uint32 bytes);
 
 private:
 	bool Receiving();
+	bool DispatchFrames();
+	bool Deliver(TSharedPacket& packet);
 	bool Sending();
+	uint32 GatherSendingPackets();
 };
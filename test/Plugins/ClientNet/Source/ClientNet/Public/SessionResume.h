@@ -0,0 +1,62 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NetPacket.h"
+
+#include "netcore_resume.h"
+
+struct FSessionResumeStats
+{
+	uint64 resumes = 0;
+	// resumes the gap did not allow, repaired with a full resync instead
+	uint64 resyncs = 0;
+	uint64 replayedPackets = 0;
+	uint64 replayedBytes = 0;
+	// unacknowledged packets dropped to keep the buffer bounded
+	uint64 evicted = 0;
+
+	FString ToString() const;
+};
+
+// sequence numbers and retransmit buffer of the server session, see NetCore::ResumeWindow. game thread only.
+// sent packets are kept until FRAMEWORKMSG_SEQUENCE_ACK covers them, bounded by ClientNet.Resume.BufferPackets
+// and ClientNet.Resume.BufferBytes
+class CLIENTNET_API FSessionResume
+{
+public:
+	// capabilities offered in FRAMEWORKMSG_SETUP_CORD
+	static uint8 GetOfferedCapabilities();
+
+	// a new numbering on both sides, after sign in or a full repair. disabled keeps nothing
+	void Reset(bool enabled);
+	bool IsEnabled() const { return _enabled; }
+
+	// a content packet handed to the server session
+	void OnSent(const TSharedPacket& packet);
+	// a content packet received from the server session, true once an ack is due
+	bool OnReceived();
+	// the server received our messages up to received
+	void Acknowledge(uint32 received);
+	// count to put in FRAMEWORKMSG_SEQUENCE_ACK, 0 when the last one is still current
+	uint32 TakeAck();
+
+	// our messages past the server's received, false when some of them were evicted already
+	bool CollectReplay(uint32 received, TArray<TSharedPacket>& packets) const;
+	void RecordResumed(const TArray<TSharedPacket>& replayed);
+	void RecordResync() { ++_stats.resyncs; }
+
+	uint32 GetSent() const { return _window.GetSent(); }
+	uint32 GetReceived() const { return _window.GetReceived(); }
+	// first sequence number still kept for a replay, GetSent() + 1 when nothing is
+	uint32 GetOldest() const { return _window.GetOldest(); }
+	const FSessionResumeStats& GetStats() const { return _stats; }
+
+private:
+	bool _enabled = false;
+	NetCore::ResumeWindow<TSharedPacket> _window;
+
+	FSessionResumeStats _stats;
+};
@@ -0,0 +1,37 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NetPacket.h"
+#include "SnapshotCoalescer.h"
+
+#include "netcore_snapshot.h"
+
+// snapshot records (count, then guid + AmbiguousSnapshotData each, see FSnapshotCoalescer) decoded in one pass into
+// an array per unit. entry i of every array belongs to record i, units the record did not carry stay zeroed and
+// SyncStates tells which ones are set. reused between frames so the arrays only grow to the largest batch seen.
+// with baselines, SNAPSHOT_SYNC_DELTA_LOCATION is resolved into absolute location and rotation units.
+// the parsing is NetCore::DecodeSnapshotRecords, the batch is its sink.
+struct CLIENTNET_API FSnapshotBatch
+{
+	TArray<SnapshotPatchGUID> Guids;
+	TArray<uint8> SyncStates;
+	TArray<FVector3f> Locations;
+	TArray<float> Rotations;
+	TArray<MotionState> Motions;
+	TArray<uint32> SkillGUIDs;
+	TArray<uint8> ControllersEnabled;
+
+	int32 Num() const { return Guids.Num(); }
+	void Reset();
+
+	// false on a compact or malformed body, the batch is left empty then
+	bool Decode(const TSharedPacket& packet, SnapshotDeltaBaselines* baselines = nullptr);
+	bool Decode(const uint8* body, uint32 bodySize, SnapshotDeltaBaselines* baselines = nullptr);
+
+	// NetCore::DecodeSnapshotRecords sink
+	void Begin(uint16 count);
+	void Add(uint16 index, const NetCore::SnapshotRecord& record);
+};
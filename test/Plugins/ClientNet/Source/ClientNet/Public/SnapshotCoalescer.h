@@ -0,0 +1,65 @@
+// Copyright 2018 CLOVERGAMES Co., Ltd. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "NetPacket.h"
+
+#include "netcore_snapshot.h"
+
+// MOVE_SNAPSHOT_PATCH_NFY body as read by the coalescer
+//	uint16 count
+//	count * { SnapshotPatchGUID guid, AmbiguousSnapshotData (SyncState + arranged units, CompressedSz bytes) }
+// a body that does not parse to exactly this is passed through untouched. SnapshotPatchGUID comes with the protocol core.
+
+struct CLIENTNET_API FSnapshotCoalescerStats
+{
+	uint64 packetsIn = 0;
+	uint64 packetsOut = 0;
+	uint64 passedThrough = 0;
+	uint64 patchesIn = 0;
+	uint64 patchesMerged = 0;
+	uint64 patchesDelivered = 0;
+
+	FString ToString() const;
+};
+
+// game thread only, folds the snapshot patches of one frame into one record per object and run of patches.
+// units are overwritten by the newest patch carrying them and the sync masks are or-ed,
+// a patch repeating a unit outside of the mergeable mask starts a new record so no event is lost.
+class CLIENTNET_API FSnapshotCoalescer
+{
+public:
+	FSnapshotCoalescer();
+
+	void SetEnabled(bool enabled) { _enabled = enabled; }
+	bool IsEnabled() const { return _enabled; }
+
+	void SetMergeableMask(uint8 mask) { _mergeableMask = mask; }
+
+	// replaces every run of consecutive patches inside the batch by the merged ones, in place of the run
+	void Coalesce(TArray<TSharedPacket>& batch);
+
+	const FSnapshotCoalescerStats& GetStats() const { return _stats; }
+
+private:
+	struct FRecord
+	{
+		SnapshotPatchGUID guid = 0;
+		uint8 syncState = 0;
+		uint8 units[8][16];
+	};
+
+	bool Merge(TSharedPacket& packet);
+	void Flush(TArray<TSharedPacket>& merged, int32 sessionID);
+
+private:
+	bool _enabled = false;
+	uint8 _mergeableMask = 0;
+
+	TArray<FRecord> _records;
+	TMap<SnapshotPatchGUID, int32> _openRecords;
+
+	FSnapshotCoalescerStats _stats;
+};